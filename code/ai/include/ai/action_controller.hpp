@@ -49,12 +49,25 @@ struct  action_execution_context
     scene_binding const&  binding() const;
     com::simulation_context const&  ctx() const;
 
+    // Relative paths to folders containing frames, which actions read. The action controller registers the paths of
+    // all actions when it compiles the action graph, and the actions then refer to the paths by the returned ids.
+    natural_32_bit  register_frame_path(std::string const&  relative_path);
+    // Returns the frame in the folder given by the registered relative path from the base folder. Resolved frames
+    // are cached per agent in tables indexed by path ids (until the access path caches of the scene context are
+    // invalidated), so no string is hashed per call.
+    com::object_guid  frame_guid_under_folder(com::object_guid const  base_folder_guid, natural_32_bit const  frame_path_id) const;
+
     agent*  myself;
     skeleton_interpolator_animation  animate;
     skeleton_interpolator_look_at  look_at;
     skeleton_interpolator_aim_at  aim_at;
     float_32_bit  time_buffer;
     std::vector<scene_object_relative_path>  disabled_colliding_with_our_motion_object;
+
+private:
+    std::vector<std::string>  m_frame_paths;   // Indexed by frame path ids.
+    mutable std::unordered_map<com::object_guid, std::vector<com::object_guid> >  m_frame_guids_cache;    // Per base folder; indexed by frame path ids.
+    mutable natural_64_bit  m_frame_guids_cache_generation;
 };
 
 
@@ -104,6 +117,7 @@ struct  agent_action
         struct  location_constraint_config
         {
             std::string  frame_folder;
+            natural_32_bit  frame_folder_id; // Of 'frame_folder'; see 'action_execution_context::register_frame_path'.
             angeo::COLLISION_SHAPE_TYPE  shape_type; // Only BOX, CAPSULE, or SPHERE!
             angeo::coordinate_system  frame;
             vector3  aabb_half_size;
@@ -123,6 +137,7 @@ struct  agent_action
         {
             bool  is_self_frame;
             std::string  frame_folder;
+            natural_32_bit  frame_folder_id; // Of 'frame_folder'; see 'action_execution_context::register_frame_path'.
             angeo::coordinate_system  frame;
             std::vector<std::string>  relative_paths_to_colliders_for_disable_colliding;
         };
@@ -164,9 +179,9 @@ struct  agent_action
     com::simulation_context const&  ctx() const { return m_context->ctx(); }
 
     desire_config const&  get_desire_config() const { return DESIRE; }
-    float_32_bit  compute_desire_penalty(motion_desire_props const&  desire_props) const;
 
     std::string const&  get_name() const { return NAME; }
+    natural_32_bit  get_id() const { return m_id; }
 
     bool  is_cyclic() const { return IS_CYCLIC; }
     bool  is_complete() const;
@@ -227,6 +242,14 @@ protected:
     std::string  NAME;
     desire_config  DESIRE;
     std::map<std::string, std::map<std::string, angeo::linear_segment_curve> >  EFFECTS;
+    struct  effect_term
+    {
+        natural_32_bit  target;                     // Index of a state variable.
+        natural_32_bit  source;                     // Index of a system or a state variable.
+        bool  is_source_system_variable;
+        angeo::linear_segment_curve  curve;
+    };
+    std::vector<effect_term>  EFFECT_TERMS;         // EFFECTS resolved to indices of variables; grouped by targets.
     std::string  MOTION_TEMPLATE_NAME;
     bool  ONLY_INTERPOLATE_TO_MOTION_TEMPLATE;
     bool  USE_MOTION_TEMPLATE_FOR_LOCATION_INTERPOLATION;
@@ -257,6 +280,9 @@ private:
     float_32_bit  m_current_time;
 
     skeletal_animation_info  m_animation;
+
+    friend struct  action_controller;
+    natural_32_bit  m_id;   // Assigned by the action_controller; see 'action_controller::compile_action_graph'.
 };
 
 
@@ -360,9 +386,23 @@ struct  action_controller
 private:
     void  process_action_transitions();
 
+    void  compile_action_graph();
+    float_32_bit  compute_desire_penalty(natural_32_bit const  action_id, float_32_bit const* const  desire_vector) const;
+
     action_execution_context_ptr  m_context;
     agent_action_ptr  m_current_action;
     std::unordered_map<std::string, agent_action_ptr>  m_available_actions;
+
+    // COMPILED ACTION GRAPH (built from 'm_available_actions' in the constructor; it also registers
+    // the frame paths of transitions, see 'action_execution_context::register_frame_path')
+
+    std::vector<agent_action_ptr>  m_actions;               // Indexed by action ids; ids follow sorted names of actions.
+    std::vector<natural_32_bit>  m_transitions_begin;       // Targets of action 'i' are m_transition_targets[m_transitions_begin[i] .. m_transitions_begin[i+1]).
+    std::vector<natural_32_bit>  m_transition_targets;
+    natural_32_bit  m_desire_vector_size;
+    std::vector<float_32_bit>  m_desire_ideals;             // Row 'i' (of size 'm_desire_vector_size') belongs to the action 'i'.
+    std::vector<float_32_bit>  m_desire_weights;            // Row 'i' (of size 'm_desire_vector_size') belongs to the action 'i'.
+    mutable std::vector<float_32_bit>  m_desire_buffer;
 };
 
 
@@ -49,6 +49,9 @@ struct agent
 
     cortex const&  get_cortex() const { return *m_cortex; }
 
+    // Agents with different seeds draw different sequences of random numbers.
+    void  set_random_seed(natural_32_bit const  seed);
+
     void  next_round(float_32_bit const  time_step_in_seconds, cortex::mock_input_props const* const  mock_input_ptr);
 
 private:
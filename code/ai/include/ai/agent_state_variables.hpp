@@ -4,6 +4,7 @@
 #   include <ai/agent_config.hpp>
 #   include <utility/basic_numeric_types.hpp>
 #   include <string>
+#   include <vector>
 #   include <unordered_map>
 #   include <memory>
 
@@ -20,14 +21,12 @@ struct  agent_state_variable
     };
 
     agent_state_variable(
-            std::string const&  name_,
             float_32_bit const  value_,
             float_32_bit const  min_value_,
             float_32_bit const  max_value_,
             float_32_bit const  ideal_value_
             );
 
-    std::string const&  get_name() const { return name; }
     float_32_bit  get_value() const { return value; }
     float_32_bit  get_min_value() const { return constants.min_value; }
     float_32_bit  get_max_value() const { return constants.max_value; }
@@ -41,13 +40,62 @@ struct  agent_state_variable
     void  add_to_value(float_32_bit const  dx) { set_value(value + dx); }
 
 private:
-    std::string  name;
     float_32_bit  value;
     config  constants;
 };
 
 
-using  agent_state_variables = std::unordered_map<std::string, agent_state_variable>;
+// Interns names of variables to dense indices. It is built once, when variables are loaded
+// from the agent's config, and then shared (read-only) by all copies of the variables.
+struct  agent_variable_names
+{
+    natural_32_bit  insert(std::string const&  name);
+
+    natural_32_bit  size() const { return (natural_32_bit)m_names.size(); }
+    std::string const&  name_of(natural_32_bit const  idx) const { return m_names.at(idx); }
+    natural_32_bit  index_of(std::string const&  name) const; // Returns size() for an unknown name.
+
+private:
+    std::vector<std::string>  m_names;
+    std::unordered_map<std::string, natural_32_bit>  m_indices;
+};
+
+
+using  agent_variable_names_const_ptr = std::shared_ptr<agent_variable_names const>;
+
+
+/**
+ * Values of state variables are stored in a flat array indexed by dense indices
+ * of the names. Copying the variables (e.g. for a search in a cortex) thus copies
+ * only the array; the names are shared. The string API (by name) is kept for tooling
+ * and configuration loading; per-step code should use indices.
+ */
+struct  agent_state_variables
+{
+    using  const_iterator = std::vector<agent_state_variable>::const_iterator;
+
+    agent_state_variables();
+    agent_state_variables(agent_variable_names_const_ptr const  names, std::vector<agent_state_variable> const&  variables);
+
+    natural_32_bit  size() const { return (natural_32_bit)m_variables.size(); }
+
+    agent_state_variable const&  at(natural_32_bit const  idx) const { return m_variables.at(idx); }
+    agent_state_variable&  at(natural_32_bit const  idx) { return m_variables.at(idx); }
+
+    std::string const&  name_of(natural_32_bit const  idx) const { return m_names->name_of(idx); }
+    natural_32_bit  index_of(std::string const&  name) const { return m_names->index_of(name); }
+
+    agent_state_variable const&  at(std::string const&  name) const;
+    agent_state_variable&  at(std::string const&  name);
+    std::size_t  count(std::string const&  name) const { return index_of(name) == size() ? 0UL : 1UL; }
+
+    const_iterator  begin() const { return m_variables.begin(); }
+    const_iterator  end() const { return m_variables.end(); }
+
+private:
+    agent_variable_names_const_ptr  m_names;
+    std::vector<agent_state_variable>  m_variables;
+};
 
 
 agent_state_variables  load_agent_state_variables(agent_config const  config);
@@ -3,14 +3,51 @@
 
 #   include <utility/basic_numeric_types.hpp>
 #   include <string>
-#   include <unordered_map>
+#   include <array>
 
 namespace ai { struct  agent_system_state; }
 
 namespace ai {
 
 
-using  agent_system_variables = std::unordered_map<std::string, float_32_bit>;
+/**
+ * System variables are interned at compile time: each variable has a fixed dense index,
+ * and values are stored in a flat array. The string API (by name) is kept for tooling
+ * and configuration loading; per-step code should use indices.
+ */
+struct  agent_system_variables
+{
+    enum  INDEX : natural_32_bit
+    {
+        SYS_ZERO                        = 0U,
+        SYS_ONE                         = 1U,
+        SYS_ANIMATION_SPEED             = 2U,
+        SYS_ANGLE_LOOK_FORWARD          = 3U,
+        SYS_ANGLE_LOOK_ATTRACTOR_XP     = 4U,
+        SYS_ANGLE_LOOK_ATTRACTOR_XN     = 5U,
+        SYS_ANGLE_LOOK_ATTRACTOR_YP     = 6U,
+        SYS_ANGLE_LOOK_ATTRACTOR_YN     = 7U,
+
+        NUM_VARIABLES                   = 8U
+    };
+
+    static std::string const&  name_of(natural_32_bit const  idx);
+    static natural_32_bit  index_of(std::string const&  name); // Returns NUM_VARIABLES for an unknown name.
+
+    agent_system_variables();
+
+    natural_32_bit  size() const { return NUM_VARIABLES; }
+
+    float_32_bit  at(natural_32_bit const  idx) const { return m_values.at(idx); }
+    float_32_bit&  at(natural_32_bit const  idx) { return m_values.at(idx); }
+
+    float_32_bit  at(std::string const&  name) const;
+    float_32_bit&  at(std::string const&  name);
+    std::size_t  count(std::string const&  name) const { return index_of(name) == NUM_VARIABLES ? 0UL : 1UL; }
+
+private:
+    std::array<float_32_bit, NUM_VARIABLES>  m_values;
+};
 
 
 agent_system_variables  load_agent_system_variables();
@@ -7,9 +7,9 @@
 #   include <ai/agent_state_variables.hpp>
 #   include <angeo/tensor_math.hpp>
 #   include <gfx/viewport.hpp>
-#   include <osi/window_props.hpp>
 #   include <osi/keyboard_props.hpp>
 #   include <osi/mouse_props.hpp>
+#   include <unordered_set>
 
 namespace ai { struct  agent; }
 
@@ -18,18 +18,19 @@ namespace ai {
 
 struct  cortex
 {
+    // A copy of the input state at the time of construction (the osi props only read the live state of the
+    // window), so the props can be passed to a simulation running in another thread than the window.
     struct  mock_input_props
     {
         mock_input_props(
-                osi::keyboard_props const* const  keyboard_,
-                osi::mouse_props const* const  mouse_,
-                osi::window_props const* const  window_,
-                gfx::viewport const* const  viewport_
+                osi::keyboard_props const&  keyboard,
+                osi::mouse_props const&  mouse,
+                gfx::viewport const&  viewport_
                 );
-        osi::keyboard_props const*  keyboard;
-        osi::mouse_props const*  mouse;
-        osi::window_props const*  window;
-        gfx::viewport const*  viewport;
+        std::unordered_set<osi::keyboard_key_name>  keys_pressed;
+        std::unordered_set<osi::mouse_button_name>  buttons_pressed;
+        vector2  cursor;
+        gfx::viewport  viewport;
     };
 
     cortex(agent const*  myself_);
@@ -41,6 +42,9 @@ struct  cortex
 
     void  next_round(float_32_bit const  time_step_in_seconds, mock_input_props const* const  mock_input_ptr);
 
+    // Cortices drawing random numbers should seed their generators here.
+    virtual void  set_random_seed(natural_32_bit const  seed) {}
+
     virtual void  next_round(float_32_bit const  time_step_in_seconds) {}
 
     // Only "MOCK" cortices should override this version of the next_step function (instead of the one above!).
@@ -3,16 +3,58 @@
 
 #   include <ai/cortex_mock.hpp>
 #   include <angeo/tensor_math.hpp>
+#   include <netlab/network.hpp>
+#   include <boost/property_tree/ptree.hpp>
+#   include <vector>
+#   include <memory>
 
 namespace ai {
 
 
+/**
+ * A cortex driven by a netlab network. The input layer has one unit per cell of the depth image of the
+ * sight controller followed by two units (for the positive and negative part) per system variable. Inputs
+ * are rate coded: each input unit accumulates its value (clipped to <0,1>) in each round and spikes whenever
+ * the accumulated value reaches 1. The output layer has two populations of units (for the positive and negative
+ * direction) per motion desire (in the order of 'as_vector'), and a desire is the difference of the ratios of
+ * spikes of its populations in all rounds of a step. The smaller of the two layers is padded by unused units
+ * to the size of the other one, because the builder of the network requires them to be of the same size.
+ * All buffers are allocated in the constructor, so steps do not allocate memory (except inside the network).
+ * The network is built in the first step, so it is built only once, with the seed set after the construction.
+ */
 struct  cortex_netlab : public cortex_mock_optional
 {
-    cortex_netlab(agent const*  myself_, bool const  use_mock_);
+    struct  config
+    {
+        natural_32_bit  num_rounds_per_step;
+        natural_32_bit  num_hidden_layers;
+        natural_32_bit  num_units_per_hidden_layer;
+        natural_32_bit  num_units_per_desire_population;
+        natural_32_bit  num_sockets_per_unit;
+
+        config(boost::property_tree::ptree const&  ptree);  // Missing keys have default values (about 0.3ms per step).
+    };
+
+    cortex_netlab(agent const*  myself_, bool const  use_mock_, boost::property_tree::ptree const&  ptree);
+    void  set_random_seed(natural_32_bit const  seed) override;
     void  next_round(float_32_bit const  time_step_in_seconds) override;
 
+    netlab::network const*  get_network() const { return m_network.get(); }   // nullptr before the first step.
+
 private:
+    void  build_network();
+    void  update_input_rates();
+    void  encode_inputs();
+    void  decode_outputs();
+
+    config  m_config;
+    natural_32_bit  m_num_depth_cells;
+    natural_32_bit  m_random_seed;
+    std::unique_ptr<netlab::network>  m_network;
+    std::vector<float_32_bit>  m_input_rates;           // For each input unit, updated once per step.
+    std::vector<float_32_bit>  m_input_accumulators;    // For each input unit.
+    std::vector<natural_32_bit>  m_output_counts;       // For each population of output units, the number of spikes in the step.
+    std::vector<float_32_bit>  m_desires;               // In the order of 'as_vector'.
 };
 
 
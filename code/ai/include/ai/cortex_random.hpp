@@ -11,6 +11,7 @@ namespace ai {
 struct  cortex_random : public cortex_mock_optional
 {
     cortex_random(agent const*  myself_, bool const  use_mock_);
+    void  set_random_seed(natural_32_bit const  seed) override { reset(m_generator, seed); }
     void  next_round(float_32_bit const  time_step_in_seconds);
 private:
     float_32_bit  m_seconds_till_change;
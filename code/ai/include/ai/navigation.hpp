@@ -7,10 +7,13 @@
 #   include <angeo/coordinate_system.hpp>
 #   include <angeo/proximity_map.hpp>
 #   include <utility/dynamic_array.hpp>
+#   include <utility/thread_pool.hpp>
+#   include <utility/mapped_file.hpp>
 #   include <unordered_map>
 #   include <unordered_set>
 #   include <string>
 #   include <array>
+#   include <filesystem>
 #   include <limits>
 #   include <functional>
 #   include <memory>
@@ -161,9 +164,20 @@ struct  navcomponent
 
     std::unordered_set<navobj_guid> const&  get_border_waypoints() const { return m_border_waypoints; }
 
+    std::vector<navobj_guid> const&  get_navlinks() const { return m_navlinks; }
+    std::vector<navobj_guid> const&  get_navlinks_of_waypoint(navobj_guid const  waypoint_guid) const;
+
+    // NOTE: Bounding boxes of waypoints in the map are in the local space of the component (see 'get_frame()').
+    angeo::proximity_map<navobj_guid> const&  get_waypoints_proximity() const { return m_waypoints_proximity; }
+
     angeo::coordinate_system_explicit const&  get_frame() const { return m_frame; }
     com::object_guid  get_collider_guid() const { return m_collider_guid; }
 
+    vector3 const&  get_local_bbox_min() const { return m_local_bbox_min; }
+    vector3 const&  get_local_bbox_max() const { return m_local_bbox_max; }
+    vector3 const&  get_world_bbox_min() const { return m_world_bbox_min; }
+    vector3 const&  get_world_bbox_max() const { return m_world_bbox_max; }
+
     bool  valid(navobj_guid const  guid) const;
 
 private:
@@ -175,15 +189,34 @@ private:
 
     waylink&  waylink_ref(navobj_guid const  nav_guid);
 
+    // Placement of this component in the frame of a nearby component at the time navlinks between them were built.
+    struct  neighbour_placement
+    {
+        navobj_guid  component_guid;
+        vector3  origin;
+        vector3  basis_vector_x;
+        vector3  basis_vector_y;
+        std::vector<navobj_guid>  navlinks; // Navlinks between the two components; the same in the placement of the other one.
+    };
+
     dynamic_array<waypoint>  m_waypoints;
     dynamic_array<waylink>  m_waylinks;
 
     std::unordered_set<navobj_guid>  m_border_waypoints;
 
+    std::vector<navobj_guid>  m_navlinks;   // Navlinks (in the navsystem) having an end in this component.
+    std::unordered_map<navobj_guid, std::vector<navobj_guid> >  m_navlinks_of_waypoints;
+    std::vector<neighbour_placement>  m_neighbours; // Sorted by guids of components.
+
     angeo::proximity_map<navobj_guid>  m_waypoints_proximity;
 
     angeo::coordinate_system_explicit  m_frame;
     com::object_guid  m_collider_guid;
+
+    vector3  m_local_bbox_min;
+    vector3  m_local_bbox_max;
+    vector3  m_world_bbox_min;
+    vector3  m_world_bbox_max;
 };
 
 
@@ -205,6 +238,9 @@ struct  navsystem
 
     waypoint const&  get_waypoint(navlink const&  link, natural_32_bit const  idx) const;
 
+    // NOTE: Bounding boxes of components in the map are in the world space.
+    angeo::proximity_map<navobj_guid> const&  get_components_proximity() const { return m_components_proximity; }
+
     std::unordered_set<navobj_guid> const&  get_dynamic_components() const { return m_dynamic_components; }
     bool  is_dynamic_component(navobj_guid const  nav_guid) const { return m_dynamic_components.count(nav_guid) != 0UL; }
 
@@ -225,6 +261,9 @@ private:
     dynamic_array<navcomponent_ptr>  m_components;
     dynamic_array<navlink>  m_navlinks;
 
+    angeo::proximity_map<navobj_guid>  m_components_proximity;
+    bool  m_does_components_proximity_need_rebalancing; // Set when components are added or removed (not moved).
+
     std::unordered_map<com::object_guid, std::unordered_set<navobj_guid> >  m_colliders_to_components;
     std::unordered_set<navobj_guid>  m_dynamic_components;
 
@@ -250,6 +289,9 @@ struct  naveditor
                                                 // must be >= 0.
         float_32_bit  m_waypoint_separation;    // An ideal distance between adjacent waypoints. Must be > 0.
         float_32_bit  m_max_incline_angle;      // Defines max angle of an inclined plane the agent can walk on. Must be in <0,PI/2>.
+        float_32_bit  m_max_navlink_length;     // Max distance of border waypoints of different components to be linked. Must be > 0.
+        float_32_bit  m_navlinks_rebuild_tolerance; // Navlinks of a moving component are rebuilt only when its placement
+                                                    // relative to some nearby component changes by more than this distance.
     };
 
     using  callback_navcomponent_updated = std::function<void(navobj_guid)>;
@@ -263,28 +305,97 @@ struct  naveditor
 
     void  set_callback_navcomponent_updated(callback_navcomponent_updated const  fn) { m_on_navcomponent_updated = fn; }
 
+    // Generated navigation data are baked to (and then loaded from) files in this directory; it is created on the first
+    // save. Baking is disabled by default (an empty path), so nothing is written unless a caller chooses a cache directory;
+    // it should not be a directory with the scene data.
+    void  set_bake_directory(std::filesystem::path const&  bake_dir) { m_bake_dir = bake_dir; }
+    std::filesystem::path const&  get_bake_directory() const { return m_bake_dir; }
+
+    // Large navgrids are generated on these workers; without them all is generated in the calling thread.
+    void  set_workers(std::shared_ptr<thread_pool> const  workers) { m_workers = workers; }
+
     void  clear();
 
 private:
+    // Waypoints and waylinks of one 2d navcomponent, not yet inserted into the navsystem. The coordinates x,y,z of
+    // each waypoint are in 'coords'. Pairs of elements of 'waylinks' and elements of 'border_waypoints' are indices
+    // of waypoints.
+    struct  navgrid2d
+    {
+        std::vector<float_32_bit>  coords;
+        std::vector<natural_32_bit>  waylinks;
+        std::vector<natural_32_bit>  border_waypoints;
+    };
+
+    // A read-only view of the data of a 'navgrid2d', either in the grid itself, or in place in a mapped bake file.
+    // The structure of the proximity map of waypoints (see 'proximity_map::export_structure') is only in the bake.
+    struct  navgrid2d_view
+    {
+        navgrid2d_view();
+        explicit navgrid2d_view(navgrid2d const&  grid);
+
+        float_32_bit const*  coords;
+        natural_32_bit const*  waylinks;
+        natural_32_bit const*  border_waypoints;
+        natural_32_bit const*  proximity_structure;
+        natural_32_bit  num_waypoints;
+        natural_32_bit  num_waylinks;
+        natural_32_bit  num_border_waypoints;
+        natural_32_bit  num_proximity_structure_words;
+    };
+
     navobj_guid  create_empty_component(com::object_guid const  collider_guid);
+    navobj_guid  create_component_from_navgrid2d(com::object_guid const  collider_guid, navgrid2d_view const&  grid);
 
     void  add_navcomponents_2d_from_box(
             com::object_guid const  collider_guid,
             std::vector<navobj_guid>* const  new_component_guids,
             std::unordered_set<navobj_guid>&  updated_components
             );
-    void  add_waypoints2d_and_waylinks_onto_xy_rectangle(navcomponent&  component, vector3 const&  half_sizes);
+    void  generate_navgrid2d_on_xy_rectangle(vector3 const&  half_sizes, matrix33 const&  rotation, navgrid2d&  grid) const;
+
+    // All inputs the generated grids depend on (a shape type, sizes, config values, selected sides), as 32-bit words.
+    // The key is stored in the bake file and compared word by word on load; its hash only names the file.
+    using  bake_key = std::vector<natural_32_bit>;
+
+    std::filesystem::path  bake_file_path(bake_key const&  key) const;
+    // Returns the mapped bake file the views point to, or nullptr when there is no valid bake for the key.
+    mapped_file_ptr  load_baked_navgrids2d(bake_key const&  key, std::vector<navgrid2d_view>&  grids) const;
+    void  save_baked_navgrids2d(bake_key const&  key, std::vector<navgrid2d> const&  grids,
+                                std::vector<navobj_guid> const&  component_guids) const;
 
     navobj_guid  add_waylink(navcomponent&  component, navobj_guid const  wp1_guid, navobj_guid const  wp2_guid);
 
+    void  update_world_bbox(navcomponent&  component);
+    void  rebalance_components_proximity_if_needed();
+    void  collect_nearby_components(navobj_guid const  component_guid, std::vector<navobj_guid>&  output_components) const;
+    navcomponent::neighbour_placement  compute_neighbour_placement(navcomponent const&  component, navobj_guid const  neighbour_guid) const;
+    bool  is_neighbour_placement_outdated(navcomponent const&  component, navcomponent::neighbour_placement const&  placement) const;
+
     void  add_navlinks(navobj_guid const  component_guid, std::unordered_set<navobj_guid>* const  updated_components = nullptr);
     void  del_navlinks(navobj_guid const  component_guid, std::unordered_set<navobj_guid>* const  updated_components = nullptr);
+    void  update_navlinks(navobj_guid const  component_guid, std::unordered_set<navobj_guid>* const  updated_components);
+
+    // Navlinks are built and erased per a pair of nearby components, so a move of a component does not touch
+    // links between other pairs. The links go from border waypoints of the component with the smaller guid.
+    void  add_navlinks_between(navobj_guid const  component_guid, navobj_guid const  other_guid,
+                               std::unordered_set<navobj_guid>* const  updated_components);
+    void  del_navlinks_between(navobj_guid const  component_guid, navobj_guid const  other_guid,
+                               std::unordered_set<navobj_guid>* const  updated_components);
 
     navsystem_ptr  m_navsystem;
     config2d  m_config2d;
 
     callback_navcomponent_updated  m_on_navcomponent_updated;
 
+    std::vector<navobj_guid>  m_nearby_components_buffer;
+    std::vector<navobj_guid>  m_border_waypoints_buffer;
+    std::vector<navobj_guid>  m_candidate_waypoints_buffer;
+
+    std::filesystem::path  m_bake_dir;
+
+    std::shared_ptr<thread_pool>  m_workers;
+
     simulation_context_const_ptr  m_context;
 };
 
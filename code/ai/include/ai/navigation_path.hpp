@@ -0,0 +1,138 @@
+#ifndef AI_NAVIGATION_PATH_HPP_INCLUDED
+#   define AI_NAVIGATION_PATH_HPP_INCLUDED
+
+#   include <ai/navigation.hpp>
+#   include <angeo/tensor_math.hpp>
+#   include <utility/basic_numeric_types.hpp>
+#   include <utility/thread_pool.hpp>
+#   include <vector>
+#   include <utility>
+#   include <memory>
+
+namespace ai {
+
+
+struct  navpath_waypoint
+{
+    navobj_guid  component_guid;
+    navobj_guid  waypoint_guid;
+    vector3  position;  // In the world space.
+};
+
+
+struct  navpath
+{
+    bool  empty() const { return waypoints.empty(); }
+    void  clear() { waypoints.clear(); length = 0.0f; }
+
+    std::vector<navpath_waypoint>  waypoints;   // From the start to the goal.
+    float_32_bit  length;                       // Sum of lengths of all traversed waylinks and navlinks.
+};
+
+
+struct  navpath_query
+{
+    vector3  start;     // In the world space.
+    vector3  goal;      // In the world space.
+    float_32_bit  max_snap_distance;
+};
+
+
+/**
+ * Searches shortest paths in the waypoint graph of a navsystem. The start and the goal
+ * are first snapped to the nearest waypoints (using proximity maps of navcomponents).
+ * Then a corridor of navcomponents is computed by A* over the graph of navcomponents
+ * connected by navlinks, and finally A* over waypoints restricted to the corridor is
+ * performed. When the restricted search fails, A* over all waypoints is used instead.
+ *
+ * All search data (open heap, per-node costs and parents, visit stamps) are kept in the
+ * finder and reused by subsequent queries; they only grow when the navsystem grows.
+ *
+ * NOTE: A finder is NOT thread-safe. However, any number of finders can query the same
+ *       navsystem concurrently (as long as nobody modifies the navsystem in the meantime).
+ *       So, create one finder per thread (or per agent).
+ */
+struct  navpath_finder
+{
+    explicit navpath_finder(navsystem_const_ptr const  navsystem_);
+
+    bool  find_path(
+            vector3 const&  start,
+            vector3 const&  goal,
+            navpath&  output_path,
+            float_32_bit const  max_snap_distance = 5.0f
+            );
+
+    void  find_paths(std::vector<navpath_query> const&  queries, std::vector<navpath>&  output_paths);
+
+    bool  find_nearest_waypoint(
+            vector3 const&  point,
+            float_32_bit const  max_distance,
+            navobj_guid&  output_component_guid,
+            navobj_guid&  output_waypoint_guid
+            ) const;
+
+    navsystem_const_ptr  get_navsystem() const { return m_navsystem; }
+
+private:
+    using  heap_item = std::pair<float_32_bit, natural_32_bit>; // (estimated total cost, node)
+
+    natural_32_bit  next_stamp();
+    void  update_node_offsets();
+    natural_32_bit  node_of(natural_32_bit const  component_index, natural_32_bit const  waypoint_index) const;
+    natural_32_bit  component_index_of_node(natural_32_bit const  node) const;
+    vector3  world_position_of_node(natural_32_bit const  node) const;
+
+    bool  find_components_corridor(
+            natural_32_bit const  start_component,
+            natural_32_bit const  goal_component,
+            vector3 const&  start,
+            vector3 const&  goal
+            );
+    bool  find_waypoints_path(
+            natural_32_bit const  start_node,
+            natural_32_bit const  goal_node,
+            bool const  restrict_to_corridor,
+            navpath&  output_path
+            );
+
+    navsystem_const_ptr  m_navsystem;
+
+    // Flat indexing of all waypoints of all components: node = m_node_offsets[component index] + waypoint index.
+    std::vector<natural_32_bit>  m_node_offsets;
+
+    // Search data over waypoint nodes; valid only for nodes whose visit stamp equals the current stamp.
+    std::vector<float_32_bit>  m_node_costs;
+    std::vector<natural_32_bit>  m_node_parents;
+    std::vector<natural_32_bit>  m_node_visit_stamps;
+    std::vector<natural_32_bit>  m_node_closed_stamps;
+    std::vector<heap_item>  m_open;
+
+    // Search data over components.
+    std::vector<float_32_bit>  m_component_costs;
+    std::vector<natural_32_bit>  m_component_parents;
+    std::vector<vector3>  m_component_entry_points;
+    std::vector<natural_32_bit>  m_component_visit_stamps;
+    std::vector<natural_32_bit>  m_component_closed_stamps;
+    std::vector<natural_32_bit>  m_corridor_stamps;
+    natural_32_bit  m_corridor_stamp;
+
+    natural_32_bit  m_stamp;
+};
+
+
+using  navpath_finder_ptr = std::shared_ptr<navpath_finder>;
+
+
+// Distributes the queries amongst threads of the pool; a thread of index 't' uses the finder 'finders.at(t)'.
+void  find_navpaths_in_parallel(
+        thread_pool&  workers,
+        std::vector<navpath_finder_ptr> const&  finders,
+        std::vector<navpath_query> const&  queries,
+        std::vector<navpath>&  output_paths
+        );
+
+
+}
+
+#endif
@@ -4,15 +4,17 @@
 #   include <ai/skeletal_motion_templates.hpp>
 #   include <ai/scene_binding.hpp>
 #   include <angeo/collision_class.hpp>
+#   include <angeo/coordinate_system.hpp>
 #   include <angeo/tensor_math.hpp>
 #   include <gfx/camera.hpp>
 #   include <com/object_guid.hpp>
 #   include <utility/random.hpp>
+#   include <utility/ring_buffer.hpp>
 #   include <boost/property_tree/ptree.hpp>
 #   include <unordered_map>
 #   include <functional>
 #   include <unordered_set>
-#   include <map>
+#   include <vector>
 
 namespace ai {
 
@@ -60,6 +62,12 @@ struct  sight_controller
                                                     // It is typically desired the function being monotonic (increasing).
         std::function<bool(com::object_guid, angeo::COLLISION_CLASS)>  collider_filter;
         std::function<float_32_bit(float_32_bit)>  depth_image_func;    // Mapping of ray cast params to depth values.
+        bool  do_grid_ray_casts;                    // When true, rays are cast through the centres of cells of the depth image (in
+                                                    // a single batched query per round) and the depth image is built from them only.
+        natural_32_bit  max_grid_ray_casts_per_round;   // Zero means no limit, i.e. all cells needing a ray can be cast in one round.
+        float_32_bit  max_grid_reprojection_distance;   // When the camera moves (rotates) less than this distance (angle) since the
+        float_32_bit  max_grid_reprojection_angle;      // last round, the cells are reprojected and rays are cast only for cells which
+                                                        // are uncovered (disoccluded) or obsolete (see 'max_ray_cast_info_life_time_in_seconds').
 
         ray_cast_config(boost::property_tree::ptree const&  config, simulation_context_const_ptr const  context);
         ray_cast_config(
@@ -77,7 +85,11 @@ struct  sight_controller
                                    cc != angeo::COLLISION_CLASS::AGENT_MOTION_OBJECT;
                             },
                 std::function<float_32_bit(float_32_bit)>  depth_image_func_ =
-                    [](float_32_bit const  x) -> float_32_bit { return x; } // Mapping of ray cast params to depth values.
+                    [](float_32_bit const  x) -> float_32_bit { return x; }, // Mapping of ray cast params to depth values.
+                bool const  do_grid_ray_casts_ = false,
+                natural_32_bit const  max_grid_ray_casts_per_round_ = 0U,
+                float_32_bit const  max_grid_reprojection_distance_ = 0.25f,
+                float_32_bit const  max_grid_reprojection_angle_ = PI() / 18.0f
                 );
     };
 
@@ -105,9 +117,17 @@ struct  sight_controller
                 );
     };
 
-    using  ray_casts_in_time = std::multimap<float_64_bit, ray_cast_info>;
+    // Ray casts ordered by the time they were performed (the oldest at the front).
+    using  ray_casts_in_time = ring_buffer<std::pair<float_64_bit, ray_cast_info> >;
     using  ray_casts_image = std::vector<float_32_bit>;
 
+    struct  depth_grid_cell
+    {
+        ray_cast_info  info;    // The 'collider_guid' is invalid when the ray has not hit anything.
+        float_64_bit  time;     // When the ray was cast (reprojection keeps the time); negative for cells with no data.
+    };
+    using  depth_grid = std::vector<depth_grid_cell>;
+
     sight_controller(
             camera_config const&  camera_config_,
             ray_cast_config const& ray_cast_config_,
@@ -115,6 +135,8 @@ struct  sight_controller
             scene_binding_ptr const  binding
             );
 
+    void  set_random_seed(natural_32_bit const  seed) { reset(m_generator, seed); }
+
     void  next_round(float_32_bit const  time_step_in_seconds);
 
     camera_config const&  get_camera_config() const { return m_camera_config; }
@@ -125,6 +147,7 @@ struct  sight_controller
     ray_casts_in_time const&  get_directed_ray_casts_in_time() const { return m_directed_ray_casts_in_time; }
     ray_casts_in_time const&  get_random_ray_casts_in_time() const { return m_random_ray_casts_in_time; }
     ray_casts_image const&  get_depth_image() const { return m_depth_image; }
+    depth_grid const&  get_depth_grid() const { return m_depth_grid; }
 
     skeletal_motion_templates  get_motion_templates() const { return m_motion_templates; }
     scene_binding_ptr  get_binding() const { return m_binding; }
@@ -136,14 +159,30 @@ private:
     void  perform_directed_ray_casts(matrix44 const&  from_camera_matrix);
     void  perform_random_ray_casts(float_32_bit const  time_step_in_seconds, matrix44 const&  from_camera_matrix);
     bool  perform_ray_cast(vector2 const&  camera_coords_01, matrix44 const&  from_camera_matrix, ray_cast_info&  result) const;
+    void  setup_ray_cast(vector2 const&  camera_coords_01, matrix44 const&  from_camera_matrix, ray_cast_info&  result) const;
+    void  setup_ray_cast_hit(com::object_guid const  collider_guid, float_32_bit const  parameter_to_coid, ray_cast_info&  result) const;
     void  update_depth_image(ray_casts_in_time const&  ray_casts);
 
+    void  perform_grid_ray_casts(matrix44 const&  from_camera_matrix);
+    void  reproject_depth_grid(matrix44 const&  from_camera_matrix);
+    void  update_depth_image_from_depth_grid();
+    vector2  camera_coords_of_cell(natural_32_bit const  cell_index) const;
+
     camera_config  m_camera_config;
     camera_perspective_ptr  m_camera;
     ray_cast_config  m_ray_cast_config;
     ray_casts_in_time  m_directed_ray_casts_in_time;
     ray_casts_in_time  m_random_ray_casts_in_time;
     ray_casts_image  m_depth_image;
+    depth_grid  m_depth_grid;
+    depth_grid  m_depth_grid_reprojected;               // Only a temporary for 'reproject_depth_grid'.
+    std::vector<natural_32_bit>  m_depth_grid_order;    // Cell indices ordered by 4x4 tiles (for the batched ray casting).
+    angeo::coordinate_system  m_depth_grid_camera;      // The camera the grid was computed for.
+    std::vector<natural_32_bit>  m_grid_cells_to_cast;  // The remaining members are only temporaries of 'perform_grid_ray_casts'.
+    std::vector<vector3>  m_grid_ray_origins;
+    std::vector<vector3>  m_grid_ray_ends;
+    std::vector<com::object_guid>  m_grid_ray_colliders;
+    std::vector<float_32_bit>  m_grid_ray_parameters;
     float_64_bit  m_current_time;
     random_generator_for_natural_32_bit  m_generator;
     float_32_bit  m_random_ray_casts_time_buffer;
@@ -11,6 +11,9 @@
 #   include <osi/keyboard_props.hpp>
 #   include <osi/mouse_props.hpp>
 #   include <utility/dynamic_array.hpp>
+#   include <utility/thread_pool.hpp>
+#   include <vector>
+#   include <memory>
 
 namespace ai {
 
@@ -34,14 +37,28 @@ struct simulator
 
     void  clear(bool const  also_navsystem = true);
 
+    // The number of threads (including the calling one) updating agents in 'next_round'. When it is greater
+    // than 1, the context must be frozen (see com::simulation_context::freeze) during 'next_round'.
+    // Agents are always updated and their requests committed to the context in the order of their ids, and
+    // each agent has its own random generators, so results do not depend on the number of threads.
+    natural_32_bit  num_worker_threads() const { return m_workers->num_threads(); }
+    void  set_num_worker_threads(natural_32_bit const  count);
+
     void  next_round(float_32_bit const  time_step_in_seconds, cortex::mock_input_props const* const  mock_input_ptr);
 
 private:
     void  ensure_navsystem_exists(simulation_context_const_ptr const  context_);
+    void  next_round_parallel(float_32_bit const  time_step_in_seconds, cortex::mock_input_props const* const  mock_input_ptr);
+
+    struct  parallel_round_data;
 
     dynamic_array<agent_ptr, agent_id>  m_agents;
     navsystem_ptr  m_navsystem;
     naveditor_ptr  m_naveditor;
+
+    std::shared_ptr<thread_pool>  m_workers;    // Shared with the naveditor; recreated only when the count changes.
+    std::vector<agent_id>  m_agent_ids_in_order;
+    std::shared_ptr<parallel_round_data>  m_parallel_round_data;
 };
 
 
@@ -5,6 +5,7 @@
 #   include <ai/scene_binding.hpp>
 #   include <angeo/tensor_math.hpp>
 #   include <angeo/coordinate_system.hpp>
+#   include <angeo/skeleton_kinematics.hpp>
 #   include <vector>
 
 namespace ai {
@@ -43,7 +44,9 @@ struct  skeleton_interpolator_look_at
             skeletal_motion_templates const  motion_templates
             );
 private:
-    angeo::joint_rotation_states_of_bones  m_joint_rotations;
+    angeo::skeleton_kinematics_flat  m_kinematics;          // Built at the first call of 'interpolate' with new templates.
+    skeletal_motion_templates  m_kinematics_templates;      // The templates 'm_kinematics' was built for.
+    angeo::joint_rotation_state_vector  m_joint_rotations;  // Indexed by dofs of 'm_kinematics'.
     vector3  m_look_at_target_in_local_space;
 };
 
@@ -57,6 +60,9 @@ struct  skeleton_interpolator_aim_at
             std::vector<angeo::coordinate_system>&  frames_to_update,
             skeletal_motion_templates const  motion_templates
             );
+private:
+    angeo::skeleton_kinematics_flat  m_kinematics;  // One chain per aim-at info; built at the first call of 'interpolate' with new templates.
+    skeletal_motion_templates  m_kinematics_templates;  // The templates 'm_kinematics' was built for.
 };
 
 
@@ -94,9 +94,45 @@ action_execution_context::action_execution_context(agent* const  myself_)
     , aim_at()
     , time_buffer(0.0f)
     , disabled_colliding_with_our_motion_object()
+    , m_frame_paths()
+    , m_frame_guids_cache()
+    , m_frame_guids_cache_generation(0UL)
 {}
 
 
+natural_32_bit  action_execution_context::register_frame_path(std::string const&  relative_path)
+{
+    auto const  it = std::find(m_frame_paths.begin(), m_frame_paths.end(), relative_path);
+    if (it != m_frame_paths.end())
+        return (natural_32_bit)(it - m_frame_paths.begin());
+    m_frame_paths.push_back(relative_path);
+    m_frame_guids_cache.clear();
+    return (natural_32_bit)m_frame_paths.size() - 1U;
+}
+
+
+com::object_guid  action_execution_context::frame_guid_under_folder(
+        com::object_guid const  base_folder_guid,
+        natural_32_bit const  frame_path_id
+        ) const
+{
+    ASSUMPTION(frame_path_id < (natural_32_bit)m_frame_paths.size());
+    if (m_frame_guids_cache_generation != ctx().path_caches_generation())
+    {
+        m_frame_guids_cache.clear();
+        m_frame_guids_cache_generation = ctx().path_caches_generation();
+    }
+    std::vector<com::object_guid>&  frame_guids = m_frame_guids_cache[base_folder_guid];
+    if (frame_guids.empty())
+        frame_guids.resize(m_frame_paths.size(), com::invalid_object_guid());
+    // A resolved frame is always valid, so the invalid guid marks a path not resolved yet.
+    com::object_guid&  frame_guid = frame_guids[frame_path_id];
+    if (frame_guid == com::invalid_object_guid())
+        frame_guid = get_frame_guid_under_agent_folder(base_folder_guid, m_frame_paths[frame_path_id], ctx());
+    return frame_guid;
+}
+
+
 motion_desire_props const&  action_execution_context::desire() const
 {
     return myself->get_cortex().get_motion_desire_props();
@@ -164,6 +200,7 @@ agent_action::agent_action(
     : NAME(name_)
     , DESIRE() // loaded below
     , EFFECTS() // loaded below
+    , EFFECT_TERMS() // loaded below
     , MOTION_TEMPLATE_NAME(get_value<std::string>("MOTION_TEMPLATE_NAME", ptree_))
     , ONLY_INTERPOLATE_TO_MOTION_TEMPLATE(get_value<bool>("ONLY_INTERPOLATE_TO_MOTION_TEMPLATE", false, ptree_))
     , USE_MOTION_TEMPLATE_FOR_LOCATION_INTERPOLATION(get_value<bool>("USE_MOTION_TEMPLATE_FOR_LOCATION_INTERPOLATION", false, ptree_))
@@ -183,6 +220,7 @@ agent_action::agent_action(
     , m_end_interpolation_time(0.0f)
     , m_current_time(0.0f)
     , m_animation{0.0f, 0U, 0U}
+    , m_id(0U) // assigned by action_controller
 {
     ASSUMPTION(motion_templates().motions_map().count(MOTION_TEMPLATE_NAME) != 0UL);
     ASSUMPTION(!(IS_CYCLIC && USE_MOTION_TEMPLATE_FOR_LOCATION_INTERPOLATION));
@@ -232,11 +270,28 @@ void  agent_action::load_effects(
         boost::property_tree::ptree const&  defaults
         )
 {
-    for (auto const& var_and_ignored : state_variables())
-        for (auto const&  var_and_curve : get_ptree_or_empty(var_and_ignored.first, ptree, &defaults))
+    for (natural_32_bit  var_idx = 0U; var_idx != state_variables().size(); ++var_idx)
+    {
+        std::string const&  var_name = state_variables().name_of(var_idx);
+        for (auto const&  var_and_curve : get_ptree_or_empty(var_name, ptree, &defaults))
         {
             ASSUMPTION(state_variables().count(var_and_curve.first) != 0UL || system_variables().count(var_and_curve.first) != 0UL);
-            angeo::load(EFFECTS[var_and_ignored.first][var_and_curve.first], var_and_curve.second);
+            angeo::load(EFFECTS[var_name][var_and_curve.first], var_and_curve.second);
+        }
+    }
+
+    // We resolve names now, so that 'update_state_variables' does no string lookups.
+    for (auto const&  var_and_derivatives : EFFECTS)
+        for (auto const&  var_and_curve : var_and_derivatives.second)
+        {
+            natural_32_bit const  system_var_idx = system_variables().index_of(var_and_curve.first);
+            bool const  is_system_var = system_var_idx != agent_system_variables::NUM_VARIABLES;
+            EFFECT_TERMS.push_back({
+                    state_variables().index_of(var_and_derivatives.first),
+                    is_system_var ? system_var_idx : state_variables().index_of(var_and_curve.first),
+                    is_system_var,
+                    var_and_curve.second
+                    });
         }
 }
 
@@ -309,6 +364,7 @@ void  agent_action::load_transitions(
                     guard.get<bool>("sensor_owner_can_be_myself") : false;
             boost::property_tree::ptree const&  location = get_ptree("location_constraint", guard);
             tc.perception_guard->location_constraint.frame_folder = get_value("frame_folder", "motion_object/", location);
+            tc.perception_guard->location_constraint.frame_folder_id = 0U; // assigned by action_controller
             tc.perception_guard->location_constraint.shape_type = angeo::as_collision_shape_type(get_value("shape_type", "BOX", location));
             ASSUMPTION(
                 tc.perception_guard->location_constraint.shape_type == angeo::COLLISION_SHAPE_TYPE::BOX ||
@@ -332,6 +388,7 @@ void  agent_action::load_transitions(
             tc.motion_object_location->frame_folder = get_value<std::string>("frame_folder", location);
             ASSUMPTION(!tc.motion_object_location->frame_folder.empty() &&
                        tc.motion_object_location->frame_folder.back() == '/');
+            tc.motion_object_location->frame_folder_id = 0U; // assigned by action_controller
             tc.motion_object_location->frame.set_origin(read_vector3(get_ptree("origin", location)));
             tc.motion_object_location->frame.set_orientation(read_quaternion(get_ptree("orientation", location)));
             for (auto const&  empty_and_rel_path : get_ptree_or_empty("disable_colliding_with", location))
@@ -356,24 +413,6 @@ void  agent_action::load_transitions(
 }
 
 
-float_32_bit  agent_action::compute_desire_penalty(motion_desire_props const&  desire_props) const
-{
-    std::vector<float_32_bit>  props_vec, ideal_vec, weights_vec;
-    as_vector(desire_props, props_vec);
-    as_vector(DESIRE.ideal, ideal_vec);
-    as_vector(DESIRE.weights, weights_vec);
-
-    float_32_bit  penalty = 0.0f;
-    for (natural_32_bit  i = 0U, n = (natural_32_bit)props_vec.size(); i < n; ++i)
-    {
-        float_32_bit const  delta = props_vec.at(i) - ideal_vec.at(i);
-        penalty += delta * delta * weights_vec.at(i);
-    }
-
-    return penalty;
-}
-
-
 bool  agent_action::is_complete() const
 {
     return  m_current_time >= m_end_time;
@@ -412,27 +451,16 @@ void  agent_action::update_state_variables(
 {
     TMPROF_BLOCK();
 
-    for (auto const&  var_and_derivatives : EFFECTS)
+    for (natural_32_bit  i = 0U, n = (natural_32_bit)EFFECT_TERMS.size(); i < n; )
     {
+        natural_32_bit const  target = EFFECT_TERMS[i].target;
         float_32_bit  derivative = 0.0f;
-        for (auto const&  var_and_curve : var_and_derivatives.second)
+        for ( ; i < n && EFFECT_TERMS[i].target == target; ++i)
         {
-            float_32_bit  var_value;
-            {
-                auto const  system_var_it = sys_variables.find(var_and_curve.first);
-                if (system_var_it != sys_variables.end())
-                    var_value = system_var_it->second;
-                else
-                {
-                    auto const  state_var_it = variables.find(var_and_curve.first);
-                    ASSUMPTION(state_var_it != variables.end());
-                    var_value = state_var_it->second.get_value();
-                }
-            }
-            derivative += var_and_curve.second(var_value);
+            effect_term const&  term = EFFECT_TERMS[i];
+            derivative += term.curve(term.is_source_system_variable ? sys_variables.at(term.source) : variables.at(term.source).get_value());
         }
-
-        variables.at(var_and_derivatives.first).add_to_value(derivative * time_step_in_seconds);
+        variables.at(target).add_to_value(derivative * time_step_in_seconds);
     }
 }
 
@@ -442,7 +470,7 @@ void  agent_action::update_time(float_32_bit const  time_step_in_seconds)
     if (m_current_time >= m_end_time)
         return;
 
-    m_current_time += (is_ghost_complete() ? system_variables().at("sys_animation_speed") : 1.0f) * time_step_in_seconds;
+    m_current_time += (is_ghost_complete() ? system_variables().at(agent_system_variables::SYS_ANIMATION_SPEED) : 1.0f) * time_step_in_seconds;
     m_current_time += m_context->time_buffer;
     m_context->time_buffer = 0.0f;
 
@@ -664,10 +692,9 @@ bool  agent_action::collect_other_entiry_folder_guid(agent_action const* const
                         ray_it->second.ray_origin_in_world_space +
                         ray_it->second.parameter_to_coid * ray_it->second.ray_direction_in_world_space
                         ;
-                com::object_guid const  frame_guid = get_frame_guid_under_agent_folder(
+                com::object_guid const  frame_guid = m_context->frame_guid_under_folder(
                         binding().folder_guid_of_agent,
-                        percept.location_constraint.frame_folder,
-                        ctx()
+                        percept.location_constraint.frame_folder_id
                         );
                 vector3 const  contact_point_in_motion_object_space =
                         angeo::point3_to_coordinate_system(
@@ -745,10 +772,9 @@ void  agent_action::collect_motion_object_relocation_frame(agent_action const* c
             from_action_ptr->TRANSITIONS.at(NAME).motion_object_location;
     if (pos_cfg != nullptr)
     {
-        com::object_guid const  frame_guid = get_frame_guid_under_agent_folder(
+        com::object_guid const  frame_guid = m_context->frame_guid_under_folder(
                 pos_cfg->is_self_frame ? binding().folder_guid_of_agent : info.other_entiry_folder_guid,
-                pos_cfg->frame_folder,
-                ctx()
+                pos_cfg->frame_folder_id
                 );
         angeo::from_coordinate_system(
                 ctx().frame_coord_system_in_world_space(frame_guid),
@@ -1189,7 +1215,7 @@ void  action_guesture::update_system_variables(
 {
     agent_action::update_system_variables(variables, state, desire_props, time_step_in_seconds);
 
-    system_variables().at("sys_animation_speed") = 1.0f;
+    system_variables().at(agent_system_variables::SYS_ANIMATION_SPEED) = 1.0f;
 }
 
 
@@ -1330,12 +1356,12 @@ void  action_roller::update_system_variables(
         vector3 const  roller_angular_velocity =
                 (m_desire_move_forward_to_linear_speed(desire_props.move.forward) / ROLLER_CONFIG.roller_radius)
                     * state.motion_object_frame.basis_vector_x();
-        system_variables().at("sys_animation_speed") = m_angular_speed_to_animation_speed(length(roller_angular_velocity));
+        system_variables().at(agent_system_variables::SYS_ANIMATION_SPEED) = m_angular_speed_to_animation_speed(length(roller_angular_velocity));
         } break;
     case ANIMATION_SPEED_SUBJECT::MOTION_OBJECT: {
         vector3 const  motion_object_angular_velocity =
                 m_desire_move_turn_ccw_to_angular_speed(desire_props.move.turn_ccw) * state.motion_object_frame.basis_vector_z();
-        system_variables().at("sys_animation_speed") = m_angular_speed_to_animation_speed(length(motion_object_angular_velocity));
+        system_variables().at(agent_system_variables::SYS_ANIMATION_SPEED) = m_angular_speed_to_animation_speed(length(motion_object_angular_velocity));
         } break;
     default: { UNREACHABLE(); } break;
     }
@@ -1569,6 +1595,13 @@ action_controller::action_controller(agent_config const  config, agent*  const
     : m_context(std::make_shared<action_execution_context>(myself))
     , m_current_action(nullptr) // loaded below
     , m_available_actions() // loaded below
+    , m_actions() // compiled below
+    , m_transitions_begin() // compiled below
+    , m_transition_targets() // compiled below
+    , m_desire_vector_size(0U) // compiled below
+    , m_desire_ideals() // compiled below
+    , m_desire_weights() // compiled below
+    , m_desire_buffer()
 {
     for (auto const&  name_and_ptree : config.actions())
     {
@@ -1605,6 +1638,8 @@ action_controller::action_controller(agent_config const  config, agent*  const
         }()
     );
 
+    compile_action_graph();
+
     m_current_action = m_available_actions.at(config.initial_action());
  }
 
@@ -1638,22 +1673,88 @@ agent_action_const_ptr  action_controller::choose_best_action(
         motion_desire_props const&  desire_props
         ) const
 {
-    agent_action_const_ptr  best_action;
+    TMPROF_BLOCK();
+
+    natural_32_bit const  current_id = current_action_ptr->get_id();
+    ASSUMPTION(current_id < (natural_32_bit)m_actions.size() && m_actions.at(current_id) == current_action_ptr);
+
+    m_desire_buffer.clear();
+    as_vector(desire_props, m_desire_buffer);
+    INVARIANT(m_desire_buffer.size() == m_desire_vector_size);
+
+    natural_32_bit  best_id = current_id;
+    float_32_bit  best_penalty = compute_desire_penalty(current_id, m_desire_buffer.data());
+    for (natural_32_bit  i = m_transitions_begin[current_id], n = m_transitions_begin[current_id + 1U]; i < n; ++i)
     {
-        best_action = current_action_ptr;
-        float_32_bit  best_penalty = current_action_ptr->compute_desire_penalty(desire_props);
-        for (auto const&  name_and_props : current_action_ptr->get_transitions())
+        natural_32_bit const  action_id = m_transition_targets[i];
+        float_32_bit const  penalty = compute_desire_penalty(action_id, m_desire_buffer.data());
+        if (penalty < best_penalty)
         {
-            agent_action_const_ptr const  action_ptr = m_available_actions.at(name_and_props.first);
-            float_32_bit const  penalty = action_ptr->compute_desire_penalty(desire_props);
-            if (best_action == nullptr || penalty < best_penalty)
-            {
-                best_action = action_ptr;
-                best_penalty = penalty;
-            }
+            best_id = action_id;
+            best_penalty = penalty;
         }
     }
-    return best_action;
+    return m_actions.at(best_id);
+}
+
+
+float_32_bit  action_controller::compute_desire_penalty(natural_32_bit const  action_id, float_32_bit const* const  desire_vector) const
+{
+    float_32_bit const* const  ideal = m_desire_ideals.data() + action_id * m_desire_vector_size;
+    float_32_bit const* const  weights = m_desire_weights.data() + action_id * m_desire_vector_size;
+    float_32_bit  penalty = 0.0f;
+    for (natural_32_bit  i = 0U; i < m_desire_vector_size; ++i)
+    {
+        float_32_bit const  delta = desire_vector[i] - ideal[i];
+        penalty += delta * delta * weights[i];
+    }
+    return penalty;
+}
+
+
+void  action_controller::compile_action_graph()
+{
+    TMPROF_BLOCK();
+
+    std::vector<std::string>  names;
+    for (auto const&  name_and_action : m_available_actions)
+        names.push_back(name_and_action.first);
+    std::sort(names.begin(), names.end());
+
+    std::unordered_map<std::string, natural_32_bit>  ids;
+    for (std::string const&  name : names)
+    {
+        agent_action_ptr const  action = m_available_actions.at(name);
+        action->m_id = (natural_32_bit)m_actions.size();
+        ids.insert({ name, action->m_id });
+        m_actions.push_back(action);
+    }
+
+    m_transitions_begin.push_back(0U);
+    for (agent_action_ptr const&  action : m_actions)
+    {
+        std::size_t const  begin = m_transition_targets.size();
+        for (auto&  name_and_props : action->TRANSITIONS)
+        {
+            m_transition_targets.push_back(ids.at(name_and_props.first));
+
+            agent_action::transition_config&  config = name_and_props.second;
+            if (config.perception_guard != nullptr)
+                config.perception_guard->location_constraint.frame_folder_id =
+                        m_context->register_frame_path(config.perception_guard->location_constraint.frame_folder);
+            if (config.motion_object_location != nullptr)
+                config.motion_object_location->frame_folder_id =
+                        m_context->register_frame_path(config.motion_object_location->frame_folder);
+        }
+        std::sort(m_transition_targets.begin() + begin, m_transition_targets.end());
+        m_transitions_begin.push_back((natural_32_bit)m_transition_targets.size());
+
+        std::size_t const  row_begin = m_desire_ideals.size();
+        as_vector(action->get_desire_config().ideal, m_desire_ideals);
+        as_vector(action->get_desire_config().weights, m_desire_weights);
+        m_desire_vector_size = (natural_32_bit)(m_desire_ideals.size() - row_begin);
+    }
+    INVARIANT(m_desire_ideals.size() == m_desire_weights.size() && m_desire_ideals.size() == m_actions.size() * m_desire_vector_size);
 }
 
 
@@ -32,7 +32,7 @@ std::shared_ptr<cortex>  make_cortex(agent const*  myself_, boost::property_tree
     else if (type == "robot")
         return std::make_shared<cortex_robot>(myself_, allow_mock);
     else if (type == "netlab")
-        return std::make_shared<cortex_netlab>(myself_, allow_mock);
+        return std::make_shared<cortex_netlab>(myself_, allow_mock, config);
 
     UNREACHABLE();
 }
@@ -62,8 +62,8 @@ agent::agent(
     , m_navsystem(navsystem_)
 {
     ASSUMPTION([this]() ->bool {
-        for (auto const& var_and_ignored : get_system_variables())
-            if (get_state_variables().count(var_and_ignored.first) != 0UL)
+        for (natural_32_bit  i = 0U; i != get_system_variables().size(); ++i)
+            if (get_state_variables().count(agent_system_variables::name_of(i)) != 0UL)
                 return false;
         return true;
         }());
@@ -73,6 +73,13 @@ agent::agent(
 }
 
 
+void  agent::set_random_seed(natural_32_bit const  seed)
+{
+    m_sight_controller.set_random_seed(2U * seed + 1U);
+    m_cortex->set_random_seed(2U * seed + 2U);
+}
+
+
 void  agent::next_round(float_32_bit const  time_step_in_seconds, cortex::mock_input_props const* const  mock_input_ptr)
 {
     TMPROF_BLOCK();
@@ -4,38 +4,96 @@
 #include <utility/development.hpp>
 #include <utility/timeprof.hpp>
 #include <utility/log.hpp>
+#include <algorithm>
 
 namespace ai {
 
 
 agent_state_variable::agent_state_variable(
-        std::string const&  name_,
         float_32_bit const  value_,
         float_32_bit const  min_value_,
         float_32_bit const  max_value_,
         float_32_bit const  ideal_value_
         )
-    : name(name_)
-    , value(value_)
+    : value(value_)
     , constants{ min_value_, max_value_, ideal_value_ }
 {}
 
 
+natural_32_bit  agent_variable_names::insert(std::string const&  name)
+{
+    auto const  it = m_indices.find(name);
+    if (it != m_indices.end())
+        return it->second;
+    natural_32_bit const  idx = (natural_32_bit)m_names.size();
+    m_names.push_back(name);
+    m_indices.insert({ name, idx });
+    return idx;
+}
+
+
+natural_32_bit  agent_variable_names::index_of(std::string const&  name) const
+{
+    auto const  it = m_indices.find(name);
+    return it == m_indices.end() ? size() : it->second;
+}
+
+
+agent_state_variables::agent_state_variables()
+    : agent_state_variables(std::make_shared<agent_variable_names>(), {})
+{}
+
+
+agent_state_variables::agent_state_variables(
+        agent_variable_names_const_ptr const  names,
+        std::vector<agent_state_variable> const&  variables
+        )
+    : m_names(names)
+    , m_variables(variables)
+{
+    ASSUMPTION(m_names != nullptr && m_names->size() == (natural_32_bit)m_variables.size());
+}
+
+
+agent_state_variable const&  agent_state_variables::at(std::string const&  name) const
+{
+    natural_32_bit const  idx = index_of(name);
+    ASSUMPTION(idx != size());
+    return at(idx);
+}
+
+
+agent_state_variable&  agent_state_variables::at(std::string const&  name)
+{
+    natural_32_bit const  idx = index_of(name);
+    ASSUMPTION(idx != size());
+    return at(idx);
+}
+
+
 agent_state_variables  load_agent_state_variables(agent_config const  config)
 {
-    agent_state_variables  variables;
+    // Names are sorted, so that indices do not depend on the order of files in the config directory.
+    std::vector<std::string>  sorted_names;
     for (auto const&  name_and_ptree : config.state_variables())
-        variables.insert({
-                name_and_ptree.first,
-                {
-                    name_and_ptree.first,
-                    name_and_ptree.second->get<float_32_bit>("initial_value"),
-                    name_and_ptree.second->get<float_32_bit>("min_value"),
-                    name_and_ptree.second->get<float_32_bit>("max_value"),
-                    name_and_ptree.second->get<float_32_bit>("ideal_value")
-                    }
+        sorted_names.push_back(name_and_ptree.first);
+    std::sort(sorted_names.begin(), sorted_names.end());
+
+    std::shared_ptr<agent_variable_names> const  names = std::make_shared<agent_variable_names>();
+    std::vector<agent_state_variable>  variables;
+    for (std::string const&  name : sorted_names)
+    {
+        auto const&  ptree = config.state_variables().at(name);
+        natural_32_bit const  idx = names->insert(name);
+        INVARIANT(idx == (natural_32_bit)variables.size());
+        variables.push_back({
+                ptree->get<float_32_bit>("initial_value"),
+                ptree->get<float_32_bit>("min_value"),
+                ptree->get<float_32_bit>("max_value"),
+                ptree->get<float_32_bit>("ideal_value")
                 });
-    return variables;
+    }
+    return agent_state_variables(names, variables);
 }
 
 
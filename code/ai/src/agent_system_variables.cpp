@@ -6,22 +6,70 @@
 #include <utility/development.hpp>
 #include <utility/timeprof.hpp>
 #include <utility/log.hpp>
+#include <unordered_map>
 
 namespace ai {
 
 
-agent_system_variables  load_agent_system_variables()
+std::string const&  agent_system_variables::name_of(natural_32_bit const  idx)
 {
-    return agent_system_variables{
-            { "sys_zero", 0.0f },
-            { "sys_one", 1.0f },
-            { "sys_animation_speed", 1.0f },
-            { "sys_angle_look_forward", 0.0f },
-            { "sys_angle_look_attractor_xp", 0.0f },
-            { "sys_angle_look_attractor_xn", 0.0f },
-            { "sys_angle_look_attractor_yp", 0.0f },
-            { "sys_angle_look_attractor_yn", 0.0f },
+    static std::array<std::string, NUM_VARIABLES> const  names{
+            "sys_zero",
+            "sys_one",
+            "sys_animation_speed",
+            "sys_angle_look_forward",
+            "sys_angle_look_attractor_xp",
+            "sys_angle_look_attractor_xn",
+            "sys_angle_look_attractor_yp",
+            "sys_angle_look_attractor_yn",
             };
+    return names.at(idx);
+}
+
+
+natural_32_bit  agent_system_variables::index_of(std::string const&  name)
+{
+    static std::unordered_map<std::string, natural_32_bit> const  indices = []() {
+            std::unordered_map<std::string, natural_32_bit>  map;
+            for (natural_32_bit  i = 0U; i != NUM_VARIABLES; ++i)
+                map.insert({ name_of(i), i });
+            return map;
+            }();
+    auto const  it = indices.find(name);
+    return it == indices.end() ? (natural_32_bit)NUM_VARIABLES : it->second;
+}
+
+
+agent_system_variables::agent_system_variables()
+    : m_values()
+{
+    m_values.fill(0.0f);
+}
+
+
+float_32_bit  agent_system_variables::at(std::string const&  name) const
+{
+    natural_32_bit const  idx = index_of(name);
+    ASSUMPTION(idx != NUM_VARIABLES);
+    return at(idx);
+}
+
+
+float_32_bit&  agent_system_variables::at(std::string const&  name)
+{
+    natural_32_bit const  idx = index_of(name);
+    ASSUMPTION(idx != NUM_VARIABLES);
+    return at(idx);
+}
+
+
+agent_system_variables  load_agent_system_variables()
+{
+    agent_system_variables  variables;
+    variables.at(agent_system_variables::SYS_ZERO) = 0.0f;
+    variables.at(agent_system_variables::SYS_ONE) = 1.0f;
+    variables.at(agent_system_variables::SYS_ANIMATION_SPEED) = 1.0f;
+    return variables;
 }
 
 
@@ -29,16 +77,16 @@ void  update_system_variables(agent_system_variables&  variables, agent_system_s
 {
     TMPROF_BLOCK();
 
-    variables["sys_angle_look_forward"] = // in range <0.0f, PI()/2.0f>
+    variables.at(agent_system_variables::SYS_ANGLE_LOOK_FORWARD) = // in range <0.0f, PI()/2.0f>
             angle(state.motion_object_frame.basis_vector_y(), state.camera_frame.basis_vector_z());
 
-    variables["sys_angle_look_attractor_xp"] = // in range <0.0f, PI()>
+    variables.at(agent_system_variables::SYS_ANGLE_LOOK_ATTRACTOR_XP) = // in range <0.0f, PI()>
             angle(vector3{5.0f, 0.0f, 0.0f}, -state.camera_frame.basis_vector_z());
-    variables["sys_angle_look_attractor_xn"] = // in range <0.0f, PI()>
+    variables.at(agent_system_variables::SYS_ANGLE_LOOK_ATTRACTOR_XN) = // in range <0.0f, PI()>
             angle(vector3{-5.0f, 0.0f, 0.0f}, -state.camera_frame.basis_vector_z());
-    variables["sys_angle_look_attractor_yp"] = // in range <0.0f, PI()>
+    variables.at(agent_system_variables::SYS_ANGLE_LOOK_ATTRACTOR_YP) = // in range <0.0f, PI()>
             angle(vector3{0.0f, 5.0f, 0.0f}, -state.camera_frame.basis_vector_z());
-    variables["sys_angle_look_attractor_yn"] = // in range <0.0f, PI()>
+    variables.at(agent_system_variables::SYS_ANGLE_LOOK_ATTRACTOR_YN) = // in range <0.0f, PI()>
             angle(vector3{0.0f, -5.0f, 0.0f}, -state.camera_frame.basis_vector_z());
 }
 
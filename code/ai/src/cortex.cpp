@@ -17,18 +17,15 @@ cortex::cortex(agent const*  myself_)
 
 
 cortex::mock_input_props::mock_input_props(
-        osi::keyboard_props const* const  keyboard_,
-        osi::mouse_props const* const  mouse_,
-        osi::window_props const* const  window_,
-        gfx::viewport const* const  viewport_
+        osi::keyboard_props const&  keyboard,
+        osi::mouse_props const&  mouse,
+        gfx::viewport const&  viewport_
         )
-    : keyboard(keyboard_)
-    , mouse(mouse_)
-    , window(window_)
+    : keys_pressed(keyboard.keys_pressed())
+    , buttons_pressed(mouse.buttons_pressed())
+    , cursor(mouse.cursor_x(), mouse.cursor_y())
     , viewport(viewport_)
-{
-    ASSUMPTION(keyboard != nullptr && mouse != nullptr && window != nullptr && viewport != nullptr);
-}
+{}
 
 
 void  cortex::next_round(float_32_bit const  time_step_in_seconds, mock_input_props const* const  mock_input_ptr)
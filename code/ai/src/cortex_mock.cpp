@@ -12,7 +12,7 @@ void  cortex_mock::next_round(float_32_bit const  time_step_in_seconds, mock_inp
 {
     TMPROF_BLOCK();
 
-    if (!mock_input.viewport->is_point_inside({ mock_input.mouse->cursor_x(), mock_input.mouse->cursor_y() }))
+    if (!mock_input.viewport.is_point_inside(mock_input.cursor))
     {
         motion_desire_props_ref().move.clear();
         return;
@@ -24,21 +24,21 @@ void  cortex_mock::next_round(float_32_bit const  time_step_in_seconds, mock_inp
     auto const  clip = [](float_32_bit const  x) -> float_32_bit { return std::max(-1.0f, std::min(x, 1.0f)); };
 
     vector2 const  mouse_pos {
-        clip(2.0f * ((mock_input.mouse->cursor_x() - mock_input.viewport->left) / (float_32_bit)mock_input.viewport->width()) - 1.0f),
-        clip(2.0f * (1.0f - (mock_input.mouse->cursor_y() - mock_input.viewport->bottom) / (float_32_bit)mock_input.viewport->height()) - 1.0f)
+        clip(2.0f * ((mock_input.cursor(0) - mock_input.viewport.left) / (float_32_bit)mock_input.viewport.width()) - 1.0f),
+        clip(2.0f * (1.0f - (mock_input.cursor(1) - mock_input.viewport.bottom) / (float_32_bit)mock_input.viewport.height()) - 1.0f)
     };
 
     // states of buttons & keys -----------------------
 
-    bool const  lmouse = mock_input.mouse->buttons_pressed().count(osi::LEFT_MOUSE_BUTTON()) != 0UL;
-    bool const  mmouse = mock_input.mouse->buttons_pressed().count(osi::MIDDLE_MOUSE_BUTTON()) != 0UL;
-    bool const  rmouse = mock_input.mouse->buttons_pressed().count(osi::RIGHT_MOUSE_BUTTON()) != 0UL;
-    bool const  shift = mock_input.keyboard->keys_pressed().count(osi::KEY_LSHIFT()) != 0UL ||
-                        mock_input.keyboard->keys_pressed().count(osi::KEY_RSHIFT()) != 0UL;
-    bool const  ctrl = mock_input.keyboard->keys_pressed().count(osi::KEY_LCTRL()) != 0UL ||
-                       mock_input.keyboard->keys_pressed().count(osi::KEY_RCTRL()) != 0UL;
-    bool const  alt = mock_input.keyboard->keys_pressed().count(osi::KEY_LALT()) != 0UL ||
-                      mock_input.keyboard->keys_pressed().count(osi::KEY_RALT()) != 0UL;
+    bool const  lmouse = mock_input.buttons_pressed.count(osi::LEFT_MOUSE_BUTTON()) != 0UL;
+    bool const  mmouse = mock_input.buttons_pressed.count(osi::MIDDLE_MOUSE_BUTTON()) != 0UL;
+    bool const  rmouse = mock_input.buttons_pressed.count(osi::RIGHT_MOUSE_BUTTON()) != 0UL;
+    bool const  shift = mock_input.keys_pressed.count(osi::KEY_LSHIFT()) != 0UL ||
+                        mock_input.keys_pressed.count(osi::KEY_RSHIFT()) != 0UL;
+    bool const  ctrl = mock_input.keys_pressed.count(osi::KEY_LCTRL()) != 0UL ||
+                       mock_input.keys_pressed.count(osi::KEY_RCTRL()) != 0UL;
+    bool const  alt = mock_input.keys_pressed.count(osi::KEY_LALT()) != 0UL ||
+                      mock_input.keys_pressed.count(osi::KEY_RALT()) != 0UL;
 
     // speed --------------------
 
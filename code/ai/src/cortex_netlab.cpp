@@ -1,22 +1,182 @@
 #include <ai/cortex_netlab.hpp>
+#include <ai/agent.hpp>
+#include <ai/utils_ptree.hpp>
+#include <netlab/builder.hpp>
 #include <utility/assumptions.hpp>
 #include <utility/invariants.hpp>
 #include <utility/development.hpp>
 #include <utility/timeprof.hpp>
 #include <utility/log.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace ai { namespace detail { namespace {
+
+
+natural_32_bit const  NUM_DESIRES = 15U;   // The number of values of 'motion_desire_props' (see 'as_vector').
+
+
+netlab::network_layer  make_layer(float_32_bit const  spike_sign)
+{
+    return {
+            spike_sign, // SPIKE_SIGN
+            1.0f,   // CHARGE_SPIKE
+            0.0f,   // CHARGE_RECOVERY
+            0.9f,   // CHARGE_DECAY_COEF
+            0.5f,   // WEIGHT_NEUTRAL_CHARGE
+            0.01f,  // WEIGHT_DELTA_PER_SPIKE
+            0.5f,   // WEIGHT_CONNECTION
+            0.1f,   // WEIGHT_DISCONNECTION
+            1.0f,   // WEIGHT_MAXIMAL
+            0.4f,   // SPIKE_MAGNITUDE
+            0U,     // first_unit
+            0U,     // num_units
+            0U      // num_sockets_per_unit
+            };
+}
+
+
+}}}
 
 namespace ai {
 
 
+cortex_netlab::config::config(boost::property_tree::ptree const&  ptree)
+    : num_rounds_per_step(get_value<natural_32_bit>("num_rounds_per_step", 3U, ptree))
+    , num_hidden_layers(get_value<natural_32_bit>("num_hidden_layers", 1U, ptree))
+    , num_units_per_hidden_layer(get_value<natural_32_bit>("num_units_per_hidden_layer", 512U, ptree))
+    , num_units_per_desire_population(get_value<natural_32_bit>("num_units_per_desire_population", 4U, ptree))
+    , num_sockets_per_unit(get_value<natural_32_bit>("num_sockets_per_unit", 2U, ptree))
+{
+    ASSUMPTION(num_rounds_per_step > 0U);
+    ASSUMPTION(num_hidden_layers + 2U <= netlab::uid::MAX_NUM_LAYERS);
+    ASSUMPTION(num_units_per_hidden_layer > 0U && num_units_per_hidden_layer <= netlab::uid::MAX_NUM_UNITS_PER_LAYER);
+    ASSUMPTION(num_units_per_desire_population > 0U &&
+               2U * detail::NUM_DESIRES * num_units_per_desire_population <= netlab::uid::MAX_NUM_UNITS_PER_LAYER);
+    ASSUMPTION(num_sockets_per_unit > 0U && num_sockets_per_unit <= netlab::uid::MAX_NUM_SOCKETS_PER_UNIT);
+}
 
-cortex_netlab::cortex_netlab(agent const*  myself_, bool const  use_mock_)
+
+cortex_netlab::cortex_netlab(agent const*  myself_, bool const  use_mock_, boost::property_tree::ptree const&  ptree)
     : cortex_mock_optional(myself_, use_mock_)
-{}
+    , m_config(ptree)
+    , m_num_depth_cells((natural_32_bit)myself_->get_sight_controller().get_depth_image().size())
+    , m_random_seed(random_generator_for_natural_32_bit::default_seed)
+    , m_network()
+    , m_input_rates(m_num_depth_cells + 2U * agent_system_variables::NUM_VARIABLES, 0.0f)
+    , m_input_accumulators(m_input_rates.size(), 0.0f)
+    , m_output_counts(2U * detail::NUM_DESIRES, 0U)
+    , m_desires(detail::NUM_DESIRES, 0.0f)
+{
+    ASSUMPTION(m_input_rates.size() <= netlab::uid::MAX_NUM_UNITS_PER_LAYER);
+}
+
+
+void  cortex_netlab::set_random_seed(natural_32_bit const  seed)
+{
+    m_random_seed = seed;
+    m_network = nullptr;    // Rebuilt with the new seed in the next step.
+}
+
+
+void  cortex_netlab::build_network()
+{
+    TMPROF_BLOCK();
+
+    m_network = std::make_unique<netlab::network>(1U, 1U, m_random_seed, netlab::statistics());
+
+    // The builder connects all output sockets of non-output layers to all input sockets of non-input layers, so the input
+    // and output layers must have the same number of units. The smaller one is padded: padding input units never spike
+    // and spikes of padding output units are ignored.
+    natural_32_bit const  num_io_units = std::max(
+            (natural_32_bit)m_input_rates.size(),
+            2U * detail::NUM_DESIRES * m_config.num_units_per_desire_population
+            );
+    netlab::uid::socket_index_type const  num_sockets = (netlab::uid::socket_index_type)m_config.num_sockets_per_unit;
+    netlab::builder  net_builder(m_network.get());
+    net_builder.insert_layer_info({ num_io_units, num_sockets, detail::make_layer(1.0f) });
+    for (natural_32_bit  i = 0U; i != m_config.num_hidden_layers; ++i)
+        net_builder.insert_layer_info({
+                m_config.num_units_per_hidden_layer,
+                num_sockets,
+                detail::make_layer(i % 4U == 3U ? -1.0f : 1.0f)   // Each fourth hidden layer is inhibitory.
+                });
+    net_builder.insert_layer_info({ num_io_units, num_sockets, detail::make_layer(1.0f) });
+    net_builder.run();
+
+    // Different initial phases of accumulators avoid synchronous spikes of input units with equal rates.
+    for (natural_32_bit  i = 0U; i != (natural_32_bit)m_input_accumulators.size(); ++i)
+        m_input_accumulators.at(i) = std::fmod(0.618034f * (float_32_bit)i, 1.0f);
+}
 
 
 void  cortex_netlab::next_round(float_32_bit const  time_step_in_seconds)
 {
-    motion_desire_props_ref() = motion_desire_props();
+    TMPROF_BLOCK();
+
+    if (m_network == nullptr)
+        build_network();
+
+    update_input_rates();
+
+    std::fill(m_output_counts.begin(), m_output_counts.end(), 0U);
+    for (natural_32_bit  round = 0U; round != m_config.num_rounds_per_step; ++round)
+    {
+        encode_inputs();
+        m_network->next_round();
+        for (netlab::uid const  id : m_network->get_spiking_output_units())
+        {
+            natural_32_bit const  population = id.unit / m_config.num_units_per_desire_population;
+            if (population < (natural_32_bit)m_output_counts.size())
+                ++m_output_counts[population];
+        }
+    }
+
+    decode_outputs();
+}
+
+
+void  cortex_netlab::update_input_rates()
+{
+    sight_controller::ray_casts_image const&  depth_image = myself().get_sight_controller().get_depth_image();
+    INVARIANT(depth_image.size() == m_num_depth_cells);
+    // The sight controller already clamps the cells to <0,1>, but the encoding must not rely on it: a rate
+    // above 1 would make the accumulator of an input unit grow unboundedly and a negative one would never spike.
+    for (natural_32_bit  i = 0U; i != m_num_depth_cells; ++i)
+        m_input_rates[i] = std::min(std::max(depth_image[i], 0.0f), 1.0f);
+
+    agent_system_variables const&  variables = myself().get_system_variables();
+    for (natural_32_bit  i = 0U, j = m_num_depth_cells; i != agent_system_variables::NUM_VARIABLES; ++i, j += 2U)
+    {
+        float_32_bit const  value = variables.at(i);
+        m_input_rates[j] = std::min(std::max(value, 0.0f), 1.0f);
+        m_input_rates[j + 1U] = std::min(std::max(-value, 0.0f), 1.0f);
+    }
+}
+
+
+void  cortex_netlab::encode_inputs()
+{
+    for (natural_32_bit  unit = 0U, n = (natural_32_bit)m_input_rates.size(); unit != n; ++unit)
+    {
+        float_32_bit&  accumulator = m_input_accumulators[unit];
+        accumulator += m_input_rates[unit];
+        if (accumulator >= 1.0f)
+        {
+            accumulator -= 1.0f;
+            m_network->set_spiking_input_unit({ 0U, unit, 0U });
+        }
+    }
+}
+
+
+void  cortex_netlab::decode_outputs()
+{
+    float_32_bit const  num_spikes_max =
+            (float_32_bit)(m_config.num_units_per_desire_population * m_config.num_rounds_per_step);
+    for (natural_32_bit  i = 0U; i != detail::NUM_DESIRES; ++i)
+        m_desires[i] = ((float_32_bit)m_output_counts[2U * i] - (float_32_bit)m_output_counts[2U * i + 1U]) / num_spikes_max;
+    from_vector(m_desires, motion_desire_props_ref());
 }
 
 
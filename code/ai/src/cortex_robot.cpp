@@ -103,13 +103,13 @@ float_32_bit  cortex_robot::compute_penalty(state_data const&  state) const
     TMPROF_BLOCK();
 
     float_32_bit  penalty = 0.0f;
-    for (auto const&  name_and_data : state.state_variables)
+    for (agent_state_variable const&  var : state.state_variables)
     {
-        float_32_bit  delta = name_and_data.second.get_value() - name_and_data.second.get_ideal_value();
+        float_32_bit  delta = var.get_value() - var.get_ideal_value();
         if (delta < -0.0001f)
-            delta /= name_and_data.second.get_ideal_value() - name_and_data.second.get_min_value();
+            delta /= var.get_ideal_value() - var.get_min_value();
         else if (delta > 0.0001f)
-            delta /= name_and_data.second.get_max_value() - name_and_data.second.get_ideal_value();
+            delta /= var.get_max_value() - var.get_ideal_value();
         penalty += delta * delta;
     }
     return penalty;
@@ -3,8 +3,17 @@
 #include <utility/timeprof.hpp>
 #include <utility/assumptions.hpp>
 #include <utility/invariants.hpp>
+#include <utility/hash_combine.hpp>
+#include <utility/endian.hpp>
+#include <utility/log.hpp>
+#include <utility/mapped_file.hpp>
 #include <unordered_map>
 #include <unordered_set>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
 
 namespace ai {
 
@@ -65,19 +74,27 @@ navcomponent::navcomponent(angeo::coordinate_system const&  frame, com::object_g
 
     , m_border_waypoints()
 
+    , m_navlinks()
+    , m_navlinks_of_waypoints()
+    , m_neighbours()
+
+    // The map is in the local space, so it remains valid when the component moves.
     , m_waypoints_proximity(
             [this](navobj_guid const  waypoint_guid) {
-                vector3 const  lo = get_waypoint(waypoint_guid).position - vector3{0.01f, 0.01f, 0.01f};
-                return angeo::point3_from_coordinate_system(lo, m_frame);
+                return vector3(get_waypoint(waypoint_guid).position - vector3{0.01f, 0.01f, 0.01f});
                 },
             [this](navobj_guid const  waypoint_guid) {
-                vector3 const  hi = get_waypoint(waypoint_guid).position + vector3{0.01f, 0.01f, 0.01f};
-                return angeo::point3_from_coordinate_system(hi, m_frame);
+                return vector3(get_waypoint(waypoint_guid).position + vector3{0.01f, 0.01f, 0.01f});
                 }
             )
 
     , m_frame(frame)
     , m_collider_guid(collider_guid)
+
+    , m_local_bbox_min(vector3_zero())
+    , m_local_bbox_max(vector3_zero())
+    , m_world_bbox_min(vector3_zero())
+    , m_world_bbox_max(vector3_zero())
 {}
 
 
@@ -94,6 +111,14 @@ waylink const&  navcomponent::get_waylink(navobj_guid const  nav_guid) const
 }
 
 
+std::vector<navobj_guid> const&  navcomponent::get_navlinks_of_waypoint(navobj_guid const  waypoint_guid) const
+{
+    static std::vector<navobj_guid> const  empty;
+    auto const  it = m_navlinks_of_waypoints.find(waypoint_guid);
+    return it == m_navlinks_of_waypoints.end() ? empty : it->second;
+}
+
+
 waypoint const&  navcomponent::get_waypoint(waylink const&  link, natural_32_bit const  idx) const
 {
     return get_waypoint(link.get_waypoint_guid(idx));
@@ -123,6 +148,12 @@ navsystem::navsystem(simulation_context_const_ptr const  context_)
     : m_components()
     , m_navlinks()
 
+    , m_components_proximity(
+            [this](navobj_guid const  component_guid) { return get_component(component_guid).get_world_bbox_min(); },
+            [this](navobj_guid const  component_guid) { return get_component(component_guid).get_world_bbox_max(); }
+            )
+    , m_does_components_proximity_need_rebalancing(false)
+
     , m_colliders_to_components()
     , m_dynamic_components()
 
@@ -190,6 +221,8 @@ void  navsystem::clear()
 {
     m_components.clear();
     m_navlinks.clear();
+    m_components_proximity.clear();
+    m_does_components_proximity_need_rebalancing = false;
     m_colliders_to_components.clear();
     m_dynamic_components.clear();
 }
@@ -206,11 +239,21 @@ naveditor::naveditor(navsystem_ptr const  navsystem_)
     , m_config2d{
             0.25f,              // m_agent_roller_radius
             2.0f,               // m_waypoint_separation
-            PI()/4.0f           // m_max_incline_angle
+            PI()/4.0f,          // m_max_incline_angle
+            2.0f,               // m_max_navlink_length
+            0.1f                // m_navlinks_rebuild_tolerance
             }
 
     , m_on_navcomponent_updated([](navobj_guid){})
 
+    , m_nearby_components_buffer()
+    , m_border_waypoints_buffer()
+    , m_candidate_waypoints_buffer()
+
+    , m_bake_dir()
+
+    , m_workers(nullptr)
+
     , m_context(m_navsystem->m_context)
 {}
 
@@ -222,15 +265,27 @@ void  naveditor::add_navcomponents_2d(com::object_guid const  collider_guid, std
     ASSUMPTION(m_context->is_valid_collider_guid(collider_guid) && m_navsystem->m_colliders_to_components.count(collider_guid) == 0UL);
 
     std::unordered_set<navobj_guid>  updated_components;
+    std::vector<navobj_guid>  component_guids;
     switch (m_context->collider_shape_type(collider_guid))
     {
     case angeo::COLLISION_SHAPE_TYPE::BOX:
-        add_navcomponents_2d_from_box(collider_guid, new_component_guids, updated_components);
+        add_navcomponents_2d_from_box(collider_guid, &component_guids, updated_components);
         break;
     default:
         return; // TODO: At least generation of navdata on triangle mesh should also be supported.
     }
 
+    // The map remains valid for searches, so it is rebalanced only once in the next round, not per collider.
+    for (navobj_guid  component_guid : component_guids)
+        m_navsystem->m_components_proximity.insert(component_guid);
+    m_navsystem->m_does_components_proximity_need_rebalancing = true;
+
+    for (navobj_guid  component_guid : component_guids)
+        add_navlinks(component_guid, &updated_components);
+
+    if (new_component_guids != nullptr)
+        new_component_guids->insert(new_component_guids->end(), component_guids.begin(), component_guids.end());
+
     for (navobj_guid  component_guid : updated_components)
         m_on_navcomponent_updated(component_guid);
 }
@@ -252,10 +307,12 @@ void  naveditor::del_navcomponents_2d(com::object_guid const  collider_guid)
 
         for (navobj_guid  component_guid : it->second)
         {
+            m_navsystem->m_components_proximity.erase(component_guid);
             m_navsystem->m_components.erase(component_guid.index());
             m_navsystem->m_dynamic_components.erase(component_guid);
         }
         m_navsystem->m_colliders_to_components.erase(it);
+        m_navsystem->m_does_components_proximity_need_rebalancing = true;
     }
 }
 
@@ -264,10 +321,12 @@ void  naveditor::next_round(float_32_bit const  time_step_in_seconds)
 {
     TMPROF_BLOCK();
 
-    // TODO: Rewrite the algorithm so that navlinks are not recomputed when connected components
-    //       do not move relatively to each other (i.e. they move with the same velocity).
+    rebalance_components_proximity_if_needed();
 
-    std::unordered_set<navobj_guid>  updated_components;
+    // First we update placement of all moved components, so that the subsequent search
+    // for nearby components sees the current state of the scene. The map remains valid
+    // for searches, so we do not rebalance it for moved components.
+    std::vector<navobj_guid>  moved_components;
     std::unordered_set<com::object_guid> const&  relocated = m_context->relocated_frame_guids();
     for (navobj_guid  component_guid : m_navsystem->get_dynamic_components())
     {
@@ -275,11 +334,20 @@ void  naveditor::next_round(float_32_bit const  time_step_in_seconds)
         com::object_guid const  frame_guid = m_context->frame_of_collider(component.get_collider_guid());
         if (relocated.count(frame_guid) != 0UL)
         {
-            del_navlinks(component_guid, &updated_components);
+            m_navsystem->m_components_proximity.erase(component_guid);
             component.m_frame = m_context->frame_coord_system_in_world_space(frame_guid);
-            add_navlinks(component_guid, &updated_components);
+            update_world_bbox(component);
+            m_navsystem->m_components_proximity.insert(component_guid);
+            moved_components.push_back(component_guid);
         }
     }
+    if (moved_components.empty())
+        return;
+
+    // Components moving together with all their neighbours (e.g. with the same velocity) keep their navlinks.
+    std::unordered_set<navobj_guid>  updated_components;
+    for (navobj_guid  component_guid : moved_components)
+        update_navlinks(component_guid, &updated_components);
     for (navobj_guid  component_guid : updated_components)
         m_on_navcomponent_updated(component_guid);
 }
@@ -303,12 +371,88 @@ navobj_guid  naveditor::create_empty_component(com::object_guid const  collider_
 }
 
 
+naveditor::navgrid2d_view::navgrid2d_view()
+    : coords(nullptr)
+    , waylinks(nullptr)
+    , border_waypoints(nullptr)
+    , proximity_structure(nullptr)
+    , num_waypoints(0U)
+    , num_waylinks(0U)
+    , num_border_waypoints(0U)
+    , num_proximity_structure_words(0U)
+{}
+
+
+naveditor::navgrid2d_view::navgrid2d_view(navgrid2d const&  grid)
+    : coords(grid.coords.data())
+    , waylinks(grid.waylinks.data())
+    , border_waypoints(grid.border_waypoints.data())
+    , proximity_structure(nullptr)
+    , num_waypoints((natural_32_bit)(grid.coords.size() / 3UL))
+    , num_waylinks((natural_32_bit)(grid.waylinks.size() / 2UL))
+    , num_border_waypoints((natural_32_bit)grid.border_waypoints.size())
+    , num_proximity_structure_words(0U)
+{}
+
+
+navobj_guid  naveditor::create_component_from_navgrid2d(com::object_guid const  collider_guid, navgrid2d_view const&  grid)
+{
+    TMPROF_BLOCK();
+
+    navobj_guid const  component_guid = create_empty_component(collider_guid);
+    navcomponent&  component = m_navsystem->component_ref(component_guid);
+
+    for (natural_32_bit  i = 0U; i != grid.num_waypoints; ++i)
+    {
+        float_32_bit const* const  xyz = grid.coords + 3U * i;
+        natural_32_bit const  idx = component.m_waypoints.insert({ {}, { xyz[0], xyz[1], xyz[2] } });
+        INVARIANT(idx == i && idx + 1U == (natural_32_bit)component.m_waypoints.data().size());
+    }
+
+    // With the structure of the map from the bake, the waypoints are inserted right to balanced leaves.
+    bool const  has_proximity_structure =
+            grid.num_proximity_structure_words != 0U &&
+            component.m_waypoints_proximity.import_structure(grid.proximity_structure, grid.num_proximity_structure_words)
+                    == grid.num_proximity_structure_words;
+    for (natural_32_bit  i = 0U; i != grid.num_waypoints; ++i)
+        component.m_waypoints_proximity.insert(navobj_guid(NAVOBJ_KIND::WAYPOINT2D, i));
+    if (!has_proximity_structure)
+        component.m_waypoints_proximity.rebalance();
+
+    for (natural_32_bit  i = 0U; i != grid.num_waylinks; ++i)
+        add_waylink(
+                component,
+                navobj_guid(NAVOBJ_KIND::WAYPOINT2D, grid.waylinks[2U * i]),
+                navobj_guid(NAVOBJ_KIND::WAYPOINT2D, grid.waylinks[2U * i + 1U])
+                );
+
+    for (natural_32_bit  i = 0U; i != grid.num_border_waypoints; ++i)
+        component.m_border_waypoints.insert(navobj_guid(NAVOBJ_KIND::WAYPOINT2D, grid.border_waypoints[i]));
+
+    if (grid.num_waypoints != 0U)
+    {
+        component.m_local_bbox_min = component.m_local_bbox_max = vector3(grid.coords[0], grid.coords[1], grid.coords[2]);
+        for (natural_32_bit  j = 0U; j != grid.num_waypoints; ++j)
+            for (int  i = 0; i != 3; ++i)
+            {
+                component.m_local_bbox_min(i) = std::min(component.m_local_bbox_min(i), grid.coords[3U * j + i]);
+                component.m_local_bbox_max(i) = std::max(component.m_local_bbox_max(i), grid.coords[3U * j + i]);
+            }
+    }
+    update_world_bbox(component);
+
+    return component_guid;
+}
+
+
 void  naveditor::add_navcomponents_2d_from_box(
         com::object_guid const  collider_guid,
         std::vector<navobj_guid>* const  new_component_guids,
         std::unordered_set<navobj_guid>&  updated_components
         )
 {
+    TMPROF_BLOCK();
+
     bool const  is_static = m_context->collision_class_of(collider_guid) == angeo::COLLISION_CLASS::STATIC_OBJECT;
     vector3 const&  box_half_sizes = m_context->collider_box_half_sizes_along_axes(collider_guid);
     angeo::coordinate_system_explicit const&  frame = m_context->frame_explicit_coord_system_in_world_space(m_context->frame_of_collider(collider_guid));
@@ -331,96 +475,144 @@ void  naveditor::add_navcomponents_2d_from_box(
     ASSUMPTION(m_config2d.m_max_incline_angle >= 0.0f && m_config2d.m_max_incline_angle <= PI() / 2.0f);
     float_32_bit const  cos_of_incline_angle = std::cosf(PI() - m_config2d.m_max_incline_angle);
 
-    for (normal_axis_angle const&   side : box_sides)
+    std::vector<natural_32_bit>  sides;
+    for (natural_32_bit  i = 0U; i != 6U; ++i)
     {
         if (is_static)
         {
             vector3 const   force_field_dir = -vector3_unit_z(); // TODO: We should read this vector from somewhere!
-            if (dot_product(angeo::vector3_from_coordinate_system(side.normal, frame), force_field_dir) > cos_of_incline_angle)
+            if (dot_product(angeo::vector3_from_coordinate_system(box_sides[i].normal, frame), force_field_dir) > cos_of_incline_angle)
                 continue;
         }
+        sides.push_back(i);
+    }
 
-        navobj_guid const  component_guid = create_empty_component(collider_guid);
-        navcomponent&  component = m_navsystem->component_ref(component_guid);
+    // The generated data depend only on the box, the config, and the selected sides; not on the placement of the box.
+    bake_key  key{ (natural_32_bit)angeo::COLLISION_SHAPE_TYPE::BOX };
+    {
+        auto const  push_float = [&key](float_32_bit const  value) {
+            natural_32_bit  word;
+            std::memcpy(&word, &value, sizeof(natural_32_bit));
+            key.push_back(word);
+        };
+        for (int  i = 0; i != 3; ++i)
+            push_float(box_half_sizes(i));
+        push_float(m_config2d.m_agent_roller_radius);
+        push_float(m_config2d.m_waypoint_separation);
+        key.insert(key.end(), sides.begin(), sides.end());
+    }
 
-        add_waypoints2d_and_waylinks_onto_xy_rectangle(component, side.half_sizes);
+    std::vector<navgrid2d_view>  views(sides.size());
+    mapped_file_ptr const  bake = load_baked_navgrids2d(key, views);
+    std::vector<navgrid2d>  grids;
+    if (bake == nullptr)
+    {
+        grids.resize(sides.size());
+        // The rows of each grid are generated in parallel (see 'generate_navgrid2d_on_xy_rectangle').
+        for (natural_32_bit  i = 0U; i < (natural_32_bit)sides.size(); ++i)
+        {
+            normal_axis_angle const&  side = box_sides[sides.at(i)];
+            generate_navgrid2d_on_xy_rectangle(side.half_sizes, angle_axis_to_rotation_matrix(side.angle, side.axis), grids.at(i));
+        }
+        for (natural_32_bit  i = 0U; i < (natural_32_bit)sides.size(); ++i)
+            views.at(i) = navgrid2d_view(grids.at(i));
+    }
 
-        matrix33 const  R = angle_axis_to_rotation_matrix(side.angle, side.axis);
-        for (waypoint&  wp : component.m_waypoints)
-            wp.position = R * wp.position;
+    std::vector<navobj_guid>  component_guids;
+    for (navgrid2d_view const&  grid : views)
+        component_guids.push_back(create_component_from_navgrid2d(collider_guid, grid));
 
-        for (natural_32_bit  idx : component.m_waypoints.valid_indices())
-            component.m_waypoints_proximity.insert(navobj_guid(NAVOBJ_KIND::WAYPOINT2D, idx));
-        component.m_waypoints_proximity.rebalance();
+    // The bake is saved only now, so that it contains structures of the just balanced proximity maps of waypoints.
+    if (bake == nullptr)
+        save_baked_navgrids2d(key, grids, component_guids);
 
-        if (new_component_guids != nullptr)
-            new_component_guids->push_back(component_guid);
-    }
+    if (new_component_guids != nullptr)
+        new_component_guids->insert(new_component_guids->end(), component_guids.begin(), component_guids.end());
 }
 
 
-void  naveditor::add_waypoints2d_and_waylinks_onto_xy_rectangle(navcomponent&  component, vector3 const&  half_sizes)
+void  naveditor::generate_navgrid2d_on_xy_rectangle(vector3 const&  half_sizes, matrix33 const&  rotation, navgrid2d&  grid) const
 {
     TMPROF_BLOCK();
 
-    std::vector<std::vector<navobj_guid> >  waypoints_grid;
+    float_32_bit const  separation = m_config2d.m_waypoint_separation;
+    float_32_bit const  radius = m_config2d.m_agent_roller_radius;
+    vector2 const  x_range(-half_sizes(0) + radius, half_sizes(0) - radius);
+    vector2 const  y_range(-half_sizes(1) + radius, half_sizes(1) - radius);
+
+    // Waypoints form rows; odd rows are shifted along x by the separation. The x coordinates of waypoints depend only
+    // on the parity of a row and the y coordinate only on the row, so both are computed here once. The loops over
+    // waypoints below then contain no tests and rows do not depend on each other.
+    std::vector<float_32_bit>  row_y;
     {
-        vector2 const  x_range(-half_sizes(0) + m_config2d.m_agent_roller_radius, half_sizes(0) - m_config2d.m_agent_roller_radius);
-        vector2 const  y_range(-half_sizes(1) + m_config2d.m_agent_roller_radius, half_sizes(1) - m_config2d.m_agent_roller_radius);
         bool  x_shift = false;
         for (float_32_bit  y = y_range(0);
-             y <= y_range(1) + (x_shift ? 1.0f : 2.0f) * m_config2d.m_waypoint_separation - 0.5f * m_config2d.m_agent_roller_radius;
-             y += m_config2d.m_waypoint_separation, x_shift = !x_shift)
+             y <= y_range(1) + (x_shift ? 1.0f : 2.0f) * separation - 0.5f * radius;
+             y += separation, x_shift = !x_shift)
+            row_y.push_back(x_shift && y > y_range(1) ?
+                                0.5f * (std::max(y - separation, y_range(0)) + std::min(y, y_range(1))) :
+                                std::min(y, y_range(1)));
+    }
+    std::vector<float_32_bit>  column_x[2];
+    for (natural_32_bit  parity = 0U; parity != 2U; ++parity)
+    {
+        bool const  x_shift = parity != 0U;
+        for (float_32_bit  x = x_range(0) + x_shift * separation;
+             x <= x_range(1) + (x_shift ? 1.0f : 2.0f) * separation - 0.5f * radius;
+             x += 2.0f * separation)
+            column_x[parity].push_back(x_shift && x > x_range(1) ?
+                                           0.5f * (std::max(x - separation, x_range(0)) + std::min(x, x_range(1))) :
+                                           std::min(x, x_range(1)));
+    }
+    if (row_y.empty())
+        return;
+
+    natural_32_bit const  num_rows = (natural_32_bit)row_y.size();
+    natural_32_bit const  num_columns[2] = { (natural_32_bit)column_x[0].size(), (natural_32_bit)column_x[1].size() };
+    auto const  row_size = [&num_columns](natural_32_bit const  i) { return num_columns[i & 1U]; };
+    auto const  row_begin = [&num_columns](natural_32_bit const  i) {
+        return (i >> 1U) * (num_columns[0] + num_columns[1]) + ((i & 1U) == 0U ? 0U : num_columns[0]);
+    };
+    natural_32_bit const  num_waypoints = row_begin(num_rows);
+
+    grid.coords.resize(3UL * num_waypoints);
+    for (natural_32_bit  wp = row_begin(0U), end = wp + row_size(0U); wp < end; ++wp)
+        grid.border_waypoints.push_back(wp);
+    for (natural_32_bit  wp = row_begin(num_rows - 1U), end = wp + row_size(num_rows - 1U); wp < end; ++wp)
+        grid.border_waypoints.push_back(wp);
+    for (natural_32_bit  i = 0U; i < num_rows; ++i)
+        if (row_size(i) != 0U)
         {
-            waypoints_grid.push_back({});
-            for (float_32_bit  x = x_range(0)+ x_shift * m_config2d.m_waypoint_separation;
-                 x <= x_range(1) + (x_shift ? 1.0f : 2.0f) * m_config2d.m_waypoint_separation - 0.5f * m_config2d.m_agent_roller_radius;
-                 x += 2.0f * m_config2d.m_waypoint_separation)
-            {
-                //vector3  position{ x, y, half_sizes(2) + m_config2d.m_agent_roller_radius };
-                vector3  position{ std::min(x, x_range(1)), std::min(y, y_range(1)), half_sizes(2) + m_config2d.m_agent_roller_radius };
-                if (x_shift)
-                {
-                    if (x_shift && x > x_range(1))
-                        position(0) = 0.5f * (std::max(x - m_config2d.m_waypoint_separation, x_range(0)) + std::min(x, x_range(1)));
-                    if (y > y_range(1))
-                        position(1) = 0.5f * (std::max(y - m_config2d.m_waypoint_separation, y_range(0)) + std::min(y, y_range(1)));
-                }
-
-                navobj_guid const  wp(
-                        NAVOBJ_KIND::WAYPOINT2D,
-                        component.m_waypoints.insert({
-                                {}, // waylinks
-                                position
-                                })
-                        );
-                waypoints_grid.back().push_back(wp);
-            }
+            grid.border_waypoints.push_back(row_begin(i));
+            grid.border_waypoints.push_back(row_begin(i) + row_size(i) - 1U);
         }
-        if (waypoints_grid.empty())
-            return;
-
-        for (auto const&  wp : waypoints_grid.front())
-            component.m_border_waypoints.insert(wp);
-        for (auto const&  wp : waypoints_grid.back())
-            component.m_border_waypoints.insert(wp);
-        for (auto const&  wp_row : waypoints_grid)
-            if (!wp_row.empty())
-            {
-                component.m_border_waypoints.insert(wp_row.front());
-                component.m_border_waypoints.insert(wp_row.back());
-            }
-    }
+    std::sort(grid.border_waypoints.begin(), grid.border_waypoints.end());
+    grid.border_waypoints.erase(
+            std::unique(grid.border_waypoints.begin(), grid.border_waypoints.end()),
+            grid.border_waypoints.end()
+            );
 
-    auto const&  insert_waylink =[this, &component, &waypoints_grid]
-        (natural_32_bit const  i0, natural_32_bit const  j0, natural_32_bit const  i1, natural_32_bit const  j1) {
-            INVARIANT(i0 < (natural_32_bit)waypoints_grid.size() && j0 < (natural_32_bit)waypoints_grid.at(i0).size());
-            if (i1 < (natural_32_bit)waypoints_grid.size() && j1 < (natural_32_bit)waypoints_grid.at(i1).size())
-                add_waylink(component, waypoints_grid.at(i0).at(j0), waypoints_grid.at(i1).at(j1));
-        };
+    // Each row writes its own range of coordinates and its own vector of waylinks.
+    std::vector<std::vector<natural_32_bit> >  row_waylinks(num_rows);
+    auto const  generate_row = [&](natural_32_bit const  i) {
+        std::vector<float_32_bit> const&  xs = column_x[i & 1U];
+        float_32_bit* const  coords = grid.coords.data() + 3UL * row_begin(i);
+        for (natural_32_bit  j = 0U, n = row_size(i); j < n; ++j)
+        {
+            vector3 const  rotated_position = rotation * vector3(xs[j], row_y[i], half_sizes(2) + radius);
+            coords[3U * j + 0U] = rotated_position(0);
+            coords[3U * j + 1U] = rotated_position(1);
+            coords[3U * j + 2U] = rotated_position(2);
+        }
 
-    for (natural_32_bit  i = 0U, m = (natural_32_bit)waypoints_grid.size(); i < m; ++i)
-        for (natural_32_bit  j = 0U, n = (natural_32_bit)waypoints_grid.at(i).size(); j < n; ++j)
+        std::vector<natural_32_bit>&  waylinks = row_waylinks.at(i);
+        auto const  insert_waylink = [&waylinks, &row_size, &row_begin, num_rows]
+            (natural_32_bit const  i0, natural_32_bit const  j0, natural_32_bit const  i1, natural_32_bit const  j1) {
+                INVARIANT(i0 < num_rows && j0 < row_size(i0));
+                if (i1 < num_rows && j1 < row_size(i1))
+                    waylinks.insert(waylinks.end(), { row_begin(i0) + j0, row_begin(i1) + j1 });
+            };
+        for (natural_32_bit  j = 0U, n = row_size(i); j < n; ++j)
             if ((i & 1U) == 0U)
             {
                 insert_waylink(i, j, i, j + 1U);
@@ -433,6 +625,169 @@ void  naveditor::add_waypoints2d_and_waylinks_onto_xy_rectangle(navcomponent&  c
                 insert_waylink(i, j, i + 1U, j);
                 insert_waylink(i, j, i + 1U, j + 1U);
             }
+    };
+    // Workers pay off from a few hundred waypoints, i.e. from a floor of about 45x45 with the default separation.
+    if (m_workers != nullptr && m_workers->num_threads() > 1U && num_waypoints >= 256U)
+        m_workers->run(num_rows, [&generate_row](natural_32_bit const  i, natural_32_bit) { generate_row(i); });
+    else
+        for (natural_32_bit  i = 0U; i < num_rows; ++i)
+            generate_row(i);
+
+    for (std::vector<natural_32_bit> const&  waylinks : row_waylinks)
+        grid.waylinks.insert(grid.waylinks.end(), waylinks.begin(), waylinks.end());
+}
+
+
+/**
+ * The bake file is a flat little-endian sequence of 32-bit words (so it is used in place, once mapped to memory):
+ *      magic, version, number of words of the key, words of the key, number of grids,
+ *      and for each grid:
+ *          number of waypoints, number of waylinks, number of border waypoints,
+ *          number of words of the structure of the proximity map of waypoints,
+ *          x,y,z (floats) of each waypoint, two waypoint indices of each waylink, indices of border waypoints,
+ *          words of the structure of the proximity map (see 'proximity_map::export_structure').
+ * Waypoints are stored in the order of their indices in the navcomponent, so the proximity map
+ * is restored by plain insertion into the stored structure, without any rebalancing.
+ */
+static natural_32_bit const  NAVGRID2D_BAKE_MAGIC = 0x564e3245U; // "E2NV"
+static natural_32_bit const  NAVGRID2D_BAKE_VERSION = 3U;
+
+
+std::filesystem::path  naveditor::bake_file_path(bake_key const&  key) const
+{
+    std::size_t  hash = 0UL;
+    for (natural_32_bit  word : key)
+        ::hash_combine(hash, word);
+    std::stringstream  sstr;
+    sstr << "navgrid2d_" << std::hex << std::setfill('0') << std::setw(16) << (natural_64_bit)hash << ".bin";
+    return m_bake_dir / sstr.str();
+}
+
+
+mapped_file_ptr  naveditor::load_baked_navgrids2d(bake_key const&  key, std::vector<navgrid2d_view>&  grids) const
+{
+    TMPROF_BLOCK();
+
+    if (m_bake_dir.empty() || !is_this_little_endian_machine())
+        return nullptr;
+    std::filesystem::path const  path = bake_file_path(key);
+    if (!std::filesystem::is_regular_file(path))
+        return nullptr;
+
+    mapped_file_ptr  file;
+    try
+    {
+        file = std::make_shared<mapped_file const>(path);
+    }
+    catch (std::exception const&  e)
+    {
+        LOG(LSL_WARNING, "Cannot map the navigation bake file: " << path << ". Details: " << e.what());
+        return nullptr;
+    }
+    if (file->size() % sizeof(natural_32_bit) != 0ULL)
+        return nullptr;
+    // The mapping starts at a page boundary, so the words are aligned.
+    natural_32_bit const* const  words = reinterpret_cast<natural_32_bit const*>(file->data());
+    natural_64_bit const  num_words = file->size() / sizeof(natural_32_bit);
+
+    natural_64_bit  cursor = 0ULL;
+    auto const  has = [num_words, &cursor](natural_64_bit const  count) { return cursor + count <= num_words; };
+    auto const  next = [words, &cursor]() { return words[cursor++]; };
+
+    if (!has(3U) || next() != NAVGRID2D_BAKE_MAGIC || next() != NAVGRID2D_BAKE_VERSION || next() != (natural_32_bit)key.size())
+        return nullptr;
+    // The file name is only a hash of the key, so the whole key must match.
+    if (!has(key.size() + 1ULL) || !std::equal(key.begin(), key.end(), words + cursor))
+        return nullptr;
+    cursor += key.size();
+    if (next() != (natural_32_bit)grids.size())
+        return nullptr;
+
+    // The views point right to the mapped words; we only check the indices.
+    for (navgrid2d_view&  grid : grids)
+    {
+        if (!has(4U))
+            return nullptr;
+        grid.num_waypoints = next();
+        grid.num_waylinks = next();
+        grid.num_border_waypoints = next();
+        grid.num_proximity_structure_words = next();
+        if (!has(3ULL * grid.num_waypoints + 2ULL * grid.num_waylinks + grid.num_border_waypoints
+                 + grid.num_proximity_structure_words))
+            return nullptr;
+
+        grid.coords = reinterpret_cast<float_32_bit const*>(words + cursor);
+        cursor += 3ULL * grid.num_waypoints;
+
+        grid.waylinks = words + cursor;
+        for (natural_32_bit  i = 0U; i != grid.num_waylinks; ++i)
+        {
+            natural_32_bit const  idx0 = next();
+            natural_32_bit const  idx1 = next();
+            if (idx0 >= grid.num_waypoints || idx1 >= grid.num_waypoints || idx0 == idx1)
+                return nullptr;
+        }
+
+        grid.border_waypoints = words + cursor;
+        for (natural_32_bit  i = 0U; i != grid.num_border_waypoints; ++i)
+            if (next() >= grid.num_waypoints)
+                return nullptr;
+
+        grid.proximity_structure = words + cursor;
+        cursor += grid.num_proximity_structure_words;
+    }
+
+    return cursor == num_words ? file : nullptr;
+}
+
+
+void  naveditor::save_baked_navgrids2d(bake_key const&  key, std::vector<navgrid2d> const&  grids,
+                                       std::vector<navobj_guid> const&  component_guids) const
+{
+    TMPROF_BLOCK();
+
+    if (m_bake_dir.empty() || !is_this_little_endian_machine())
+        return;
+
+    std::error_code  ec;
+    std::filesystem::create_directories(m_bake_dir, ec);
+    if (ec)
+    {
+        LOG(LSL_WARNING, "Cannot create the navigation bake directory: " << m_bake_dir << ". Details: " << ec.message());
+        return;
+    }
+
+    std::vector<natural_32_bit>  words{ NAVGRID2D_BAKE_MAGIC, NAVGRID2D_BAKE_VERSION, (natural_32_bit)key.size() };
+    words.insert(words.end(), key.begin(), key.end());
+    words.push_back((natural_32_bit)grids.size());
+    std::vector<natural_32_bit>  proximity_structure;
+    for (natural_32_bit  g = 0U; g < (natural_32_bit)grids.size(); ++g)
+    {
+        navgrid2d const&  grid = grids.at(g);
+        proximity_structure.clear();
+        m_navsystem->get_component(component_guids.at(g)).get_waypoints_proximity().export_structure(proximity_structure);
+
+        words.push_back((natural_32_bit)(grid.coords.size() / 3UL));
+        words.push_back((natural_32_bit)(grid.waylinks.size() / 2UL));
+        words.push_back((natural_32_bit)grid.border_waypoints.size());
+        words.push_back((natural_32_bit)proximity_structure.size());
+        for (float_32_bit const  coord : grid.coords)
+        {
+            natural_32_bit  word;
+            std::memcpy(&word, &coord, sizeof(natural_32_bit));
+            words.push_back(word);
+        }
+        words.insert(words.end(), grid.waylinks.begin(), grid.waylinks.end());
+        words.insert(words.end(), grid.border_waypoints.begin(), grid.border_waypoints.end());
+        words.insert(words.end(), proximity_structure.begin(), proximity_structure.end());
+    }
+
+    std::filesystem::path const  path = bake_file_path(key);
+    std::ofstream  ostr(path.string(), std::ios_base::binary);
+    if (ostr.good())
+        ostr.write((char const*)words.data(), words.size() * sizeof(natural_32_bit));
+    if (!ostr.good())
+        LOG(LSL_WARNING, "Cannot write the navigation bake file: " << path);
 }
 
 
@@ -455,11 +810,115 @@ navobj_guid  naveditor::add_waylink(navcomponent&  component, navobj_guid const
 
 
 
+// Computes the axis-aligned box containing all corners of the box <lo,hi> mapped by 'transform'.
+template<typename transform_type>
+static void  transform_bbox(vector3 const&  lo, vector3 const&  hi, transform_type const&  transform,
+                            vector3&  output_lo, vector3&  output_hi)
+{
+    output_lo = output_hi = transform(lo);
+    for (natural_32_bit  corner = 1U; corner != 8U; ++corner)
+    {
+        vector3 const  point = transform(vector3{ (corner & 1U) ? hi(0) : lo(0), (corner & 2U) ? hi(1) : lo(1), (corner & 4U) ? hi(2) : lo(2) });
+        for (int  i = 0; i != 3; ++i)
+        {
+            output_lo(i) = std::min(output_lo(i), point(i));
+            output_hi(i) = std::max(output_hi(i), point(i));
+        }
+    }
+}
+
+
+void  naveditor::update_world_bbox(navcomponent&  component)
+{
+    transform_bbox(
+            component.m_local_bbox_min,
+            component.m_local_bbox_max,
+            [&component](vector3 const&  p) { return angeo::point3_from_coordinate_system(p, component.m_frame); },
+            component.m_world_bbox_min,
+            component.m_world_bbox_max
+            );
+}
+
+
+void  naveditor::rebalance_components_proximity_if_needed()
+{
+    if (m_navsystem->m_does_components_proximity_need_rebalancing)
+    {
+        m_navsystem->m_components_proximity.rebalance();
+        m_navsystem->m_does_components_proximity_need_rebalancing = false;
+    }
+}
+
+
+void  naveditor::collect_nearby_components(navobj_guid const  component_guid, std::vector<navobj_guid>&  output_components) const
+{
+    navcomponent const&  component = m_navsystem->get_component(component_guid);
+    vector3 const  margin{ m_config2d.m_max_navlink_length, m_config2d.m_max_navlink_length, m_config2d.m_max_navlink_length };
+    output_components.clear();
+    m_navsystem->m_components_proximity.find_by_bbox(
+            component.m_world_bbox_min - margin,
+            component.m_world_bbox_max + margin,
+            [this, &component, &output_components, component_guid](navobj_guid const  other_guid) -> bool {
+                // Sides of the same collider are never linked together.
+                if (other_guid != component_guid
+                        && m_navsystem->get_component(other_guid).get_collider_guid() != component.get_collider_guid())
+                    output_components.push_back(other_guid);
+                return true;
+            }
+            );
+    std::sort(output_components.begin(), output_components.end());
+    output_components.erase(std::unique(output_components.begin(), output_components.end()), output_components.end());
+}
+
+
+navcomponent::neighbour_placement  naveditor::compute_neighbour_placement(
+        navcomponent const&  component,
+        navobj_guid const  neighbour_guid
+        ) const
+{
+    angeo::coordinate_system_explicit const&  neighbour_frame = m_navsystem->get_component(neighbour_guid).get_frame();
+    return {
+        neighbour_guid,
+        angeo::point3_to_coordinate_system(component.m_frame.origin(), neighbour_frame),
+        angeo::vector3_to_coordinate_system(component.m_frame.basis_vector_x(), neighbour_frame),
+        angeo::vector3_to_coordinate_system(component.m_frame.basis_vector_y(), neighbour_frame),
+        {}
+    };
+}
+
+
+bool  naveditor::is_neighbour_placement_outdated(
+        navcomponent const&  component,
+        navcomponent::neighbour_placement const&  placement
+        ) const
+{
+    // A rotation moves waypoints of the component by at most their distance from the origin times the change of basis vectors.
+    // The farthest point of the bbox from the origin is its corner made of the coordinates with greater magnitudes, which
+    // need not be the min or max corner (e.g. for an asymmetric bbox).
+    float_32_bit const  radius = length(vector3(
+            std::max(std::fabs(component.m_local_bbox_min(0)), std::fabs(component.m_local_bbox_max(0))),
+            std::max(std::fabs(component.m_local_bbox_min(1)), std::fabs(component.m_local_bbox_max(1))),
+            std::max(std::fabs(component.m_local_bbox_min(2)), std::fabs(component.m_local_bbox_max(2)))
+            ));
+    navcomponent::neighbour_placement const  current = compute_neighbour_placement(component, placement.component_guid);
+    float_32_bit const  shift =
+            length(current.origin - placement.origin)
+            + radius * (length(current.basis_vector_x - placement.basis_vector_x)
+                        + length(current.basis_vector_y - placement.basis_vector_y));
+    return shift > m_config2d.m_navlinks_rebuild_tolerance;
+}
+
+
 void  naveditor::add_navlinks(navobj_guid const  component_guid, std::unordered_set<navobj_guid>* const  updated_components)
 {
     TMPROF_BLOCK();
 
-    // TODO!
+    INVARIANT(m_navsystem->get_component(component_guid).m_neighbours.empty());
+
+    collect_nearby_components(component_guid, m_nearby_components_buffer);
+    std::vector<navobj_guid> const  nearby_components = m_nearby_components_buffer;
+    for (navobj_guid  other_guid : nearby_components)
+        add_navlinks_between(component_guid, other_guid, updated_components);
 
     if (updated_components != nullptr)
         updated_components->insert(component_guid);
@@ -470,13 +929,244 @@ void  naveditor::del_navlinks(navobj_guid const  component_guid, std::unordered_
 {
     TMPROF_BLOCK();
 
-    // TODO!
+    navcomponent const&  component = m_navsystem->get_component(component_guid);
+    while (!component.m_neighbours.empty())
+        del_navlinks_between(component_guid, component.m_neighbours.back().component_guid, updated_components);
+    INVARIANT(component.m_navlinks.empty() && component.m_navlinks_of_waypoints.empty());
 
     if (updated_components != nullptr)
         updated_components->insert(component_guid);
 }
 
 
+void  naveditor::update_navlinks(navobj_guid const  component_guid, std::unordered_set<navobj_guid>* const  updated_components)
+{
+    TMPROF_BLOCK();
+
+    navcomponent const&  component = m_navsystem->get_component(component_guid);
+
+    // Both sequences are sorted by guids, so we can merge them. Pairs staying nearby are rebuilt only when their
+    // relative placement (and so the overlap of their bounding boxes) changed by more than the tolerance.
+    collect_nearby_components(component_guid, m_nearby_components_buffer);
+    std::vector<navobj_guid>  to_del, to_add;
+    for (std::size_t  i = 0UL, j = 0UL; i != m_nearby_components_buffer.size() || j != component.m_neighbours.size(); )
+        if (j == component.m_neighbours.size()
+                || (i != m_nearby_components_buffer.size() && m_nearby_components_buffer.at(i) < component.m_neighbours.at(j).component_guid))
+            to_add.push_back(m_nearby_components_buffer.at(i++));
+        else if (i == m_nearby_components_buffer.size() || component.m_neighbours.at(j).component_guid < m_nearby_components_buffer.at(i))
+            to_del.push_back(component.m_neighbours.at(j++).component_guid);
+        else
+        {
+            if (is_neighbour_placement_outdated(component, component.m_neighbours.at(j)))
+            {
+                to_del.push_back(component.m_neighbours.at(j).component_guid);
+                to_add.push_back(component.m_neighbours.at(j).component_guid);
+            }
+            ++i; ++j;
+        }
+
+    for (navobj_guid  other_guid : to_del)
+        del_navlinks_between(component_guid, other_guid, updated_components);
+    for (navobj_guid  other_guid : to_add)
+        add_navlinks_between(component_guid, other_guid, updated_components);
+}
+
+
+void  naveditor::add_navlinks_between(
+        navobj_guid const  component_guid,
+        navobj_guid const  other_guid,
+        std::unordered_set<navobj_guid>* const  updated_components
+        )
+{
+    TMPROF_BLOCK();
+
+    navcomponent&  src = m_navsystem->component_ref(std::min(component_guid, other_guid));
+    navcomponent&  dst = m_navsystem->component_ref(std::max(component_guid, other_guid));
+    navobj_guid const  src_guid = std::min(component_guid, other_guid);
+    navobj_guid const  dst_guid = std::max(component_guid, other_guid);
+
+    auto const  insert_placement = [this](navcomponent&  component, navobj_guid const  neighbour_guid) {
+        auto const  it = std::lower_bound(
+                component.m_neighbours.begin(), component.m_neighbours.end(), neighbour_guid,
+                [](navcomponent::neighbour_placement const&  placement, navobj_guid const  guid) { return placement.component_guid < guid; }
+                );
+        INVARIANT(it == component.m_neighbours.end() || it->component_guid != neighbour_guid);
+        return component.m_neighbours.insert(it, compute_neighbour_placement(component, neighbour_guid));
+    };
+    std::vector<navobj_guid>&  src_navlinks = insert_placement(src, dst_guid)->navlinks;
+    std::vector<navobj_guid>&  dst_navlinks = insert_placement(dst, src_guid)->navlinks;
+
+    // Only border waypoints of 'src' inside the overlap of the bounding boxes (extended by the max navlink length)
+    // can be linked. We find them by a single query to the proximity map of 'src', which is in its local space.
+    float_32_bit const  max_length = m_config2d.m_max_navlink_length;
+    vector3 const  radius_vector{ max_length, max_length, max_length };
+    vector3  world_lo, world_hi;
+    for (int  i = 0; i != 3; ++i)
+    {
+        world_lo(i) = std::max(src.m_world_bbox_min(i), dst.m_world_bbox_min(i)) - max_length;
+        world_hi(i) = std::min(src.m_world_bbox_max(i), dst.m_world_bbox_max(i)) + max_length;
+        if (world_lo(i) > world_hi(i))
+            return;
+    }
+    vector3  lo, hi;
+    transform_bbox(world_lo, world_hi, [&src](vector3 const&  p) { return angeo::point3_to_coordinate_system(p, src.m_frame); }, lo, hi);
+    m_border_waypoints_buffer.clear();
+    src.m_waypoints_proximity.find_by_bbox(lo, hi, [this, &src](navobj_guid const  wp_guid) -> bool {
+        if (src.m_border_waypoints.count(wp_guid) != 0UL)
+            m_border_waypoints_buffer.push_back(wp_guid);
+        return true;
+    });
+    if (m_border_waypoints_buffer.empty())
+        return;
+
+    // Positions of the found waypoints in the local space of 'dst'.
+    std::vector<vector3>  points;
+    for (navobj_guid  wp_guid : m_border_waypoints_buffer)
+        points.push_back(angeo::point3_to_coordinate_system(
+                angeo::point3_from_coordinate_system(src.get_waypoint(wp_guid).position, src.m_frame),
+                dst.m_frame
+                ));
+
+    // We split the waypoints into segments of neighbouring ones (sorted along the longest side of the overlap) and we
+    // query the proximity map of 'dst' only once per segment. Each waypoint is then linked to the nearest candidate.
+    int  axis = 0;
+    for (int  i = 1; i != 3; ++i)
+        if (hi(i) - lo(i) > hi(axis) - lo(axis))
+            axis = i;
+    std::vector<natural_32_bit>  order(m_border_waypoints_buffer.size());
+    for (natural_32_bit  i = 0U; i != (natural_32_bit)order.size(); ++i)
+        order.at(i) = i;
+    std::sort(order.begin(), order.end(), [this, &src, axis](natural_32_bit const  i, natural_32_bit const  j) {
+        float_32_bit const  pi = src.get_waypoint(m_border_waypoints_buffer.at(i)).position(axis);
+        float_32_bit const  pj = src.get_waypoint(m_border_waypoints_buffer.at(j)).position(axis);
+        return pi < pj || (pi == pj && m_border_waypoints_buffer.at(i) < m_border_waypoints_buffer.at(j));
+    });
+    natural_32_bit constexpr  segment_size = 8U;
+    for (natural_32_bit  begin = 0U; begin < (natural_32_bit)order.size(); begin += segment_size)
+    {
+        natural_32_bit const  end = std::min(begin + segment_size, (natural_32_bit)order.size());
+        vector3  segment_lo = points.at(order.at(begin));
+        vector3  segment_hi = segment_lo;
+        for (natural_32_bit  k = begin + 1U; k < end; ++k)
+            for (int  i = 0; i != 3; ++i)
+            {
+                segment_lo(i) = std::min(segment_lo(i), points.at(order.at(k))(i));
+                segment_hi(i) = std::max(segment_hi(i), points.at(order.at(k))(i));
+            }
+        m_candidate_waypoints_buffer.clear();
+        dst.m_waypoints_proximity.find_by_bbox(segment_lo - radius_vector, segment_hi + radius_vector,
+                                               [this, &dst](navobj_guid const  wp_guid) -> bool {
+            if (dst.m_border_waypoints.count(wp_guid) != 0UL)
+                m_candidate_waypoints_buffer.push_back(wp_guid);
+            return true;
+        });
+        if (m_candidate_waypoints_buffer.empty())
+            continue;
+
+        for (natural_32_bit  k = begin; k < end; ++k)
+        {
+            vector3 const&  point = points.at(order.at(k));
+            float_32_bit  best_distance_squared = max_length * max_length;
+            navobj_guid  best_guid = invalid_navobj_guid();
+            for (navobj_guid  candidate_guid : m_candidate_waypoints_buffer)
+            {
+                float_32_bit const  distance_squared = length_squared(dst.get_waypoint(candidate_guid).position - point);
+                if (distance_squared < best_distance_squared || (distance_squared == best_distance_squared && !best_guid.valid()))
+                {
+                    best_distance_squared = distance_squared;
+                    best_guid = candidate_guid;
+                }
+            }
+            if (!best_guid.valid())
+                continue;
+
+            navobj_guid const  wp_guid = m_border_waypoints_buffer.at(order.at(k));
+            navobj_guid const  navlink_guid(
+                    NAVOBJ_KIND::NAVLINK,
+                    m_navsystem->m_navlinks.insert({
+                            { { wp_guid, best_guid }, std::sqrt(best_distance_squared) }, // link
+                            { src_guid, dst_guid } // components
+                            })
+                    );
+            src.m_navlinks.push_back(navlink_guid);
+            src.m_navlinks_of_waypoints[wp_guid].push_back(navlink_guid);
+            dst.m_navlinks.push_back(navlink_guid);
+            dst.m_navlinks_of_waypoints[best_guid].push_back(navlink_guid);
+            src_navlinks.push_back(navlink_guid);
+            dst_navlinks.push_back(navlink_guid);
+        }
+    }
+
+    if (!src_navlinks.empty() && updated_components != nullptr)
+    {
+        updated_components->insert(src_guid);
+        updated_components->insert(dst_guid);
+    }
+}
+
+
+void  naveditor::del_navlinks_between(
+        navobj_guid const  component_guid,
+        navobj_guid const  other_guid,
+        std::unordered_set<navobj_guid>* const  updated_components
+        )
+{
+    TMPROF_BLOCK();
+
+    auto const  find_placement = [](navcomponent&  component, navobj_guid const  neighbour_guid) {
+        auto const  it = std::lower_bound(
+                component.m_neighbours.begin(), component.m_neighbours.end(), neighbour_guid,
+                [](navcomponent::neighbour_placement const&  placement, navobj_guid const  guid) { return placement.component_guid < guid; }
+                );
+        INVARIANT(it != component.m_neighbours.end() && it->component_guid == neighbour_guid);
+        return it;
+    };
+
+    navcomponent&  component = m_navsystem->component_ref(component_guid);
+    navcomponent&  other = m_navsystem->component_ref(other_guid);
+    auto const  component_it = find_placement(component, other_guid);
+    auto const  other_it = find_placement(other, component_guid);
+
+    std::vector<navobj_guid>&  navlinks = component_it->navlinks;
+    if (!navlinks.empty())
+    {
+        std::sort(navlinks.begin(), navlinks.end());
+        auto const  is_erased = [&navlinks](navobj_guid const  navlink_guid) {
+            return std::binary_search(navlinks.begin(), navlinks.end(), navlink_guid);
+        };
+        for (navcomponent*  component_ptr : { &component, &other })
+            component_ptr->m_navlinks.erase(
+                    std::remove_if(component_ptr->m_navlinks.begin(), component_ptr->m_navlinks.end(), is_erased),
+                    component_ptr->m_navlinks.end()
+                    );
+
+        for (navobj_guid  navlink_guid : navlinks)
+        {
+            navlink const&  link = m_navsystem->get_navlink(navlink_guid);
+            for (natural_32_bit  side = 0U; side != 2U; ++side)
+            {
+                navcomponent&  side_component = m_navsystem->component_ref(link.get_component_guid(side));
+                auto const  it = side_component.m_navlinks_of_waypoints.find(link.link.get_waypoint_guid(side));
+                INVARIANT(it != side_component.m_navlinks_of_waypoints.end());
+                it->second.erase(std::remove(it->second.begin(), it->second.end(), navlink_guid), it->second.end());
+                if (it->second.empty())
+                    side_component.m_navlinks_of_waypoints.erase(it);
+            }
+            m_navsystem->m_navlinks.erase(navlink_guid.index());
+        }
+
+        if (updated_components != nullptr)
+        {
+            updated_components->insert(component_guid);
+            updated_components->insert(other_guid);
+        }
+    }
+
+    component.m_neighbours.erase(component_it);
+    other.m_neighbours.erase(other_it);
+}
+
+
 void  naveditor::clear()
 {
     // nothing to do, yet.
@@ -0,0 +1,422 @@
+#include <ai/navigation_path.hpp>
+#include <angeo/coordinate_system.hpp>
+#include <utility/timeprof.hpp>
+#include <utility/assumptions.hpp>
+#include <utility/invariants.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace ai { namespace {
+
+
+NAVOBJ_KIND  waypoint_kind_of(navcomponent const&  component)
+{
+    return component.is_surface() ? NAVOBJ_KIND::WAYPOINT2D : NAVOBJ_KIND::WAYPOINT3D;
+}
+
+
+}}
+
+namespace ai {
+
+
+navpath_finder::navpath_finder(navsystem_const_ptr const  navsystem_)
+    : m_navsystem(navsystem_)
+
+    , m_node_offsets()
+
+    , m_node_costs()
+    , m_node_parents()
+    , m_node_visit_stamps()
+    , m_node_closed_stamps()
+    , m_open()
+
+    , m_component_costs()
+    , m_component_parents()
+    , m_component_entry_points()
+    , m_component_visit_stamps()
+    , m_component_closed_stamps()
+    , m_corridor_stamps()
+    , m_corridor_stamp(0U)
+
+    , m_stamp(0U)
+{
+    ASSUMPTION(m_navsystem != nullptr);
+}
+
+
+bool  navpath_finder::find_path(
+        vector3 const&  start,
+        vector3 const&  goal,
+        navpath&  output_path,
+        float_32_bit const  max_snap_distance
+        )
+{
+    TMPROF_BLOCK();
+
+    output_path.clear();
+
+    navobj_guid  start_component_guid, start_waypoint_guid;
+    if (!find_nearest_waypoint(start, max_snap_distance, start_component_guid, start_waypoint_guid))
+        return false;
+    navobj_guid  goal_component_guid, goal_waypoint_guid;
+    if (!find_nearest_waypoint(goal, max_snap_distance, goal_component_guid, goal_waypoint_guid))
+        return false;
+
+    update_node_offsets();
+
+    natural_32_bit const  start_node = node_of(start_component_guid.index(), start_waypoint_guid.index());
+    natural_32_bit const  goal_node = node_of(goal_component_guid.index(), goal_waypoint_guid.index());
+
+    // The corridor search is not exact (costs of crossing components are only estimated
+    // by distances of navlink ends). So, when the search restricted to the corridor fails,
+    // we must fall back to the search over all waypoints.
+    if (!find_components_corridor(
+            start_component_guid.index(),
+            goal_component_guid.index(),
+            world_position_of_node(start_node),
+            world_position_of_node(goal_node)
+            ))
+        return false;
+    if (find_waypoints_path(start_node, goal_node, true, output_path))
+        return true;
+    return find_waypoints_path(start_node, goal_node, false, output_path);
+}
+
+
+void  navpath_finder::find_paths(std::vector<navpath_query> const&  queries, std::vector<navpath>&  output_paths)
+{
+    TMPROF_BLOCK();
+
+    output_paths.resize(queries.size());
+    for (std::size_t  i = 0UL; i != queries.size(); ++i)
+    {
+        navpath_query const&  query = queries.at(i);
+        find_path(query.start, query.goal, output_paths.at(i), query.max_snap_distance);
+    }
+}
+
+
+bool  navpath_finder::find_nearest_waypoint(
+        vector3 const&  point,
+        float_32_bit const  max_distance,
+        navobj_guid&  output_component_guid,
+        navobj_guid&  output_waypoint_guid
+        ) const
+{
+    TMPROF_BLOCK();
+
+    ASSUMPTION(max_distance >= 0.0f);
+
+    vector3 const  radius_vector{ max_distance, max_distance, max_distance };
+    float_32_bit  best_distance_squared = max_distance * max_distance;
+    bool  found = false;
+    // Only components whose world bounding boxes meet the box around the query sphere can contain the waypoint.
+    m_navsystem->get_components_proximity().find_by_bbox(
+            point - radius_vector,
+            point + radius_vector,
+            [&](navobj_guid const  component_guid) -> bool {
+                navcomponent const&  component = m_navsystem->get_component(component_guid);
+                // The proximity map of waypoints is in the local space of the component. Since the frame is
+                // orthonormal, distances are preserved and the local box still contains the whole query sphere.
+                vector3 const  local_point = angeo::point3_to_coordinate_system(point, component.get_frame());
+                component.get_waypoints_proximity().find_by_bbox(
+                        local_point - radius_vector,
+                        local_point + radius_vector,
+                        [&](navobj_guid const  waypoint_guid) -> bool {
+                            float_32_bit const  distance_squared =
+                                    length_squared(component.get_waypoint(waypoint_guid).position - local_point);
+                            if (distance_squared <= best_distance_squared)
+                            {
+                                best_distance_squared = distance_squared;
+                                output_component_guid = component_guid;
+                                output_waypoint_guid = waypoint_guid;
+                                found = true;
+                            }
+                            return true;
+                        }
+                        );
+                return true;
+            }
+            );
+    return found;
+}
+
+
+natural_32_bit  navpath_finder::next_stamp()
+{
+    if (m_stamp == std::numeric_limits<natural_32_bit>::max())
+    {
+        std::fill(m_node_visit_stamps.begin(), m_node_visit_stamps.end(), 0U);
+        std::fill(m_node_closed_stamps.begin(), m_node_closed_stamps.end(), 0U);
+        std::fill(m_component_visit_stamps.begin(), m_component_visit_stamps.end(), 0U);
+        std::fill(m_component_closed_stamps.begin(), m_component_closed_stamps.end(), 0U);
+        std::fill(m_corridor_stamps.begin(), m_corridor_stamps.end(), 0U);
+        m_corridor_stamp = 0U;
+        m_stamp = 0U;
+    }
+    return ++m_stamp;
+}
+
+
+void  navpath_finder::update_node_offsets()
+{
+    TMPROF_BLOCK();
+
+    dynamic_array<navcomponent_ptr> const&  components = m_navsystem->get_components();
+    natural_32_bit const  num_components = (natural_32_bit)components.data().size();
+
+    m_node_offsets.resize(num_components + 1U);
+    m_node_offsets.front() = 0U;
+    for (natural_32_bit  i = 0U; i != num_components; ++i)
+        m_node_offsets.at(i + 1U) = m_node_offsets.at(i) + (
+                components.valid(i) ? (natural_32_bit)components.at(i)->get_waypoints().data().size() : 0U
+                );
+
+    // Vectors never shrink their capacity, so the memory is allocated only when the navsystem grows.
+    natural_32_bit const  num_nodes = m_node_offsets.back();
+    if (m_node_costs.size() < num_nodes)
+    {
+        m_node_costs.resize(num_nodes);
+        m_node_parents.resize(num_nodes);
+        m_node_visit_stamps.resize(num_nodes, 0U);
+        m_node_closed_stamps.resize(num_nodes, 0U);
+    }
+    if (m_component_costs.size() < num_components)
+    {
+        m_component_costs.resize(num_components);
+        m_component_parents.resize(num_components);
+        m_component_entry_points.resize(num_components);
+        m_component_visit_stamps.resize(num_components, 0U);
+        m_component_closed_stamps.resize(num_components, 0U);
+        m_corridor_stamps.resize(num_components, 0U);
+    }
+}
+
+
+natural_32_bit  navpath_finder::node_of(natural_32_bit const  component_index, natural_32_bit const  waypoint_index) const
+{
+    INVARIANT(m_node_offsets.at(component_index) + waypoint_index < m_node_offsets.at(component_index + 1U));
+    return m_node_offsets.at(component_index) + waypoint_index;
+}
+
+
+natural_32_bit  navpath_finder::component_index_of_node(natural_32_bit const  node) const
+{
+    // Components without waypoints have equal neighbour offsets; 'upper_bound' skips all of them.
+    auto const  it = std::upper_bound(m_node_offsets.begin(), m_node_offsets.end(), node);
+    INVARIANT(it != m_node_offsets.begin() && it != m_node_offsets.end());
+    return (natural_32_bit)(std::distance(m_node_offsets.begin(), it) - 1);
+}
+
+
+vector3  navpath_finder::world_position_of_node(natural_32_bit const  node) const
+{
+    natural_32_bit const  component_index = component_index_of_node(node);
+    navcomponent const&  component = *m_navsystem->get_components().at(component_index);
+    return angeo::point3_from_coordinate_system(
+                component.get_waypoints().at(node - m_node_offsets.at(component_index)).position,
+                component.get_frame()
+                );
+}
+
+
+bool  navpath_finder::find_components_corridor(
+        natural_32_bit const  start_component,
+        natural_32_bit const  goal_component,
+        vector3 const&  start,
+        vector3 const&  goal
+        )
+{
+    TMPROF_BLOCK();
+
+    natural_32_bit const  stamp = next_stamp();
+
+    m_component_costs.at(start_component) = 0.0f;
+    m_component_parents.at(start_component) = start_component;
+    m_component_entry_points.at(start_component) = start;
+    m_component_visit_stamps.at(start_component) = stamp;
+
+    m_open.clear();
+    m_open.push_back({ 0.0f, start_component });
+
+    bool  found = false;
+    while (!m_open.empty())
+    {
+        std::pop_heap(m_open.begin(), m_open.end(), std::greater<heap_item>());
+        natural_32_bit const  component_index = m_open.back().second;
+        m_open.pop_back();
+
+        if (m_component_closed_stamps.at(component_index) == stamp)
+            continue;
+        m_component_closed_stamps.at(component_index) = stamp;
+
+        if (component_index == goal_component)
+        {
+            found = true;
+            break;
+        }
+
+        navcomponent const&  component = *m_navsystem->get_components().at(component_index);
+        for (navobj_guid const  navlink_guid : component.get_navlinks())
+        {
+            navlink const&  link = m_navsystem->get_navlink(navlink_guid);
+            natural_32_bit const  side = link.get_component_guid(0U).index() == component_index ? 0U : 1U;
+            natural_32_bit const  other_index = link.get_component_guid(1U - side).index();
+            if (m_component_closed_stamps.at(other_index) == stamp)
+                continue;
+
+            vector3 const  exit_point = angeo::point3_from_coordinate_system(
+                    component.get_waypoint(link.link.get_waypoint_guid(side)).position,
+                    component.get_frame()
+                    );
+            vector3 const  entry_point = angeo::point3_from_coordinate_system(
+                    m_navsystem->get_waypoint(link, 1U - side).position,
+                    m_navsystem->get_component(link, 1U - side).get_frame()
+                    );
+            // We estimate the cost of crossing the component by the distance from its entry point to the exit point.
+            float_32_bit const  cost = m_component_costs.at(component_index)
+                                       + length(exit_point - m_component_entry_points.at(component_index))
+                                       + link.link.length;
+            if (m_component_visit_stamps.at(other_index) != stamp || cost < m_component_costs.at(other_index))
+            {
+                m_component_costs.at(other_index) = cost;
+                m_component_parents.at(other_index) = component_index;
+                m_component_entry_points.at(other_index) = entry_point;
+                m_component_visit_stamps.at(other_index) = stamp;
+                m_open.push_back({ cost + length(goal - entry_point), other_index });
+                std::push_heap(m_open.begin(), m_open.end(), std::greater<heap_item>());
+            }
+        }
+    }
+    if (!found)
+        return false;
+
+    m_corridor_stamp = stamp;
+    for (natural_32_bit  component_index = goal_component; ; component_index = m_component_parents.at(component_index))
+    {
+        m_corridor_stamps.at(component_index) = m_corridor_stamp;
+        if (component_index == start_component)
+            break;
+    }
+
+    return true;
+}
+
+
+bool  navpath_finder::find_waypoints_path(
+        natural_32_bit const  start_node,
+        natural_32_bit const  goal_node,
+        bool const  restrict_to_corridor,
+        navpath&  output_path
+        )
+{
+    TMPROF_BLOCK();
+
+    natural_32_bit const  stamp = next_stamp();
+    vector3 const  goal = world_position_of_node(goal_node);
+
+    m_node_costs.at(start_node) = 0.0f;
+    m_node_parents.at(start_node) = start_node;
+    m_node_visit_stamps.at(start_node) = stamp;
+
+    m_open.clear();
+    m_open.push_back({ length(goal - world_position_of_node(start_node)), start_node });
+
+    auto const  relax = [this, stamp, &goal](natural_32_bit const  node, natural_32_bit const  parent, float_32_bit const  cost) {
+        if (m_node_closed_stamps.at(node) == stamp)
+            return;
+        if (m_node_visit_stamps.at(node) != stamp || cost < m_node_costs.at(node))
+        {
+            m_node_costs.at(node) = cost;
+            m_node_parents.at(node) = parent;
+            m_node_visit_stamps.at(node) = stamp;
+            m_open.push_back({ cost + length(goal - world_position_of_node(node)), node });
+            std::push_heap(m_open.begin(), m_open.end(), std::greater<heap_item>());
+        }
+    };
+
+    bool  found = false;
+    while (!m_open.empty())
+    {
+        std::pop_heap(m_open.begin(), m_open.end(), std::greater<heap_item>());
+        natural_32_bit const  node = m_open.back().second;
+        m_open.pop_back();
+
+        if (m_node_closed_stamps.at(node) == stamp)
+            continue;
+        m_node_closed_stamps.at(node) = stamp;
+
+        if (node == goal_node)
+        {
+            found = true;
+            break;
+        }
+
+        natural_32_bit const  component_index = component_index_of_node(node);
+        navcomponent const&  component = *m_navsystem->get_components().at(component_index);
+        natural_32_bit const  offset = m_node_offsets.at(component_index);
+        navobj_guid const  waypoint_guid(waypoint_kind_of(component), node - offset);
+        float_32_bit const  cost = m_node_costs.at(node);
+
+        for (navobj_guid const  waylink_guid : component.get_waypoint(waypoint_guid).links)
+        {
+            waylink const&  link = component.get_waylink(waylink_guid);
+            navobj_guid const  other_guid = link.get_waypoint_guid(link.get_waypoint_guid(0U) == waypoint_guid ? 1U : 0U);
+            relax(offset + other_guid.index(), node, cost + link.length);
+        }
+
+        for (navobj_guid const  navlink_guid : component.get_navlinks_of_waypoint(waypoint_guid))
+        {
+            navlink const&  link = m_navsystem->get_navlink(navlink_guid);
+            natural_32_bit const  side =
+                    link.get_component_guid(0U).index() == component_index && link.link.get_waypoint_guid(0U) == waypoint_guid ? 0U : 1U;
+            natural_32_bit const  other_index = link.get_component_guid(1U - side).index();
+            if (restrict_to_corridor && m_corridor_stamps.at(other_index) != m_corridor_stamp)
+                continue;
+            relax(node_of(other_index, link.link.get_waypoint_guid(1U - side).index()), node, cost + link.link.length);
+        }
+    }
+    if (!found)
+        return false;
+
+    for (natural_32_bit  node = goal_node; ; node = m_node_parents.at(node))
+    {
+        natural_32_bit const  component_index = component_index_of_node(node);
+        navcomponent const&  component = *m_navsystem->get_components().at(component_index);
+        navobj_guid const  waypoint_guid(waypoint_kind_of(component), node - m_node_offsets.at(component_index));
+        output_path.waypoints.push_back({
+                navobj_guid(NAVOBJ_KIND::NAVCOMPONENT, component_index),
+                waypoint_guid,
+                angeo::point3_from_coordinate_system(component.get_waypoint(waypoint_guid).position, component.get_frame())
+                });
+        if (node == start_node)
+            break;
+    }
+    std::reverse(output_path.waypoints.begin(), output_path.waypoints.end());
+    output_path.length = m_node_costs.at(goal_node);
+
+    return true;
+}
+
+
+void  find_navpaths_in_parallel(
+        thread_pool&  workers,
+        std::vector<navpath_finder_ptr> const&  finders,
+        std::vector<navpath_query> const&  queries,
+        std::vector<navpath>&  output_paths
+        )
+{
+    TMPROF_BLOCK();
+
+    ASSUMPTION(finders.size() >= workers.num_threads());
+
+    output_paths.resize(queries.size());
+    workers.run((natural_32_bit)queries.size(), [&finders, &queries, &output_paths](natural_32_bit const  i, natural_32_bit const  t) {
+        navpath_query const&  query = queries.at(i);
+        finders.at(t)->find_path(query.start, query.goal, output_paths.at(i), query.max_snap_distance);
+    });
+}
+
+
+}
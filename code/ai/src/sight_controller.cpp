@@ -53,7 +53,52 @@ std::function<float_32_bit(float_32_bit)>  parse_function(std::string const&  ex
 }
 
 
+// Computes the half-spaces (see 'angeo::collision_scene::find_objects_in_proximity_to_convex_volume')
+// and the bbox of the camera's frustum in the world space.
+void  compute_camera_frustum_in_world_space(
+        gfx::camera_perspective const&  camera,
+        matrix44 const&  from_camera_matrix,
+        std::vector<std::pair<vector3, vector3> >&  half_spaces,
+        vector3&  min_corner,
+        vector3&  max_corner
+        )
+{
+    static vector2 const  window_corners[4] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+    vector3  near_corners[4], far_corners[4];
+    for (natural_32_bit  i = 0U; i != 4U; ++i)
+    {
+        camera.ray_points_in_camera_space(window_corners[i], near_corners[i], far_corners[i]);
+        near_corners[i] = transform_point(near_corners[i], from_camera_matrix);
+        far_corners[i] = transform_point(far_corners[i], from_camera_matrix);
+    }
+
+    min_corner = max_corner = near_corners[0];
+    vector3  centre = vector3_zero();
+    for (natural_32_bit  i = 0U; i != 4U; ++i)
+    {
+        min_corner = min_components(min_corner, min_components(near_corners[i], far_corners[i]));
+        max_corner = max_components(max_corner, max_components(near_corners[i], far_corners[i]));
+        centre += near_corners[i] + far_corners[i];
+    }
+    centre = (1.0f / 8.0f) * centre;
 
+    auto const  add_half_space = [&half_spaces, &centre](vector3 const&  A, vector3 const&  B, vector3 const&  C) {
+        vector3 const  normal = cross_product(B - A, C - A);
+        half_spaces.push_back({ A, dot_product(centre - A, normal) >= 0.0f ? normal : -normal });
+    };
+    half_spaces.clear();
+    add_half_space(near_corners[0], near_corners[1], near_corners[2]);
+    add_half_space(far_corners[0], far_corners[1], far_corners[2]);
+    for (natural_32_bit  i = 0U; i != 4U; ++i)
+        add_half_space(near_corners[i], near_corners[(i + 1U) % 4U], far_corners[i]);
+}
+
+
+template<typename T>
+T  get_value_or_default(std::string const&  key, boost::property_tree::ptree const&  config, T const  default_value)
+{
+    return config.count(key) == 0UL ? default_value : get_value<T>(key, config);
+}
 
 
 std::function<bool(com::object_guid, angeo::COLLISION_CLASS)>  parse_filter(
@@ -131,7 +176,11 @@ sight_controller::ray_cast_config::ray_cast_config(
                     get_ptree("collider_filter", config),
                     get_value<bool>("ignore_disabled_sensors", config),
                     context.get()),
-            detail::parse_function(get_value<std::string>("depth_image_func", config))
+            detail::parse_function(get_value<std::string>("depth_image_func", config)),
+            detail::get_value_or_default<bool>("do_grid_ray_casts", config, false),
+            detail::get_value_or_default<natural_32_bit>("max_grid_ray_casts_per_round", config, 0U),
+            detail::get_value_or_default<float_32_bit>("max_grid_reprojection_distance", config, 0.25f),
+            detail::get_value_or_default<float_32_bit>("max_grid_reprojection_angle", config, PI() / 18.0f)
             )
 {}
 
@@ -145,7 +194,11 @@ sight_controller::ray_cast_config::ray_cast_config(
         natural_16_bit const  num_cells_along_y_axis_,
         std::function<float_32_bit(float_32_bit)> const&  distribution_of_cells_in_camera_space_,
         std::function<bool(com::object_guid, angeo::COLLISION_CLASS)> const&  collider_filter_,
-        std::function<float_32_bit(float_32_bit)>  depth_image_func_
+        std::function<float_32_bit(float_32_bit)>  depth_image_func_,
+        bool const  do_grid_ray_casts_,
+        natural_32_bit const  max_grid_ray_casts_per_round_,
+        float_32_bit const  max_grid_reprojection_distance_,
+        float_32_bit const  max_grid_reprojection_angle_
         )
     : do_directed_ray_casts(do_directed_ray_casts_)
     , num_random_ray_casts_per_second(num_random_ray_casts_per_second_)
@@ -156,6 +209,10 @@ sight_controller::ray_cast_config::ray_cast_config(
     , distribution_of_cells_in_camera_space(distribution_of_cells_in_camera_space_)
     , collider_filter(collider_filter_)
     , depth_image_func(depth_image_func_)
+    , do_grid_ray_casts(do_grid_ray_casts_)
+    , max_grid_ray_casts_per_round(max_grid_ray_casts_per_round_)
+    , max_grid_reprojection_distance(max_grid_reprojection_distance_)
+    , max_grid_reprojection_angle(max_grid_reprojection_angle_)
 {
     ASSUMPTION(
         max_ray_cast_info_life_time_in_seconds >= 0.0f &&
@@ -163,7 +220,9 @@ sight_controller::ray_cast_config::ray_cast_config(
         num_cells_along_y_axis > 0U &&
         distribution_of_cells_in_camera_space.operator bool() &&
         collider_filter.operator bool() &&
-        depth_image_func.operator bool()
+        depth_image_func.operator bool() &&
+        max_grid_reprojection_distance >= 0.0f &&
+        max_grid_reprojection_angle >= 0.0f
         );
 }
 
@@ -201,19 +260,47 @@ sight_controller::sight_controller(
     , m_directed_ray_casts_in_time()
     , m_random_ray_casts_in_time()
     , m_depth_image(ray_cast_config_.num_cells_along_x_axis * ray_cast_config_.num_cells_along_y_axis, 0.0f)
+    , m_depth_grid() // initialised below, if needed
+    , m_depth_grid_reprojected()
+    , m_depth_grid_order() // initialised below, if needed
+    , m_depth_grid_camera()
+    , m_grid_cells_to_cast()
+    , m_grid_ray_origins()
+    , m_grid_ray_ends()
+    , m_grid_ray_colliders()
+    , m_grid_ray_parameters()
     , m_current_time(0.0)
     , m_generator()
     , m_random_ray_casts_time_buffer(0.0f)
     , m_motion_templates(motion_templates)
     , m_binding(binding)
-{}
+{
+    if (m_ray_cast_config.do_grid_ray_casts)
+    {
+        natural_32_bit const  nx = m_ray_cast_config.num_cells_along_x_axis;
+        natural_32_bit const  ny = m_ray_cast_config.num_cells_along_y_axis;
+        natural_32_bit const  tile_size = 4U;
+
+        m_depth_grid.resize(nx * ny, depth_grid_cell{ ray_cast_info(), -1.0 });
+        for (natural_32_bit  i = 0U; i != nx * ny; ++i)
+            m_depth_grid.at(i).info.collider_guid = com::invalid_object_guid();
+        for (natural_32_bit  tile_y = 0U; tile_y < ny; tile_y += tile_size)
+            for (natural_32_bit  tile_x = 0U; tile_x < nx; tile_x += tile_size)
+                for (natural_32_bit  y = tile_y, y_end = std::min(ny, tile_y + tile_size); y < y_end; ++y)
+                    for (natural_32_bit  x = tile_x, x_end = std::min(nx, tile_x + tile_size); x < x_end; ++x)
+                        m_depth_grid_order.push_back(x + y * nx);
+        INVARIANT(m_depth_grid_order.size() == m_depth_grid.size());
+    }
+}
 
 
 void  sight_controller::next_round(float_32_bit const  time_step_in_seconds)
 {
     TMPROF_BLOCK();
 
-    if (!m_ray_cast_config.do_directed_ray_casts && m_ray_cast_config.num_random_ray_casts_per_second == 0U)
+    if (!m_ray_cast_config.do_directed_ray_casts &&
+            m_ray_cast_config.num_random_ray_casts_per_second == 0U &&
+            !m_ray_cast_config.do_grid_ray_casts)
         return;
 
     update_camera(time_step_in_seconds);
@@ -235,8 +322,13 @@ void  sight_controller::next_round(float_32_bit const  time_step_in_seconds)
         erase_obsolete_ray_casts(m_random_ray_casts_in_time);
         perform_random_ray_casts(time_step_in_seconds, from_camera_matrix);
     }
-
-    if (m_ray_cast_config.do_update_depth_image)
+    if (m_ray_cast_config.do_grid_ray_casts)
+    {
+        perform_grid_ray_casts(from_camera_matrix);
+        if (m_ray_cast_config.do_update_depth_image)
+            update_depth_image_from_depth_grid();
+    }
+    else if (m_ray_cast_config.do_update_depth_image)
     {
         std::fill(m_depth_image.begin(), m_depth_image.end(), 0.0f);
         update_depth_image(m_directed_ray_casts_in_time);
@@ -249,7 +341,7 @@ void  sight_controller::erase_obsolete_ray_casts(ray_casts_in_time&  ray_casts)
 {
     while (!ray_casts.empty() && (float_32_bit)(m_current_time - ray_casts.begin()->first) >=
                                            m_ray_cast_config.max_ray_cast_info_life_time_in_seconds)
-        ray_casts.erase(ray_casts.begin());
+        ray_casts.pop_front();
 }
 
 
@@ -353,13 +445,30 @@ void  sight_controller::update_camera(float_32_bit const  time_step_in_seconds)
 
 void  sight_controller::perform_directed_ray_casts(matrix44 const&  from_camera_matrix)
 {
+    TMPROF_BLOCK();
+
     com::simulation_context const&  ctx = *m_binding->context;
 
     matrix44  to_camera_matrix;
     angeo::to_base_matrix(*get_camera()->coordinate_system(), to_camera_matrix);
 
+    std::vector<std::pair<vector3, vector3> >  frustum_half_spaces;
+    vector3  frustum_min_corner, frustum_max_corner;
+    detail::compute_camera_frustum_in_world_space(
+            *get_camera(),
+            from_camera_matrix,
+            frustum_half_spaces,
+            frustum_min_corner,
+            frustum_max_corner
+            );
+
+    // Only colliders of agents and sensors are targets of directed ray casts.
     auto const  collider_acceptor = 
         [this, &ctx, &to_camera_matrix, &from_camera_matrix](com::object_guid const  collider_guid) -> bool {
+            com::object_guid const  owner_guid = ctx.owner_of_collider(collider_guid);
+            if (owner_guid == com::invalid_object_guid() ||
+                    (owner_guid.kind != com::OBJECT_KIND::AGENT && owner_guid.kind != com::OBJECT_KIND::SENSOR))
+                return true;
             if (!get_ray_cast_config().collider_filter(collider_guid, ctx.collision_class_of(collider_guid)))
                 return true;
             angeo::coordinate_system const&  frame = ctx.frame_coord_system_in_world_space(ctx.frame_of_collider(collider_guid));
@@ -369,21 +478,19 @@ void  sight_controller::perform_directed_ray_casts(matrix44 const&  from_camera_
                 return true;
             ray_cast_info  info;
             if (perform_ray_cast(camera_coords_01, from_camera_matrix, info)/* && info.collider_guid == collider_guid */)
-                m_directed_ray_casts_in_time.insert({ m_current_time, info });
+                m_directed_ray_casts_in_time.push_back({ m_current_time, info });
             return true;
         };
 
-    for (com::simulation_context::agent_guid_iterator  agent_it = ctx.agents_begin(), agent_end = ctx.agents_end();
-            agent_it != agent_end; ++agent_it)
-    {
-        std::unordered_set<com::object_guid> const&  agent_colliders = ctx.colliders_of_agent(*agent_it);
-        for (auto  collider_it = agent_colliders.begin(); collider_it != agent_colliders.end(); ++collider_it)
-            collider_acceptor(*collider_it);
-    }
-
-    for (com::simulation_context::sensor_guid_iterator  sensor_it = ctx.sensors_begin(), sensor_end = ctx.sensors_end();
-            sensor_it != sensor_end; ++sensor_it)
-        collider_acceptor(ctx.collider_of_sensor(*sensor_it));
+    ctx.find_colliders_in_convex_volume(
+            frustum_half_spaces,
+            frustum_min_corner,
+            frustum_max_corner,
+            true,
+            true,
+            0U,
+            collider_acceptor
+            );
 }
 
 
@@ -402,7 +509,7 @@ void  sight_controller::perform_random_ray_casts(float_32_bit const  time_step_i
                             ),
                     from_camera_matrix,
                     info))
-            m_random_ray_casts_in_time.insert({ m_current_time, info });
+            m_random_ray_casts_in_time.push_back({ m_current_time, info });
 
     }
 }
@@ -414,40 +521,62 @@ bool  sight_controller::perform_ray_cast(
         ray_cast_info&  result
         ) const
 {
-    result.cell_x = std::min(m_ray_cast_config.num_cells_along_x_axis - 1U,
-                             (natural_32_bit)(camera_coords_01(0) * (m_ray_cast_config.num_cells_along_x_axis - 1U) + 0.5f));
-    result.cell_y = std::min(m_ray_cast_config.num_cells_along_y_axis - 1U,
-                             (natural_32_bit)(camera_coords_01(1) * (m_ray_cast_config.num_cells_along_y_axis - 1U) + 0.5f));
+    setup_ray_cast(camera_coords_01, from_camera_matrix, result);
 
-    vector3  ray_begin_in_camera, ray_end_in_camera;
-    get_camera()->ray_points_in_camera_space(camera_coords_01, ray_begin_in_camera, ray_end_in_camera);
-
-    result.ray_origin_in_world_space = transform_point(ray_begin_in_camera, from_camera_matrix);;
-    vector3 const  ray_end = transform_point(ray_end_in_camera, from_camera_matrix);
-
-    result.collider_guid = ctx().ray_cast_to_nearest_collider(
+    float_32_bit  parameter_to_coid;
+    com::object_guid const  collider_guid = ctx().ray_cast_to_nearest_collider(
             result.ray_origin_in_world_space,
-            ray_end,
+            result.ray_origin_in_world_space + result.ray_direction_in_world_space,
             true,
             true,
             0U,
-            &result.parameter_to_coid,
+            &parameter_to_coid,
             m_ray_cast_config.collider_filter
             );
-    if (result.collider_guid == com::invalid_object_guid())
+    if (collider_guid == com::invalid_object_guid())
         return false;
 
+    setup_ray_cast_hit(collider_guid, parameter_to_coid, result);
+
+    return true;
+}
+
+
+void  sight_controller::setup_ray_cast(
+        vector2 const&  camera_coords_01,
+        matrix44 const&  from_camera_matrix,
+        ray_cast_info&  result
+        ) const
+{
+    result.cell_x = std::min(m_ray_cast_config.num_cells_along_x_axis - 1U,
+                             (natural_32_bit)(camera_coords_01(0) * (m_ray_cast_config.num_cells_along_x_axis - 1U) + 0.5f));
+    result.cell_y = std::min(m_ray_cast_config.num_cells_along_y_axis - 1U,
+                             (natural_32_bit)(camera_coords_01(1) * (m_ray_cast_config.num_cells_along_y_axis - 1U) + 0.5f));
+
+    vector3  ray_begin_in_camera, ray_end_in_camera;
+    get_camera()->ray_points_in_camera_space(camera_coords_01, ray_begin_in_camera, ray_end_in_camera);
+
+    result.ray_origin_in_world_space = transform_point(ray_begin_in_camera, from_camera_matrix);
+    result.ray_direction_in_world_space = transform_point(ray_end_in_camera, from_camera_matrix) - result.ray_origin_in_world_space;
     result.camera_coords_of_cell_coords = contract32(ray_begin_in_camera);
-    result.ray_direction_in_world_space = ray_end - result.ray_origin_in_world_space;
+    result.collider_guid = com::invalid_object_guid();
+}
 
+
+void  sight_controller::setup_ray_cast_hit(
+        com::object_guid const  collider_guid,
+        float_32_bit const  parameter_to_coid,
+        ray_cast_info&  result
+        ) const
+{
     auto const  to01 = [](float_32_bit const  x, float_32_bit const  lo, float_32_bit const  hi) {
         return (x - lo) / (hi - lo);
     };
 
+    result.collider_guid = collider_guid;
+    result.parameter_to_coid = parameter_to_coid;
     result.depth_inverted =
             to01(1.0f / result.parameter_to_coid, 1.0f / get_camera()->far_plane(), 1.0f / get_camera()->near_plane());
-
-    return true;
 }
 
 
@@ -463,4 +592,151 @@ void  sight_controller::update_depth_image(ray_casts_in_time const&  ray_casts)
 }
 
 
+void  sight_controller::perform_grid_ray_casts(matrix44 const&  from_camera_matrix)
+{
+    TMPROF_BLOCK();
+
+    reproject_depth_grid(from_camera_matrix);
+
+    // Cells with no data (uncovered by the reprojection) go first, then the obsolete ones.
+    m_grid_cells_to_cast.clear();
+    natural_32_bit const  max_num_casts =
+            m_ray_cast_config.max_grid_ray_casts_per_round == 0U ?
+                    (natural_32_bit)m_depth_grid.size() :
+                    m_ray_cast_config.max_grid_ray_casts_per_round;
+    for (natural_32_bit  cell_index : m_depth_grid_order)
+        if (m_depth_grid.at(cell_index).time < 0.0 && m_grid_cells_to_cast.size() < max_num_casts)
+            m_grid_cells_to_cast.push_back(cell_index);
+    for (natural_32_bit  cell_index : m_depth_grid_order)
+    {
+        depth_grid_cell const&  cell = m_depth_grid.at(cell_index);
+        if (cell.time >= 0.0 && m_grid_cells_to_cast.size() < max_num_casts &&
+                (float_32_bit)(m_current_time - cell.time) >= m_ray_cast_config.max_ray_cast_info_life_time_in_seconds)
+            m_grid_cells_to_cast.push_back(cell_index);
+    }
+    if (m_grid_cells_to_cast.empty())
+        return;
+
+    m_grid_ray_origins.clear();
+    m_grid_ray_ends.clear();
+    for (natural_32_bit  cell_index : m_grid_cells_to_cast)
+    {
+        ray_cast_info&  info = m_depth_grid.at(cell_index).info;
+        setup_ray_cast(camera_coords_of_cell(cell_index), from_camera_matrix, info);
+        m_grid_ray_origins.push_back(info.ray_origin_in_world_space);
+        m_grid_ray_ends.push_back(info.ray_origin_in_world_space + info.ray_direction_in_world_space);
+    }
+
+    ctx().ray_cast_to_nearest_colliders(
+            m_grid_ray_origins,
+            m_grid_ray_ends,
+            true,
+            true,
+            0U,
+            m_grid_ray_colliders,
+            m_grid_ray_parameters,
+            m_ray_cast_config.collider_filter
+            );
+
+    for (natural_32_bit  i = 0U, n = (natural_32_bit)m_grid_cells_to_cast.size(); i != n; ++i)
+    {
+        depth_grid_cell&  cell = m_depth_grid.at(m_grid_cells_to_cast.at(i));
+        if (m_grid_ray_colliders.at(i) != com::invalid_object_guid())
+            setup_ray_cast_hit(m_grid_ray_colliders.at(i), m_grid_ray_parameters.at(i), cell.info);
+        cell.time = m_current_time;
+    }
+}
+
+
+void  sight_controller::reproject_depth_grid(matrix44 const&  from_camera_matrix)
+{
+    TMPROF_BLOCK();
+
+    angeo::coordinate_system const&  camera_coord_system = *get_camera()->coordinate_system();
+    if (camera_coord_system.origin() == m_depth_grid_camera.origin() &&
+            camera_coord_system.orientation().coeffs() == m_depth_grid_camera.orientation().coeffs())
+        return;
+
+    float_32_bit const  cos_half_angle = std::fabs(dot_product(camera_coord_system.orientation(), m_depth_grid_camera.orientation()));
+    bool const  can_reproject =
+            length(camera_coord_system.origin() - m_depth_grid_camera.origin()) <= m_ray_cast_config.max_grid_reprojection_distance &&
+            2.0f * std::acosf(std::min(1.0f, cos_half_angle)) <= m_ray_cast_config.max_grid_reprojection_angle;
+    m_depth_grid_camera = camera_coord_system;
+
+    m_depth_grid_reprojected.resize(m_depth_grid.size());
+    for (depth_grid_cell&  cell : m_depth_grid_reprojected)
+    {
+        cell.info.collider_guid = com::invalid_object_guid();
+        cell.time = -1.0;
+    }
+
+    if (can_reproject)
+    {
+        matrix44  to_camera_matrix;
+        angeo::to_base_matrix(camera_coord_system, to_camera_matrix);
+
+        // Misses cannot be reprojected, so their cells are cast again (unless covered by a reprojected hit).
+        for (depth_grid_cell const&  cell : m_depth_grid)
+        {
+            if (cell.time < 0.0 || cell.info.collider_guid == com::invalid_object_guid())
+                continue;
+
+            vector3 const  hit_point = cell.info.ray_origin_in_world_space +
+                                       cell.info.parameter_to_coid * cell.info.ray_direction_in_world_space;
+            vector2  camera_coords_01;
+            if (!get_camera()->pixel_coordinates_in_01_of_point_in_camera_space(
+                    transform_point(hit_point, to_camera_matrix),
+                    camera_coords_01
+                    ))
+                continue;
+
+            natural_32_bit const  target_index =
+                    std::min(m_ray_cast_config.num_cells_along_x_axis - 1U,
+                             (natural_32_bit)(camera_coords_01(0) * (m_ray_cast_config.num_cells_along_x_axis - 1U) + 0.5f)) +
+                    std::min(m_ray_cast_config.num_cells_along_y_axis - 1U,
+                             (natural_32_bit)(camera_coords_01(1) * (m_ray_cast_config.num_cells_along_y_axis - 1U) + 0.5f)) *
+                    m_ray_cast_config.num_cells_along_x_axis;
+            depth_grid_cell&  target = m_depth_grid_reprojected.at(target_index);
+
+            ray_cast_info  info;
+            setup_ray_cast(camera_coords_of_cell(target_index), from_camera_matrix, info);
+            float_32_bit const  param = dot_product(hit_point - info.ray_origin_in_world_space, info.ray_direction_in_world_space) /
+                                        length_squared(info.ray_direction_in_world_space);
+            if (param <= 0.0f || param >= 1.0f)
+                continue;
+            if (target.time >= 0.0 && target.info.parameter_to_coid <= param)
+                continue;   // The target cell already holds a closer point.
+
+            setup_ray_cast_hit(cell.info.collider_guid, param, info);
+            target.info = info;
+            target.time = cell.time;
+        }
+    }
+
+    m_depth_grid.swap(m_depth_grid_reprojected);
+}
+
+
+void  sight_controller::update_depth_image_from_depth_grid()
+{
+    for (natural_32_bit  i = 0U, n = (natural_32_bit)m_depth_grid.size(); i != n; ++i)
+    {
+        depth_grid_cell const&  cell = m_depth_grid.at(i);
+        m_depth_image.at(i) = cell.time < 0.0 || cell.info.collider_guid == com::invalid_object_guid() ? 0.0f :
+                std::max(0.0f, std::min(1.0f, m_ray_cast_config.depth_image_func(cell.info.depth_inverted)));
+    }
+}
+
+
+vector2  sight_controller::camera_coords_of_cell(natural_32_bit const  cell_index) const
+{
+    natural_32_bit const  nx = m_ray_cast_config.num_cells_along_x_axis;
+    natural_32_bit const  ny = m_ray_cast_config.num_cells_along_y_axis;
+    return {
+        nx > 1U ? (float_32_bit)(cell_index % nx) / (float_32_bit)(nx - 1U) : 0.5f,
+        ny > 1U ? (float_32_bit)(cell_index / nx) / (float_32_bit)(ny - 1U) : 0.5f
+        };
+}
+
+
 }
@@ -1,15 +1,27 @@
 #include <ai/simulator.hpp>
+#include <com/simulation_context.hpp>
 #include <utility/assumptions.hpp>
 #include <utility/invariants.hpp>
 #include <utility/timeprof.hpp>
+#include <algorithm>
 
 namespace ai {
 
 
+struct  simulator::parallel_round_data
+{
+    // Indexed by positions of agents in 'm_agent_ids_in_order'.
+    std::vector<com::simulation_context::requests_buffer_ptr>  requests_of_agents;
+};
+
+
 simulator::simulator()
     : m_agents()
     , m_navsystem(nullptr)
     , m_naveditor(nullptr)
+    , m_workers(std::make_shared<thread_pool>(1U))
+    , m_agent_ids_in_order()
+    , m_parallel_round_data(std::make_shared<parallel_round_data>())
 {}
 
 
@@ -20,13 +32,17 @@ agent_id  simulator::insert_agent(
         )
 {
     ensure_navsystem_exists(binding->context);
-    return m_agents.insert(std::make_shared<agent>(config, motion_templates, m_navsystem, binding));
+    agent_id const  id = m_agents.insert(std::make_shared<agent>(config, motion_templates, m_navsystem, binding));
+    m_agents.at(id)->set_random_seed(id);
+    m_agent_ids_in_order.insert(std::lower_bound(m_agent_ids_in_order.begin(), m_agent_ids_in_order.end(), id), id);
+    return id;
 }
 
 
 void  simulator::erase_agent(agent_id const  id)
 {
     m_agents.erase(id);
+    m_agent_ids_in_order.erase(std::lower_bound(m_agent_ids_in_order.begin(), m_agent_ids_in_order.end(), id));
 }
 
 
@@ -40,6 +56,7 @@ agent const&  simulator::get_agent(agent_id const  id) const
 void  simulator::clear(bool const  also_navsystem)
 {
     m_agents.clear();
+    m_agent_ids_in_order.clear();
     if (also_navsystem && m_navsystem != nullptr)
     {
         m_naveditor->clear();
@@ -54,8 +71,58 @@ void  simulator::next_round(float_32_bit const  time_step_in_seconds, cortex::mo
 
     if (m_naveditor != nullptr)
         m_naveditor->next_round(time_step_in_seconds);
-    for (agent_id  id : m_agents.valid_indices())
-        m_agents.at(id)->next_round(time_step_in_seconds, mock_input_ptr);
+    if (m_workers->num_threads() > 1U && m_agent_ids_in_order.size() > 1UL)
+        next_round_parallel(time_step_in_seconds, mock_input_ptr);
+    else
+        for (agent_id  id : m_agent_ids_in_order)
+            m_agents.at(id)->next_round(time_step_in_seconds, mock_input_ptr);
+}
+
+
+void  simulator::set_num_worker_threads(natural_32_bit const  count)
+{
+    ASSUMPTION(count > 0U);
+    if (count == m_workers->num_threads())
+        return;
+    if (m_naveditor != nullptr)
+        m_naveditor->set_workers(nullptr);
+    m_workers = nullptr;  // Joins the current workers first.
+    m_workers = std::make_shared<thread_pool>(count);
+    if (m_naveditor != nullptr)
+        m_naveditor->set_workers(m_workers);
+}
+
+
+void  simulator::next_round_parallel(float_32_bit const  time_step_in_seconds, cortex::mock_input_props const* const  mock_input_ptr)
+{
+    TMPROF_BLOCK();
+
+    natural_32_bit const  num_agents = (natural_32_bit)m_agent_ids_in_order.size();
+
+    std::vector<com::simulation_context::requests_buffer_ptr>&  buffers = m_parallel_round_data->requests_of_agents;
+    while (buffers.size() < num_agents)
+        buffers.push_back(com::simulation_context::create_requests_buffer());
+
+    try
+    {
+        m_workers->run(num_agents, [this, &buffers, time_step_in_seconds, mock_input_ptr](natural_32_bit const  i, natural_32_bit) {
+            agent&  agent_ref = *m_agents.at(m_agent_ids_in_order.at(i));
+            ASSUMPTION(agent_ref.get_binding()->context->is_frozen());
+            com::simulation_context::begin_recording_requests(*buffers.at(i));
+            try { agent_ref.next_round(time_step_in_seconds, mock_input_ptr); }
+            catch (...) { com::simulation_context::end_recording_requests(); throw; }
+            com::simulation_context::end_recording_requests();
+        });
+    }
+    catch (...)
+    {
+        for (natural_32_bit  i = 0U; i != num_agents; ++i)
+            *buffers.at(i) = com::simulation_context::requests_buffer();
+        throw;
+    }
+
+    for (natural_32_bit  i = 0U; i != num_agents; ++i)
+        m_agents.at(m_agent_ids_in_order.at(i))->get_binding()->context->commit_recorded_requests(*buffers.at(i));
 }
 
 
@@ -66,6 +133,7 @@ void  simulator::ensure_navsystem_exists(simulation_context_const_ptr const  con
         ASSUMPTION(context_ != nullptr);
         m_navsystem = std::make_shared<navsystem>(context_);
         m_naveditor = std::make_shared<naveditor>(m_navsystem);
+        m_naveditor->set_workers(m_workers);
     }
 }
 
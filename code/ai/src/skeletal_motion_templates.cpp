@@ -443,7 +443,8 @@ skeletal_motion_templates_data::skeletal_motion_templates_data(async::finalise_l
 
             motion_template&  record = motions_map[dir_name];
 
-            if (std::filesystem::is_regular_file(entry_pathname / "keyframe0.txt"))
+            if (std::filesystem::is_regular_file(entry_pathname / "keyframe0.txt") ||
+                std::filesystem::is_regular_file(entry_pathname / gfx::keyframes_binary_file_name()))
                 record.keyframes = motion_template::keyframes_type(entry_pathname, 1U, ultimate_finaliser);
 
             if (std::filesystem::is_directory(entry_pathname / "!meta"))
@@ -76,7 +76,9 @@ void  skeleton_interpolator_animation::commit(
 
 
 skeleton_interpolator_look_at::skeleton_interpolator_look_at()
-    : m_joint_rotations()
+    : m_kinematics()
+    , m_kinematics_templates()
+    , m_joint_rotations()
     , m_look_at_target_in_local_space(vector3_zero())
 {}
 
@@ -96,27 +98,20 @@ void  skeleton_interpolator_look_at::interpolate(
 
     tranform_matrices_of_skeleton_bones const  bone_matrices(&frames_to_update, &parents);
 
-    std::vector<angeo::skeleton_kinematics_of_chain_of_bones>  kinematics;
+    if (!(m_kinematics_templates == motion_templates))
+    {
+        angeo::skeleton_kinematics_flat::chain_specs  chains;
+        for (auto const&  name_and_info : motion_templates.look_at())
+            chains.push_back({ name_and_info.second->end_effector_bone, &name_and_info.second->all_bones });
+        m_kinematics = angeo::skeleton_kinematics_flat(chains, motion_templates.joints(), parents, motion_templates.lengths());
+        m_kinematics_templates = motion_templates;
+        m_joint_rotations.clear();
+    }
+    m_kinematics.setup_joint_states_from_pose_frames(motion_templates.pose_frames().get_coord_systems());
+
     std::vector< angeo::look_at_target>  look_at_targets;
-    std::unordered_map<natural_32_bit, angeo::coordinate_system*>  output_frame_pointers;
     for (auto const&  name_and_info : motion_templates.look_at())
     {
-        std::unordered_map<natural_32_bit, angeo::coordinate_system const*>  pose_frame_pointers;
-        for (natural_32_bit  bone : name_and_info.second->all_bones)
-        {
-            pose_frame_pointers.insert({ bone, &motion_templates.pose_frames().get_coord_systems().at(bone) });
-            output_frame_pointers.insert({ bone, &frames_to_update.at(bone) });
-        }
-
-        kinematics.push_back({
-                pose_frame_pointers,
-                name_and_info.second->all_bones,
-                name_and_info.second->end_effector_bone,
-                motion_templates.joints(),
-                parents,
-                motion_templates.lengths()
-                });
-
         angeo::look_at_target  target;
         {
             target.target = parents.at(name_and_info.second->root_bone) == -1 ?
@@ -130,32 +125,27 @@ void  skeleton_interpolator_look_at::interpolate(
         look_at_targets.push_back(target);
     }
 
-    angeo::skeleton_look_at(kinematics, look_at_targets);
+    angeo::skeleton_look_at(m_kinematics, look_at_targets);
 
-    angeo::joint_angle_deltas_of_bones  angle_deltas;
-    angeo::joint_rotation_props_of_bones  joint_definitions;
-    for (angeo::skeleton_kinematics_of_chain_of_bones const&  kin : kinematics)
-        for (auto const&  bone_and_states : kin.joint_states)
-        {
-            auto  it = m_joint_rotations.find(bone_and_states.first);
-            if (it == m_joint_rotations.end())
-                it = m_joint_rotations.insert(bone_and_states).first;
-            auto const  def_it = kin.joint_definitions.find(bone_and_states.first);
-            angeo::skeleton_interpolate_joint_rotation_states(
-                    angle_deltas[bone_and_states.first],
-                    it->second,
-                    bone_and_states.second,
-                    def_it->second,
-                    time_step_in_seconds
-                    );
-            joint_definitions.insert(*def_it);
-        }
-    angeo::skeleton_apply_angle_deltas(m_joint_rotations, angle_deltas, joint_definitions);
-    angeo::skeleton_commit_joint_states_to_frames(output_frame_pointers, m_joint_rotations);
+    if (m_joint_rotations.empty())
+        m_joint_rotations = m_kinematics.dof_states;
+
+    angeo::joint_angle_deltas_vector  angle_deltas;
+    angeo::skeleton_interpolate_joint_rotation_states(
+            angle_deltas,
+            m_joint_rotations,
+            m_kinematics.dof_states,
+            m_kinematics.dof_props,
+            time_step_in_seconds
+            );
+    angeo::skeleton_apply_angle_deltas(m_joint_rotations, angle_deltas, m_kinematics.dof_props);
+    m_kinematics.commit_joint_states_to_frames(m_joint_rotations, frames_to_update);
 }
 
 
 skeleton_interpolator_aim_at::skeleton_interpolator_aim_at()
+    : m_kinematics()
+    , m_kinematics_templates()
 {}
 
 
@@ -174,24 +164,20 @@ void  skeleton_interpolator_aim_at::interpolate(
 
     tranform_matrices_of_skeleton_bones const  bone_matrices(&frames_to_update, &parents);
 
-    for (auto const&  name_and_info : motion_templates.aim_at())
+    if (!(m_kinematics_templates == motion_templates))
     {
-        std::unordered_map<natural_32_bit, angeo::coordinate_system const*>  pose_frame_pointers;
-        std::unordered_map<natural_32_bit, angeo::coordinate_system*>  output_frame_pointers;
-        for (natural_32_bit  bone : name_and_info.second->all_bones)
-        {
-            pose_frame_pointers.insert({ bone, &motion_templates.pose_frames().get_coord_systems().at(bone) });
-            output_frame_pointers.insert({ bone, &frames_to_update.at(bone) });
-        }
+        angeo::skeleton_kinematics_flat::chain_specs  chains;
+        for (auto const&  name_and_info : motion_templates.aim_at())
+            chains.push_back({ name_and_info.second->end_effector_bone, &name_and_info.second->all_bones });
+        m_kinematics = angeo::skeleton_kinematics_flat(chains, motion_templates.joints(), parents, motion_templates.lengths());
+        m_kinematics_templates = motion_templates;
+    }
 
-        angeo::skeleton_kinematics_of_chain_of_bones  kinematics(
-                pose_frame_pointers,
-                name_and_info.second->all_bones,
-                name_and_info.second->end_effector_bone,
-                motion_templates.joints(),
-                parents,
-                motion_templates.lengths()
-                );
+    natural_32_bit  chain = 0U;
+    for (auto const&  name_and_info : motion_templates.aim_at())
+    {
+        // Each chain starts from the pose frames (like when the chains are processed independently).
+        m_kinematics.setup_joint_states_from_pose_frames(motion_templates.pose_frames().get_coord_systems());
 
         angeo::bone_aim_at_targets  aim_at_targets;
         {
@@ -204,9 +190,11 @@ void  skeleton_interpolator_aim_at::interpolate(
             aim_at_targets.push_back(angeo::aim_at_target{ target, name_and_info.second->touch_points.at("pointer") });
         }
 
-        angeo::skeleton_aim_at(kinematics, aim_at_targets);
+        angeo::skeleton_aim_at(m_kinematics, chain, aim_at_targets);
+
+        m_kinematics.commit_target_frames_of_chain(chain, frames_to_update);
 
-        kinematics.commit_target_frames(output_frame_pointers);
+        ++chain;
     }
 }
 
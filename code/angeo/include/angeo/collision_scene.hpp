@@ -146,6 +146,7 @@ struct  collision_scene
     void  clear();
 
     void  on_position_changed(collision_object_id const  coid, matrix44 const&  from_base_matrix);
+    void  on_positions_changed(std::vector<std::pair<collision_object_id, matrix44 const*> > const&  coids_and_matrices);
 
     void  disable_colliding(collision_object_id const  coid_1, collision_object_id const  coid_2);
     void  enable_colliding(collision_object_id const  coid_1, collision_object_id const  coid_2);
@@ -161,6 +162,10 @@ struct  collision_scene
             bool const with_dynamic = true
             );
 
+    // The const search functions rebalance the proximity maps lazily (when an object was inserted, erased,
+    // or moved). Call this function before searching from several threads at once.
+    void  rebalance_proximity_maps_if_needed() const;
+
     void  find_objects_in_proximity_to_axis_aligned_bounding_box(
             vector3 const& min_corner,
             vector3 const& max_corner,
@@ -177,6 +182,19 @@ struct  collision_scene
             collision_object_acceptor const&  acceptor
             ) const;
 
+    // The convex volume (e.g. a camera frustum) is the intersection of the passed half-spaces, each given
+    // by a pair of a point on the boundary plane and a normal vector (not necessarily normalised) pointing
+    // inside the volume. The passed bbox must enclose the volume; it is used for the search in the proximity
+    // maps. Objects whose bbox is completely outside some half-space are not passed to the acceptor.
+    void  find_objects_in_proximity_to_convex_volume(
+            std::vector<std::pair<vector3, vector3> > const&  half_spaces,
+            vector3 const&  min_corner,
+            vector3 const&  max_corner,
+            bool const  search_static,
+            bool const  search_dynamic,
+            collision_object_acceptor const&  acceptor
+            ) const;
+
     void  find_contacts_with_box(
             vector3 const&  half_sizes_along_axes,
             matrix44 const&  from_base_matrix,
@@ -227,6 +245,25 @@ struct  collision_scene
             float_32_bit const  min_parameter_value = 1e-6f
             ) const;
 
+    // Casts all the passed rays (i.e. segments from ray_origins[i] to ray_ends[i]) at once. Consecutive
+    // rays are processed in packets: Candidate objects of a packet are collected by a single search of
+    // the proximity maps (using the bbox of the whole packet) and then all rays of the packet are tested
+    // against them. So, the passed rays should be ordered so that consecutive rays are spatially close
+    // (e.g. rays of a depth image should be passed by tiles rather than by rows).
+    // For each ray i, ray_parameters_to_nearest_coids[i] < 1.0f iff the ray hits nearest_coids[i].
+    void  ray_cast_batch(
+            std::vector<vector3> const&  ray_origins,
+            std::vector<vector3> const&  ray_ends,
+            bool const  search_static,
+            bool const  search_dynamic,
+            std::vector<collision_object_id>&  nearest_coids,
+            std::vector<float_32_bit>&  ray_parameters_to_nearest_coids,
+            std::function<bool(collision_object_id, COLLISION_CLASS)> const&  collider_filter =
+                    [](collision_object_id, COLLISION_CLASS) { return true; },
+            float_32_bit const  min_parameter_value = 1e-6f,
+            natural_32_bit const  num_rays_in_packet = 16U
+            ) const;
+
     vector3  get_object_aabb_min_corner(collision_object_id const  coid) const;
     vector3  get_object_aabb_max_corner(collision_object_id const  coid) const;
 
@@ -11,7 +11,9 @@
 #   include <memory>
 #   include <vector>
 #   include <array>
+#   include <cstring>
 #   include <mutex>
+#   include <atomic>
 
 namespace angeo {
 
@@ -136,15 +138,23 @@ struct proximity_map
             vector3 const& query_bbox_min_corner,
             vector3 const& query_bbox_max_corner,
             std::function<bool(object_type)> const&  output_collector
-            );
+            ) const;
 
     void  find_by_line(
             vector3 const&  line_begin,
             vector3 const&  line_end,
             std::function<bool(object_type)> const&  output_collector
-            );
+            ) const;
+
+    void  enumerate(std::function<bool(object_type, natural_32_bit)> const&  output_collector) const;
 
-    void  enumerate(std::function<bool(object_type, natural_32_bit)> const&  output_collector);
+    // The split structure of the map (i.e., without objects) as 32-bit words in the pre-order of nodes: for each
+    // node the direction of the normal of its split plane (3 for a leaf) followed, for a split node only, by bit
+    // patterns of the three float coordinates of the plane origin. When the structure is imported to an empty map,
+    // insertion of the same objects produces the balanced map without calling 'rebalance'. The import returns the
+    // number of words read, or 0 when the words do not start with a valid structure (the map is then unchanged).
+    void  export_structure(std::vector<natural_32_bit>&  output_words) const;
+    natural_64_bit  import_structure(natural_32_bit const* const  words, natural_64_bit const  num_words);
 
     struct  statistics
     {
@@ -191,11 +201,13 @@ struct proximity_map
 
         natural_32_bit  num_objects;
         natural_32_bit  num_split_nodes;
-        natural_32_bit  num_searches_by_bbox_in_last_frame; 
+        // The counters of searches are atomic, because the const search functions of 'collision_scene'
+        // may be called from several threads at once.
+        std::atomic<natural_32_bit>  num_searches_by_bbox_in_last_frame;
         natural_32_bit  max_num_searches_by_bbox_till_last_frame;   // I.e. the last frame is not included; see'num_searches_by_bbox_in_last_frame' for the last frame.
-        natural_32_bit  num_searches_by_line_in_last_frame;
+        std::atomic<natural_32_bit>  num_searches_by_line_in_last_frame;
         natural_32_bit  max_num_searches_by_line_till_last_frame;   // I.e. the last frame is not included; see 'num_searches_by_line_in_last_frame' for the last frame.
-        natural_32_bit  num_enumerate_calls_in_last_frame;
+        std::atomic<natural_32_bit>  num_enumerate_calls_in_last_frame;
         natural_32_bit  max_num_enumerate_calls_till_last_frame;    // I.e. the last frame is not included; see 'num_enumerate_calls_in_last_frame' for the last frame.
     };
     statistics const&  get_statistics() const { return m_statistics; }
@@ -252,19 +264,28 @@ private:
             vector3 const& query_bbox_min_corner,
             vector3 const& query_bbox_max_corner,
             std::function<bool(object_type)> const&  output_collector
-            );
+            ) const;
 
     bool  find_by_line(
             split_node* const  node_ptr,
             vector3 const&  line_begin,
             vector3 const&  line_end,
             std::function<bool(object_type)> const&  output_collector
-            );
+            ) const;
 
     bool  enumerate(
             split_node* const  node_ptr,
             natural_32_bit&  output_leaf_node_index,
             std::function<bool(object_type, natural_32_bit)> const&  output_collector
+            ) const;
+
+    static void  export_structure(split_node const* const  node_ptr, std::vector<natural_32_bit>&  output_words);
+    static std::unique_ptr<split_node>  import_structure(
+            natural_32_bit const* const  words,
+            natural_64_bit const  num_words,
+            natural_32_bit const  depth,
+            natural_64_bit&  cursor,
+            natural_32_bit&  num_nodes
             );
 
     void  apply_node_split(split_node* const  node_ptr);
@@ -281,7 +302,7 @@ private:
 
     std::unique_ptr<split_node>  m_root;
 
-    statistics  m_statistics;
+    mutable statistics  m_statistics;
 };
 
 
@@ -541,7 +562,7 @@ void  proximity_map<object_type__>::find_by_bbox(
         vector3 const& query_bbox_min_corner,
         vector3 const& query_bbox_max_corner,
         std::function<bool(object_type)> const&  output_collector
-        )
+        ) const
 {
     TMPROF_BLOCK();
 
@@ -557,7 +578,7 @@ bool  proximity_map<object_type__>::find_by_bbox(
         vector3 const& query_bbox_min_corner,
         vector3 const& query_bbox_max_corner,
         std::function<bool(object_type)> const&  output_collector
-        )
+        ) const
 {
     if (node_ptr->m_split_plane_normal_direction == split_node::SPLIT_PLANE_NORMAL_DIRECTION::NOT_SET)
     {
@@ -601,7 +622,7 @@ void  proximity_map<object_type__>::find_by_line(
         vector3 const&  line_begin,
         vector3 const&  line_end,
         std::function<bool(object_type)> const&  output_collector
-        )
+        ) const
 {
     TMPROF_BLOCK();
 
@@ -617,7 +638,7 @@ bool  proximity_map<object_type__>::find_by_line(
         vector3 const&  line_begin,
         vector3 const&  line_end,
         std::function<bool(object_type)> const&  output_collector
-        )
+        ) const
 {
     if (node_ptr->m_split_plane_normal_direction == split_node::SPLIT_PLANE_NORMAL_DIRECTION::NOT_SET)
     {
@@ -691,7 +712,7 @@ bool  proximity_map<object_type__>::find_by_line(
 
 
 template<typename  object_type__>
-void  proximity_map<object_type__>::enumerate(std::function<bool(object_type, natural_32_bit)> const&  output_collector)
+void  proximity_map<object_type__>::enumerate(std::function<bool(object_type, natural_32_bit)> const&  output_collector) const
 {
     TMPROF_BLOCK();
 
@@ -707,7 +728,7 @@ bool  proximity_map<object_type__>::enumerate(
         split_node* const  node_ptr,
         natural_32_bit&  output_leaf_node_index,
         std::function<bool(object_type, natural_32_bit)> const&  output_collector
-        )
+        ) const
 {
     if (node_ptr->m_split_plane_normal_direction == split_node::SPLIT_PLANE_NORMAL_DIRECTION::NOT_SET)
     {
@@ -724,6 +745,87 @@ bool  proximity_map<object_type__>::enumerate(
 }
 
 
+template<typename  object_type__>
+void  proximity_map<object_type__>::export_structure(std::vector<natural_32_bit>&  output_words) const
+{
+    TMPROF_BLOCK();
+
+    export_structure(m_root.get(), output_words);
+}
+
+
+template<typename  object_type__>
+void  proximity_map<object_type__>::export_structure(split_node const* const  node_ptr, std::vector<natural_32_bit>&  output_words)
+{
+    output_words.push_back((natural_32_bit)node_ptr->m_split_plane_normal_direction);
+    if (node_ptr->m_split_plane_normal_direction == split_node::SPLIT_PLANE_NORMAL_DIRECTION::NOT_SET)
+        return;
+    for (int i = 0; i != 3; ++i)
+    {
+        natural_32_bit  word;
+        std::memcpy(&word, &node_ptr->m_spit_plane_origin(i), sizeof(natural_32_bit));
+        output_words.push_back(word);
+    }
+    export_structure(node_ptr->m_front_child_node.get(), output_words);
+    export_structure(node_ptr->m_back_child_node.get(), output_words);
+}
+
+
+template<typename  object_type__>
+natural_64_bit  proximity_map<object_type__>::import_structure(natural_32_bit const* const  words, natural_64_bit const  num_words)
+{
+    TMPROF_BLOCK();
+
+    ASSUMPTION(m_statistics.num_objects == 0U);
+
+    natural_64_bit  cursor = 0ULL;
+    natural_32_bit  num_nodes = 0U;
+    std::unique_ptr<split_node>  root = import_structure(words, num_words, 0U, cursor, num_nodes);
+    if (root == nullptr)
+        return 0ULL;
+    m_root.swap(root);
+    m_statistics.num_split_nodes = num_nodes;
+    return cursor;
+}
+
+
+template<typename  object_type__>
+std::unique_ptr<typename proximity_map<object_type__>::split_node>  proximity_map<object_type__>::import_structure(
+        natural_32_bit const* const  words,
+        natural_64_bit const  num_words,
+        natural_32_bit const  depth,
+        natural_64_bit&  cursor,
+        natural_32_bit&  num_nodes
+        )
+{
+    // The depth is bounded, so that a corrupted input cannot exhaust the stack.
+    if (cursor >= num_words || depth > 128U)
+        return nullptr;
+    natural_32_bit const  direction = words[cursor++];
+    if (direction > (natural_32_bit)split_node::SPLIT_PLANE_NORMAL_DIRECTION::NOT_SET)
+        return nullptr;
+
+    std::unique_ptr<split_node>  node(new split_node);
+    ++num_nodes;
+    if (direction == (natural_32_bit)split_node::SPLIT_PLANE_NORMAL_DIRECTION::NOT_SET)
+        return node;
+
+    if (cursor + 3ULL > num_words)
+        return nullptr;
+    node->m_split_plane_normal_direction = (typename split_node::SPLIT_PLANE_NORMAL_DIRECTION)direction;
+    for (int i = 0; i != 3; ++i)
+        std::memcpy(&node->m_spit_plane_origin(i), words + cursor++, sizeof(natural_32_bit));
+    node->m_objects.reset();
+    node->m_front_child_node = import_structure(words, num_words, depth + 1U, cursor, num_nodes);
+    if (node->m_front_child_node == nullptr)
+        return nullptr;
+    node->m_back_child_node = import_structure(words, num_words, depth + 1U, cursor, num_nodes);
+    if (node->m_back_child_node == nullptr)
+        return nullptr;
+    return node;
+}
+
+
 template<typename  object_type__>
 void  proximity_map<object_type__>::apply_node_split(split_node* const  node_ptr)
 {
@@ -333,6 +333,112 @@ void  skeleton_aim_at(
         );
 
 
+//////////////////////////////////////////////////////////////////////////////
+// FLAT VARIANT OF THE KINEMATICS OF CHAINS OF BONES                        //
+//////////////////////////////////////////////////////////////////////////////
+
+
+// The same data as in 'skeleton_kinematics_of_chain_of_bones', but for several chains at once (bones
+// can be shared by the chains) and stored in contiguous arrays instead of hash maps. Each bone of
+// the chains is assigned a 'slot'. Slots are ordered by bone indices, so that a parent bone always
+// precedes its children (see the assumption of 'skeleton_compute_child_bones'). Joint rotational
+// degrees of freedom, 'dofs', of all slots are stored in a single array; dofs of slot 's' are
+// those in the range <dofs_begin[s], dofs_begin[s+1]).
+// The structure is supposed to be built only once (for a skeleton) and then reused: Call
+// 'setup_joint_states_from_pose_frames' before each use of the look-at/aim-at algorithms below.
+struct  skeleton_kinematics_flat
+{
+    // Pairs of an end-effector bone and all bones of the chain (see 'skeleton_kinematics_of_chain_of_bones').
+    using  chain_specs = std::vector<std::pair<natural_32_bit, std::unordered_set<natural_32_bit> const*> >;
+
+    skeleton_kinematics_flat();
+    skeleton_kinematics_flat(
+            chain_specs const&  chains,
+            joint_rotation_props_of_bones const&  rotation_props,
+            std::vector<integer_32_bit> const&  parent_bones_,
+            std::vector<float_32_bit> const&  bone_lengths_
+            );
+
+    natural_32_bit  num_slots() const { return (natural_32_bit)bones.size(); }
+    natural_32_bit  num_dofs() const { return (natural_32_bit)dof_props.size(); }
+    natural_32_bit  num_chains() const { return (natural_32_bit)chains_begin.size() - 1U; }
+
+    // The vector is indexed by bones (i.e. it contains frames of all bones of the skeleton).
+    void  setup_joint_states_from_pose_frames(std::vector<coordinate_system> const&  pose_frames);
+
+    // The vector is indexed by dofs.
+    void  apply_angle_deltas(joint_angle_deltas_vector const&  angle_deltas)
+    { skeleton_apply_angle_deltas(dof_states, angle_deltas, dof_props); }
+
+    // Both 'states' and 'output_frames' are indexed by dofs and bones respectively. Updated are only frames of bones in the chains.
+    void  commit_joint_states_to_frames(joint_rotation_state_vector const&  states, std::vector<coordinate_system>&  output_frames) const;
+    void  commit_target_frames(std::vector<coordinate_system>&  output_frames) const
+    { commit_joint_states_to_frames(dof_states, output_frames); }
+    // Updated are only frames of bones in the passed chain.
+    void  commit_target_frames_of_chain(natural_32_bit const  chain, std::vector<coordinate_system>&  output_frames) const;
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////
+    // NEXT FOLLOW IMPLEMENTATION DETAILS - rather do not access from outside of this module.
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // A row of the linear system solved by the look-at and aim-at algorithms (one per dof).
+    struct  ik_info
+    {
+        natural_32_bit  dof;
+        vector3  coefs;
+        float_32_bit  min_angle_delta;
+        float_32_bit  max_angle_delta;
+    };
+
+    void  commit_joint_states_of_slot_to_frame(
+            joint_rotation_state_vector const&  states,
+            natural_32_bit const  slot,
+            coordinate_system&  output_frame
+            ) const;
+    void  update_world_matrices_of_chain(natural_32_bit const  chain) const;
+    // The 'chain_pos' is an index into 'chain_slots' (of the chain) and 'dof' is a global dof index.
+    matrix44 const&  get_world_matrix_of_predecessor_dof(
+            natural_32_bit const  chain,
+            natural_32_bit const  chain_pos,
+            natural_32_bit const  dof
+            ) const;
+
+    std::vector<natural_32_bit>  bones;                 // Slot -> bone.
+    std::vector<float_32_bit>  bone_lengths;            // Slot -> length of the bone.
+    std::vector<natural_32_bit>  slot_chain_counts;     // Slot -> the number of chains containing the slot.
+    std::vector<natural_32_bit>  dofs_begin;            // Slot -> the first dof of the slot; the size is 'num_slots() + 1'.
+    joint_rotation_props_vector  dof_props;             // Dof -> joint rotation props.
+    joint_rotation_state_vector  dof_states;            // Dof -> joint rotation state.
+    std::vector<natural_32_bit>  chains_begin;          // Chain -> the first index to 'chain_slots'; the size is 'num_chains() + 1'.
+    std::vector<natural_32_bit>  chain_slots;           // Slots of each chain in the order from the root bone to the end-effector bone.
+
+    // Scratch buffers of the look-at and aim-at algorithms, kept between calls so that they do not allocate.
+    std::vector<ik_info>  ik_infos;
+    std::vector<float_32_bit>  ik_solution;
+    joint_angle_deltas_vector  angle_deltas;
+    std::vector<bool>  locked_slots;
+};
+
+
+// The same algorithm as 'skeleton_look_at' above; the chains are those of the passed kinematics.
+void  skeleton_look_at(
+        skeleton_kinematics_flat&  kinematics,
+        std::vector<look_at_target> const&  look_at_targets,
+        natural_32_bit const  max_iterations = 5U,
+        natural_32_bit const  max_ik_solver_iterations = 3U
+        );
+
+
+// The same algorithm as 'skeleton_aim_at' above for the chain of the passed index.
+void  skeleton_aim_at(
+        skeleton_kinematics_flat&  kinematics,
+        natural_32_bit const  chain,
+        bone_aim_at_targets const&  aim_at_targets,
+        natural_32_bit const  max_iterations = 5U,
+        natural_32_bit const  max_ik_solver_iterations = 3U
+        );
+
+
 /// Given a parent for a bone (-1 when no parent), the function computes children the bone.
 void  skeleton_compute_child_bones(std::vector<integer_32_bit> const&  parents, std::vector<std::vector<integer_32_bit> >&  children);
 
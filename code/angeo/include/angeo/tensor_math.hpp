@@ -124,6 +124,8 @@ inline scalar  angle(vector3 const& u, vector3 const& v) { return std::acosf(cos
 inline scalar  min_coord(vector3 const&  u) { return u.minCoeff(); }
 inline scalar  max_coord(vector3 const&  u) { return u.maxCoeff(); }
 inline vector3  mul_components(vector3 const& u, vector3 const& v) { return { u(0)* v(0), u(1)* v(1), u(2)* v(2) }; }
+inline vector3  min_components(vector3 const& u, vector3 const& v) { return u.cwiseMin(v); }
+inline vector3  max_components(vector3 const& u, vector3 const& v) { return u.cwiseMax(v); }
 
 inline vector4  expand34(vector3 const& u, scalar h=scalar(1.0)) { return { u(0), u(1), u(2), h }; }
 inline vector3  contract43(vector4 const& u) { return { u(0), u(1), u(2) }; }
@@ -812,6 +812,43 @@ void  collision_scene::on_position_changed(collision_object_id const  coid, matr
 }
 
 
+void  collision_scene::on_positions_changed(std::vector<std::pair<collision_object_id, matrix44 const*> > const&  coids_and_matrices)
+{
+    TMPROF_BLOCK();
+
+    // The batch is processed in three passes: all objects are erased from proximity maps (this needs their old
+    // bounding boxes), then all shapes are moved and finally all objects are inserted back. So, each pass runs
+    // one kind of work over the whole batch, and each map is marked for rebalancing only once.
+    bool  any_static = false;
+    bool  any_dynamic = false;
+    for (auto const&  coid_and_matrix : coids_and_matrices)
+        if (m_dynamic_object_ids.count(coid_and_matrix.first) == 0UL)
+        {
+            m_proximity_static_objects.erase(coid_and_matrix.first);
+            any_static = true;
+        }
+        else
+        {
+            m_proximity_dynamic_objects.erase(coid_and_matrix.first);
+            any_dynamic = true;
+        }
+
+    for (auto const&  coid_and_matrix : coids_and_matrices)
+        update_shape_position(coid_and_matrix.first, *coid_and_matrix.second);
+
+    for (auto const&  coid_and_matrix : coids_and_matrices)
+        if (m_dynamic_object_ids.count(coid_and_matrix.first) == 0UL)
+            m_proximity_static_objects.insert(coid_and_matrix.first);
+        else
+            m_proximity_dynamic_objects.insert(coid_and_matrix.first);
+
+    if (any_static)
+        m_does_proximity_static_need_rebalancing = true;
+    if (any_dynamic)
+        m_does_proximity_dynamic_need_rebalancing = true;
+}
+
+
 void  collision_scene::disable_colliding(
             collision_object_id const  coid_1,
             collision_object_id const  coid_2
@@ -1009,6 +1046,39 @@ void  collision_scene::find_objects_in_proximity_to_axis_aligned_bounding_box(
 }
 
 
+void  collision_scene::find_objects_in_proximity_to_convex_volume(
+        std::vector<std::pair<vector3, vector3> > const&  half_spaces,
+        vector3 const&  min_corner,
+        vector3 const&  max_corner,
+        bool const  search_static,
+        bool const  search_dynamic,
+        collision_object_acceptor const&  acceptor
+        ) const
+{
+    TMPROF_BLOCK();
+
+    find_objects_in_proximity_to_axis_aligned_bounding_box(
+            min_corner,
+            max_corner,
+            search_static,
+            search_dynamic,
+            [this, &half_spaces, &acceptor](collision_object_id const  coid) -> bool {
+                    vector3 const  lo = get_object_aabb_min_corner(coid);
+                    vector3 const  hi = get_object_aabb_max_corner(coid);
+                    for (auto const&  point_and_normal : half_spaces)
+                    {
+                        vector3 const&  n = point_and_normal.second;
+                        // The corner of the bbox furthest in the direction of the normal.
+                        vector3 const  corner{ n(0) >= 0.0f ? hi(0) : lo(0), n(1) >= 0.0f ? hi(1) : lo(1), n(2) >= 0.0f ? hi(2) : lo(2) };
+                        if (dot_product(corner - point_and_normal.first, n) < 0.0f)
+                            return true;
+                    }
+                    return acceptor(coid);
+                }
+            );
+}
+
+
 void  collision_scene::find_objects_in_proximity_to_line(
         vector3 const&  line_begin,
         vector3 const&  line_end,
@@ -1310,6 +1380,104 @@ bool  collision_scene::ray_cast(
 }
 
 
+void  collision_scene::ray_cast_batch(
+        std::vector<vector3> const&  ray_origins,
+        std::vector<vector3> const&  ray_ends,
+        bool const  search_static,
+        bool const  search_dynamic,
+        std::vector<collision_object_id>&  nearest_coids,
+        std::vector<float_32_bit>&  ray_parameters_to_nearest_coids,
+        std::function<bool(collision_object_id, COLLISION_CLASS)> const&  collider_filter,
+        float_32_bit const  min_parameter_value,
+        natural_32_bit const  num_rays_in_packet
+        ) const
+{
+    TMPROF_BLOCK();
+
+    ASSUMPTION(ray_origins.size() == ray_ends.size() && num_rays_in_packet > 0U);
+
+    natural_32_bit const  num_rays = (natural_32_bit)ray_origins.size();
+    nearest_coids.assign(num_rays, get_invalid_collision_object_id());
+    ray_parameters_to_nearest_coids.assign(num_rays, 1.0f);
+
+    std::vector<collision_object_id>  candidates;
+    std::vector<vector3>  candidates_min_corners;
+    std::vector<vector3>  candidates_max_corners;
+    for (natural_32_bit  packet_begin = 0U; packet_begin < num_rays; packet_begin += num_rays_in_packet)
+    {
+        natural_32_bit const  packet_end = std::min(num_rays, packet_begin + num_rays_in_packet);
+
+        vector3  packet_min_corner = ray_origins.at(packet_begin);
+        vector3  packet_max_corner = ray_origins.at(packet_begin);
+        for (natural_32_bit  i = packet_begin; i < packet_end; ++i)
+        {
+            packet_min_corner = min_components(packet_min_corner, min_components(ray_origins.at(i), ray_ends.at(i)));
+            packet_max_corner = max_components(packet_max_corner, max_components(ray_origins.at(i), ray_ends.at(i)));
+        }
+
+        candidates.clear();
+        candidates_min_corners.clear();
+        candidates_max_corners.clear();
+        find_objects_in_proximity_to_axis_aligned_bounding_box(
+                packet_min_corner,
+                packet_max_corner,
+                search_static,
+                search_dynamic,
+                [this, &collider_filter, &candidates, &candidates_min_corners, &candidates_max_corners]
+                    (collision_object_id const  coid) -> bool {
+                        if (collider_filter(coid, get_collision_class(coid)))
+                        {
+                            candidates.push_back(coid);
+                            candidates_min_corners.push_back(get_object_aabb_min_corner(coid));
+                            candidates_max_corners.push_back(get_object_aabb_max_corner(coid));
+                        }
+                        return true;
+                    }
+                );
+        if (candidates.empty())
+            continue;
+
+        for (natural_32_bit  i = packet_begin; i < packet_end; ++i)
+        {
+            collision_object_id* const  nearest_coid = &nearest_coids.at(i);
+            float_32_bit* const  ray_parameter_to_nearest_coid = &ray_parameters_to_nearest_coids.at(i);
+            for (natural_32_bit  j = 0U, n = (natural_32_bit)candidates.size(); j < n; ++j)
+            {
+                float_32_bit  param_of_bbox_entry;
+                if (!clip_line_into_bbox(
+                        ray_origins.at(i),
+                        ray_ends.at(i),
+                        candidates_min_corners.at(j),
+                        candidates_max_corners.at(j),
+                        nullptr,
+                        nullptr,
+                        &param_of_bbox_entry,
+                        nullptr
+                        ))
+                    continue;
+                if (param_of_bbox_entry >= *ray_parameter_to_nearest_coid)
+                    continue;   // The object is behind the nearest hit found so far.
+                ray_cast_precise_collision_object_acceptor(
+                        candidates.at(j),
+                        ray_origins.at(i),
+                        ray_ends.at(i),
+                        [nearest_coid, ray_parameter_to_nearest_coid, min_parameter_value]
+                            (collision_object_id const  coid, float_32_bit const  ray_param) -> bool {
+                                if (ray_param >= min_parameter_value && ray_param < *ray_parameter_to_nearest_coid)
+                                {
+                                    *ray_parameter_to_nearest_coid = ray_param;
+                                    *nearest_coid = coid;
+                                }
+                                return true;
+                            },
+                        [](collision_object_id, COLLISION_CLASS) { return true; } // Candidates are already filtered.
+                        );
+            }
+        }
+    }
+}
+
+
 vector3  collision_scene::get_object_aabb_min_corner(collision_object_id const  coid) const
 {
     switch (get_shape_type(coid))
@@ -1650,6 +1818,12 @@ void  collision_scene::insert_dynamic_object(collision_object_id const  coid)
     m_does_proximity_dynamic_need_rebalancing = true;
 }
 
+void  collision_scene::rebalance_proximity_maps_if_needed() const
+{
+    rebalance_static_proximity_map_if_needed();
+    rebalance_dynamic_proximity_map_if_needed();
+}
+
 void  collision_scene::rebalance_static_proximity_map_if_needed() const
 {
     if (m_does_proximity_static_need_rebalancing)
@@ -9,6 +9,8 @@
 #include <utility/timeprof.hpp>
 #include <utility/log.hpp>
 #include <unordered_set>
+#include <map>
+#include <algorithm>
 
 namespace angeo {
 
@@ -314,7 +316,9 @@ struct  skeleton_ik_constraint_system_look_at
         float_32_bit  max_angle_delta;
     };
 
-    using  left_hand_side = std::unordered_map<
+    // Ordered by bone indices, i.e. from the root to the end-effector (parents precede children), because the
+    // solver is greedy and so the order of bones matters.
+    using  left_hand_side = std::map<
             // Index of a bone in the chain.
             natural_32_bit,
             // For each rotational degree of freedom of the joint between the bone and its direct parent bone
@@ -674,6 +678,470 @@ void  skeleton_aim_at(
 }
 
 
+skeleton_kinematics_flat::skeleton_kinematics_flat()
+    : bones()
+    , bone_lengths()
+    , slot_chain_counts()
+    , dofs_begin(1U, 0U)
+    , dof_props()
+    , dof_states()
+    , chains_begin(1U, 0U)
+    , chain_slots()
+    , ik_infos()
+    , ik_solution()
+    , angle_deltas()
+    , locked_slots()
+{}
+
+
+skeleton_kinematics_flat::skeleton_kinematics_flat(
+        chain_specs const&  chains,
+        joint_rotation_props_of_bones const&  rotation_props,
+        std::vector<integer_32_bit> const&  parent_bones_,
+        std::vector<float_32_bit> const&  bone_lengths_
+        )
+    : skeleton_kinematics_flat()
+{
+    TMPROF_BLOCK();
+
+    std::vector<std::vector<natural_32_bit> >  bones_of_chains;
+    std::vector<integer_32_bit>  slot_of_bone(parent_bones_.size(), -1);
+    for (auto const&  end_effector_and_bones : chains)
+    {
+        bones_of_chains.push_back({});
+        for (natural_32_bit  bone = end_effector_and_bones.first;
+             end_effector_and_bones.second->count(bone) != 0ULL;
+             bone = (natural_32_bit)parent_bones_.at(bone))
+        {
+            bones_of_chains.back().push_back(bone);
+            slot_of_bone.at(bone) = 0;
+            if (parent_bones_.at(bone) < 0)
+                break;
+        }
+        INVARIANT(!bones_of_chains.back().empty());
+        std::reverse(bones_of_chains.back().begin(), bones_of_chains.back().end());
+    }
+
+    for (natural_32_bit  bone = 0U, n = (natural_32_bit)slot_of_bone.size(); bone != n; ++bone)
+        if (slot_of_bone.at(bone) >= 0)
+        {
+            ASSUMPTION(parent_bones_.at(bone) < (integer_32_bit)bone);
+            slot_of_bone.at(bone) = (integer_32_bit)bones.size();
+            bones.push_back(bone);
+            bone_lengths.push_back(bone_lengths_.at(bone));
+            slot_chain_counts.push_back(0U);
+            joint_rotation_props_vector const&  joint_props = rotation_props.at(bone);
+            ASSUMPTION(!joint_props.empty());
+            dof_props.insert(dof_props.end(), joint_props.begin(), joint_props.end());
+            dofs_begin.push_back((natural_32_bit)dof_props.size());
+        }
+    dof_states.resize(dof_props.size());
+
+    for (std::vector<natural_32_bit> const&  chain_bones : bones_of_chains)
+    {
+        for (natural_32_bit  bone : chain_bones)
+        {
+            natural_32_bit const  slot = (natural_32_bit)slot_of_bone.at(bone);
+            chain_slots.push_back(slot);
+            ++slot_chain_counts.at(slot);
+        }
+        chains_begin.push_back((natural_32_bit)chain_slots.size());
+    }
+}
+
+
+void  skeleton_kinematics_flat::setup_joint_states_from_pose_frames(std::vector<coordinate_system> const&  pose_frames)
+{
+    TMPROF_BLOCK();
+
+    coordinate_system const  identity_frame = { vector3_zero(), quaternion_identity() };
+    for (natural_32_bit  slot = 0U, n = num_slots(); slot != n; ++slot)
+        for (natural_32_bit  dof = dofs_begin.at(slot), end = dofs_begin.at(slot + 1U); dof != end; ++dof)
+        {
+            joint_rotation_props const&  props = dof_props.at(dof);
+            joint_rotation_state&  state = dof_states.at(dof);
+            bool const  is_first = dof == dofs_begin.at(slot);
+            state.frame = is_first ? pose_frames.at(bones.at(slot)) : identity_frame;
+            state.current_angle = compute_rotation_angle(
+                    props.axis,
+                    props.zero_angle_direction,
+                    is_first ? vector3_from_coordinate_system(props.direction, state.frame) : props.direction
+                    );
+            state.from_bone_to_world_space_matrix = matrix44_identity();
+        }
+}
+
+
+void  skeleton_kinematics_flat::commit_joint_states_to_frames(
+        joint_rotation_state_vector const&  states,
+        std::vector<coordinate_system>&  output_frames
+        ) const
+{
+    TMPROF_BLOCK();
+
+    ASSUMPTION(states.size() == dof_states.size());
+    for (natural_32_bit  slot = 0U, n = num_slots(); slot != n; ++slot)
+        commit_joint_states_of_slot_to_frame(states, slot, output_frames.at(bones.at(slot)));
+}
+
+
+void  skeleton_kinematics_flat::commit_target_frames_of_chain(
+        natural_32_bit const  chain,
+        std::vector<coordinate_system>&  output_frames
+        ) const
+{
+    TMPROF_BLOCK();
+
+    for (natural_32_bit  pos = chains_begin.at(chain), pos_end = chains_begin.at(chain + 1U); pos != pos_end; ++pos)
+        commit_joint_states_of_slot_to_frame(dof_states, chain_slots.at(pos), output_frames.at(bones.at(chain_slots.at(pos))));
+}
+
+
+void  skeleton_kinematics_flat::commit_joint_states_of_slot_to_frame(
+        joint_rotation_state_vector const&  states,
+        natural_32_bit const  slot,
+        coordinate_system&  output_frame
+        ) const
+{
+    natural_32_bit const  begin = dofs_begin.at(slot);
+    natural_32_bit const  end = dofs_begin.at(slot + 1U);
+    from_base_matrix(states.at(begin).frame, states.at(begin).from_bone_to_world_space_matrix);
+    for (natural_32_bit  dof = begin + 1U; dof != end; ++dof)
+    {
+        matrix44  F;
+        from_base_matrix(states.at(dof).frame, F);
+        states.at(dof).from_bone_to_world_space_matrix = states.at(dof - 1U).from_bone_to_world_space_matrix * F;
+    }
+    vector3  S;
+    matrix33  R;
+    decompose_matrix44(states.at(end - 1U).from_bone_to_world_space_matrix, S, R);
+    output_frame.set_origin(S);
+    output_frame.set_orientation(rotation_matrix_to_quaternion(R));
+}
+
+
+void  skeleton_kinematics_flat::update_world_matrices_of_chain(natural_32_bit const  chain) const
+{
+    TMPROF_BLOCK();
+
+    matrix44 const*  last_computed = nullptr;
+    for (natural_32_bit  pos = chains_begin.at(chain), pos_end = chains_begin.at(chain + 1U); pos != pos_end; ++pos)
+    {
+        natural_32_bit const  slot = chain_slots.at(pos);
+        for (natural_32_bit  dof = dofs_begin.at(slot), end = dofs_begin.at(slot + 1U); dof != end; ++dof)
+        {
+            joint_rotation_state const&  state = dof_states.at(dof);
+            from_base_matrix(state.frame, state.from_bone_to_world_space_matrix);
+            if (last_computed != nullptr)
+                state.from_bone_to_world_space_matrix = (*last_computed) * state.from_bone_to_world_space_matrix;
+            last_computed = &state.from_bone_to_world_space_matrix;
+        }
+    }
+}
+
+
+matrix44 const&  skeleton_kinematics_flat::get_world_matrix_of_predecessor_dof(
+        natural_32_bit const  chain,
+        natural_32_bit const  chain_pos,
+        natural_32_bit const  dof
+        ) const
+{
+    static matrix44 const  default_world_matrix = matrix44_identity();
+    if (dof != dofs_begin.at(chain_slots.at(chain_pos)))
+        return dof_states.at(dof - 1U).from_bone_to_world_space_matrix;
+    if (chain_pos == chains_begin.at(chain))
+        return default_world_matrix;    // The root bone of the chain.
+    return dof_states.at(dofs_begin.at(chain_slots.at(chain_pos - 1U) + 1U) - 1U).from_bone_to_world_space_matrix;
+}
+
+
+namespace detail {
+
+
+using  flat_ik_info = skeleton_kinematics_flat::ik_info;
+
+
+// Gauss-Seidel like solver shared by look-at and aim-at; adds the solution to 'angle_deltas' (indexed by dofs).
+void  skeleton_solve_flat_ik_system(
+        std::vector<flat_ik_info> const&  ik_infos,
+        vector3 const&  rhs_goal,
+        natural_32_bit const  max_ik_solver_iterations,
+        std::vector<float_32_bit>&  solution,
+        joint_angle_deltas_vector&  angle_deltas
+        )
+{
+    ASSUMPTION(max_ik_solver_iterations > 0U);
+    solution.assign(ik_infos.size(), 0.0f);
+    vector3  rhs = vector3_zero();
+    float_32_bit const  alpha = 1.0f / ((float_32_bit)max_ik_solver_iterations);
+    for (natural_32_bit  iteration_index = 0U; iteration_index != max_ik_solver_iterations; ++iteration_index)
+        for (natural_32_bit  i = 0U, n = (natural_32_bit)ik_infos.size(); i != n; ++i)
+        {
+            flat_ik_info const&  info = ik_infos[i];
+            float_32_bit const  angle_delta_scaled = alpha * closest_point_on_ray_to_point(
+                    rhs,
+                    info.coefs,
+                    rhs_goal,
+                    info.min_angle_delta - solution[i],
+                    info.max_angle_delta - solution[i],
+                    nullptr
+                    );
+            solution[i] += angle_delta_scaled;
+            rhs += angle_delta_scaled * info.coefs;
+        }
+    for (natural_32_bit  i = 0U, n = (natural_32_bit)ik_infos.size(); i != n; ++i)
+        angle_deltas[ik_infos[i].dof] += solution[i];
+}
+
+
+float_32_bit  skeleton_setup_flat_ik_system_look_at(
+        std::vector<flat_ik_info>&  ik_infos,
+        skeleton_kinematics_flat const&  kinematics,
+        natural_32_bit const  chain,
+        look_at_target const&  look_target,
+        std::vector<bool> const&  locked_slots
+        )
+{
+    TMPROF_BLOCK();
+
+    kinematics.update_world_matrices_of_chain(chain);
+
+    natural_32_bit const  chain_begin = kinematics.chains_begin.at(chain);
+    natural_32_bit const  chain_end = kinematics.chains_begin.at(chain + 1U);
+    natural_32_bit const  end_effector_slot = kinematics.chain_slots.at(chain_end - 1U);
+    matrix44 const&  W = kinematics.dof_states.at(kinematics.dofs_begin.at(end_effector_slot + 1U) - 1U).from_bone_to_world_space_matrix;
+
+    vector3 const  current_dir = transform_vector(look_target.direction, W);
+    vector3 const  target_dir = look_target.target - transform_point(vector3_zero(), W);
+    vector3 const  axis = cross_product(current_dir, target_dir);
+    float_32_bit const  axis_length = length(axis);
+    float_32_bit const  angle_to_reduce = angle(current_dir, target_dir);
+
+    float_32_bit  rhs;
+    vector3  direction;
+    vector3  tangent;
+    vector3  bitangent;
+    if (axis_length < 0.001f || angle_to_reduce < 0.001f)
+    {
+        rhs = 0.0f;
+        direction = tangent = bitangent = vector3_zero();
+    }
+    else
+    {
+        rhs = angle_to_reduce;
+        direction = (1.0f / axis_length) * axis;
+        compute_tangent_space_of_unit_vector(direction, tangent, bitangent);
+    }
+
+    // The solver is greedy, so the order of bones matters: the first ones take the biggest share of the rotation.
+    // As in the map-based variant, bones go in the order of their indices, i.e. from the root to the end-effector.
+    ik_infos.clear();
+    for (natural_32_bit  pos = chain_begin; pos != chain_end; ++pos)
+    {
+        natural_32_bit const  slot = kinematics.chain_slots.at(pos);
+        if (locked_slots.at(slot))
+            continue;
+        for (natural_32_bit  dof = kinematics.dofs_begin.at(slot), end = kinematics.dofs_begin.at(slot + 1U); dof != end; ++dof)
+        {
+            joint_rotation_props const&  joint_definition = kinematics.dof_props.at(dof);
+            joint_rotation_state const&  joint_state = kinematics.dof_states.at(dof);
+
+            vector3 const  velocity = transform_vector(joint_definition.axis, kinematics.get_world_matrix_of_predecessor_dof(chain, pos, dof));
+            ik_infos.push_back({
+                    dof,
+                    { dot_product(direction, velocity), dot_product(tangent, velocity), dot_product(bitangent, velocity) },
+                    -0.5f * joint_definition.max_angle - joint_state.current_angle,
+                     0.5f * joint_definition.max_angle - joint_state.current_angle
+                    });
+        }
+    }
+
+    return rhs;
+}
+
+
+vector3  skeleton_setup_flat_ik_system_aim_at(
+        std::vector<flat_ik_info>&  ik_infos,
+        skeleton_kinematics_flat const&  kinematics,
+        natural_32_bit const  chain,
+        aim_at_target const&  aim_target
+        )
+{
+    TMPROF_BLOCK();
+
+    kinematics.update_world_matrices_of_chain(chain);
+
+    natural_32_bit const  chain_begin = kinematics.chains_begin.at(chain);
+    natural_32_bit const  chain_end = kinematics.chains_begin.at(chain + 1U);
+    natural_32_bit const  end_effector_slot = kinematics.chain_slots.at(chain_end - 1U);
+
+    float_32_bit  chain_length = length(aim_target.source);
+    for (natural_32_bit  pos = chain_begin; pos + 1U < chain_end; ++pos)
+        chain_length += kinematics.bone_lengths.at(kinematics.chain_slots.at(pos));
+
+    vector3 const  chain_root_origin =
+            kinematics.dof_states.at(kinematics.dofs_begin.at(kinematics.chain_slots.at(chain_begin))).frame.origin();
+    vector3  target_dir = aim_target.target - chain_root_origin;
+    float_32_bit const  target_dir_len = length(target_dir);
+
+    vector3 const  target = target_dir_len > chain_length ? 
+            chain_root_origin + (chain_length / target_dir_len) * target_dir :
+            aim_target.target
+            ;
+    vector3 const  source = transform_point(
+            aim_target.source,
+            kinematics.dof_states.at(kinematics.dofs_begin.at(end_effector_slot + 1U) - 1U).from_bone_to_world_space_matrix
+            );
+    vector3  direction = target - source;
+    float_32_bit const  distance = length(direction);
+    vector3  rhs, tangent, bitangent;
+    if (distance < 0.001f)
+        rhs = direction = tangent = bitangent = vector3_zero();
+    else
+    {
+        rhs = vector3{ distance, 0.0f, 0.0f };
+        direction /= distance;
+        compute_tangent_space_of_unit_vector(direction, tangent, bitangent);
+    }
+
+    auto const  bone_origin = [&kinematics, &chain_root_origin, chain_begin](natural_32_bit const  pos) -> vector3 {
+        return pos == chain_begin ?
+                chain_root_origin :
+                transform_point(
+                        vector3_zero(),
+                        kinematics.dof_states.at(kinematics.dofs_begin.at(kinematics.chain_slots.at(pos))).from_bone_to_world_space_matrix
+                        );
+    };
+
+    ik_infos.clear();
+    for (natural_32_bit  pos = chain_end; pos != chain_begin; )
+    {
+        --pos;
+        natural_32_bit const  slot = kinematics.chain_slots.at(pos);
+        vector3 const  radius_vector = (pos + 1U == chain_end ? source : bone_origin(pos + 1U)) - bone_origin(pos);
+        for (natural_32_bit  dof = kinematics.dofs_begin.at(slot), end = kinematics.dofs_begin.at(slot + 1U); dof != end; ++dof)
+        {
+            joint_rotation_props const&  joint_definition = kinematics.dof_props.at(dof);
+            joint_rotation_state const&  joint_state = kinematics.dof_states.at(dof);
+
+            vector3 const  axis_in_world_space = transform_vector(
+                    joint_definition.axis,
+                    kinematics.get_world_matrix_of_predecessor_dof(chain, pos, dof)
+                    );
+            vector3 const  velocity = cross_product(axis_in_world_space, radius_vector);
+            float_32_bit const  MAX_ANGLE_DELTA = PI() / 10.0f;
+            ik_infos.push_back({
+                    dof,
+                    { dot_product(direction, velocity), dot_product(tangent, velocity), dot_product(bitangent, velocity) },
+                    std::max(-MAX_ANGLE_DELTA, -0.5f * joint_definition.max_angle - joint_state.current_angle),
+                    std::min( MAX_ANGLE_DELTA, 0.5f * joint_definition.max_angle - joint_state.current_angle)
+                    });
+        }
+    }
+
+    return rhs;
+}
+
+
+void  skeleton_look_at_iteration_flat(
+        skeleton_kinematics_flat&  kinematics,
+        std::vector<look_at_target> const&  look_at_targets,
+        natural_32_bit const  max_ik_solver_iterations,
+        std::vector<bool> const&  locked_slots,
+        std::vector<flat_ik_info>&  ik_infos,
+        std::vector<float_32_bit>&  solution,
+        joint_angle_deltas_vector&  angle_deltas
+        )
+{
+    TMPROF_BLOCK();
+
+    angle_deltas.assign(kinematics.num_dofs(), 0.0f);
+    for (natural_32_bit  chain = 0U, n = kinematics.num_chains(); chain != n; ++chain)
+    {
+        float_32_bit const  rhs = skeleton_setup_flat_ik_system_look_at(
+                ik_infos,
+                kinematics,
+                chain,
+                look_at_targets.at(chain),
+                locked_slots
+                );
+        skeleton_solve_flat_ik_system(ik_infos, rhs * vector3_unit_x(), max_ik_solver_iterations, solution, angle_deltas);
+    }
+    for (natural_32_bit  slot = 0U, n = kinematics.num_slots(); slot != n; ++slot)
+        if (kinematics.slot_chain_counts.at(slot) > 1U)
+            for (natural_32_bit  dof = kinematics.dofs_begin.at(slot), end = kinematics.dofs_begin.at(slot + 1U); dof != end; ++dof)
+                angle_deltas.at(dof) /= (float_32_bit)kinematics.slot_chain_counts.at(slot);
+
+    kinematics.apply_angle_deltas(angle_deltas);
+}
+
+
+}
+
+
+void  skeleton_look_at(
+        skeleton_kinematics_flat&  kinematics,
+        std::vector<look_at_target> const&  look_at_targets,
+        natural_32_bit const  max_iterations,
+        natural_32_bit const  max_ik_solver_iterations
+        )
+{
+    TMPROF_BLOCK();
+
+    ASSUMPTION(max_iterations > 0U && look_at_targets.size() == kinematics.num_chains());
+
+    std::vector<detail::flat_ik_info>&  ik_infos = kinematics.ik_infos;
+    std::vector<float_32_bit>&  solution = kinematics.ik_solution;
+    joint_angle_deltas_vector&  angle_deltas = kinematics.angle_deltas;
+    std::vector<bool>&  locked_slots = kinematics.locked_slots;
+
+    locked_slots.assign(kinematics.num_slots(), false);
+    for (natural_32_bit  i = 0U; i != max_iterations; ++i)
+        detail::skeleton_look_at_iteration_flat(
+                kinematics, look_at_targets, max_ik_solver_iterations, locked_slots, ik_infos, solution, angle_deltas
+                );
+
+    for (natural_32_bit  slot = 0U, n = kinematics.num_slots(); slot != n; ++slot)
+        locked_slots.at(slot) = kinematics.slot_chain_counts.at(slot) > 1U;
+    detail::skeleton_look_at_iteration_flat(
+            kinematics, look_at_targets, max_ik_solver_iterations, locked_slots, ik_infos, solution, angle_deltas
+            );
+}
+
+
+void  skeleton_aim_at(
+        skeleton_kinematics_flat&  kinematics,
+        natural_32_bit const  chain,
+        bone_aim_at_targets const&  aim_at_targets,
+        natural_32_bit const  max_iterations,
+        natural_32_bit const  max_ik_solver_iterations
+        )
+{
+    TMPROF_BLOCK();
+
+    ASSUMPTION(max_iterations > 0U && chain < kinematics.num_chains());
+
+    if (aim_at_targets.empty())
+        return;
+
+    std::vector<detail::flat_ik_info>&  ik_infos = kinematics.ik_infos;
+    std::vector<float_32_bit>&  solution = kinematics.ik_solution;
+    joint_angle_deltas_vector&  angle_deltas = kinematics.angle_deltas;
+    for (natural_32_bit i = 0U; i != max_iterations; ++i)
+    {
+        angle_deltas.assign(kinematics.num_dofs(), 0.0f);
+        for (aim_at_target const&  target : aim_at_targets)
+        {
+            vector3 const  rhs = detail::skeleton_setup_flat_ik_system_aim_at(ik_infos, kinematics, chain, target);
+            detail::skeleton_solve_flat_ik_system(ik_infos, rhs, max_ik_solver_iterations, solution, angle_deltas);
+        }
+        if (aim_at_targets.size() > 1UL)
+            skeleton_scale_angle_deltas(angle_deltas, 1.0f / (float_32_bit)aim_at_targets.size());
+        kinematics.apply_angle_deltas(angle_deltas);
+    }
+}
+
+
 void  skeleton_compute_child_bones(std::vector<integer_32_bit> const&  parents, std::vector<std::vector<integer_32_bit> >&  children)
 {
     children.clear();
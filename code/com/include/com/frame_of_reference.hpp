@@ -33,6 +33,11 @@ struct  frames_provider
     angeo::coordinate_system_explicit const&  frame_explicit_in_world_space(frame_id const  id) const;
     matrix44 const&  world_matrix(frame_id const  id) const;
 
+    // Computes all lazily updated data of all frames invalidated since the last call, so that the const
+    // functions above do not write into the frames (and so they can be called from several threads at
+    // once) until some frame is modified again.
+    void  update_cached_data() const;
+
     void  translate(frame_id const  id, vector3 const&  shift);
     void  rotate(frame_id const  id, quaternion const&  rotation);
     void  set_origin(frame_id const  id, vector3 const&  new_origin);
@@ -62,11 +67,13 @@ private:
         mutable bool  is_frame_in_world_space_valid;
         mutable bool  is_frame_in_world_space_explicit_valid;
         mutable bool  is_world_matrix_valid;
+        mutable bool  is_in_invalidated;
     };
 
     void  invalidate(frame_id const  id) const;
 
     dynamic_array<frame_of_reference, frame_id>  m_frames;
+    mutable std::vector<frame_id>  m_invalidated; // Ids of frames to be updated in 'update_cached_data'; some may be erased already.
 };
 
 
@@ -34,6 +34,7 @@
 #   include <vector>
 #   include <list>
 #   include <string>
+#   include <array>
 #   include <functional>
 #   include <algorithm>
 #   include <memory>
@@ -134,17 +135,22 @@ struct  simulation_context
     {
         using  names_to_guids_map = std::unordered_map<std::string, object_guid>;
         using  kinds_to_names_map = std::unordered_map<OBJECT_KIND, std::unordered_set<std::string> >;
+        using  kinds_to_guids_array = std::array<std::vector<object_guid>, get_num_object_kinds()>;
         folder_content_type();
         folder_content_type(std::string const&  folder_name, object_guid const  parent_folder_guid);
+        void  insert_child_folder(object_guid const  guid, std::string const&  name);
+        void  erase_child_folder(std::string const&  name);
         void  insert_content(OBJECT_KIND const  kind, object_guid const  guid);
         void  insert_content(OBJECT_KIND const  kind, object_guid const  guid, std::string const&  name);
         void  erase_content(OBJECT_KIND const  kind);
         void  erase_content(std::string const&  name, OBJECT_KIND const  kind);
+        std::vector<object_guid> const&  guids_of_kind(OBJECT_KIND const  kind) const { return content_of_kind.at(as_number(kind)); }
         std::string  folder_name;
         object_guid  parent_folder;
         names_to_guids_map  child_folders;    // Only folder guids.
         names_to_guids_map  content;          // All other guids.
         kinds_to_names_map  content_index;    // The 'content' split by object kinds.
+        kinds_to_guids_array  content_of_kind;// Guids of 'child_folders' and 'content' split by object kinds (no string lookups).
     };
 
     using  folder_visitor_type = std::function<bool(object_guid, folder_content_type const&)>;
@@ -200,6 +206,7 @@ struct  simulation_context
     angeo::coordinate_system const&  frame_coord_system_in_world_space(object_guid const  frame_guid) const;
     angeo::coordinate_system_explicit const&  frame_explicit_coord_system_in_world_space(object_guid const  frame_guid) const;
     matrix44 const&  frame_world_matrix(object_guid const  frame_guid) const;
+    std::vector<object_guid> const&  colliders_of_frame(object_guid const  frame_guid) const;
     object_guid  insert_frame(object_guid const  under_folder_guid, object_guid const  parent_frame_guid,
                               vector3 const  origin, quaternion const  orientation, bool const  relative_to_parent = false) const;
     object_guid  insert_frame(object_guid const  under_folder_guid, object_guid const  parent_frame_guid,
@@ -223,6 +230,9 @@ struct  simulation_context
     void  frame_relocate(object_guid const  frame_guid, angeo::coordinate_system const&  new_coord_system,
                          bool const  relative_to_parent = false);
     void  frame_relocate_relative_to_parent(object_guid const  frame_guid, object_guid const  relocation_frame_guid);
+    // Relocates all colliders bound to the passed frames (see 'colliders_of_frame') to world matrices of
+    // those frames. The collision scenes are updated in batches (one batch per scene).
+    void  relocate_colliders_of_frames(std::vector<object_guid> const&  frame_guids);
 
     /////////////////////////////////////////////////////////////////////////////////////
     // BATCHES API
@@ -394,6 +404,31 @@ struct  simulation_context
                     [](object_guid, angeo::COLLISION_CLASS) { return true; },
             float_32_bit const  min_parameter_value = 1e-6f
             ) const;
+    // A batched version of the function above; see 'angeo::collision_scene::ray_cast_batch' for
+    // the recommended order of rays. For rays hitting nothing the output guid is invalid_object_guid().
+    void  ray_cast_to_nearest_colliders(
+            std::vector<vector3> const&  ray_origins,
+            std::vector<vector3> const&  ray_ends,
+            bool const  search_static,
+            bool const  search_dynamic,
+            collision_scene_index const  scene_index,
+            std::vector<object_guid>&  output_nearest_colliders,
+            std::vector<float_32_bit>&  output_ray_parameters_to_nearest_colliders,
+            std::function<bool(object_guid, angeo::COLLISION_CLASS)> const&  collider_filter =
+                    [](object_guid, angeo::COLLISION_CLASS) { return true; },
+            float_32_bit const  min_parameter_value = 1e-6f
+            ) const;
+    // See 'angeo::collision_scene::find_objects_in_proximity_to_convex_volume'. The search terminates
+    // when the acceptor returns false.
+    void  find_colliders_in_convex_volume(
+            std::vector<std::pair<vector3, vector3> > const&  half_spaces,
+            vector3 const&  min_corner,
+            vector3 const&  max_corner,
+            bool const  search_static,
+            bool const  search_dynamic,
+            collision_scene_index const  scene_index,
+            std::function<bool(object_guid)> const&  acceptor
+            ) const;
     void  request_enable_collider(object_guid const  collider_guid, bool const  state) const;
     void  request_enable_colliding(object_guid const  collider_1, object_guid const  collider_2, const bool  state) const;
     void  request_enable_colliding(object_guid const  base_folder_guid_1, std::string const&  relative_path_to_collider_1,
@@ -691,6 +726,10 @@ struct  simulation_context
     void  erase_agent(object_guid const  agent_guid);
     void  generate_navigation2d_data_from_collider(object_guid const  collider_guid_);
     void  delete_navigation2d_data_generated_from_collider(object_guid const  collider_guid_);
+    // Navigation data generated from colliders are baked to (and then loaded from) files in this directory.
+    // An empty path (the default) disables the baking.
+    void  set_navigation_bake_dir(std::string const&  bake_dir);
+    std::string  get_navigation_bake_dir() const;
 
     /////////////////////////////////////////////////////////////////////////////////////
     // COLLISION CONTACTS API
@@ -754,6 +793,9 @@ struct  simulation_context
     std::string  to_absolute_path(object_guid const  guid) const;
     object_guid  from_relative_path(object_guid const  base_guid, std::string const&  relative_path) const;
     std::string  to_relative_path(object_guid const  guid, object_guid const  relative_base_guid) const;
+    // Changes whenever resolved paths may become invalid (i.e. whenever the access path caches are cleared).
+    // So, clients caching resolved guids can detect when to drop their caches.
+    natural_64_bit  path_caches_generation() const { return m_path_caches_generation; }
 
     /////////////////////////////////////////////////////////////////////////////////////
     // SCENE IMPORT/EXPORT API
@@ -777,6 +819,7 @@ struct  simulation_context
     /////////////////////////////////////////////////////////////////////////////////////
 
     bool  has_pending_requests() const;
+    bool  has_pending_late_requests() const;
 
     // Disabled (not const) for modules.
 
@@ -798,6 +841,33 @@ struct  simulation_context
     std::unordered_set<object_guid> const&  relocated_frame_guids() const { return m_relocated_frame_guids; }
     void  clear_relocated_frame_guids();
 
+    /////////////////////////////////////////////////////////////////////////////////////
+    // PARALLEL ACCESS API
+    /////////////////////////////////////////////////////////////////////////////////////
+
+    // While the context is frozen, its const functions can be called from several threads at once.
+    // Freezing computes all lazily updated data (e.g., frames in the world space) in advance and
+    // stops filling the access path caches. A thread calling request functions of a frozen context
+    // must record them into its own buffer (see 'begin_recording_requests'). The recorded requests
+    // are moved into the context by 'commit_recorded_requests', in the order chosen by the caller.
+
+    struct  requests_buffer;
+    using  requests_buffer_ptr = std::shared_ptr<requests_buffer>;
+
+    bool  is_frozen() const { return m_frozen; }
+
+    static requests_buffer_ptr  create_requests_buffer();
+    // Requests issued from the calling thread go to 'buffer' till 'end_recording_requests' is called.
+    static void  begin_recording_requests(requests_buffer&  buffer);
+    static void  end_recording_requests();
+    // Moves the recorded requests behind the pending ones (like if they were issued now); 'buffer' becomes empty.
+    void  commit_recorded_requests(requests_buffer&  buffer) const;
+
+    // Disabled (not const) for modules.
+
+    void  freeze();
+    void  unfreeze();
+
     /////////////////////////////////////////////////////////////////////////////////////
     // SCENE CLEAR API
     /////////////////////////////////////////////////////////////////////////////////////
@@ -825,7 +895,18 @@ private:
         std::string  element_name;
     };
 
-    using  folder_element_frame = folder_element<frame_id>;
+    struct  folder_element_frame : public folder_element<frame_id>
+    {
+        folder_element_frame()
+            : base_type()
+            , colliders()
+        {}
+        folder_element_frame(module_specific_id const  id_, index_type const  folder_index_, std::string const&  name_)
+            : base_type(id_, folder_index_, name_)
+            , colliders()
+        {}
+        std::vector<object_guid>  colliders; // Colliders whose 'frame' is this frame.
+    };
 
     struct  folder_element_batch : public folder_element<std::string>
     {
@@ -955,6 +1036,31 @@ private:
     std::unordered_set<object_guid>  m_invalidated_guids;
     std::unordered_set<object_guid>  m_relocated_frame_guids;
 
+    std::vector<std::vector<std::pair<angeo::collision_object_id, matrix44 const*> > >  m_colliders_relocation_batches;
+
+    /////////////////////////////////////////////////////////////////////////////////////
+    // ACCESS PATH CACHES
+    /////////////////////////////////////////////////////////////////////////////////////
+
+    // INVARIANT:
+    //      The caches below hold only successfully resolved paths. Since names of objects never change and
+    //      an insertion cannot make an already resolved path ambiguous, the caches are invalidated (cleared)
+    //      only when an object or a folder is erased (because its guid may be reused later).
+    //      The caches are not extended while the context is frozen (see 'freeze').
+
+    void  invalidate_path_caches();
+
+    mutable std::unordered_map<std::string, object_guid>  m_absolute_paths_to_guids;
+    mutable std::unordered_map<object_guid, std::unordered_map<std::string, object_guid> >  m_relative_paths_to_guids;
+    mutable std::unordered_map<object_guid, std::string>  m_guids_to_absolute_paths;
+    natural_64_bit  m_path_caches_generation;
+
+    /////////////////////////////////////////////////////////////////////////////////////
+    // PARALLEL ACCESS
+    /////////////////////////////////////////////////////////////////////////////////////
+
+    bool  m_frozen;
+
     /////////////////////////////////////////////////////////////////////////////////////
     // CACHES
     /////////////////////////////////////////////////////////////////////////////////////
@@ -993,9 +1099,6 @@ private:
         float_32_bit  initial_value;
     };
 
-    mutable std::list<REQUEST_EARLY_KIND>  m_pending_requests_early;
-    mutable std::list<request_data_insertion_of_custom_constraint> m_requests_early_insert_custom_constraint;
-    mutable std::list<request_data_insertion_of_instant_constraint> m_requests_early_insert_instant_constraint;
 
     /////////////////////////////////////////////////////////////////////////////////////
     // REQUESTS HANDLING
@@ -1090,36 +1193,58 @@ private:
         matrix33  inverted_inertia_tensor;
     };
 
-    mutable std::list<REQUEST_KIND>  m_pending_requests;
-    mutable std::list<object_guid>  m_requests_erase_folder;
-    mutable std::list<object_guid>  m_requests_erase_frame;
-    mutable std::list<request_data_relocate_frame>  m_requests_relocate_frame;
-    mutable std::list<request_data_set_parent_frame>  m_requests_set_parent_frame;
-    mutable std::list<object_guid>  m_requests_erase_batch;
-    mutable std::list<request_data_enable_collider>  m_requests_enable_collider;
-    mutable std::list<request_data_enable_colliding>  m_requests_enable_colliding;
-    mutable std::list<request_data_enable_colliding_by_path>  m_requests_enable_colliding_by_path;
-    mutable std::list<request_data_insert_collider_box>  m_requests_insert_collider_box;
-    mutable std::list<request_data_insert_collider_capsule>  m_requests_insert_collider_capsule;
-    mutable std::list<request_data_insert_collider_sphere>  m_requests_insert_collider_sphere;
-    mutable std::list<object_guid>  m_requests_erase_collider;
-    mutable std::list<request_data_insert_rigid_body>  m_requests_insert_rigid_body;
-    mutable std::list<object_guid>  m_requests_erase_rigid_body;
-    mutable std::list<request_data_set_velocity>  m_requests_set_linear_velocity;
-    mutable std::list<request_data_set_velocity_by_path>  m_requests_set_linear_velocity_by_path;
-    mutable std::list<request_data_set_velocity>  m_requests_set_angular_velocity;
-    mutable std::list<request_data_set_velocity_by_path>  m_requests_set_angular_velocity_by_path;
-    mutable std::list<request_data_mul_velocity>  m_requests_mul_linear_velocity;
-    mutable std::list<request_data_mul_velocity_by_path>  m_requests_mul_linear_velocity_by_path;
-    mutable std::list<request_data_mul_velocity>  m_requests_mul_angular_velocity;
-    mutable std::list<request_data_mul_velocity_by_path>  m_requests_mul_angular_velocity_by_path;
-    mutable std::list<request_data_set_acceleration_from_source>  m_requests_set_linear_acceleration_from_source;
-    mutable std::list<request_data_set_acceleration_from_source>  m_requests_set_angular_acceleration_from_source;
-    mutable std::list<request_data_del_acceleration_from_source>  m_requests_del_linear_acceleration_from_source;
-    mutable std::list<request_data_del_acceleration_from_source>  m_requests_del_angular_acceleration_from_source;
-    mutable std::list<object_guid>  m_requests_erase_timer;
-    mutable std::list<object_guid>  m_requests_erase_sensor;
-    mutable std::list<object_guid>  m_requests_erase_agent;
+
+public: // Declared in the public section above.
+
+    // All early requests and requests in the order they were issued. The context processes its own
+    // buffer 'm_requests'. Requests issued from a thread recording requests are stored into the buffer
+    // of that thread instead (see 'begin_recording_requests').
+    struct  requests_buffer
+    {
+        // Moves all requests of 'other' behind those in this buffer; 'other' becomes empty.
+        void  splice(requests_buffer&  other);
+
+        std::list<REQUEST_EARLY_KIND>  pending_early;
+        std::list<request_data_insertion_of_custom_constraint>  early_insert_custom_constraint;
+        std::list<request_data_insertion_of_instant_constraint>  early_insert_instant_constraint;
+        std::list<REQUEST_KIND>  pending;
+        std::list<object_guid>  erase_folder;
+        std::list<object_guid>  erase_frame;
+        std::list<request_data_relocate_frame>  relocate_frame;
+        std::list<request_data_set_parent_frame>  set_parent_frame;
+        std::list<object_guid>  erase_batch;
+        std::list<request_data_enable_collider>  enable_collider;
+        std::list<request_data_enable_colliding>  enable_colliding;
+        std::list<request_data_enable_colliding_by_path>  enable_colliding_by_path;
+        std::list<request_data_insert_collider_box>  insert_collider_box;
+        std::list<request_data_insert_collider_capsule>  insert_collider_capsule;
+        std::list<request_data_insert_collider_sphere>  insert_collider_sphere;
+        std::list<object_guid>  erase_collider;
+        std::list<request_data_insert_rigid_body>  insert_rigid_body;
+        std::list<object_guid>  erase_rigid_body;
+        std::list<request_data_set_velocity>  set_linear_velocity;
+        std::list<request_data_set_velocity_by_path>  set_linear_velocity_by_path;
+        std::list<request_data_set_velocity>  set_angular_velocity;
+        std::list<request_data_set_velocity_by_path>  set_angular_velocity_by_path;
+        std::list<request_data_mul_velocity>  mul_linear_velocity;
+        std::list<request_data_mul_velocity_by_path>  mul_linear_velocity_by_path;
+        std::list<request_data_mul_velocity>  mul_angular_velocity;
+        std::list<request_data_mul_velocity_by_path>  mul_angular_velocity_by_path;
+        std::list<request_data_set_acceleration_from_source>  set_linear_acceleration_from_source;
+        std::list<request_data_set_acceleration_from_source>  set_angular_acceleration_from_source;
+        std::list<request_data_del_acceleration_from_source>  del_linear_acceleration_from_source;
+        std::list<request_data_del_acceleration_from_source>  del_angular_acceleration_from_source;
+        std::list<object_guid>  erase_timer;
+        std::list<object_guid>  erase_sensor;
+        std::list<object_guid>  erase_agent;
+    };
+
+private:
+
+    requests_buffer&  requests() const;
+
+    mutable requests_buffer  m_requests;
+    static thread_local requests_buffer*  s_recording_requests_buffer;
 
     /////////////////////////////////////////////////////////////////////////////////////
     // LATE REQUESTS HANDLING
@@ -1188,6 +1313,28 @@ private:
 };
 
 
+// Keeps the context frozen (see simulation_context::freeze) for its lifetime, when 'freeze' is true.
+// So, the context is unfrozen also when an exception is thrown.
+struct  simulation_context_freeze_guard
+{
+    simulation_context_freeze_guard(simulation_context&  ctx, bool const  freeze = true)
+        : m_ctx(freeze ? &ctx : nullptr)
+    {
+        if (m_ctx != nullptr)
+            m_ctx->freeze();
+    }
+    ~simulation_context_freeze_guard()
+    {
+        if (m_ctx != nullptr)
+            m_ctx->unfreeze();
+    }
+    simulation_context_freeze_guard(simulation_context_freeze_guard const&) = delete;
+    simulation_context_freeze_guard&  operator=(simulation_context_freeze_guard const&) = delete;
+private:
+    simulation_context*  m_ctx;
+};
+
+
 }
 
 #endif
@@ -13,10 +13,18 @@
 #   include <com/device_simulator.hpp>
 #   include <ai/simulator.hpp>
 #   include <unordered_map>
+#   include <unordered_set>
 #   include <vector>
+#   include <array>
 #   include <string>
 #   include <utility>
+#   include <functional>
 #   include <memory>
+#   include <thread>
+#   include <mutex>
+#   include <condition_variable>
+#   include <atomic>
+#   include <chrono>
 
 namespace com {
 
@@ -30,6 +38,23 @@ struct  simulator : public osi::simulator
         float_32_bit  MAX_SIMULATION_TIME_DELTA;
         natural_8_bit  MAX_NUM_SUB_SIMULATION_STEPS;
 
+        // When true, each simulation sub-step advances the time by exactly MAX_SIMULATION_TIME_DELTA seconds.
+        // The time not consumed by whole sub-steps stays in 'simulation_time_buffer' for the next round, and
+        // scene batches are rendered interpolated between the last two simulated states of their frames.
+        bool  FIXED_TIME_STEP;
+        // When true, the simulation runs (with the fixed time step) in its own thread and at its own rate.
+        // The render (main) thread never waits for the context (except when the console is active). It draws
+        // scene batches from published snapshots of the simulated states and the debug data from a snapshot
+        // captured in the last round it could lock the context. The work of a round accessing the context
+        // (from 'on_begin_simulation' to 'on_end_simulation' and the capture of the debug data) runs only in
+        // rounds where the simulation thread is not in the middle of its steps; the simulation thread then
+        // waits after its steps to let the next round in. 'on_begin_round' and 'on_end_round' are called
+        // in each round, but they may access the context only via 'call_with_context'. The callbacks of the
+        // camera update and the render, and 'do_render_batch' must not access the context in this mode. The
+        // mock input for the cortex is copied each round and passed to the simulation thread. The option is
+        // ignored on WebAssembly.
+        bool  SIMULATE_IN_SEPARATE_THREAD;
+
         float_32_bit  simulation_time_buffer;
         float_32_bit  last_time_step;
 
@@ -63,6 +88,7 @@ struct  simulator : public osi::simulator
         vector3  text_shift;
         vector3  text_ambient_colour;
         std::string  fps_prefix;
+        std::string  sps_prefix;
         gfx::batch  batch_grid;
         gfx::batch  batch_frame;
         gfx::batch  batch_sensory_collision_contact;
@@ -165,13 +191,34 @@ struct  simulator : public osi::simulator
     simulation_context_ptr  context() { return m_context; }
     simulation_context_const_ptr  context() const { return m_context; }
 
-    simulation_configuration&  simulation_config() { return m_simulation_config; }
-    simulation_configuration const&  simulation_config() const { return m_simulation_config; }
+    // While the simulation thread runs, the render (main) thread works with its own copy of the configuration, so
+    // it can change it in any round. The changes are passed to the simulation thread in the next round holding the
+    // context (only the changed fields, so changes made meanwhile by the simulation thread are kept).
+    simulation_configuration&  simulation_config()
+    { return is_render_thread() ? m_render_thread_simulation_config : m_simulation_config; }
+    simulation_configuration const&  simulation_config() const
+    { return is_render_thread() ? m_render_thread_simulation_config : m_simulation_config; }
+
+    // False only in rounds, in which the simulation thread holds the context (see SIMULATE_IN_SEPARATE_THREAD).
+    bool  has_context_in_round() const { return m_has_context_in_round; }
+    // Calls 'action' right away, when the context is accessible, or at the beginning of the next round holding the
+    // context otherwise (in the order of calls). Callbacks use it to access the context, e.g. on a key press, so the
+    // press is not lost in a round without the context.
+    void  call_with_context(std::function<void()> const&  action);
 
     render_configuration&  render_config() { return m_render_config; }
     render_configuration const&  render_config() const { return m_render_config; }
 
     natural_32_bit  FPS() const { return m_FPS; }
+    natural_32_bit  SPS() const { return m_SPS; } // Simulation steps per second.
+    bool  is_simulation_thread_running() const { return m_simulation_thread.joinable(); }
+
+    // Runs the simulation without a window, GL context, or render (e.g., batch runs on machines without
+    // a display). The function first waits till all pending late requests (e.g., scene imports) are
+    // processed, and then it performs 'num_steps' simulation steps, each by exactly MAX_SIMULATION_TIME_DELTA
+    // seconds, as fast as possible. The function is NOT supposed to be called from 'round()'; instead,
+    // call it on an instance which was never passed to 'osi::run()'.
+    void  run_headless(natural_32_bit const  num_steps);
 
     VIEWPORT_TYPE  active_viewport_type() const { return m_active_viewport; }
     std::shared_ptr<gfx::viewport const>  get_viewport_ptr(VIEWPORT_TYPE const  vp_type) const { return m_viewports.at((std::size_t)vp_type); }
@@ -193,10 +240,46 @@ private:
     {
         gfx::batch  batch;
         std::vector<matrix44>  world_matrices;
+        std::vector<matrix44>  matrices_to_pose_bones; // Used only for tasks collected from scene snapshots.
     };
     using  render_tasks_map = std::unordered_map<std::string, render_task_info>;
 
+    struct  scene_snapshot
+    {
+        struct  batch_instances
+        {
+            gfx::batch  batch;
+            std::string  batch_id;
+            std::vector<matrix44>  world_matrices;
+            std::vector<matrix44>  matrices_to_pose_bones;
+        };
+        std::unordered_map<object_guid, batch_instances>  batches;
+        std::chrono::steady_clock::time_point  publish_time;
+    };
+
+    // The debug data of the context to be drawn in a round. It is captured only while the render
+    // thread holds the context, and then it is drawn (possibly repeatedly) without accessing it.
+    struct  debug_snapshot
+    {
+        std::vector<render_task_info>  tasks;
+        std::vector<render_task_info>  wireframe_tasks; // Colliders
+        bool  render_sight_image;
+        std::string  screen_text; // The screen text logged by the work of the round accessing the context.
+    };
+
     void  simulate();
+    std::shared_ptr<ai::cortex::mock_input_props const>  capture_mock_input() const;
+    void  simulation_step(ai::cortex::mock_input_props const* const  mock_input_ptr);
+    void  capture_scene_snapshot(bool const  also_as_previous);
+    void  collect_render_tasks_from_scene_snapshots(render_tasks_map&  render_tasks_opaque,
+                                                    render_tasks_map&  render_tasks_translucent);
+    void  start_simulation_thread();
+    void  stop_simulation_thread();
+    bool  try_lock_context_for_render_thread();
+    void  lock_context_for_render_thread();
+    void  synchronise_simulation_configs();
+    bool  is_render_thread() const { return std::this_thread::get_id() == m_render_thread_id.load(std::memory_order_relaxed); }
+    void  simulation_thread_worker();
     void  update_collision_contacts_and_constraints();
     void  update_collider_locations_of_relocated_frames();
 
@@ -206,15 +289,19 @@ private:
 
     void  render();
     void  render_task(render_task_info const&  task);
+    void  render_batch(gfx::batch  batch, std::vector<matrix44> const&  world_matrices,
+                       std::vector<matrix44> const&  matrices_to_pose_bones);
     void  render_grid();
-    void  render_frames();
-    void  render_colliders();
-    void  render_collision_contacts();
-    void  render_sight_frustums();
-    void  render_sight_contacts();
-    void  render_sight_image();
-    void  render_agent_action_transition_contratints();
-    void  render_ai_navigation_data();
+    void  capture_debug_snapshot();
+    void  render_debug_snapshot();
+    void  collect_render_tasks_of_frames();
+    void  collect_render_tasks_of_colliders();
+    void  collect_render_tasks_of_collision_contacts();
+    void  collect_render_tasks_of_sight_frustums();
+    void  collect_render_tasks_of_sight_contacts();
+    void  update_sight_image();
+    void  collect_render_tasks_of_agent_action_transition_contratints();
+    void  collect_render_tasks_of_ai_navigation_data();
     void  render_text();
 
     gfx::batch  create_batch_for_collider(object_guid const  collider_guid, bool const  is_enabled);
@@ -233,6 +320,11 @@ private:
     VIEWPORT_TYPE  m_active_viewport;
 
     simulation_configuration  m_simulation_config;
+    simulation_configuration  m_render_thread_simulation_config;
+    simulation_configuration  m_render_thread_simulation_config_base; // 'm_simulation_config' at the last synchronisation.
+    std::atomic<std::thread::id>  m_render_thread_id;   // Set only while the simulation thread runs.
+    bool  m_has_context_in_round;
+    std::vector<std::function<void()> >  m_actions_with_context;  // See 'call_with_context'.
     render_configuration  m_render_config;
 
     struct  console_props {
@@ -252,10 +344,47 @@ private:
 
     gfx::gui::text_box  m_output_text_box;
 
+    // Working buffers of 'update_collider_locations_of_relocated_frames' (kept here to avoid allocations per round).
+    std::vector<object_guid>  m_dirty_frames;
+    std::unordered_set<object_guid>  m_dirty_frames_set;
+
     natural_32_bit  m_FPS_num_rounds;
     float_32_bit  m_FPS_time;
     natural_32_bit  m_FPS;
 
+    std::atomic<natural_32_bit>  m_SPS_num_steps;
+    natural_32_bit  m_SPS;
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // FIXED TIME STEP AND SIMULATION THREAD
+    //////////////////////////////////////////////////////////////////////////////////////////
+
+    // Snapshots are published in the order: back -> current -> previous. The render thread only
+    // reads 'current' and 'previous' (under 'm_scene_snapshots_mutex'); the back one is written by
+    // the simulating thread without any lock.
+    std::array<scene_snapshot, 3U>  m_scene_snapshots;
+    natural_8_bit  m_scene_snapshot_previous;
+    natural_8_bit  m_scene_snapshot_current;
+    natural_8_bit  m_scene_snapshot_back;
+    float_32_bit  m_scene_snapshot_interpolation_param; // Used when the simulation does not run in the separate thread.
+    std::mutex  m_scene_snapshots_mutex;
+
+    std::thread  m_simulation_thread;
+    std::atomic<bool>  m_simulation_thread_stop;
+    std::mutex  m_context_mutex;    // The simulation thread holds it during each simulation step.
+    std::unique_lock<std::mutex>  m_context_lock; // The lock of the render (main) thread on 'm_context_mutex'.
+    // The render thread failed to get 'm_context_lock' and wants it in its next round. The simulation thread then
+    // waits on 'm_context_handoff' after its steps, till the render thread gets the lock (or the thread is stopped).
+    bool  m_context_lock_requested; // Guarded by 'm_context_handoff_mutex'.
+    std::mutex  m_context_handoff_mutex;
+    std::condition_variable  m_context_handoff;
+    // The input published by the render thread each round. The first simulation step after a publish gets the 'untaken'
+    // input instead, which holds also keys and buttons pressed in rounds since the last step. So, a press shorter than
+    // a step still reaches the cortex, and only once.
+    std::shared_ptr<ai::cortex::mock_input_props const>  m_simulation_thread_mock_input;
+    std::shared_ptr<ai::cortex::mock_input_props const>  m_simulation_thread_mock_input_untaken;
+    std::mutex  m_simulation_thread_mock_input_mutex;
+
     struct  text_cache {
         bool  operator==(text_cache const&  other) const { return width == other.width && text == other.text && scale == other.scale; }
         bool  operator!=(text_cache const&  other) const { return !(*this == other); }
@@ -269,6 +398,8 @@ private:
     // DEBUG DRAW DATA OF LIBRARIES
     //////////////////////////////////////////////////////////////////////////////////////////
 
+    debug_snapshot  m_debug_snapshot;
+
     using  cached_collider_batch_state = std::array<gfx::batch, 2U>;
     std::unordered_map<object_guid, cached_collider_batch_state>  m_collider_batches_cache;
 
@@ -584,16 +584,18 @@ void  console::execute_pa(std::vector<std::string> const&  words, simulator cons
     push_to_history(msgstream() << "ID: " << const_cast<simulation_context&>(ctx).from_agent_guid(agent_guid));
 
     push_to_history("State variables:");
-    for (auto const&  name_and_props : ctx.agent_state_variables(agent_guid))
-        push_to_history(msgstream() << "   " << name_and_props.first << " = "
-                                    << name_and_props.second.get_value()
-                                    << " [ " << name_and_props.second.get_min_value() << ", " << name_and_props.second.get_max_value() << " ] "
-                                    << name_and_props.second.get_ideal_value()
+    ai::agent_state_variables const&  state_vars = ctx.agent_state_variables(agent_guid);
+    for (natural_32_bit  i = 0U; i != state_vars.size(); ++i)
+        push_to_history(msgstream() << "   " << state_vars.name_of(i) << " = "
+                                    << state_vars.at(i).get_value()
+                                    << " [ " << state_vars.at(i).get_min_value() << ", " << state_vars.at(i).get_max_value() << " ] "
+                                    << state_vars.at(i).get_ideal_value()
                                     );
 
     push_to_history("System variables:");
-    for (auto const&  name_and_value : ctx.agent_system_variables(agent_guid))
-        push_to_history(msgstream() << "   " << name_and_value.first << " = " << name_and_value.second);
+    ai::agent_system_variables const&  system_vars = ctx.agent_system_variables(agent_guid);
+    for (natural_32_bit  i = 0U; i != system_vars.size(); ++i)
+        push_to_history(msgstream() << "   " << ai::agent_system_variables::name_of(i) << " = " << system_vars.at(i));
 
     ai::agent_system_state const&  sys_state = ctx.agent_system_state(agent_guid);
     push_to_history("System state:");
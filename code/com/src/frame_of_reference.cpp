@@ -19,6 +19,7 @@ frames_provider::frame_of_reference::frame_of_reference()
     , is_frame_in_world_space_valid(true)
     , is_frame_in_world_space_explicit_valid(true)
     , is_world_matrix_valid(true)
+    , is_in_invalidated(false)
 {}
 
 
@@ -42,6 +43,7 @@ void  frames_provider::erase(frame_id const  id)
 void  frames_provider::clear()
 {
     m_frames.clear();
+    m_invalidated.clear();
 }
 
 
@@ -158,6 +160,21 @@ matrix44 const&  frames_provider::world_matrix(frame_id const  id) const
 }
 
 
+void  frames_provider::update_cached_data() const
+{
+    TMPROF_BLOCK();
+
+    for (frame_id  id : m_invalidated)
+        if (valid(id))
+        {
+            frame_explicit(id);
+            frame_explicit_in_world_space(id);
+            m_frames.at(id).is_in_invalidated = false;
+        }
+    m_invalidated.clear();
+}
+
+
 void  frames_provider::translate(frame_id const  id, vector3 const&  shift)
 {
     ASSUMPTION(valid(id));
@@ -273,6 +290,11 @@ void  frames_provider::invalidate(frame_id const  id) const
     frame.is_frame_in_world_space_valid = false;
     frame.is_frame_in_world_space_explicit_valid = false;
     frame.is_world_matrix_valid = false;
+    if (!frame.is_in_invalidated)
+    {
+        frame.is_in_invalidated = true;
+        m_invalidated.push_back(id);
+    }
     for (frame_id  child_id : frame.children)
         invalidate(child_id);
 }
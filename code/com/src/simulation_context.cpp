@@ -78,6 +78,14 @@ simulation_context::simulation_context(
     , m_data_root_dir(canonical_path(data_root_dir_.empty() ? "." : data_root_dir_).string())
     , m_invalidated_guids()
     , m_relocated_frame_guids()
+    , m_colliders_relocation_batches()
+    // ACCESS PATH CACHES
+    , m_absolute_paths_to_guids()
+    , m_relative_paths_to_guids()
+    , m_guids_to_absolute_paths()
+    , m_path_caches_generation(0UL)
+    // PARALLEL ACCESS
+    , m_frozen(false)
     // CACHES
     , m_cache_of_imported_scenes()
     , m_cache_of_imported_batches()
@@ -85,40 +93,8 @@ simulation_context::simulation_context(
     , m_cache_of_imported_agent_configs()
     // EARLY REQUESTS HANDLING
     , m_rigid_bodies_with_invalidated_shape()
-    , m_pending_requests_early()
-    , m_requests_early_insert_custom_constraint()
-    , m_requests_early_insert_instant_constraint()
     // REQUESTS HANDLING
-    , m_pending_requests()
-    , m_requests_erase_folder()
-    , m_requests_erase_frame()
-    , m_requests_relocate_frame()
-    , m_requests_set_parent_frame()
-    , m_requests_erase_batch()
-    , m_requests_enable_collider()
-    , m_requests_enable_colliding()
-    , m_requests_enable_colliding_by_path()
-    , m_requests_insert_collider_box()
-    , m_requests_insert_collider_capsule()
-    , m_requests_insert_collider_sphere()
-    , m_requests_erase_collider()
-    , m_requests_insert_rigid_body()
-    , m_requests_erase_rigid_body()
-    , m_requests_set_linear_velocity()
-    , m_requests_set_linear_velocity_by_path()
-    , m_requests_set_angular_velocity()
-    , m_requests_set_angular_velocity_by_path()
-    , m_requests_mul_linear_velocity()
-    , m_requests_mul_linear_velocity_by_path()
-    , m_requests_mul_angular_velocity()
-    , m_requests_mul_angular_velocity_by_path()
-    , m_requests_set_linear_acceleration_from_source()
-    , m_requests_set_angular_acceleration_from_source()
-    , m_requests_del_linear_acceleration_from_source()
-    , m_requests_del_angular_acceleration_from_source()
-    , m_requests_erase_timer()
-    , m_requests_erase_sensor()
-    , m_requests_erase_agent()
+    , m_requests()
     // LATE REQUESTS HANDLING
     , m_requests_late_scene_import()
     , m_requests_late_insert_agent()
@@ -150,6 +126,7 @@ simulation_context::folder_content_type::folder_content_type()
     , child_folders()
     , content()
     , content_index()
+    , content_of_kind()
 {}
 
 
@@ -162,11 +139,33 @@ simulation_context::folder_content_type::folder_content_type(
     , child_folders()
     , content()
     , content_index()
+    , content_of_kind()
 {
     ASSUMPTION(!folder_name.empty() && parent_folder == invalid_object_guid() || parent_folder.kind == OBJECT_KIND::FOLDER);
 }
 
 
+void  simulation_context::folder_content_type::insert_child_folder(object_guid const  guid, std::string const&  name)
+{
+    ASSUMPTION(guid.kind == OBJECT_KIND::FOLDER);
+    child_folders.insert({ name, guid });
+    content_of_kind.at(as_number(OBJECT_KIND::FOLDER)).push_back(guid);
+}
+
+
+void  simulation_context::folder_content_type::erase_child_folder(std::string const&  name)
+{
+    auto const  it = child_folders.find(name);
+    ASSUMPTION(it != child_folders.end());
+    std::vector<object_guid>&  guids = content_of_kind.at(as_number(OBJECT_KIND::FOLDER));
+    auto const  guid_it = std::find(guids.begin(), guids.end(), it->second);
+    INVARIANT(guid_it != guids.end());
+    *guid_it = guids.back();
+    guids.pop_back();
+    child_folders.erase(it);
+}
+
+
 void  simulation_context::folder_content_type::insert_content(OBJECT_KIND const  kind, object_guid const  guid)
 {
     insert_content(kind, guid, to_string(kind));
@@ -181,6 +180,7 @@ void  simulation_context::folder_content_type::insert_content(
 {
     content.insert({ name, guid });
     content_index[kind].insert(name);
+    content_of_kind.at(as_number(kind)).push_back(guid);
 }
 
 
@@ -192,7 +192,14 @@ void  simulation_context::folder_content_type::erase_content(OBJECT_KIND const
 
 void  simulation_context::folder_content_type::erase_content(std::string const&  name, OBJECT_KIND const  kind)
 {
-    content.erase(name);
+    auto const  content_it = content.find(name);
+    ASSUMPTION(content_it != content.end() && content_it->second.kind == kind);
+    std::vector<object_guid>&  guids = content_of_kind.at(as_number(kind));
+    auto const  guid_it = std::find(guids.begin(), guids.end(), content_it->second);
+    INVARIANT(guid_it != guids.end());
+    *guid_it = guids.back();
+    guids.pop_back();
+    content.erase(content_it);
     auto const  it = content_index.find(kind);
     it->second.erase(name);
     if (it->second.empty())
@@ -337,13 +344,15 @@ void  simulation_context::for_each_parent_folder(object_guid  folder_guid, bool
 void  simulation_context::for_each_child_folder(object_guid const  folder_guid, bool const  recursively,
                                                 bool const  including_passed_folder, folder_visitor_type const&  visitor) const
 {
-    folder_content_type const&  fct = folder_content(folder_guid);
-    for (auto const&  name_and_guid : including_passed_folder ? folder_content_type::names_to_guids_map{
-                                                                        {fct.folder_name, folder_guid }
-                                                                        } :
-                                                                fct.child_folders)
-        if (visitor(name_and_guid.second, folder_content(name_and_guid.second)) && recursively)
-            for_each_child_folder(name_and_guid.second, recursively, false, visitor);
+    if (including_passed_folder)
+    {
+        if (visitor(folder_guid, folder_content(folder_guid)) && recursively)
+            for_each_child_folder(folder_guid, recursively, false, visitor);
+        return;
+    }
+    for (object_guid const  child_guid : folder_content(folder_guid).guids_of_kind(OBJECT_KIND::FOLDER))
+        if (visitor(child_guid, folder_content(child_guid)) && recursively)
+            for_each_child_folder(child_guid, recursively, false, visitor);
 }
 
 
@@ -352,14 +361,12 @@ void  simulation_context::for_each_object_of_kind_under_folder(object_guid const
                                                                folder_content_visitor_type const&  visitor) const
 {
     folder_content_type const&  fct = folder_content(folder_guid);
-    auto const  content_it = fct.content_index.find(kind);
-    if (content_it != fct.content_index.end())
-        for (std::string const&  name : content_it->second)
-            if (!visitor(fct.content.at(name)))
-                return;
+    for (object_guid const  guid : fct.guids_of_kind(kind))
+        if (!visitor(guid))
+            return;
     if (recursively)
-        for (auto const&  name_and_guid : fct.child_folders)
-            for_each_object_of_kind_under_folder(name_and_guid.second, recursively, kind, visitor);
+        for (object_guid const  child_guid : fct.guids_of_kind(OBJECT_KIND::FOLDER))
+            for_each_object_of_kind_under_folder(child_guid, recursively, kind, visitor);
 }
 
 
@@ -388,15 +395,15 @@ object_guid  simulation_context::insert_folder(object_guid const  under_folder_g
             OBJECT_KIND::FOLDER,
             self->m_folders.insert(folder_content_type(folder_name, under_folder_guid))
             };
-    self->m_folders.at(under_folder_guid.index).child_folders.insert({ folder_name, new_folder_guid });
+    self->m_folders.at(under_folder_guid.index).insert_child_folder(new_folder_guid, folder_name);
     return new_folder_guid;
 }
 
 
 void  simulation_context::request_erase_non_root_empty_folder(object_guid const  folder_guid) const
 {
-    m_requests_erase_folder.push_back(folder_guid);
-    m_pending_requests.push_back(REQUEST_ERASE_FOLDER);
+    requests().erase_folder.push_back(folder_guid);
+    requests().pending.push_back(REQUEST_ERASE_FOLDER);
 }
 
 
@@ -456,8 +463,9 @@ void  simulation_context::erase_non_root_empty_folder(object_guid const  folder_
     if (folder_guid != root_folder())
     {
         folder_content_type const&  erased_folder = m_folders.at(folder_guid.index);
-        m_folders.at(erased_folder.parent_folder.index).child_folders.erase(erased_folder.folder_name);
+        m_folders.at(erased_folder.parent_folder.index).erase_child_folder(erased_folder.folder_name);
         m_folders.erase(folder_guid.index);
+        invalidate_path_caches();
     }
 }
 
@@ -624,6 +632,13 @@ matrix44 const&  simulation_context::frame_world_matrix(object_guid const  frame
 }
 
 
+std::vector<object_guid> const&  simulation_context::colliders_of_frame(object_guid const  frame_guid) const
+{
+    ASSUMPTION(is_valid_frame_guid(frame_guid));
+    return m_frames.at(frame_guid.index).colliders;
+}
+
+
 object_guid  simulation_context::insert_frame(object_guid const  under_folder_guid, object_guid const  parent_frame_guid,
                                               vector3 const  origin, quaternion const  orientation, bool const  relative_to_parent) const
 {
@@ -645,8 +660,8 @@ object_guid  simulation_context::insert_frame(object_guid const  under_folder_gu
 
 void  simulation_context::request_erase_frame(object_guid const  frame_guid) const
 {
-    m_requests_erase_frame.push_back(frame_guid);
-    m_pending_requests.push_back(REQUEST_ERASE_FRAME);
+    requests().erase_frame.push_back(frame_guid);
+    requests().pending.push_back(REQUEST_ERASE_FRAME);
 }
 
 
@@ -654,8 +669,8 @@ void  simulation_context::request_relocate_frame(object_guid const  frame_guid,
                                                  quaternion const&  new_orientation, bool const  relative_to_parent) const
 {
     ASSUMPTION(is_valid_frame_guid(frame_guid));
-    m_requests_relocate_frame.push_back({ frame_guid, new_origin, new_orientation, relative_to_parent });
-    m_pending_requests.push_back(REQUEST_RELOCATE_FRAME);
+    requests().relocate_frame.push_back({ frame_guid, new_origin, new_orientation, relative_to_parent });
+    requests().pending.push_back(REQUEST_RELOCATE_FRAME);
 }
 
 
@@ -672,8 +687,8 @@ void  simulation_context::request_set_parent_frame(object_guid const  frame_guid
             is_valid_frame_guid(frame_guid) &&
             (is_valid_frame_guid(parent_frame_guid) || parent_frame_guid == invalid_object_guid())
             );
-    m_requests_set_parent_frame.push_back({ frame_guid, parent_frame_guid });
-    m_pending_requests.push_back(REQUEST_SET_PARENT_FRAME);
+    requests().set_parent_frame.push_back({ frame_guid, parent_frame_guid });
+    requests().pending.push_back(REQUEST_SET_PARENT_FRAME);
 }
 
 
@@ -741,6 +756,7 @@ void  simulation_context::erase_frame(object_guid const  frame_guid)
     auto const&  elem = m_frames.at(frame_guid.index);
     m_frames_provider.erase(elem.id);
     m_folders.at(elem.folder_index).erase_content(OBJECT_KIND::FRAME);
+    invalidate_path_caches();
     m_frids_to_guids.erase(elem.id);
     m_frames.erase(frame_guid.index);
 }
@@ -808,6 +824,36 @@ void  simulation_context::frame_relocate_relative_to_parent(object_guid const  f
 }
 
 
+void  simulation_context::relocate_colliders_of_frames(std::vector<object_guid> const&  frame_guids)
+{
+    TMPROF_BLOCK();
+
+    m_colliders_relocation_batches.resize(m_collision_scenes_ptr->size());
+    for (object_guid const  frame_guid : frame_guids)
+    {
+        folder_element_frame const&  frame = m_frames.at(frame_guid.index);
+        if (frame.colliders.empty())
+            continue;
+        matrix44 const* const  world_matrix_ptr = &m_frames_provider.world_matrix(frame.id);
+        for (object_guid const  collider_guid : frame.colliders)
+        {
+            folder_element_collider const&  collider = m_colliders.at(collider_guid.index);
+            auto&  batch = m_colliders_relocation_batches.at(collider.scene_index);
+            for (angeo::collision_object_id  coid : collider.id)
+                batch.push_back({ coid, world_matrix_ptr });
+        }
+    }
+    for (natural_32_bit  i = 0U; i < (natural_32_bit)m_colliders_relocation_batches.size(); ++i)
+    {
+        auto&  batch = m_colliders_relocation_batches.at(i);
+        if (batch.empty())
+            continue;
+        m_collision_scenes_ptr->at(i)->on_positions_changed(batch);
+        batch.clear();
+    }
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////////
 // BATCHES API
 /////////////////////////////////////////////////////////////////////////////////////
@@ -868,8 +914,8 @@ std::vector<matrix44> const&  simulation_context::matrices_to_pose_bones_of_batc
 
 void  simulation_context::request_erase_batch(object_guid const  batch_guid) const
 {
-    m_requests_erase_batch.push_back(batch_guid);
-    m_pending_requests.push_back(REQUEST_ERASE_BATCH);
+    requests().erase_batch.push_back(batch_guid);
+    requests().pending.push_back(REQUEST_ERASE_BATCH);
 }
 
 
@@ -931,6 +977,7 @@ void  simulation_context::erase_batch(object_guid const  batch_guid)
         );
 
     m_folders.at(elem.folder_index).erase_content(elem.element_name, OBJECT_KIND::BATCH);
+    invalidate_path_caches();
     m_batches_to_guids.erase(elem.id);
     m_batches.erase(batch_guid.index);
 }
@@ -1365,10 +1412,72 @@ object_guid  simulation_context::ray_cast_to_nearest_collider(
 }
 
 
+void  simulation_context::ray_cast_to_nearest_colliders(
+        std::vector<vector3> const&  ray_origins,
+        std::vector<vector3> const&  ray_ends,
+        bool const  search_static,
+        bool const  search_dynamic,
+        collision_scene_index const  scene_index,
+        std::vector<object_guid>&  output_nearest_colliders,
+        std::vector<float_32_bit>&  output_ray_parameters_to_nearest_colliders,
+        std::function<bool(object_guid, angeo::COLLISION_CLASS)> const&  collider_filter,
+        float_32_bit const  min_parameter_value
+        ) const
+{
+    output_nearest_colliders.assign(ray_origins.size(), invalid_object_guid());
+    if (m_collision_scenes_ptr->at(scene_index) == nullptr)
+    {
+        output_ray_parameters_to_nearest_colliders.assign(ray_origins.size(), 1.0f);
+        return;
+    }
+    std::vector<angeo::collision_object_id>  nearest_coids;
+    m_collision_scenes_ptr->at(scene_index)->ray_cast_batch(
+            ray_origins,
+            ray_ends,
+            search_static,
+            search_dynamic,
+            nearest_coids,
+            output_ray_parameters_to_nearest_colliders,
+            [this,&collider_filter,scene_index](angeo::collision_object_id const  coid, angeo::COLLISION_CLASS const  cc) {
+                    return collider_filter(to_collider_guid(coid, scene_index), cc);
+                    },
+            min_parameter_value
+            );
+    for (std::size_t  i = 0UL, n = nearest_coids.size(); i < n; ++i)
+        if (output_ray_parameters_to_nearest_colliders.at(i) < 1.0f)
+            output_nearest_colliders.at(i) = m_coids_to_guids.at({nearest_coids.at(i), scene_index});
+}
+
+
+void  simulation_context::find_colliders_in_convex_volume(
+        std::vector<std::pair<vector3, vector3> > const&  half_spaces,
+        vector3 const&  min_corner,
+        vector3 const&  max_corner,
+        bool const  search_static,
+        bool const  search_dynamic,
+        collision_scene_index const  scene_index,
+        std::function<bool(object_guid)> const&  acceptor
+        ) const
+{
+    if (m_collision_scenes_ptr->at(scene_index) == nullptr)
+        return;
+    m_collision_scenes_ptr->at(scene_index)->find_objects_in_proximity_to_convex_volume(
+            half_spaces,
+            min_corner,
+            max_corner,
+            search_static,
+            search_dynamic,
+            [this, &acceptor, scene_index](angeo::collision_object_id const  coid) -> bool {
+                    return acceptor(to_collider_guid(coid, scene_index));
+                    }
+            );
+}
+
+
 void  simulation_context::request_enable_collider(object_guid const  collider_guid, bool const  state) const
 {
-    m_requests_enable_collider.push_back({collider_guid, state});
-    m_pending_requests.push_back(REQUEST_ENABLE_COLLIDER);
+    requests().enable_collider.push_back({collider_guid, state});
+    requests().pending.push_back(REQUEST_ENABLE_COLLIDER);
 }
 
 
@@ -1377,8 +1486,8 @@ void  simulation_context::request_enable_colliding(
         ) const
 {
     ASSUMPTION(collider_1 != collider_2);
-    m_requests_enable_colliding.push_back({collider_1, collider_2, state});
-    m_pending_requests.push_back(REQUEST_ENABLE_COLLIDING);
+    requests().enable_colliding.push_back({collider_1, collider_2, state});
+    requests().pending.push_back(REQUEST_ENABLE_COLLIDING);
 }
 
 
@@ -1387,12 +1496,12 @@ void  simulation_context::request_enable_colliding(object_guid const  base_folde
                                                    const bool  state) const
 {
     ASSUMPTION(base_folder_guid_1 != base_folder_guid_2 || relative_path_to_collider_1 != relative_path_to_collider_2);
-    m_requests_enable_colliding_by_path.push_back({
+    requests().enable_colliding_by_path.push_back({
             base_folder_guid_1, relative_path_to_collider_1,
             base_folder_guid_2, relative_path_to_collider_2,
             state
             });
-    m_pending_requests.push_back(REQUEST_ENABLE_COLLIDING_BY_PATH);
+    requests().pending.push_back(REQUEST_ENABLE_COLLIDING_BY_PATH);
 }
 
 
@@ -1413,8 +1522,8 @@ void  simulation_context::request_insert_collider_box(
     box.collision_class = collision_class;
     box.density_multiplier = density_multiplier;
     box.scene_index = scene_index;
-    m_requests_insert_collider_box.push_back(box);
-    m_pending_requests.push_back(REQUEST_INSERT_COLLIDER_BOX);
+    requests().insert_collider_box.push_back(box);
+    requests().pending.push_back(REQUEST_INSERT_COLLIDER_BOX);
 }
 
 
@@ -1437,8 +1546,8 @@ void  simulation_context::request_insert_collider_capsule(
     capsule.collision_class = collision_class;
     capsule.density_multiplier = density_multiplier;
     capsule.scene_index = scene_index;
-    m_requests_insert_collider_capsule.push_back(capsule);
-    m_pending_requests.push_back(REQUEST_INSERT_COLLIDER_CAPSULE);
+    requests().insert_collider_capsule.push_back(capsule);
+    requests().pending.push_back(REQUEST_INSERT_COLLIDER_CAPSULE);
 }
 
 
@@ -1459,15 +1568,15 @@ void  simulation_context::request_insert_collider_sphere(
     sphere.collision_class = collision_class;
     sphere.density_multiplier = density_multiplier;
     sphere.scene_index = scene_index;
-    m_requests_insert_collider_sphere.push_back(sphere);
-    m_pending_requests.push_back(REQUEST_INSERT_COLLIDER_SPHERE);
+    requests().insert_collider_sphere.push_back(sphere);
+    requests().pending.push_back(REQUEST_INSERT_COLLIDER_SPHERE);
 }
 
 
 void  simulation_context::request_erase_collider(object_guid const  collider_guid) const
 {
-    m_requests_erase_collider.push_back(collider_guid);
-    m_pending_requests.push_back(REQUEST_ERASE_COLLIDER);
+    requests().erase_collider.push_back(collider_guid);
+    requests().pending.push_back(REQUEST_ERASE_COLLIDER);
 }
 
 
@@ -1568,6 +1677,8 @@ object_guid  simulation_context::insert_collider(
     for (angeo::collision_object_id  coid : coids)
         m_coids_to_guids.insert({ {coid,scene_index}, collider_guid });
 
+    m_frames.at(frame_guid.index).colliders.push_back(collider_guid);
+
     m_folders.at(under_folder_guid.index).insert_content(OBJECT_KIND::COLLIDER, collider_guid, name);
 
     if (owner_guid != invalid_object_guid())
@@ -1615,9 +1726,18 @@ void  simulation_context::erase_collider(object_guid const  collider_guid)
         if (is_rigid_body_moveable(elem.rigid_body)&& elem.scene_index == 0U)
             m_rigid_bodies_with_invalidated_shape.insert(elem.rigid_body);
     }
+    if (is_valid_frame_guid(elem.frame))
+    {
+        auto&  frame_colliders = m_frames.at(elem.frame.index).colliders;
+        auto const  self_it = std::find(frame_colliders.begin(), frame_colliders.end(), collider_guid);
+        INVARIANT(self_it != frame_colliders.end());
+        *self_it = frame_colliders.back();
+        frame_colliders.pop_back();
+    }
     for (angeo::collision_object_id  coid : elem.id)
         m_collision_scenes_ptr->at(elem.scene_index)->erase_object(coid);
     m_folders.at(elem.folder_index).erase_content(elem.element_name, OBJECT_KIND::COLLIDER);
+    invalidate_path_caches();
     for (angeo::collision_object_id  coid : elem.id)
         m_coids_to_guids.erase({coid,elem.scene_index});
     m_colliders.erase(collider_guid.index);
@@ -1878,22 +1998,22 @@ void  simulation_context::request_insert_rigid_body(
     rigid_body.angular_acceleration = angular_acceleration;
     rigid_body.inverted_mass = inverted_mass;
     rigid_body.inverted_inertia_tensor = inverted_inertia_tensor;
-    m_requests_insert_rigid_body.push_back(rigid_body);
-    m_pending_requests.push_back(REQUEST_INSERT_RIGID_BODY);
+    requests().insert_rigid_body.push_back(rigid_body);
+    requests().pending.push_back(REQUEST_INSERT_RIGID_BODY);
 }
 
 
 void  simulation_context::request_erase_rigid_body(object_guid const  rigid_body_guid) const
 {
-    m_requests_erase_rigid_body.push_back(rigid_body_guid);
-    m_pending_requests.push_back(REQUEST_ERASE_RIGID_BODY);
+    requests().erase_rigid_body.push_back(rigid_body_guid);
+    requests().pending.push_back(REQUEST_ERASE_RIGID_BODY);
 }
 
 
 void  simulation_context::request_set_rigid_body_linear_velocity(object_guid const  rigid_body_guid, vector3 const&  velocity) const
 {
-    m_requests_set_linear_velocity.push_back({ rigid_body_guid, velocity });
-    m_pending_requests.push_back(REQUEST_SET_LINEAR_VELOCITY);
+    requests().set_linear_velocity.push_back({ rigid_body_guid, velocity });
+    requests().pending.push_back(REQUEST_SET_LINEAR_VELOCITY);
 }
 
 
@@ -1901,15 +2021,15 @@ void  simulation_context::request_set_rigid_body_linear_velocity(
         object_guid const  base_folder_guid, std::string const&  relative_path_to_rigid_body, vector3 const&  velocity
         ) const
 {
-    m_requests_set_linear_velocity_by_path.push_back({ base_folder_guid, relative_path_to_rigid_body, velocity });
-    m_pending_requests.push_back(REQUEST_SET_LINEAR_VELOCITY_BY_PATH);
+    requests().set_linear_velocity_by_path.push_back({ base_folder_guid, relative_path_to_rigid_body, velocity });
+    requests().pending.push_back(REQUEST_SET_LINEAR_VELOCITY_BY_PATH);
 }
 
 
 void  simulation_context::request_set_rigid_body_angular_velocity(object_guid const  rigid_body_guid,  vector3 const&  velocity) const
 {
-    m_requests_set_angular_velocity.push_back({ rigid_body_guid, velocity });
-    m_pending_requests.push_back(REQUEST_SET_ANGULAR_VELOCITY);
+    requests().set_angular_velocity.push_back({ rigid_body_guid, velocity });
+    requests().pending.push_back(REQUEST_SET_ANGULAR_VELOCITY);
 }
 
 
@@ -1917,8 +2037,8 @@ void  simulation_context::request_set_rigid_body_angular_velocity(
         object_guid const  base_folder_guid, std::string const&  relative_path_to_rigid_body,  vector3 const&  velocity
         ) const
 {
-    m_requests_set_angular_velocity_by_path.push_back({ base_folder_guid, relative_path_to_rigid_body, velocity });
-    m_pending_requests.push_back(REQUEST_SET_ANGULAR_VELOCITY_BY_PATH);
+    requests().set_angular_velocity_by_path.push_back({ base_folder_guid, relative_path_to_rigid_body, velocity });
+    requests().pending.push_back(REQUEST_SET_ANGULAR_VELOCITY_BY_PATH);
 }
 
 
@@ -1926,8 +2046,8 @@ void  simulation_context::request_mul_rigid_body_linear_velocity(
         object_guid const  rigid_body_guid, vector3 const&  velocity_scale
         ) const
 {
-    m_requests_mul_linear_velocity.push_back({ rigid_body_guid, velocity_scale });
-    m_pending_requests.push_back(REQUEST_MUL_LINEAR_VELOCITY);
+    requests().mul_linear_velocity.push_back({ rigid_body_guid, velocity_scale });
+    requests().pending.push_back(REQUEST_MUL_LINEAR_VELOCITY);
 }
 
 
@@ -1935,8 +2055,8 @@ void  simulation_context::request_mul_rigid_body_linear_velocity(
         object_guid const  base_folder_guid, std::string const&  relative_path_to_rigid_body, vector3 const&  velocity_scale
         ) const
 {
-    m_requests_mul_linear_velocity_by_path.push_back({ base_folder_guid, relative_path_to_rigid_body, velocity_scale });
-    m_pending_requests.push_back(REQUEST_MUL_LINEAR_VELOCITY_BY_PATH);
+    requests().mul_linear_velocity_by_path.push_back({ base_folder_guid, relative_path_to_rigid_body, velocity_scale });
+    requests().pending.push_back(REQUEST_MUL_LINEAR_VELOCITY_BY_PATH);
 }
 
 
@@ -1944,8 +2064,8 @@ void  simulation_context::request_mul_rigid_body_angular_velocity(
         object_guid const  rigid_body_guid,  vector3 const&  velocity_scale
         ) const
 {
-    m_requests_mul_angular_velocity.push_back({ rigid_body_guid, velocity_scale });
-    m_pending_requests.push_back(REQUEST_MUL_ANGULAR_VELOCITY);
+    requests().mul_angular_velocity.push_back({ rigid_body_guid, velocity_scale });
+    requests().pending.push_back(REQUEST_MUL_ANGULAR_VELOCITY);
 }
 
 
@@ -1953,40 +2073,40 @@ void  simulation_context::request_mul_rigid_body_angular_velocity(
         object_guid const  base_folder_guid, std::string const&  relative_path_to_rigid_body,  vector3 const&  velocity_scale
         ) const
 {
-    m_requests_mul_angular_velocity_by_path.push_back({ base_folder_guid, relative_path_to_rigid_body, velocity_scale });
-    m_pending_requests.push_back(REQUEST_MUL_ANGULAR_VELOCITY_BY_PATH);
+    requests().mul_angular_velocity_by_path.push_back({ base_folder_guid, relative_path_to_rigid_body, velocity_scale });
+    requests().pending.push_back(REQUEST_MUL_ANGULAR_VELOCITY_BY_PATH);
 }
 
 
 void  simulation_context::request_set_rigid_body_linear_acceleration_from_source(
         object_guid const  rigid_body_guid, rigid_body_acceleration_source_id const  source_id, vector3 const&  acceleration) const
 {
-    m_requests_set_linear_acceleration_from_source.push_back({ rigid_body_guid, source_id, acceleration });
-    m_pending_requests.push_back(REQUEST_SET_LINEAR_ACCEL);
+    requests().set_linear_acceleration_from_source.push_back({ rigid_body_guid, source_id, acceleration });
+    requests().pending.push_back(REQUEST_SET_LINEAR_ACCEL);
 }
 
 
 void  simulation_context::request_set_rigid_body_angular_acceleration_from_source(
         object_guid const  rigid_body_guid, rigid_body_acceleration_source_id const  source_id, vector3 const&  acceleration) const
 {
-    m_requests_set_angular_acceleration_from_source.push_back({ rigid_body_guid, source_id, acceleration });
-    m_pending_requests.push_back(REQUEST_SET_ANGULAR_ACCEL);
+    requests().set_angular_acceleration_from_source.push_back({ rigid_body_guid, source_id, acceleration });
+    requests().pending.push_back(REQUEST_SET_ANGULAR_ACCEL);
 }
 
 
 void  simulation_context::request_remove_rigid_body_linear_acceleration_from_source(
         object_guid const  rigid_body_guid, rigid_body_acceleration_source_id const  source_id) const
 {
-    m_requests_del_linear_acceleration_from_source.push_back({ rigid_body_guid, source_id });
-    m_pending_requests.push_back(REQUEST_DEL_LINEAR_ACCEL);
+    requests().del_linear_acceleration_from_source.push_back({ rigid_body_guid, source_id });
+    requests().pending.push_back(REQUEST_DEL_LINEAR_ACCEL);
 }
 
 
 void  simulation_context::request_remove_rigid_body_angular_acceleration_from_source(
         object_guid const  rigid_body_guid, rigid_body_acceleration_source_id const  source_id) const
 {
-    m_requests_del_angular_acceleration_from_source.push_back({ rigid_body_guid, source_id });
-    m_pending_requests.push_back(REQUEST_DEL_ANGULAR_ACCEL);
+    requests().del_angular_acceleration_from_source.push_back({ rigid_body_guid, source_id });
+    requests().pending.push_back(REQUEST_DEL_ANGULAR_ACCEL);
 }
 
 
@@ -1999,7 +2119,7 @@ void  simulation_context::request_early_insertion_of_custom_constraint_to_physic
         float_32_bit const  initial_value_for_cache_miss
         ) const
 {
-    m_requests_early_insert_custom_constraint.push_back({
+    requests().early_insert_custom_constraint.push_back({
         ccid,
         rigid_body_0, linear_component_0, angular_component_0,
         rigid_body_1, linear_component_1, angular_component_1,
@@ -2007,7 +2127,7 @@ void  simulation_context::request_early_insertion_of_custom_constraint_to_physic
         variable_lower_bound, variable_upper_bound,
         initial_value_for_cache_miss
         });
-    m_pending_requests_early.push_back(REQUEST_INSERT_CUSTOM_CONSTRAINT);
+    requests().pending_early.push_back(REQUEST_INSERT_CUSTOM_CONSTRAINT);
 }
 
 
@@ -2019,14 +2139,14 @@ void  simulation_context::request_early_insertion_of_instant_constraint_to_physi
         float_32_bit const  initial_value
         ) const
 {
-    m_requests_early_insert_instant_constraint.push_back({
+    requests().early_insert_instant_constraint.push_back({
         rigid_body_0, linear_component_0, angular_component_0,
         rigid_body_1, linear_component_1, angular_component_1,
         bias,
         variable_lower_bound, variable_upper_bound,
         initial_value
         });
-    m_pending_requests_early.push_back(REQUEST_INSERT_INSTANT_CONSTRAINT);
+    requests().pending_early.push_back(REQUEST_INSERT_INSTANT_CONSTRAINT);
 }
 
 
@@ -2053,6 +2173,7 @@ void  simulation_context::erase_rigid_body(object_guid const  rigid_body_guid)
         m_colliders.at(collider_guid.index).rigid_body = invalid_object_guid();
     m_rigid_body_simulator_ptr->erase_rigid_body(elem.id);
     m_folders.at(elem.folder_index).erase_content(OBJECT_KIND::RIGID_BODY);
+    invalidate_path_caches();
     m_rbids_to_guids.erase(elem.id);
     m_moveable_rigid_bodies.erase(rigid_body_guid.index);
     m_rigid_bodies.erase(rigid_body_guid.index);
@@ -2229,8 +2350,8 @@ simulation_context::timer_guid_iterator  simulation_context::timers_end() const
 
 void  simulation_context::request_erase_timer(object_guid const  timer_guid) const
 {
-    m_requests_erase_timer.push_back(timer_guid);
-    m_pending_requests.push_back(REQUEST_ERASE_TIMER);
+    requests().erase_timer.push_back(timer_guid);
+    requests().pending.push_back(REQUEST_ERASE_TIMER);
 }
 
 
@@ -2267,6 +2388,7 @@ void  simulation_context::erase_timer(object_guid const  timer_guid)
     }
     m_device_simulator_ptr->erase_timer(elem.id);
     m_folders.at(elem.folder_index).erase_content(elem.element_name, OBJECT_KIND::TIMER);
+    invalidate_path_caches();
     m_tmids_to_guids.erase(elem.id);
     m_timers.erase(timer_guid.index);
 }
@@ -2331,8 +2453,8 @@ simulation_context::sensor_guid_iterator  simulation_context::sensors_end() cons
 
 void  simulation_context::request_erase_sensor(object_guid const  sensor_guid) const
 {
-    m_requests_erase_sensor.push_back(sensor_guid);
-    m_pending_requests.push_back(REQUEST_ERASE_SENSOR);
+    requests().erase_sensor.push_back(sensor_guid);
+    requests().pending.push_back(REQUEST_ERASE_SENSOR);
 }
 
 
@@ -2384,6 +2506,7 @@ void  simulation_context::erase_sensor(object_guid const  sensor_guid)
     remove_request_infos(m_device_simulator_ptr->request_infos_touch_end_of_sensor(elem.id));
     m_device_simulator_ptr->erase_sensor(elem.id);
     m_folders.at(elem.folder_index).erase_content(elem.element_name, OBJECT_KIND::SENSOR);
+    invalidate_path_caches();
     m_seids_to_guids.erase(elem.id);
     m_sensors.erase(sensor_guid.index);
 }
@@ -2705,7 +2828,7 @@ void  simulation_context::request_late_insert_agent(
         std::vector<std::pair<std::string, gfx::batch> > const&  skeleton_attached_batches
         ) const
 {
-    ASSUMPTION(is_valid_folder_guid(under_folder_guid) && !skeleton_attached_batches.empty());
+    ASSUMPTION(is_valid_folder_guid(under_folder_guid) && !skeleton_attached_batches.empty() && !m_frozen);
 
     m_requests_late_insert_agent.push_back({ 
             under_folder_guid,
@@ -2718,8 +2841,8 @@ void  simulation_context::request_late_insert_agent(
 
 void  simulation_context::request_erase_agent(object_guid const  agent_guid) const
 {
-    m_requests_erase_agent.push_back(agent_guid);
-    m_pending_requests.push_back(REQUEST_ERASE_AGENT);
+    requests().erase_agent.push_back(agent_guid);
+    requests().pending.push_back(REQUEST_ERASE_AGENT);
 }
 
 
@@ -2832,6 +2955,7 @@ void  simulation_context::erase_agent(object_guid const  agent_guid)
     }
 
     m_folders.at(elem.folder_index).erase_content(OBJECT_KIND::AGENT);
+    invalidate_path_caches();
     m_agids_to_guids.erase(elem.id);
     m_agents.erase(agent_guid.index);
 }
@@ -2851,6 +2975,18 @@ void  simulation_context::delete_navigation2d_data_generated_from_collider(objec
 }
 
 
+void  simulation_context::set_navigation_bake_dir(std::string const&  bake_dir)
+{
+    m_ai_simulator_ptr->get_naveditor()->set_bake_directory(bake_dir);
+}
+
+
+std::string  simulation_context::get_navigation_bake_dir() const
+{
+    return m_ai_simulator_ptr->get_naveditor()->get_bake_directory().string();
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////////
 // COLLISION CONTACTS API
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3066,6 +3202,10 @@ object_guid  simulation_context::from_absolute_path(std::string const&  path) co
 {
     ASSUMPTION(is_absolute_path(path));
 
+    auto const  cache_it = m_absolute_paths_to_guids.find(path);
+    if (cache_it != m_absolute_paths_to_guids.end())
+        return cache_it->second;
+
     std::vector<std::string>  names;
     boost::split(names, path, [](std::string::value_type c) -> bool { return c == '/'; });
     std::vector<std::string>  tmp_names;
@@ -3102,6 +3242,8 @@ object_guid  simulation_context::from_absolute_path(std::string const&  path) co
             return invalid_object_guid();
         guid = it->second;
     }
+    if (!m_frozen)
+        m_absolute_paths_to_guids.insert({ path, guid });
     return guid;
 }
 
@@ -3110,6 +3252,10 @@ std::string  simulation_context::to_absolute_path(object_guid const  guid) const
 {
     ASSUMPTION(guid != invalid_object_guid());
 
+    auto const  cache_it = m_guids_to_absolute_paths.find(guid);
+    if (cache_it != m_guids_to_absolute_paths.end())
+        return cache_it->second;
+
     std::vector<std::string>  names;
     for (object_guid  obj_guid = guid; obj_guid != root_folder(); obj_guid = folder_of(obj_guid))
         names.push_back(name_of(obj_guid));
@@ -3122,6 +3268,9 @@ std::string  simulation_context::to_absolute_path(object_guid const  guid) const
 
     INVARIANT(is_absolute_path(path) && (guid.kind == OBJECT_KIND::FOLDER) == is_path_to_folder(path));
 
+    if (!m_frozen)
+        m_guids_to_absolute_paths.insert({ guid, path });
+
     return path;
 }
 
@@ -3129,7 +3278,19 @@ std::string  simulation_context::to_absolute_path(object_guid const  guid) const
 object_guid  simulation_context::from_relative_path(object_guid const  base_guid, std::string const&  relative_path) const
 {
     ASSUMPTION(!is_absolute_path(relative_path));
-    return from_absolute_path(to_absolute_path(base_guid) + "/" + relative_path);
+
+    auto const  base_it = m_relative_paths_to_guids.find(base_guid);
+    if (base_it != m_relative_paths_to_guids.end())
+    {
+        auto const  cache_it = base_it->second.find(relative_path);
+        if (cache_it != base_it->second.end())
+            return cache_it->second;
+    }
+
+    object_guid const  guid = from_absolute_path(to_absolute_path(base_guid) + "/" + relative_path);
+    if (guid != invalid_object_guid() && !m_frozen)
+        m_relative_paths_to_guids[base_guid].insert({ relative_path, guid });
+    return guid;
 }
 
 
@@ -3169,6 +3330,15 @@ std::string  simulation_context::to_relative_path(object_guid const  guid, objec
 }
 
 
+void  simulation_context::invalidate_path_caches()
+{
+    m_absolute_paths_to_guids.clear();
+    m_relative_paths_to_guids.clear();
+    m_guids_to_absolute_paths.clear();
+    ++m_path_caches_generation;
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////////
 // SCENE IMPORT/EXPORT API
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3230,6 +3400,7 @@ std::string  simulation_context::get_texture_root_dir() const
 
 void  simulation_context::request_late_import_scene_from_directory(import_scene_props const&  props) const
 {
+    ASSUMPTION(!m_frozen);
     auto const  it = m_cache_of_imported_scenes.find(detail::imported_scene::key_from_path(props.import_dir));
     m_requests_late_scene_import.push_back({
             it == m_cache_of_imported_scenes.end() ? detail::imported_scene(props.import_dir) : it->second,
@@ -3359,11 +3530,11 @@ inline cursor_to_requests_list<T>  make_request_cursor_to(std::list<T>&  data_)
 
 void  simulation_context::process_pending_early_requests()
 {
-    for ( ; !m_pending_requests_early.empty(); m_pending_requests_early.pop_front())
-        switch (m_pending_requests_early.front())
+    for ( ; !m_requests.pending_early.empty(); m_requests.pending_early.pop_front())
+        switch (m_requests.pending_early.front())
         {
         case REQUEST_INSERT_CUSTOM_CONSTRAINT: {
-            auto  cursor = make_request_cursor_to(m_requests_early_insert_custom_constraint);
+            auto  cursor = make_request_cursor_to(m_requests.early_insert_custom_constraint);
             insert_custom_constraint_to_physics(
                     cursor->ccid,
                     cursor->rigid_body_0,
@@ -3379,7 +3550,7 @@ void  simulation_context::process_pending_early_requests()
                 );
             } break;
         case REQUEST_INSERT_INSTANT_CONSTRAINT: {
-            auto  cursor = make_request_cursor_to(m_requests_early_insert_instant_constraint);
+            auto  cursor = make_request_cursor_to(m_requests.early_insert_instant_constraint);
             insert_instant_constraint_to_physics(
                 cursor->rigid_body_0,
                 cursor->linear_component_0,
@@ -3400,147 +3571,153 @@ void  simulation_context::process_pending_early_requests()
 
 void  simulation_context::clear_pending_early_requests()
 {
-    m_pending_requests_early.clear();
-    m_requests_early_insert_custom_constraint.clear();
-    m_requests_early_insert_instant_constraint.clear();
+    m_requests.pending_early.clear();
+    m_requests.early_insert_custom_constraint.clear();
+    m_requests.early_insert_instant_constraint.clear();
 }
 
 
 bool  simulation_context::has_pending_requests() const
 {
-    return !m_pending_requests.empty();
+    return !m_requests.pending.empty();
+}
+
+
+bool  simulation_context::has_pending_late_requests() const
+{
+    return !m_requests_late_scene_import.empty() || !m_requests_late_insert_agent.empty();
 }
 
 
 void  simulation_context::process_pending_requests()
 {
-    for ( ; has_pending_requests(); m_pending_requests.pop_front())
-        switch (m_pending_requests.front())
+    for ( ; has_pending_requests(); m_requests.pending.pop_front())
+        switch (m_requests.pending.front())
         {
         case REQUEST_ERASE_FOLDER:
-            erase_non_root_empty_folder(*make_request_cursor_to(m_requests_erase_folder));
+            erase_non_root_empty_folder(*make_request_cursor_to(m_requests.erase_folder));
             break;
         case REQUEST_ERASE_FRAME:
-            erase_frame(*make_request_cursor_to(m_requests_erase_frame));
+            erase_frame(*make_request_cursor_to(m_requests.erase_frame));
             break;
         case REQUEST_RELOCATE_FRAME: {
-            auto  cursor = make_request_cursor_to(m_requests_relocate_frame);
+            auto  cursor = make_request_cursor_to(m_requests.relocate_frame);
             frame_relocate(cursor->frame_guid, cursor->position, cursor->orientation, cursor->relative_to_parent);
             } break;
         case REQUEST_SET_PARENT_FRAME: {
-            auto  cursor = make_request_cursor_to(m_requests_set_parent_frame);
+            auto  cursor = make_request_cursor_to(m_requests.set_parent_frame);
             set_parent_frame(cursor->frame_guid, cursor->parent_frame_guid);
             } break;
         case REQUEST_ERASE_BATCH:
-            erase_batch(*make_request_cursor_to(m_requests_erase_batch));
+            erase_batch(*make_request_cursor_to(m_requests.erase_batch));
             break;
         case REQUEST_ENABLE_COLLIDER: {
-            auto  cursor = make_request_cursor_to(m_requests_enable_collider);
+            auto  cursor = make_request_cursor_to(m_requests.enable_collider);
             enable_collider(cursor->collider_guid, cursor->state);
             } break;
         case REQUEST_ENABLE_COLLIDING: {
-            auto  cursor = make_request_cursor_to(m_requests_enable_colliding);
+            auto  cursor = make_request_cursor_to(m_requests.enable_colliding);
             enable_colliding(cursor->collider_1, cursor->collider_2, cursor->state);
             } break;
         case REQUEST_ENABLE_COLLIDING_BY_PATH: {
-            auto  cursor = make_request_cursor_to(m_requests_enable_colliding_by_path);
+            auto  cursor = make_request_cursor_to(m_requests.enable_colliding_by_path);
             enable_colliding(from_relative_path(cursor->base_folder_guid_1, cursor->relative_path_to_collider_1),
                              from_relative_path(cursor->base_folder_guid_2, cursor->relative_path_to_collider_2),
                              cursor->state);
             } break;
         case REQUEST_INSERT_COLLIDER_BOX: {
-            auto  cursor = make_request_cursor_to(m_requests_insert_collider_box);
+            auto  cursor = make_request_cursor_to(m_requests.insert_collider_box);
             insert_collider_box(cursor->under_folder_guid, cursor->name, cursor->half_sizes_along_axes,
                                 cursor->material, cursor->collision_class, cursor->density_multiplier,
                                 cursor->scene_index);
             } break;
         case REQUEST_INSERT_COLLIDER_CAPSULE: {
-            auto  cursor = make_request_cursor_to(m_requests_insert_collider_capsule);
+            auto  cursor = make_request_cursor_to(m_requests.insert_collider_capsule);
             insert_collider_capsule(cursor->under_folder_guid, cursor->name, cursor->half_distance_between_end_points,
                                     cursor->thickness_from_central_line, cursor->material, cursor->collision_class,
                                     cursor->density_multiplier, cursor->scene_index);
             } break;
         case REQUEST_INSERT_COLLIDER_SPHERE: {
-            auto  cursor = make_request_cursor_to(m_requests_insert_collider_sphere);
+            auto  cursor = make_request_cursor_to(m_requests.insert_collider_sphere);
             insert_collider_sphere(cursor->under_folder_guid, cursor->name, cursor->radius, cursor->material,
                                    cursor->collision_class, cursor->density_multiplier, cursor->scene_index);
             } break;
         case REQUEST_ERASE_COLLIDER:
-            erase_collider(*make_request_cursor_to(m_requests_erase_collider));
+            erase_collider(*make_request_cursor_to(m_requests.erase_collider));
             break;
         case REQUEST_INSERT_RIGID_BODY: {
-            auto  cursor = make_request_cursor_to(m_requests_insert_rigid_body);
+            auto  cursor = make_request_cursor_to(m_requests.insert_rigid_body);
             insert_rigid_body(cursor->under_folder_guid, cursor->is_moveable, cursor->linear_velocity,
                               cursor->angular_velocity, cursor->linear_acceleration, cursor->angular_acceleration,
                               cursor->inverted_mass, cursor->inverted_inertia_tensor);
             } break;
         case REQUEST_ERASE_RIGID_BODY:
-            erase_rigid_body(*make_request_cursor_to(m_requests_erase_rigid_body));
+            erase_rigid_body(*make_request_cursor_to(m_requests.erase_rigid_body));
             break;
         case REQUEST_SET_LINEAR_VELOCITY: {
-            auto  cursor = make_request_cursor_to(m_requests_set_linear_velocity);
+            auto  cursor = make_request_cursor_to(m_requests.set_linear_velocity);
             set_rigid_body_linear_velocity(cursor->rb_guid, cursor->velocity);
             } break;
         case REQUEST_SET_LINEAR_VELOCITY_BY_PATH: {
-            auto  cursor = make_request_cursor_to(m_requests_set_linear_velocity_by_path);
+            auto  cursor = make_request_cursor_to(m_requests.set_linear_velocity_by_path);
             set_rigid_body_linear_velocity(from_relative_path(cursor->base_folder_guid, cursor->relative_path_to_rigid_body),
                                            cursor->velocity);
             } break;
         case REQUEST_SET_ANGULAR_VELOCITY: {
-            auto  cursor = make_request_cursor_to(m_requests_set_angular_velocity);
+            auto  cursor = make_request_cursor_to(m_requests.set_angular_velocity);
             set_rigid_body_angular_velocity(cursor->rb_guid, cursor->velocity);
             } break;
         case REQUEST_SET_ANGULAR_VELOCITY_BY_PATH: {
-            auto  cursor = make_request_cursor_to(m_requests_set_angular_velocity_by_path);
+            auto  cursor = make_request_cursor_to(m_requests.set_angular_velocity_by_path);
             set_rigid_body_angular_velocity(from_relative_path(cursor->base_folder_guid, cursor->relative_path_to_rigid_body),
                                             cursor->velocity);
             } break;
         case REQUEST_MUL_LINEAR_VELOCITY: {
-            auto  cursor = make_request_cursor_to(m_requests_mul_linear_velocity);
+            auto  cursor = make_request_cursor_to(m_requests.mul_linear_velocity);
             vector3 const  velocity = mul_components(cursor->velocity_scale, linear_velocity_of_rigid_body(cursor->rb_guid));
             set_rigid_body_linear_velocity(cursor->rb_guid, velocity);
             } break;
         case REQUEST_MUL_LINEAR_VELOCITY_BY_PATH: {
-            auto  cursor = make_request_cursor_to(m_requests_mul_linear_velocity_by_path);
+            auto  cursor = make_request_cursor_to(m_requests.mul_linear_velocity_by_path);
             object_guid const  rb_guid = from_relative_path(cursor->base_folder_guid, cursor->relative_path_to_rigid_body);
             vector3 const  velocity = mul_components(cursor->velocity_scale, linear_velocity_of_rigid_body(rb_guid));
             set_rigid_body_linear_velocity(rb_guid, velocity);
             } break;
         case REQUEST_MUL_ANGULAR_VELOCITY: {
-            auto  cursor = make_request_cursor_to(m_requests_mul_angular_velocity);
+            auto  cursor = make_request_cursor_to(m_requests.mul_angular_velocity);
             vector3 const  velocity = mul_components(cursor->velocity_scale, angular_velocity_of_rigid_body(cursor->rb_guid));
             set_rigid_body_angular_velocity(cursor->rb_guid, velocity);
             } break;
         case REQUEST_MUL_ANGULAR_VELOCITY_BY_PATH: {
-            auto  cursor = make_request_cursor_to(m_requests_mul_angular_velocity_by_path);
+            auto  cursor = make_request_cursor_to(m_requests.mul_angular_velocity_by_path);
             object_guid const  rb_guid = from_relative_path(cursor->base_folder_guid, cursor->relative_path_to_rigid_body);
             vector3 const  velocity = mul_components(cursor->velocity_scale, angular_velocity_of_rigid_body(rb_guid));
             set_rigid_body_angular_velocity(rb_guid, velocity);
             } break;
         case REQUEST_SET_LINEAR_ACCEL: {
-            auto  cursor = make_request_cursor_to(m_requests_set_linear_acceleration_from_source);
+            auto  cursor = make_request_cursor_to(m_requests.set_linear_acceleration_from_source);
             set_rigid_body_linear_acceleration_from_source(cursor->rb_guid, cursor->source_id, cursor->acceleration);
             } break;
         case REQUEST_SET_ANGULAR_ACCEL: {
-            auto  cursor = make_request_cursor_to(m_requests_set_angular_acceleration_from_source);
+            auto  cursor = make_request_cursor_to(m_requests.set_angular_acceleration_from_source);
             set_rigid_body_angular_acceleration_from_source(cursor->rb_guid, cursor->source_id, cursor->acceleration);
             } break;
         case REQUEST_DEL_LINEAR_ACCEL: {
-            auto  cursor = make_request_cursor_to(m_requests_del_linear_acceleration_from_source);
+            auto  cursor = make_request_cursor_to(m_requests.del_linear_acceleration_from_source);
             remove_rigid_body_linear_acceleration_from_source(cursor->rb_guid, cursor->source_id);
             } break;
         case REQUEST_DEL_ANGULAR_ACCEL: {
-            auto  cursor = make_request_cursor_to(m_requests_del_angular_acceleration_from_source);
+            auto  cursor = make_request_cursor_to(m_requests.del_angular_acceleration_from_source);
             remove_rigid_body_angular_acceleration_from_source(cursor->rb_guid, cursor->source_id);
             } break;
         case REQUEST_ERASE_TIMER:
-            erase_timer(*make_request_cursor_to(m_requests_erase_timer));
+            erase_timer(*make_request_cursor_to(m_requests.erase_timer));
             break;
         case REQUEST_ERASE_SENSOR:
-            erase_sensor(*make_request_cursor_to(m_requests_erase_sensor));
+            erase_sensor(*make_request_cursor_to(m_requests.erase_sensor));
             break;
         case REQUEST_ERASE_AGENT:
-            erase_agent(*make_request_cursor_to(m_requests_erase_agent));
+            erase_agent(*make_request_cursor_to(m_requests.erase_agent));
             break;
         default: UNREACHABLE(); break;
         }
@@ -3549,36 +3726,36 @@ void  simulation_context::process_pending_requests()
 
 void  simulation_context::clear_pending_requests()
 {
-    m_pending_requests.clear();
-    m_requests_erase_folder.clear();
-    m_requests_erase_frame.clear();
-    m_requests_relocate_frame.clear();
-    m_requests_set_parent_frame.clear();
-    m_requests_erase_batch.clear();
-    m_requests_enable_collider.clear();
-    m_requests_enable_colliding.clear();
-    m_requests_enable_colliding_by_path.clear();
-    m_requests_insert_collider_box.clear();
-    m_requests_insert_collider_capsule.clear();
-    m_requests_insert_collider_sphere.clear();
-    m_requests_erase_collider.clear();
-    m_requests_insert_rigid_body.clear();
-    m_requests_erase_rigid_body.clear();
-    m_requests_set_linear_velocity.clear();
-    m_requests_set_linear_velocity_by_path.clear();
-    m_requests_set_angular_velocity.clear();
-    m_requests_set_angular_velocity_by_path.clear();
-    m_requests_mul_linear_velocity.clear();
-    m_requests_mul_linear_velocity_by_path.clear();
-    m_requests_mul_angular_velocity.clear();
-    m_requests_mul_angular_velocity_by_path.clear();
-    m_requests_set_linear_acceleration_from_source.clear();
-    m_requests_set_angular_acceleration_from_source.clear();
-    m_requests_del_linear_acceleration_from_source.clear();
-    m_requests_del_angular_acceleration_from_source.clear();
-    m_requests_erase_timer.clear();
-    m_requests_erase_sensor.clear();
-    m_requests_erase_agent.clear();
+    m_requests.pending.clear();
+    m_requests.erase_folder.clear();
+    m_requests.erase_frame.clear();
+    m_requests.relocate_frame.clear();
+    m_requests.set_parent_frame.clear();
+    m_requests.erase_batch.clear();
+    m_requests.enable_collider.clear();
+    m_requests.enable_colliding.clear();
+    m_requests.enable_colliding_by_path.clear();
+    m_requests.insert_collider_box.clear();
+    m_requests.insert_collider_capsule.clear();
+    m_requests.insert_collider_sphere.clear();
+    m_requests.erase_collider.clear();
+    m_requests.insert_rigid_body.clear();
+    m_requests.erase_rigid_body.clear();
+    m_requests.set_linear_velocity.clear();
+    m_requests.set_linear_velocity_by_path.clear();
+    m_requests.set_angular_velocity.clear();
+    m_requests.set_angular_velocity_by_path.clear();
+    m_requests.mul_linear_velocity.clear();
+    m_requests.mul_linear_velocity_by_path.clear();
+    m_requests.mul_angular_velocity.clear();
+    m_requests.mul_angular_velocity_by_path.clear();
+    m_requests.set_linear_acceleration_from_source.clear();
+    m_requests.set_angular_acceleration_from_source.clear();
+    m_requests.del_linear_acceleration_from_source.clear();
+    m_requests.del_angular_acceleration_from_source.clear();
+    m_requests.erase_timer.clear();
+    m_requests.erase_sensor.clear();
+    m_requests.erase_agent.clear();
 }
 
 
@@ -3687,6 +3864,108 @@ void  simulation_context::clear_relocated_frame_guids()
 }
 
 
+/////////////////////////////////////////////////////////////////////////////////////
+// PARALLEL ACCESS API
+/////////////////////////////////////////////////////////////////////////////////////
+
+
+thread_local simulation_context::requests_buffer*  simulation_context::s_recording_requests_buffer = nullptr;
+
+
+simulation_context::requests_buffer_ptr  simulation_context::create_requests_buffer()
+{
+    return std::make_shared<requests_buffer>();
+}
+
+
+void  simulation_context::begin_recording_requests(requests_buffer&  buffer)
+{
+    ASSUMPTION(s_recording_requests_buffer == nullptr);
+    s_recording_requests_buffer = &buffer;
+}
+
+
+void  simulation_context::end_recording_requests()
+{
+    ASSUMPTION(s_recording_requests_buffer != nullptr);
+    s_recording_requests_buffer = nullptr;
+}
+
+
+void  simulation_context::freeze()
+{
+    TMPROF_BLOCK();
+
+    ASSUMPTION(!m_frozen);
+    m_frames_provider.update_cached_data();
+    for (auto  ptr : *m_collision_scenes_ptr)
+        if (ptr != nullptr)
+            ptr->rebalance_proximity_maps_if_needed();
+    m_frozen = true;
+}
+
+
+void  simulation_context::unfreeze()
+{
+    ASSUMPTION(m_frozen);
+    m_frozen = false;
+}
+
+
+void  simulation_context::commit_recorded_requests(requests_buffer&  buffer) const
+{
+    ASSUMPTION(&buffer != &m_requests);
+    m_requests.splice(buffer);
+}
+
+
+simulation_context::requests_buffer&  simulation_context::requests() const
+{
+    if (s_recording_requests_buffer != nullptr)
+        return *s_recording_requests_buffer;
+    ASSUMPTION(!m_frozen);
+    return m_requests;
+}
+
+
+void  simulation_context::requests_buffer::splice(requests_buffer&  other)
+{
+    pending_early.splice(pending_early.end(), other.pending_early);
+    early_insert_custom_constraint.splice(early_insert_custom_constraint.end(), other.early_insert_custom_constraint);
+    early_insert_instant_constraint.splice(early_insert_instant_constraint.end(), other.early_insert_instant_constraint);
+    pending.splice(pending.end(), other.pending);
+    erase_folder.splice(erase_folder.end(), other.erase_folder);
+    erase_frame.splice(erase_frame.end(), other.erase_frame);
+    relocate_frame.splice(relocate_frame.end(), other.relocate_frame);
+    set_parent_frame.splice(set_parent_frame.end(), other.set_parent_frame);
+    erase_batch.splice(erase_batch.end(), other.erase_batch);
+    enable_collider.splice(enable_collider.end(), other.enable_collider);
+    enable_colliding.splice(enable_colliding.end(), other.enable_colliding);
+    enable_colliding_by_path.splice(enable_colliding_by_path.end(), other.enable_colliding_by_path);
+    insert_collider_box.splice(insert_collider_box.end(), other.insert_collider_box);
+    insert_collider_capsule.splice(insert_collider_capsule.end(), other.insert_collider_capsule);
+    insert_collider_sphere.splice(insert_collider_sphere.end(), other.insert_collider_sphere);
+    erase_collider.splice(erase_collider.end(), other.erase_collider);
+    insert_rigid_body.splice(insert_rigid_body.end(), other.insert_rigid_body);
+    erase_rigid_body.splice(erase_rigid_body.end(), other.erase_rigid_body);
+    set_linear_velocity.splice(set_linear_velocity.end(), other.set_linear_velocity);
+    set_linear_velocity_by_path.splice(set_linear_velocity_by_path.end(), other.set_linear_velocity_by_path);
+    set_angular_velocity.splice(set_angular_velocity.end(), other.set_angular_velocity);
+    set_angular_velocity_by_path.splice(set_angular_velocity_by_path.end(), other.set_angular_velocity_by_path);
+    mul_linear_velocity.splice(mul_linear_velocity.end(), other.mul_linear_velocity);
+    mul_linear_velocity_by_path.splice(mul_linear_velocity_by_path.end(), other.mul_linear_velocity_by_path);
+    mul_angular_velocity.splice(mul_angular_velocity.end(), other.mul_angular_velocity);
+    mul_angular_velocity_by_path.splice(mul_angular_velocity_by_path.end(), other.mul_angular_velocity_by_path);
+    set_linear_acceleration_from_source.splice(set_linear_acceleration_from_source.end(), other.set_linear_acceleration_from_source);
+    set_angular_acceleration_from_source.splice(set_angular_acceleration_from_source.end(), other.set_angular_acceleration_from_source);
+    del_linear_acceleration_from_source.splice(del_linear_acceleration_from_source.end(), other.del_linear_acceleration_from_source);
+    del_angular_acceleration_from_source.splice(del_angular_acceleration_from_source.end(), other.del_angular_acceleration_from_source);
+    erase_timer.splice(erase_timer.end(), other.erase_timer);
+    erase_sensor.splice(erase_sensor.end(), other.erase_sensor);
+    erase_agent.splice(erase_agent.end(), other.erase_agent);
+}
+
+
 /////////////////////////////////////////////////////////////////////////////////////
 // SCENE CLEAR API
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3719,8 +3998,8 @@ void  simulation_context::clear(bool const  also_caches)
     INVARIANT(
         folder_content(root_folder()).content.empty() &&
         folder_content(root_folder()).child_folders.empty() &&
-        m_pending_requests_early.empty() &&
-        m_pending_requests.empty() &&
+        m_requests.pending_early.empty() &&
+        m_requests.pending.empty() &&
         m_requests_late_scene_import.empty() &&
         m_requests_late_insert_agent.empty()
         );
@@ -34,6 +34,9 @@ simulator::simulation_configuration::simulation_configuration()
     : MAX_SIMULATION_TIME_DELTA(1.0f / 30.0f)
     , MAX_NUM_SUB_SIMULATION_STEPS(1U)
 
+    , FIXED_TIME_STEP(false)
+    , SIMULATE_IN_SEPARATE_THREAD(false)
+
     , simulation_time_buffer(0.0f)
     , last_time_step(0.0f)
 
@@ -66,6 +69,7 @@ simulator::render_configuration::render_configuration(gfx::viewport const&  vp,
     , text_shift{ 0.0f, -1.0f, 0.0f }
     , text_ambient_colour{ 1.0f, 0.0f, 1.0f }
     , fps_prefix("FPS:")
+    , sps_prefix("SPS:")
     , batch_grid(gfx::create_default_grid())
     , batch_frame(gfx::create_basis_vectors())
     , batch_sensory_collision_contact(gfx::create_arrow(0.1f, { 1.0f, 1.0f, 0.0f, 1.0f }))
@@ -213,19 +217,49 @@ simulator::simulator(std::string const&  data_root_dir)
     , m_active_viewport(VIEWPORT_TYPE::SCENE)
 
     , m_simulation_config()
+    , m_render_thread_simulation_config()
+    , m_render_thread_simulation_config_base()
+    , m_render_thread_id()
+    , m_has_context_in_round(true)
+    , m_actions_with_context()
     , m_render_config(*m_viewports.at((std::size_t)m_active_viewport), m_context->get_data_root_dir())
 
     , m_console(m_render_config.font_props, m_viewports.at((std::size_t)VIEWPORT_TYPE::CONSOLE))
     , m_output_text_box(m_render_config.font_props, m_viewports.at((std::size_t)VIEWPORT_TYPE::OUTPUT))
 
+    , m_dirty_frames()
+    , m_dirty_frames_set()
+
     , m_FPS_num_rounds(0U)
     , m_FPS_time(0.0f)
     , m_FPS(0U)
 
+    , m_SPS_num_steps(0U)
+    , m_SPS(0U)
+
+    , m_scene_snapshots()
+    , m_scene_snapshot_previous(0U)
+    , m_scene_snapshot_current(1U)
+    , m_scene_snapshot_back(2U)
+    , m_scene_snapshot_interpolation_param(1.0f)
+    , m_scene_snapshots_mutex()
+
+    , m_simulation_thread()
+    , m_simulation_thread_stop(false)
+    , m_context_mutex()
+    , m_context_lock(m_context_mutex, std::defer_lock)
+    , m_context_lock_requested(false)
+    , m_context_handoff_mutex()
+    , m_context_handoff()
+    , m_simulation_thread_mock_input(nullptr)
+    , m_simulation_thread_mock_input_untaken(nullptr)
+    , m_simulation_thread_mock_input_mutex()
+
     , m_text_cache { "", gfx::batch(), 0.0f, 0.0f }
 
     // Debug draw data
 
+    , m_debug_snapshot { {}, {}, false, "" }
     , m_collider_batches_cache()    
     , m_ai_debug_draw_data()
 {
@@ -238,6 +272,8 @@ simulator::simulator(std::string const&  data_root_dir)
 
 simulator::~simulator()
 {
+    stop_simulation_thread();
+
     m_ai_simulator_ptr.reset();
     m_device_simulator_ptr.reset();
     m_rigid_body_simulator_ptr.reset();
@@ -262,6 +298,7 @@ void  simulator::initialise()
 
 void  simulator::terminate()
 {
+    stop_simulation_thread();
     context()->clear(true);
     render_config().terminate();
     osi::simulator::terminate();
@@ -295,31 +332,98 @@ void  simulator::round()
 
     bool const  is_window_minimised = get_window_props().minimised();
 
+#if PLATFORM() != PLATFORM_WEBASSEMBLY()
+    if (simulation_config().SIMULATE_IN_SEPARATE_THREAD != is_simulation_thread_running())
+    {
+        if (simulation_config().SIMULATE_IN_SEPARATE_THREAD)
+            start_simulation_thread();
+        else
+            stop_simulation_thread();
+    }
+#endif
+
     if (!is_window_minimised)
         update_viewports();
 
-    on_begin_round();
-
-        if (!is_window_minimised)
+    bool  has_context = true;
+    if (is_simulation_thread_running())
+    {
         {
-            ++m_FPS_num_rounds;
-            m_FPS_time += round_seconds();
-            if (m_FPS_time >= 0.25f)
+            std::shared_ptr<ai::cortex::mock_input_props const> const  mock_input = capture_mock_input();
+            std::lock_guard<std::mutex> const  lock(m_simulation_thread_mock_input_mutex);
+            if (mock_input != nullptr && m_simulation_thread_mock_input_untaken != nullptr)
             {
-                m_FPS = (natural_32_bit)(m_FPS_num_rounds / m_FPS_time + 0.5f);
-                m_FPS_num_rounds = 0U;
-                do m_FPS_time -= 0.25f; while (m_FPS_time >= 0.25f);
+                auto const  merged_mock_input = std::make_shared<ai::cortex::mock_input_props>(*mock_input);
+                merged_mock_input->keys_pressed.insert(m_simulation_thread_mock_input_untaken->keys_pressed.begin(),
+                                                       m_simulation_thread_mock_input_untaken->keys_pressed.end());
+                merged_mock_input->buttons_pressed.insert(m_simulation_thread_mock_input_untaken->buttons_pressed.begin(),
+                                                          m_simulation_thread_mock_input_untaken->buttons_pressed.end());
+                m_simulation_thread_mock_input_untaken = merged_mock_input;
             }
-            if (render_config().render_text && render_config().render_fps)
-                SLOG(render_config().fps_prefix << FPS() << "\n");
-                //CLOG(render_config().fps_prefix << FPS());
+            else
+                m_simulation_thread_mock_input_untaken = mock_input;
+            m_simulation_thread_mock_input = mock_input;
+        }
+
+        // When the simulation thread is in the middle of its steps, we do not wait for it. The work of
+        // the round accessing the context is then skipped and we only render from the snapshots. Only
+        // the console waits for the context, because its commands and the completion of paths read it.
+        if (render_config().show_console && active_viewport_type() == VIEWPORT_TYPE::CONSOLE)
+            lock_context_for_render_thread();
+        else
+            has_context = try_lock_context_for_render_thread();
+    }
+    m_has_context_in_round = has_context;
+
+    if (!is_window_minimised)
+    {
+        ++m_FPS_num_rounds;
+        m_FPS_time += round_seconds();
+        if (m_FPS_time >= 0.25f)
+        {
+            m_FPS = (natural_32_bit)(m_FPS_num_rounds / m_FPS_time + 0.5f);
+            m_SPS = (natural_32_bit)(m_SPS_num_steps.exchange(0U) / m_FPS_time + 0.5f);
+            m_FPS_num_rounds = 0U;
+            do m_FPS_time -= 0.25f; while (m_FPS_time >= 0.25f);
+        }
+        if (render_config().render_text && render_config().render_fps)
+        {
+            SLOG(render_config().fps_prefix << FPS() << "\n");
+            //CLOG(render_config().fps_prefix << FPS());
+            if (simulation_config().FIXED_TIME_STEP || is_simulation_thread_running())
+                SLOG(render_config().sps_prefix << SPS() << "\n");
         }
+    }
+
+    if (has_context && !m_actions_with_context.empty())
+    {
+        std::vector<std::function<void()> > const  actions = std::move(m_actions_with_context);
+        m_actions_with_context.clear();
+        for (std::function<void()> const&  action : actions)
+            action();
+    }
+
+    // The callback is called in each round, so no input is lost. In rounds without the context, it must access
+    // the context only through 'call_with_context'.
+    on_begin_round();
+
+    if (!has_context)
+        screen_text_logger::instance().append(m_debug_snapshot.screen_text);
+    else
+    {
+        std::size_t const  screen_text_begin = screen_text_logger::instance().text().size();
 
         on_begin_simulation();
             context()->process_pending_late_requests();
             if (render_config().show_console == true)
                 update_console();
-            if (!simulation_config().paused)
+            if (is_simulation_thread_running())
+            {
+                // The simulation steps are performed in the simulation thread.
+                if (simulation_config().paused)
+                    SLOG("PAUSED\n");
+            }
+            else if (!simulation_config().paused)
             {
                 simulate();
 
@@ -337,20 +441,38 @@ void  simulator::round()
                     context()->process_pending_requests();
                     update_collider_locations_of_relocated_frames();
                 }
+                if (simulation_config().FIXED_TIME_STEP)
+                    capture_scene_snapshot(true);
                 SLOG("PAUSED\n");
             }
         on_end_simulation();
 
         if (!is_window_minimised)
-        {
-            on_begin_camera_update();
-                camera_update();
-            on_end_camera_update();
+            capture_debug_snapshot();
+
+        m_debug_snapshot.screen_text = screen_text_logger::instance().text().substr(
+                std::min(screen_text_begin, screen_text_logger::instance().text().size())
+                );
 
-            on_begin_render();
-                render();
-            on_end_render();
+        if (m_context_lock.owns_lock())
+        {
+            // Changes of the configuration from this and previous rounds are passed to the simulation thread.
+            synchronise_simulation_configs();
+            m_context_lock.unlock();
+            m_has_context_in_round = false;
         }
+    }
+
+    if (!is_window_minimised)
+    {
+        on_begin_camera_update();
+            camera_update();
+        on_end_camera_update();
+
+        on_begin_render();
+            render();
+        on_end_render();
+    }
 
     on_end_round();
 }
@@ -360,54 +482,389 @@ void  simulator::simulate()
 {
     TMPROF_BLOCK();
 
-    simulation_context&  ctx = *context();
-
-    ai::cortex::mock_input_props const  mock_input{
-            &get_keyboard_props(), &get_mouse_props(), &get_window_props(), &get_viewport(VIEWPORT_TYPE::SCENE)
-            };
-    ai::cortex::mock_input_props const* const  mock_input_ptr =
-            render_config().camera_controller_type == CAMERA_CONTROLLER_TYPE::CAMERA_IS_LOCKED ? &mock_input : nullptr;
+    std::shared_ptr<ai::cortex::mock_input_props const> const  mock_input = capture_mock_input();
+    ai::cortex::mock_input_props const* const  mock_input_ptr = mock_input.get();
 
     simulation_config().simulation_time_buffer =
         std::min(simulation_config().simulation_time_buffer + round_seconds(),
                  (float_32_bit)simulation_config().MAX_NUM_SUB_SIMULATION_STEPS * simulation_config().MAX_SIMULATION_TIME_DELTA);
 
+    if (simulation_config().FIXED_TIME_STEP)
+    {
+        while (simulation_config().simulation_time_buffer >= simulation_config().MAX_SIMULATION_TIME_DELTA)
+        {
+            simulation_config().last_time_step = simulation_config().MAX_SIMULATION_TIME_DELTA;
+            simulation_config().simulation_time_buffer -= simulation_config().last_time_step;
+            simulation_step(mock_input_ptr);
+            capture_scene_snapshot(false);
+        }
+        m_scene_snapshot_interpolation_param =
+                simulation_config().simulation_time_buffer / simulation_config().MAX_SIMULATION_TIME_DELTA;
+        return;
+    }
+
     do
     {
         simulation_config().last_time_step = std::min(simulation_config().simulation_time_buffer,
                                                       simulation_config().MAX_SIMULATION_TIME_DELTA);
         simulation_config().simulation_time_buffer -= simulation_config().last_time_step;
+        simulation_step(mock_input_ptr);
+    }
+    while (simulation_config().simulation_time_buffer >= simulation_config().MAX_SIMULATION_TIME_DELTA);
+}
+
+
+std::shared_ptr<ai::cortex::mock_input_props const>  simulator::capture_mock_input() const
+{
+    if (render_config().camera_controller_type != CAMERA_CONTROLLER_TYPE::CAMERA_IS_LOCKED)
+        return nullptr;
+    return std::make_shared<ai::cortex::mock_input_props const>(
+            get_keyboard_props(), get_mouse_props(), get_viewport(VIEWPORT_TYPE::SCENE)
+            );
+}
 
-        ctx.clear_collision_contacts();
-        update_collision_contacts_and_constraints();
 
-        device_simulator()->next_round((simulation_context const&)ctx, simulation_config().last_time_step);
+void  simulator::simulation_step(ai::cortex::mock_input_props const* const  mock_input_ptr)
+{
+    TMPROF_BLOCK();
+
+    simulation_context&  ctx = *context();
+
+    ctx.clear_collision_contacts();
+    update_collision_contacts_and_constraints();
+
+    device_simulator()->next_round((simulation_context const&)ctx, simulation_config().last_time_step);
+    {
+        simulation_context_freeze_guard const  freeze_guard(ctx, ai_simulator()->num_worker_threads() > 1U);
         ai_simulator()->next_round(simulation_config().last_time_step, mock_input_ptr);
-        custom_module_round();
+    }
+    custom_module_round();
+
+    ctx.process_rigid_bodies_with_invalidated_shape();
+    ctx.process_pending_early_requests();
 
-        ctx.process_rigid_bodies_with_invalidated_shape();
-        ctx.process_pending_early_requests();
+    rigid_body_simulator()->solve_constraint_system(simulation_config().last_time_step, simulation_config().last_time_step * 0.75f);
+    rigid_body_simulator()->integrate_motion_of_rigid_bodies(simulation_config().last_time_step);
+    rigid_body_simulator()->prepare_contact_cache_and_constraint_system_for_next_frame();
+
+    ctx.clear_invalidated_guids();
+    ctx.clear_relocated_frame_guids();
+
+    for (auto  rb_it = ctx.moveable_rigid_bodies_begin(), rb_end = ctx.moveable_rigid_bodies_end(); rb_it != rb_end; ++rb_it)
+        ctx.frame_relocate(
+                ctx.frame_of_rigid_body(*rb_it),
+                ctx.mass_centre_of_rigid_body(*rb_it),
+                ctx.orientation_of_rigid_body(*rb_it),
+                true
+                );
 
-        rigid_body_simulator()->solve_constraint_system(simulation_config().last_time_step, simulation_config().last_time_step * 0.75f);
-        rigid_body_simulator()->integrate_motion_of_rigid_bodies(simulation_config().last_time_step);
-        rigid_body_simulator()->prepare_contact_cache_and_constraint_system_for_next_frame();
+    ctx.process_pending_requests();
 
-        ctx.clear_invalidated_guids();
-        ctx.clear_relocated_frame_guids();
+    update_collider_locations_of_relocated_frames();
 
-        for (auto  rb_it = ctx.moveable_rigid_bodies_begin(), rb_end = ctx.moveable_rigid_bodies_end(); rb_it != rb_end; ++rb_it)
-            ctx.frame_relocate(
-                    ctx.frame_of_rigid_body(*rb_it),
-                    ctx.mass_centre_of_rigid_body(*rb_it),
-                    ctx.orientation_of_rigid_body(*rb_it),
-                    true
+    ++m_SPS_num_steps;
+}
+
+
+void  simulator::capture_scene_snapshot(bool const  also_as_previous)
+{
+    TMPROF_BLOCK();
+
+    simulation_context&  ctx = *context();
+
+    scene_snapshot&  snapshot = m_scene_snapshots.at(m_scene_snapshot_back);
+    for (auto  it = snapshot.batches.begin(); it != snapshot.batches.end(); )
+        if (ctx.is_valid_batch_guid(it->first) && ctx.from_batch_guid(it->first) == it->second.batch_id)
+            ++it;
+        else
+            it = snapshot.batches.erase(it);
+    for (simulation_context::batch_guid_iterator  batch_it = ctx.batches_begin(), batch_end = ctx.batches_end();
+            batch_it != batch_end; ++batch_it)
+    {
+        object_guid const  batch_guid = *batch_it;
+        scene_snapshot::batch_instances&  instances = snapshot.batches[batch_guid];
+        if (instances.batch_id.empty())
+        {
+            instances.batch = ctx.from_batch_guid_to_batch(batch_guid);
+            instances.batch_id = ctx.from_batch_guid(batch_guid);
+            instances.matrices_to_pose_bones = ctx.matrices_to_pose_bones_of_batch(batch_guid);
+        }
+        instances.world_matrices.clear();
+        for (object_guid  frame_guid : ctx.frames_of_batch(batch_guid))
+            instances.world_matrices.push_back(ctx.frame_world_matrix(frame_guid));
+    }
+
+    std::lock_guard<std::mutex> const  lock(m_scene_snapshots_mutex);
+    snapshot.publish_time = std::chrono::steady_clock::now();
+    if (also_as_previous)
+    {
+        m_scene_snapshots.at(m_scene_snapshot_current) = snapshot; // The current becomes previous below.
+        m_scene_snapshot_interpolation_param = 1.0f;
+    }
+    std::swap(m_scene_snapshot_back, m_scene_snapshot_previous);
+    std::swap(m_scene_snapshot_previous, m_scene_snapshot_current);
+}
+
+
+void  simulator::collect_render_tasks_from_scene_snapshots(render_tasks_map&  render_tasks_opaque,
+                                                           render_tasks_map&  render_tasks_translucent)
+{
+    TMPROF_BLOCK();
+
+    std::lock_guard<std::mutex> const  lock(m_scene_snapshots_mutex);
+
+    scene_snapshot const&  previous = m_scene_snapshots.at(m_scene_snapshot_previous);
+    scene_snapshot const&  current = m_scene_snapshots.at(m_scene_snapshot_current);
+
+    float_32_bit  param = m_scene_snapshot_interpolation_param;
+    if (is_simulation_thread_running())
+    {
+        float_32_bit const  elapsed_seconds =
+                std::chrono::duration<float_32_bit>(std::chrono::steady_clock::now() - current.publish_time).count();
+        param = std::max(0.0f, std::min(1.0f, elapsed_seconds / simulation_config().MAX_SIMULATION_TIME_DELTA));
+    }
+
+    for (auto const&  guid_and_instances : current.batches)
+    {
+        scene_snapshot::batch_instances const&  instances = guid_and_instances.second;
+        if (!do_render_batch(guid_and_instances.first) || !instances.batch.loaded_successfully())
+            continue;
+
+        render_tasks_map&  tasks = instances.batch.is_translucent() ? render_tasks_translucent : render_tasks_opaque;
+
+        auto  it = tasks.find(instances.batch_id);
+        if (it == tasks.end())
+            it = tasks.insert({ instances.batch_id, { instances.batch, {}, instances.matrices_to_pose_bones } }).first;
+
+        auto const  previous_it = previous.batches.find(guid_and_instances.first);
+        if (param >= 1.0f
+                || previous_it == previous.batches.end()
+                || previous_it->second.batch_id != instances.batch_id
+                || previous_it->second.world_matrices.size() != instances.world_matrices.size())
+        {
+            it->second.world_matrices.insert(
+                    it->second.world_matrices.end(),
+                    instances.world_matrices.begin(),
+                    instances.world_matrices.end()
+                    );
+            continue;
+        }
+        for (std::size_t  i = 0UL; i != instances.world_matrices.size(); ++i)
+        {
+            vector3  origin[2];
+            matrix33  rotation[2];
+            decompose_matrix44(previous_it->second.world_matrices.at(i), origin[0], rotation[0]);
+            decompose_matrix44(instances.world_matrices.at(i), origin[1], rotation[1]);
+            it->second.world_matrices.push_back({});
+            compose_from_base_matrix(
+                    interpolate_linear(origin[0], origin[1], param),
+                    quaternion_to_rotation_matrix(interpolate_spherical(
+                            rotation_matrix_to_quaternion(rotation[0]),
+                            rotation_matrix_to_quaternion(rotation[1]),
+                            param
+                            )),
+                    it->second.world_matrices.back()
                     );
+        }
+    }
+}
+
+
+void  simulator::start_simulation_thread()
+{
+    ASSUMPTION(!is_simulation_thread_running());
+    {
+        std::lock_guard<std::mutex> const  lock(m_context_mutex);
+        capture_scene_snapshot(true);
+    }
+    m_render_thread_simulation_config = m_simulation_config;
+    m_render_thread_simulation_config_base = m_simulation_config;
+    m_render_thread_id = std::this_thread::get_id();
+    m_simulation_thread_stop = false;
+    m_simulation_thread = std::thread(&simulator::simulation_thread_worker, this);
+}
+
+
+void  simulator::stop_simulation_thread()
+{
+    if (!is_simulation_thread_running())
+        return;
+    if (m_context_lock.owns_lock())
+        m_context_lock.unlock();
+    {
+        std::lock_guard<std::mutex> const  lock(m_context_handoff_mutex);
+        m_simulation_thread_stop = true;
+    }
+    m_context_handoff.notify_all();
+    m_simulation_thread.join();
+    synchronise_simulation_configs();
+    m_render_thread_id = std::thread::id();
+    m_has_context_in_round = true;
+    m_simulation_thread_mock_input = nullptr;
+    m_simulation_thread_mock_input_untaken = nullptr;
+    m_context_lock_requested = false;
+}
+
+
+bool  simulator::try_lock_context_for_render_thread()
+{
+    ASSUMPTION(!m_context_lock.owns_lock());
+    bool const  locked = m_context_lock.try_lock();
+    {
+        // When we fail, the request makes the simulation thread wait for us after its current steps.
+        std::lock_guard<std::mutex> const  lock(m_context_handoff_mutex);
+        m_context_lock_requested = !locked;
+    }
+    if (locked)
+        m_context_handoff.notify_all();
+    return locked;
+}
+
+
+void  simulator::lock_context_for_render_thread()
+{
+    ASSUMPTION(!m_context_lock.owns_lock());
+    {
+        std::lock_guard<std::mutex> const  lock(m_context_handoff_mutex);
+        m_context_lock_requested = true;
+    }
+    m_context_lock.lock();
+    {
+        std::lock_guard<std::mutex> const  lock(m_context_handoff_mutex);
+        m_context_lock_requested = false;
+    }
+    m_context_handoff.notify_all();
+}
+
+
+void  simulator::synchronise_simulation_configs()
+{
+    // Only fields changed by the render thread since the last synchronisation are applied, so changes made by the
+    // simulation thread meanwhile (e.g. the pause after 'num_rounds_to_pause' steps) are kept. The time buffer and
+    // the last time step are owned by the simulation thread.
+    simulation_configuration&  cfg = m_simulation_config;
+    simulation_configuration const&  render_cfg = m_render_thread_simulation_config;
+    simulation_configuration const&  base = m_render_thread_simulation_config_base;
+    auto const  apply_change = [](auto&  value, auto const&  render_value, auto const&  base_value) {
+        if (render_value != base_value)
+            value = render_value;
+    };
+    apply_change(cfg.MAX_SIMULATION_TIME_DELTA, render_cfg.MAX_SIMULATION_TIME_DELTA, base.MAX_SIMULATION_TIME_DELTA);
+    apply_change(cfg.MAX_NUM_SUB_SIMULATION_STEPS, render_cfg.MAX_NUM_SUB_SIMULATION_STEPS, base.MAX_NUM_SUB_SIMULATION_STEPS);
+    apply_change(cfg.FIXED_TIME_STEP, render_cfg.FIXED_TIME_STEP, base.FIXED_TIME_STEP);
+    apply_change(cfg.SIMULATE_IN_SEPARATE_THREAD, render_cfg.SIMULATE_IN_SEPARATE_THREAD, base.SIMULATE_IN_SEPARATE_THREAD);
+    apply_change(cfg.paused, render_cfg.paused, base.paused);
+    apply_change(cfg.num_rounds_to_pause, render_cfg.num_rounds_to_pause, base.num_rounds_to_pause);
+    m_render_thread_simulation_config = cfg;
+    m_render_thread_simulation_config_base = cfg;
+}
+
+
+void  simulator::call_with_context(std::function<void()> const&  action)
+{
+    if (m_has_context_in_round)
+        action();
+    else
+        m_actions_with_context.push_back(action);
+}
+
+
+void  simulator::simulation_thread_worker()
+{
+    TMPROF_BLOCK();
+
+    std::chrono::steady_clock::time_point  last_time = std::chrono::steady_clock::now();
+    while (!m_simulation_thread_stop)
+    {
+        bool  simulated = false;
+        {
+            std::lock_guard<std::mutex> const  lock(m_context_mutex);
+
+            std::chrono::steady_clock::time_point const  now = std::chrono::steady_clock::now();
+            float_32_bit const  time_delta = std::chrono::duration<float_32_bit>(now - last_time).count();
+            last_time = now;
+
+            if (!simulation_config().paused)
+            {
+                simulation_config().simulation_time_buffer =
+                    std::min(simulation_config().simulation_time_buffer + time_delta,
+                             (float_32_bit)simulation_config().MAX_NUM_SUB_SIMULATION_STEPS *
+                                simulation_config().MAX_SIMULATION_TIME_DELTA);
+                std::shared_ptr<ai::cortex::mock_input_props const>  mock_input;
+                std::shared_ptr<ai::cortex::mock_input_props const>  first_step_mock_input;
+                if (simulation_config().simulation_time_buffer >= simulation_config().MAX_SIMULATION_TIME_DELTA)
+                {
+                    // The untaken input is consumed only by a step, so no press is lost or passed to several steps.
+                    std::lock_guard<std::mutex> const  lock(m_simulation_thread_mock_input_mutex);
+                    mock_input = m_simulation_thread_mock_input;
+                    first_step_mock_input = m_simulation_thread_mock_input_untaken != nullptr ?
+                                                    m_simulation_thread_mock_input_untaken : mock_input;
+                    m_simulation_thread_mock_input_untaken = nullptr;
+                }
+                // The render thread does not wait for us, so we perform all due steps at once. It gets the
+                // context (if it asks for it) only after that.
+                while (!simulation_config().paused
+                       && simulation_config().simulation_time_buffer >= simulation_config().MAX_SIMULATION_TIME_DELTA)
+                {
+                    simulation_config().last_time_step = simulation_config().MAX_SIMULATION_TIME_DELTA;
+                    simulation_config().simulation_time_buffer -= simulation_config().last_time_step;
+                    simulation_step(simulated ? mock_input.get() : first_step_mock_input.get());
+                    capture_scene_snapshot(false);
+                    simulated = true;
+
+                    if (simulation_config().num_rounds_to_pause > 0U)
+                    {
+                        --simulation_config().num_rounds_to_pause;
+                        if (simulation_config().num_rounds_to_pause == 0U)
+                            simulation_config().paused = true;
+                    }
+                }
+            }
+            else if (context()->has_pending_requests())
+            {
+                context()->process_pending_requests();
+                update_collider_locations_of_relocated_frames();
+                capture_scene_snapshot(true);
+            }
+        }
+        // The render thread only tries to lock the mutex (once per round), so we must not lock it right
+        // away again, if it asked for it. We sleep till it gets the lock in its next round.
+        if (!simulated)
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        std::unique_lock<std::mutex>  lock(m_context_handoff_mutex);
+        m_context_handoff.wait(lock, [this]() { return !m_context_lock_requested || m_simulation_thread_stop; });
+    }
+}
 
-        ctx.process_pending_requests();
 
+void  simulator::run_headless(natural_32_bit const  num_steps)
+{
+    TMPROF_BLOCK();
+
+    ASSUMPTION(!is_simulation_thread_running());
+
+    simulation_context&  ctx = *context();
+
+    while (ctx.has_pending_late_requests())
+    {
+        ctx.process_pending_late_requests();
+        if (ctx.has_pending_late_requests())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (ctx.has_pending_requests())
+    {
+        ctx.process_pending_requests();
         update_collider_locations_of_relocated_frames();
     }
-    while (simulation_config().simulation_time_buffer >= simulation_config().MAX_SIMULATION_TIME_DELTA);
+
+    for (natural_32_bit  i = 0U; i != num_steps; ++i)
+    {
+        on_begin_simulation();
+            ctx.process_pending_late_requests();
+            simulation_config().last_time_step = simulation_config().MAX_SIMULATION_TIME_DELTA;
+            simulation_step(nullptr);
+        on_end_simulation();
+    }
 }
 
 
@@ -508,25 +965,30 @@ void  simulator::update_collider_locations_of_relocated_frames()
     TMPROF_BLOCK();
 
     simulation_context&  ctx = *context();
+
+    // The dirty set consists of all relocated frames and all their descendants in the frame hierarchy. Each
+    // dirty frame is visited exactly once (the frame sub-tree of an already visited frame is never walked again),
+    // so the pass is linear in the number of dirty frames plus the number of colliders bound to them.
+    m_dirty_frames.clear();
+    m_dirty_frames_set.clear();
     for (object_guid  frame_guid : ctx.relocated_frame_guids())
-        if (ctx.is_valid_frame_guid(frame_guid))
-        {
-            bool  has_relocated_parent = false;
-            for (object_guid  closest_frame_guid = ctx.find_closest_frame(ctx.folder_of_frame(frame_guid), false);
-                    closest_frame_guid != invalid_object_guid();
-                    closest_frame_guid = ctx.find_closest_frame(ctx.folder_of_frame(closest_frame_guid), false))
-                if (ctx.relocated_frame_guids().count(closest_frame_guid) != 0UL)
-                {
-                    has_relocated_parent = true;
-                    break;
-                }
-            if (!has_relocated_parent)
-                ctx.for_each_object_of_kind_under_folder(ctx.folder_of_frame(frame_guid), true, OBJECT_KIND::COLLIDER,
-                    [&ctx](object_guid const  collider_guid) -> bool {
-                        ctx.relocate_collider(collider_guid, ctx.frame_world_matrix(ctx.frame_of_collider(collider_guid)));
-                        return true;
-                    });
-        }
+        if (ctx.is_valid_frame_guid(frame_guid) && m_dirty_frames_set.insert(frame_guid).second)
+            m_dirty_frames.push_back(frame_guid);
+    for (std::size_t  i = 0UL; i < m_dirty_frames.size(); ++i)
+    {
+        std::size_t const  first_child_index = m_dirty_frames.size();
+        ctx.direct_children_frames(m_dirty_frames.at(i), m_dirty_frames);
+        for (std::size_t  j = first_child_index; j < m_dirty_frames.size(); )
+            if (m_dirty_frames_set.insert(m_dirty_frames.at(j)).second)
+                ++j;
+            else
+            {
+                m_dirty_frames.at(j) = m_dirty_frames.back();
+                m_dirty_frames.pop_back();
+            }
+    }
+
+    ctx.relocate_colliders_of_frames(m_dirty_frames);
 }
 
 
@@ -592,13 +1054,18 @@ void  simulator::render()
 {
     TMPROF_BLOCK();
 
-    simulation_context&  ctx = *context();
     render_configuration&  cfg = render_config();
 
     render_tasks_map  render_tasks_opaque;
     render_tasks_map  render_tasks_translucent;
 
-    if (cfg.render_scene_batches)
+    // When the simulation runs in the separate thread, nothing below accesses the context.
+    bool const  use_scene_snapshots = simulation_config().FIXED_TIME_STEP || is_simulation_thread_running();
+    if (cfg.render_scene_batches && use_scene_snapshots)
+        collect_render_tasks_from_scene_snapshots(render_tasks_opaque, render_tasks_translucent);
+    else if (cfg.render_scene_batches)
+    {
+        simulation_context&  ctx = *context();
         for (simulation_context::batch_guid_iterator  batch_it = ctx.batches_begin(), batch_end = ctx.batches_end();
              batch_it != batch_end; ++batch_it)
         {
@@ -622,6 +1089,7 @@ void  simulator::render()
             for (object_guid  frame_guid : ctx.frames_of_batch(batch_guid))
                 it->second.world_matrices.push_back(ctx.frame_world_matrix(frame_guid));
         }
+    }
 
     // Here we start the actual rendering of batches collected above.
 
@@ -641,30 +1109,7 @@ void  simulator::render()
     if (cfg.render_grid && cfg.batch_grid.loaded_successfully())
         render_grid();
 
-    if (cfg.render_frames && cfg.batch_frame.loaded_successfully())
-        render_frames();
-
-    if (cfg.render_colliders_of_rigid_bodies
-            || cfg.render_colliders_of_fields
-            || cfg.render_colliders_of_sensors
-            || cfg.render_colliders_of_agents
-            || cfg.render_colliders_of_ray_casts
-            )
-        render_colliders();
-
-    if (cfg.render_collision_contacts)
-        render_collision_contacts();
-
-    if (cfg.render_sight_frustums)
-        render_sight_frustums();
-    if (cfg.render_sight_contacts_directed || cfg.render_sight_contacts_random)
-        render_sight_contacts();
-    if (cfg.render_sight_image)
-        render_sight_image();
-    if (cfg.render_agent_action_transition_contratints)
-        render_agent_action_transition_contratints();
-    if (cfg.render_ai_navigation_data)
-        render_ai_navigation_data();
+    render_debug_snapshot();
 
     custom_render();
 
@@ -701,19 +1146,125 @@ void  simulator::render_batch(gfx::batch  batch, std::vector<matrix44> const&  w
 }
 
 
+void  simulator::render_batch(gfx::batch  batch, std::vector<matrix44> const&  world_matrices,
+                             std::vector<matrix44> const&  matrices_to_pose_bones)
+{
+    render_configuration&  cfg = render_config();
+    gfx::render_batch(
+            batch,
+            world_matrices,
+            matrices_to_pose_bones,
+            cfg.matrix_from_world_to_camera,
+            cfg.matrix_from_camera_to_clipspace,
+            cfg.diffuse_colour,
+            cfg.ambient_colour,
+            cfg.specular_colour,
+            cfg.directional_light_direction_in_camera_space,
+            cfg.directional_light_colour,
+            true,
+            cfg.fog_colour,
+            cfg.fog_near,
+            cfg.fog_far,
+            &cfg.draw_state
+            );
+}
+
+
 void  simulator::render_task(render_task_info const&  task)
 {
-    render_batch(task.batch, task.world_matrices);
+    if (simulation_config().FIXED_TIME_STEP || is_simulation_thread_running())
+        render_batch(task.batch, task.world_matrices, task.matrices_to_pose_bones);
+    else
+        render_batch(task.batch, task.world_matrices);
 }
 
 
 void  simulator::render_grid()
 {
-    render_batch(render_config().batch_grid, { matrix44_identity() });
+    render_batch(render_config().batch_grid, { matrix44_identity() }, {});
 }
 
 
-void  simulator::render_frames()
+void  simulator::capture_debug_snapshot()
+{
+    TMPROF_BLOCK();
+
+    render_configuration const&  cfg = render_config();
+
+    m_debug_snapshot.tasks.clear();
+    m_debug_snapshot.wireframe_tasks.clear();
+    m_debug_snapshot.render_sight_image = false;
+
+    if (cfg.render_frames && cfg.batch_frame.loaded_successfully())
+        collect_render_tasks_of_frames();
+
+    if (cfg.render_colliders_of_rigid_bodies
+            || cfg.render_colliders_of_fields
+            || cfg.render_colliders_of_sensors
+            || cfg.render_colliders_of_agents
+            || cfg.render_colliders_of_ray_casts
+            )
+        collect_render_tasks_of_colliders();
+
+    if (cfg.render_collision_contacts)
+        collect_render_tasks_of_collision_contacts();
+
+    if (cfg.render_sight_frustums)
+        collect_render_tasks_of_sight_frustums();
+    if (cfg.render_sight_contacts_directed || cfg.render_sight_contacts_random)
+        collect_render_tasks_of_sight_contacts();
+    if (cfg.render_sight_image)
+        update_sight_image();
+    if (cfg.render_agent_action_transition_contratints)
+        collect_render_tasks_of_agent_action_transition_contratints();
+    if (cfg.render_ai_navigation_data)
+        collect_render_tasks_of_ai_navigation_data();
+}
+
+
+void  simulator::render_debug_snapshot()
+{
+    TMPROF_BLOCK();
+
+    for (render_task_info const&  task : m_debug_snapshot.tasks)
+        render_batch(task.batch, task.world_matrices, task.matrices_to_pose_bones);
+
+    if (!m_debug_snapshot.wireframe_tasks.empty())
+    {
+#if PLATFORM() != PLATFORM_WEBASSEMBLY()
+        GLint  backup_polygon_mode[2];
+        glGetIntegerv(GL_POLYGON_MODE, &backup_polygon_mode[0]);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+#endif
+
+        for (render_task_info const&  task : m_debug_snapshot.wireframe_tasks)
+            render_batch(task.batch, task.world_matrices, task.matrices_to_pose_bones);
+
+#if PLATFORM() != PLATFORM_WEBASSEMBLY()
+        glPolygonMode(GL_FRONT_AND_BACK, backup_polygon_mode[0]);
+#endif
+    }
+
+    if (m_debug_snapshot.render_sight_image && m_ai_debug_draw_data.m_sight_image_render_data != nullptr)
+    {
+        gfx::update_sprite(m_ai_debug_draw_data.m_sight_image_render_data->batch, m_ai_debug_draw_data.m_sight_image_render_data->img);
+        if (gfx::make_current(m_ai_debug_draw_data.m_sight_image_render_data->batch, render_config().draw_state, false))
+        {
+            gfx::render_sprite_batch(
+                    m_ai_debug_draw_data.m_sight_image_render_data->batch,
+                    5U,
+                    5U,
+                    (natural_32_bit)get_viewport(VIEWPORT_TYPE::SCENE).width(),
+                    (natural_32_bit)get_viewport(VIEWPORT_TYPE::SCENE).height(),
+                    std::max(0.01f, render_config().sight_image_scale)
+                    );
+            render_config().draw_state = m_ai_debug_draw_data.m_sight_image_render_data->batch.get_draw_state();
+        }
+    }
+}
+
+
+void  simulator::collect_render_tasks_of_frames()
 {
     simulation_context&  ctx = *context();
     if (ctx.frames_begin() == ctx.frames_end())
@@ -731,11 +1282,11 @@ void  simulator::render_frames()
             frame_it != frame_end; ++frame_it)
         if (skeleton_frames.count(*frame_it) == 0UL)
             task.world_matrices.push_back(ctx.frame_world_matrix(*frame_it));
-    render_task(task);
+    m_debug_snapshot.tasks.push_back(std::move(task));
 }
 
 
-void  simulator::render_colliders()
+void  simulator::collect_render_tasks_of_colliders()
 {
     std::unordered_map<object_guid, cached_collider_batch_state>  collider_batches_cache;
 
@@ -816,24 +1367,12 @@ void  simulator::render_colliders()
 
     m_collider_batches_cache.swap(collider_batches_cache);
 
-    // And here we do the actual rendering of prepared render tasks.
-
-#if PLATFORM() != PLATFORM_WEBASSEMBLY()
-    GLint  backup_polygon_mode[2];
-    glGetIntegerv(GL_POLYGON_MODE, &backup_polygon_mode[0]);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-#endif
-
-    for (auto const&  id_and_task : tasks)
-        render_task(id_and_task.second);
-
-#if PLATFORM() != PLATFORM_WEBASSEMBLY()
-    glPolygonMode(GL_FRONT_AND_BACK, backup_polygon_mode[0]);
-#endif
+    for (auto&  id_and_task : tasks)
+        m_debug_snapshot.wireframe_tasks.push_back(std::move(id_and_task.second));
 }
 
 
-void  simulator::render_collision_contacts()
+void  simulator::collect_render_tasks_of_collision_contacts()
 {
     simulation_context&  ctx = *context();
     render_task_info  sensory_task{ render_config().batch_sensory_collision_contact, {} };
@@ -860,12 +1399,12 @@ void  simulator::render_collision_contacts()
         task_ptr->world_matrices.push_back({});
         compose_from_base_matrix(cc.contact_point(), X, Y, Z, task_ptr->world_matrices.back());
     }
-    render_task(sensory_task);
-    render_task(physics_task);
+    m_debug_snapshot.tasks.push_back(std::move(sensory_task));
+    m_debug_snapshot.tasks.push_back(std::move(physics_task));
 }
 
 
-void  simulator::render_sight_frustums()
+void  simulator::collect_render_tasks_of_sight_frustums()
 {
     simulation_context&  ctx = *context();
 
@@ -900,12 +1439,12 @@ void  simulator::render_sight_frustums()
             frustum_task.batch = frustum_it->second;
         frustum_task.world_matrices.push_back(W);
     }
-    for (auto const&  key_and_task : m_frustum_tasks)
-        render_task(key_and_task.second);
+    for (auto&  key_and_task : m_frustum_tasks)
+        m_debug_snapshot.tasks.push_back(std::move(key_and_task.second));
 }
 
 
-void  simulator::render_sight_contacts()
+void  simulator::collect_render_tasks_of_sight_contacts()
 {
     simulation_context&  ctx = *context();
 
@@ -938,13 +1477,13 @@ void  simulator::render_sight_contacts()
             add_sight_contacts(sight.get_random_ray_casts_in_time(), task_sight_contacts_random);
     }
     if (render_config().render_sight_contacts_directed)
-        render_task(task_sight_contacts_directed);
+        m_debug_snapshot.tasks.push_back(std::move(task_sight_contacts_directed));
     if (render_config().render_sight_contacts_random)
-        render_task(task_sight_contacts_random);
+        m_debug_snapshot.tasks.push_back(std::move(task_sight_contacts_random));
 }
 
 
-void  simulator::render_sight_image()
+void  simulator::update_sight_image()
 {
     simulation_context&  ctx = *context();
 
@@ -987,23 +1526,11 @@ void  simulator::render_sight_image()
         ++j;
     }
 
-    gfx::update_sprite(m_ai_debug_draw_data.m_sight_image_render_data->batch, m_ai_debug_draw_data.m_sight_image_render_data->img);
-    if (gfx::make_current(m_ai_debug_draw_data.m_sight_image_render_data->batch, render_config().draw_state, false))
-    {
-        gfx::render_sprite_batch(
-                m_ai_debug_draw_data.m_sight_image_render_data->batch,
-                5U,
-                5U,
-                (natural_32_bit)get_viewport(VIEWPORT_TYPE::SCENE).width(),
-                (natural_32_bit)get_viewport(VIEWPORT_TYPE::SCENE).height(),
-                std::max(0.01f, render_config().sight_image_scale)
-                );
-        render_config().draw_state = m_ai_debug_draw_data.m_sight_image_render_data->batch.get_draw_state();
-    }
+    m_debug_snapshot.render_sight_image = true;
 }
 
 
-void  simulator::render_agent_action_transition_contratints()
+void  simulator::collect_render_tasks_of_agent_action_transition_contratints()
 {
     simulation_context&  ctx = *context();
     render_configuration&  cfg = render_config();
@@ -1095,11 +1622,11 @@ void  simulator::render_agent_action_transition_contratints()
                 task.world_matrices.push_back(world_matrix);
             }
     }
-    for (auto const&  id_and_task : tasks)
-        render_task(id_and_task.second);
+    for (auto&  id_and_task : tasks)
+        m_debug_snapshot.tasks.push_back(std::move(id_and_task.second));
 }
 
-void  simulator::render_ai_navigation_data()
+void  simulator::collect_render_tasks_of_ai_navigation_data()
 {
     render_tasks_map  tasks;
     ai::navsystem const&  navsystem = *m_ai_simulator_ptr->get_navsystem();
@@ -1179,8 +1706,8 @@ void  simulator::render_ai_navigation_data()
             tasks[m_ai_debug_draw_data.m_navlinks_batch.get_id()].world_matrices.push_back(matrix44_identity());
     }
 
-    for (auto const&  id_and_task : tasks)
-        render_task(id_and_task.second);
+    for (auto&  id_and_task : tasks)
+        m_debug_snapshot.tasks.push_back(std::move(id_and_task.second));
 }
 
 void  simulator::render_text()
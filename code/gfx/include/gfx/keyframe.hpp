@@ -3,6 +3,7 @@
 
 #   include <utility/async_resource_load.hpp>
 #   include <angeo/coordinate_system.hpp>
+#   include <utility/mapped_file.hpp>
 #   include <utility/assumptions.hpp>
 #   include <filesystem>
 #   include <vector>
@@ -11,6 +12,7 @@
 #   include <memory>
 #   include <utility>
 #   include <type_traits>
+#   include <mutex>
 
 namespace gfx { namespace detail {
 
@@ -23,10 +25,23 @@ struct  keyframe_data
     using  translation_map_ptr = std::shared_ptr<std::unordered_map<natural_32_bit, natural_32_bit> const>;
 
     keyframe_data(async::finalise_load_on_destroy_ptr const  finaliser);
+
+    // A keyframe stored in a block of a binary keyframes file (see 'keyframes_data'). The coordinate
+    // systems are decoded from the mapped file only at the first call to 'coord_systems()'.
+    keyframe_data(
+            async::finalise_load_on_destroy_ptr const  finaliser,
+            mapped_file_ptr const  file,
+            natural_64_bit const  block_offset,
+            natural_32_bit const  num_coord_systems,
+            float_32_bit const  time_point,
+            translation_map_ptr const  from_indices_to_bones,
+            translation_map_ptr const  from_bones_to_indices
+            );
+
     ~keyframe_data();
 
     float_32_bit  time_point() const { return m_time_point; }
-    std::vector<angeo::coordinate_system> const&  coord_systems() const { return m_coord_systems; }
+    std::vector<angeo::coordinate_system> const&  coord_systems() const;
     translation_map_ptr  from_indices_to_bones() const { return m_from_indices_to_bones; };
     translation_map_ptr  from_bones_to_indices() const { return m_from_bones_to_indices; };
 
@@ -35,9 +50,14 @@ private:
     friend struct  keyframes_data;
 
     float_32_bit  m_time_point;
-    std::vector<angeo::coordinate_system>  m_coord_systems;
+    mutable std::vector<angeo::coordinate_system>  m_coord_systems;
     translation_map_ptr  m_from_indices_to_bones;
     translation_map_ptr  m_from_bones_to_indices;
+
+    mapped_file_ptr  m_file;        // Is nullptr, if the keyframe was loaded from a text file.
+    natural_64_bit  m_block_offset;
+    natural_32_bit  m_num_coord_systems;
+    mutable std::once_flag  m_decode_flag;
 };
 
 
@@ -65,6 +85,16 @@ struct  keyframe : public async::resource_accessor<detail::keyframe_data>
             )
     {}
 
+    // Constructs the keyframe data directly from the passed arguments (used for binary keyframes files).
+    template<typename... arg_types>
+    keyframe(
+            async::key_type const&  key,
+            async::finalise_load_on_destroy_ptr const  parent_finaliser,
+            arg_types... args_for_constructor_of_the_resource
+            )
+        : async::resource_accessor<detail::keyframe_data>(key, parent_finaliser, args_for_constructor_of_the_resource...)
+    {}
+
     void  insert_load_request(
             std::filesystem::path const&  path,
             async::finalise_load_on_destroy_ptr const  parent_finaliser = nullptr
@@ -106,6 +136,8 @@ struct  keyframes_data
 
 private:
 
+    void  load_binary(std::filesystem::path const&  pathname, async::finalise_load_on_destroy_ptr const  finaliser);
+
     std::vector<keyframe>  m_keyframes;
     translation_map_ptr  m_from_indices_to_bones;
     translation_map_ptr  m_from_bones_to_indices;
@@ -172,6 +204,34 @@ struct  keyframes : public async::resource_accessor<detail::keyframes_data>
 };
 
 
+/**
+ * The binary format of all keyframes of a directory. When the file is present in a directory of keyframes
+ * and it is not older than any of the text files 'keyframe*.txt' and 'bones.txt' in the directory (see
+ * 'is_keyframes_binary_file_up_to_date'), it is loaded instead of them. All values are in the native
+ * byte order:
+ *      "E2KF"                                  magic (4 bytes)
+ *      natural_32_bit                          version (=1)
+ *      natural_32_bit                          number of keyframes K
+ *      natural_32_bit                          number of coordinate systems per keyframe C
+ *      natural_32_bit                          number of bones B (0 means the identity map of indices to bones)
+ *      B x natural_32_bit                      bones of coordinate systems (the content of 'bones.txt')
+ *      K x (float_32_bit, natural_32_bit,      index of keyframes sorted by time: time point, unused,
+ *           natural_64_bit)                    and offset of the keyframe's block from the start of the file
+ *      K x C x 7 x float_32_bit                blocks of keyframes: origin xyz, orientation xyzw
+ * The file is memory-mapped and keyframes are decoded only when they are accessed for the first time.
+ */
+inline std::string  keyframes_binary_file_name() { return "keyframes.bin"; }
+
+// Returns true, if the directory contains the file 'keyframes_binary_file_name()' and none of the text files
+// 'keyframe*.txt' and 'bones.txt' in the directory was modified after the binary file. Otherwise the binary
+// file is stale (or missing) and the text files are loaded instead.
+bool  is_keyframes_binary_file_up_to_date(std::filesystem::path const&  keyframes_dir);
+
+// Converts files 'keyframe*.txt' and 'bones.txt' (if present) in the passed directory into the
+// file 'keyframes_binary_file_name()' in the same directory.
+void  convert_keyframes_to_binary(std::filesystem::path const&  keyframes_dir);
+
+
 }
 
 #endif
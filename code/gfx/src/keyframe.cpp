@@ -3,24 +3,28 @@
 #include <utility/read_line.hpp>
 #include <utility/invariants.hpp>
 #include <utility/timeprof.hpp>
+#include <utility/log.hpp>
 #include <utility/canonical_path.hpp>
 #include <utility/msgstream.hpp>
 #include <filesystem>
 #include <fstream>
+#include <unordered_set>
+#include <cstring>
 
-namespace gfx { namespace detail {
+namespace gfx { namespace detail { namespace {
 
 
-keyframe_data::keyframe_data(async::finalise_load_on_destroy_ptr const  finaliser)
-    : m_time_point(0.0)
-    , m_coord_systems()
-    , m_from_indices_to_bones(nullptr)
-    , m_from_bones_to_indices(nullptr)
-{
-    TMPROF_BLOCK();
+natural_32_bit const  KEYFRAMES_BINARY_VERSION = 1U;
+natural_32_bit const  KEYFRAMES_BINARY_HEADER_SIZE = 5U * sizeof(natural_32_bit);
+natural_32_bit const  KEYFRAMES_BINARY_INDEX_ENTRY_SIZE = 2U * sizeof(natural_32_bit) + sizeof(natural_64_bit);
+natural_32_bit const  KEYFRAMES_BINARY_COORD_SYSTEM_SIZE = 7U * sizeof(float_32_bit);
 
-    std::filesystem::path const  pathname = finaliser->get_key().get_unique_id();
 
+float_32_bit  read_keyframe_text_file(
+        std::filesystem::path const&  pathname,
+        std::vector<angeo::coordinate_system>&  coord_systems
+        )
+{
     if (!std::filesystem::exists(pathname))
         throw std::runtime_error(msgstream() << "The passed file '" << pathname << "' does not exist.");
 
@@ -31,17 +35,106 @@ keyframe_data::keyframe_data(async::finalise_load_on_destroy_ptr const  finalise
     if (!istr.good())
         throw std::runtime_error(msgstream() << "Cannot open the keyframe file '" << pathname << "'.");
 
+    float_32_bit  time_point;
     {
         std::string  line;
         if (!read_line(istr,line))
             throw std::runtime_error(msgstream() << "Cannot read time point in the file '" << pathname << "'.");
         std::istringstream istr(line);
-        istr >> m_time_point;
-        if (m_time_point < 0.0f)
+        istr >> time_point;
+        if (time_point < 0.0f)
             throw std::runtime_error(msgstream() << "The time point in the file '" << pathname << "' is negative.");
     }
 
-    angeo::read_all_coord_systems(istr, pathname, m_coord_systems);
+    angeo::read_all_coord_systems(istr, pathname, coord_systems);
+
+    return time_point;
+}
+
+
+void  read_bones_text_file(
+        std::filesystem::path const&  bones_pathname,
+        std::vector<natural_32_bit>&  bones // Indexed by coordinate systems of keyframes.
+        )
+{
+    std::unordered_set<natural_32_bit>  visited;
+    std::ifstream  istr;
+    angeo::open_file_stream_for_reading(istr, bones_pathname);
+    for (natural_32_bit i = 0U, n = angeo::read_num_records(istr, bones_pathname); i != n; ++i)
+    {
+        std::string  line;
+        if (!read_line(istr, line))
+            throw std::runtime_error(msgstream() << "Cannot read " << i << "-th bone in the file '" << bones_pathname << "'.");
+        natural_32_bit  bone;
+        {
+            std::istringstream sstr(line);
+            sstr >> bone;
+        }
+        if (visited.count(bone) != 0UL)
+            throw std::runtime_error(msgstream() << "Bone " << bone << " appears more than once in the file '" << bones_pathname << "'.");
+        visited.insert(bone);
+        bones.push_back(bone);
+    }
+}
+
+
+template<typename T>
+T  read_binary_value(natural_8_bit const*  data, natural_64_bit const  offset)
+{
+    T  value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+
+template<typename T>
+void  write_binary_value(std::ofstream&  ostr, T const  value)
+{
+    ostr.write((char const*)&value, sizeof(T));
+}
+
+
+}}}
+
+namespace gfx { namespace detail {
+
+
+keyframe_data::keyframe_data(async::finalise_load_on_destroy_ptr const  finaliser)
+    : m_time_point(0.0)
+    , m_coord_systems()
+    , m_from_indices_to_bones(nullptr)
+    , m_from_bones_to_indices(nullptr)
+    , m_file(nullptr)
+    , m_block_offset(0ULL)
+    , m_num_coord_systems(0U)
+    , m_decode_flag()
+{
+    TMPROF_BLOCK();
+
+    m_time_point = read_keyframe_text_file(finaliser->get_key().get_unique_id(), m_coord_systems);
+    m_num_coord_systems = (natural_32_bit)m_coord_systems.size();
+}
+
+
+keyframe_data::keyframe_data(
+        async::finalise_load_on_destroy_ptr const  finaliser,
+        mapped_file_ptr const  file,
+        natural_64_bit const  block_offset,
+        natural_32_bit const  num_coord_systems,
+        float_32_bit const  time_point,
+        translation_map_ptr const  from_indices_to_bones,
+        translation_map_ptr const  from_bones_to_indices
+        )
+    : m_time_point(time_point)
+    , m_coord_systems()
+    , m_from_indices_to_bones(from_indices_to_bones)
+    , m_from_bones_to_indices(from_bones_to_indices)
+    , m_file(file)
+    , m_block_offset(block_offset)
+    , m_num_coord_systems(num_coord_systems)
+    , m_decode_flag()
+{
+    ASSUMPTION(m_file != nullptr && m_block_offset + m_num_coord_systems * KEYFRAMES_BINARY_COORD_SYSTEM_SIZE <= m_file->size());
 }
 
 
@@ -51,6 +144,28 @@ keyframe_data::~keyframe_data()
 }
 
 
+std::vector<angeo::coordinate_system> const&  keyframe_data::coord_systems() const
+{
+    if (m_file != nullptr)
+        std::call_once(m_decode_flag, [this]() {
+            TMPROF_BLOCK();
+
+            m_coord_systems.reserve(m_num_coord_systems);
+            float_32_bit  values[7];
+            natural_8_bit const*  block = m_file->data() + m_block_offset;
+            for (natural_32_bit  i = 0U; i != m_num_coord_systems; ++i, block += KEYFRAMES_BINARY_COORD_SYSTEM_SIZE)
+            {
+                std::memcpy(values, block, KEYFRAMES_BINARY_COORD_SYSTEM_SIZE);
+                m_coord_systems.push_back({
+                        vector3(values[0], values[1], values[2]),
+                        make_quaternion_xyzw(values[3], values[4], values[5], values[6])
+                        });
+            }
+        });
+    return m_coord_systems;
+}
+
+
 }}
 
 namespace gfx { namespace detail {
@@ -69,6 +184,12 @@ keyframes_data::keyframes_data(
     if (!std::filesystem::is_directory(keyframes_dir))
         throw std::runtime_error("Cannot access the directory of keyframes: " + keyframes_dir.string());
 
+    if (is_keyframes_binary_file_up_to_date(keyframes_dir))
+    {
+        load_binary(keyframes_dir / keyframes_binary_file_name(), finaliser);
+        return;
+    }
+
     async::finalise_load_on_destroy_ptr const  keyframes_finaliser =
         async::finalise_load_on_destroy::create(
                 [this, keyframes_dir](async::finalise_load_on_destroy_ptr) {
@@ -121,27 +242,15 @@ keyframes_data::keyframes_data(
         }
         else if (filename == "bones.txt")
         {
+            std::vector<natural_32_bit>  bones;
+            read_bones_text_file(canonical_path(entry.path()), bones);
+
             auto  to_bones_ptr = std::make_shared<translation_map>();
             auto  from_bones_ptr = std::make_shared<translation_map>();
-
-            std::filesystem::path const  parents_pathname = canonical_path(entry.path());
-
-            std::ifstream  istr;
-            angeo::open_file_stream_for_reading(istr, parents_pathname);
-            for (natural_32_bit i = 0U, n = angeo::read_num_records(istr, parents_pathname); i != n; ++i)
+            for (natural_32_bit i = 0U; i != (natural_32_bit)bones.size(); ++i)
             {
-                std::string  line;
-                if (!read_line(istr, line))
-                    throw std::runtime_error(msgstream() << "Cannot read " << i << "-th bone in the file '" << parents_pathname << "'.");
-                natural_32_bit  bone;
-                {
-                    std::istringstream sstr(line);
-                    sstr >> bone;
-                }
-                if (from_bones_ptr->count(bone) != 0UL)
-                    throw std::runtime_error(msgstream() << "Bone " << bone << " appears more than once in the file '" << parents_pathname << "'.");
-                to_bones_ptr->insert({ i, bone });
-                from_bones_ptr->insert({ bone, i });
+                to_bones_ptr->insert({ i, bones.at(i) });
+                from_bones_ptr->insert({ bones.at(i), i });
             }
 
             m_from_indices_to_bones = to_bones_ptr;
@@ -157,4 +266,173 @@ keyframes_data::~keyframes_data()
 }
 
 
+void  keyframes_data::load_binary(std::filesystem::path const&  pathname, async::finalise_load_on_destroy_ptr const  finaliser)
+{
+    TMPROF_BLOCK();
+
+    mapped_file_ptr const  file = std::make_shared<mapped_file>(pathname);
+    natural_8_bit const* const  data = file->data();
+
+    if (file->size() < KEYFRAMES_BINARY_HEADER_SIZE || std::memcmp(data, "E2KF", 4U) != 0)
+        throw std::runtime_error(msgstream() << "The file '" << pathname << "' is not a binary keyframes file.");
+    if (read_binary_value<natural_32_bit>(data, 4U) != KEYFRAMES_BINARY_VERSION)
+        throw std::runtime_error(msgstream() << "Unsupported version of the binary keyframes file '" << pathname << "'.");
+    natural_32_bit const  num_keyframes = read_binary_value<natural_32_bit>(data, 8U);
+    natural_32_bit const  num_coord_systems = read_binary_value<natural_32_bit>(data, 12U);
+    natural_32_bit const  num_bones = read_binary_value<natural_32_bit>(data, 16U);
+
+    natural_64_bit const  bones_offset = KEYFRAMES_BINARY_HEADER_SIZE;
+    natural_64_bit const  index_offset = bones_offset + (natural_64_bit)num_bones * sizeof(natural_32_bit);
+    natural_64_bit const  blocks_offset = index_offset + (natural_64_bit)num_keyframes * KEYFRAMES_BINARY_INDEX_ENTRY_SIZE;
+    if (num_keyframes == 0U)
+        throw std::runtime_error("There is no keyframe in the file: " + pathname.string());
+    if (num_bones != 0U && num_bones != num_coord_systems)
+        throw std::runtime_error(msgstream() << "The count of bones differs from the count of coordinate systems in the file '" << pathname << "'.");
+    if (blocks_offset + (natural_64_bit)num_keyframes * num_coord_systems * KEYFRAMES_BINARY_COORD_SYSTEM_SIZE > file->size())
+        throw std::runtime_error(msgstream() << "The binary keyframes file '" << pathname << "' is truncated.");
+
+    auto  to_bones_ptr = std::make_shared<translation_map>();
+    auto  from_bones_ptr = num_bones == 0U ? to_bones_ptr : std::make_shared<translation_map>();
+    for (natural_32_bit i = 0U; i != num_coord_systems; ++i)
+    {
+        natural_32_bit const  bone =
+                num_bones == 0U ? i : read_binary_value<natural_32_bit>(data, bones_offset + i * sizeof(natural_32_bit));
+        if (num_bones != 0U && from_bones_ptr->count(bone) != 0UL)
+            throw std::runtime_error(msgstream() << "Bone " << bone << " appears more than once in the file '" << pathname << "'.");
+        to_bones_ptr->insert({ i, bone });
+        if (num_bones != 0U)
+            from_bones_ptr->insert({ bone, i });
+    }
+    m_from_indices_to_bones = to_bones_ptr;
+    m_from_bones_to_indices = from_bones_ptr;
+
+    m_keyframes.reserve(num_keyframes);
+    for (natural_32_bit i = 0U; i != num_keyframes; ++i)
+    {
+        natural_64_bit const  entry_offset = index_offset + (natural_64_bit)i * KEYFRAMES_BINARY_INDEX_ENTRY_SIZE;
+        float_32_bit const  time_point = read_binary_value<float_32_bit>(data, entry_offset);
+        natural_64_bit const  block_offset = read_binary_value<natural_64_bit>(data, entry_offset + 2U * sizeof(natural_32_bit));
+        if (block_offset < blocks_offset || block_offset + num_coord_systems * KEYFRAMES_BINARY_COORD_SYSTEM_SIZE > file->size())
+            throw std::runtime_error(msgstream() << "Wrong offset of keyframe #" << i << " in the file '" << pathname << "'.");
+        if (i > 0U && time_point < m_keyframes.at(i - 1U).get_time_point())
+            throw std::runtime_error(msgstream() << "Keyframes are not sorted by time in the file '" << pathname << "'.");
+        m_keyframes.push_back(keyframe(
+                async::key_type{ "gfx::keyframe", msgstream() << pathname.string() << "#" << i },
+                finaliser,
+                file,
+                block_offset,
+                num_coord_systems,
+                time_point,
+                m_from_indices_to_bones,
+                m_from_bones_to_indices
+                ));
+    }
+}
+
+
 }}
+
+namespace gfx {
+
+
+bool  is_keyframes_binary_file_up_to_date(std::filesystem::path const&  keyframes_dir)
+{
+    std::filesystem::path const  pathname = keyframes_dir / keyframes_binary_file_name();
+    if (!std::filesystem::is_regular_file(pathname))
+        return false;
+    std::filesystem::file_time_type const  binary_time = std::filesystem::last_write_time(pathname);
+    for (std::filesystem::directory_entry const& entry : std::filesystem::directory_iterator(keyframes_dir))
+    {
+        std::string const  filename = entry.path().filename().string();
+        std::string const  extension = entry.path().filename().extension().string();
+        if (((filename.find("keyframe") == 0UL && extension == ".txt") || filename == "bones.txt") &&
+                std::filesystem::last_write_time(entry.path()) > binary_time)
+        {
+            LOG(LSL_WARNING, "The binary keyframes file " << pathname << " is older than " << entry.path()
+                             << ", so text files of keyframes are loaded instead.");
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void  convert_keyframes_to_binary(std::filesystem::path const&  keyframes_dir)
+{
+    TMPROF_BLOCK();
+
+    using namespace detail;
+
+    if (!std::filesystem::is_directory(keyframes_dir))
+        throw std::runtime_error("Cannot access the directory of keyframes: " + keyframes_dir.string());
+
+    std::vector<std::pair<float_32_bit, std::vector<angeo::coordinate_system> > >  keyframes;
+    std::vector<natural_32_bit>  bones;
+    for (std::filesystem::directory_entry const& entry : std::filesystem::directory_iterator(keyframes_dir))
+    {
+        std::string const  filename = entry.path().filename().string();
+        std::string const  extension = entry.path().filename().extension().string();
+
+        if (filename.find("keyframe") == 0UL && extension == ".txt")
+        {
+            keyframes.push_back({});
+            keyframes.back().first = read_keyframe_text_file(canonical_path(entry.path()), keyframes.back().second);
+        }
+        else if (filename == "bones.txt")
+            read_bones_text_file(canonical_path(entry.path()), bones);
+    }
+    if (keyframes.empty())
+        throw std::runtime_error("There is no keyframe file in the directory: " + keyframes_dir.string());
+    std::stable_sort(
+            keyframes.begin(),
+            keyframes.end(),
+            [](auto const&  left, auto const&  right) { return left.first < right.first; }
+            );
+
+    natural_32_bit const  num_keyframes = (natural_32_bit)keyframes.size();
+    natural_32_bit const  num_coord_systems = (natural_32_bit)keyframes.front().second.size();
+    for (auto const&  time_and_frames : keyframes)
+        if (time_and_frames.second.size() != num_coord_systems)
+            throw std::runtime_error("Loaded of keyframes have different counts of coordinate "
+                                     "systems (inconsystent animation).");
+    if (!bones.empty() && bones.size() != num_coord_systems)
+        throw std::runtime_error("The count of bones differs from the count of coordinate systems in the directory: " +
+                                 keyframes_dir.string());
+
+    std::filesystem::path const  pathname = keyframes_dir / keyframes_binary_file_name();
+    std::ofstream  ostr(pathname.string(), std::ios_base::binary);
+    if (!ostr.good())
+        throw std::runtime_error(msgstream() << "Cannot open the output file '" << pathname << "'.");
+
+    ostr.write("E2KF", 4U);
+    write_binary_value(ostr, KEYFRAMES_BINARY_VERSION);
+    write_binary_value(ostr, num_keyframes);
+    write_binary_value(ostr, num_coord_systems);
+    write_binary_value(ostr, (natural_32_bit)bones.size());
+    for (natural_32_bit  bone : bones)
+        write_binary_value(ostr, bone);
+    natural_64_bit const  blocks_offset = KEYFRAMES_BINARY_HEADER_SIZE + bones.size() * sizeof(natural_32_bit) +
+                                          (natural_64_bit)num_keyframes * KEYFRAMES_BINARY_INDEX_ENTRY_SIZE;
+    for (natural_32_bit  i = 0U; i != num_keyframes; ++i)
+    {
+        write_binary_value(ostr, keyframes.at(i).first);
+        write_binary_value(ostr, (natural_32_bit)0U);
+        write_binary_value(ostr, blocks_offset + (natural_64_bit)i * num_coord_systems * KEYFRAMES_BINARY_COORD_SYSTEM_SIZE);
+    }
+    for (auto const&  time_and_frames : keyframes)
+        for (angeo::coordinate_system const&  frame : time_and_frames.second)
+        {
+            write_binary_value(ostr, frame.origin()(0));
+            write_binary_value(ostr, frame.origin()(1));
+            write_binary_value(ostr, frame.origin()(2));
+            write_binary_value(ostr, frame.orientation().x());
+            write_binary_value(ostr, frame.orientation().y());
+            write_binary_value(ostr, frame.orientation().z());
+            write_binary_value(ostr, frame.orientation().w());
+        }
+    if (!ostr.good())
+        throw std::runtime_error(msgstream() << "Failed to write the output file '" << pathname << "'.");
+}
+
+
+}
@@ -2,8 +2,6 @@
 #   define NETLAB_BUILDER_HPP_INCLUDED
 
 #   include <netlab/uid.hpp>
-#   include <netlab/sockets.hpp>
-#   include <netlab/unit.hpp>
 #   include <netlab/layer.hpp>
 #   include <utility/basic_numeric_types.hpp>
 #   include <vector>
@@ -18,8 +16,10 @@ struct  builder
 {
     struct  layer_info
     {
-        natural_16_bit  num_units;
-        natural_16_bit  num_sockets_per_unit;
+        natural_32_bit  num_units;                          // Must be > 0 and <= uid::MAX_NUM_UNITS_PER_LAYER.
+        uid::socket_index_type  num_sockets_per_unit;       // Must be <= uid::MAX_NUM_SOCKETS_PER_UNIT.
+                                                            // Totals of units and of sockets over all layers must
+                                                            // be < synapses::TOMBSTONE.
         network_layer  layer;
     };
 
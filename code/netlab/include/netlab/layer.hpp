@@ -2,10 +2,7 @@
 #   define NETLAB_LAYER_HPP_INCLUDED
 
 #   include <netlab/uid.hpp>
-#   include <netlab/sockets.hpp>
-#   include <netlab/unit.hpp>
 #   include <utility/basic_numeric_types.hpp>
-#   include <vector>
 
 namespace netlab {
 
@@ -25,9 +22,11 @@ struct  network_layer
     float_32_bit  WEIGHT_MAXIMAL;                       // Must be > WEIGHT_CONNECTION
     float_32_bit  SPIKE_MAGNITUDE;                      // Must be > 0.0f
 
-    // DATA:
+    // DATA (set by the builder):
 
-    std::vector<computation_unit>  units;               // Cannot be empty.
+    natural_32_bit  first_unit;                         // Index of the first unit of the layer in arrays of the network.
+    natural_32_bit  num_units;                          // Must be > 0.
+    uid::socket_index_type  num_sockets_per_unit;
 };
 
 
@@ -3,21 +3,34 @@
 
 #   include <netlab/uid.hpp>
 #   include <netlab/sockets.hpp>
-#   include <netlab/unit.hpp>
+#   include <netlab/synapses.hpp>
 #   include <netlab/layer.hpp>
 #   include <netlab/statistics.hpp>
 #   include <netlab/builder.hpp>
 #   include <utility/basic_numeric_types.hpp>
 #   include <utility/random.hpp>
+#   include <utility/thread_pool.hpp>
+#   include <filesystem>
 #   include <vector>
 #   include <array>
 #   include <mutex>
+#   include <atomic>
+#   include <memory>
 
 namespace netlab {
 
 
 struct  network
 {
+    // Totals since the network was constructed.
+    struct  counters
+    {
+        natural_64_bit  num_spikes;             // Of all units, including input units.
+        natural_64_bit  num_synaptic_events;    // Spikes delivered through connected sockets.
+        natural_64_bit  num_connections;
+        natural_64_bit  num_disconnections;
+    };
+
     network();
     network(
         natural_8_bit const  NUM_INPUT_LAYERS_,
@@ -29,38 +42,50 @@ struct  network
     void  set_spiking_input_unit(uid const  input_unit_id);
     std::vector<uid> const&  get_spiking_output_units() const { return spiking_output_units; }
     statistics const&  get_statisitcs() const { return stats; }
+    counters  get_counters() const;
+
+    // The number of threads used by 'next_round'. Results of rounds do NOT depend on it.
+    natural_32_bit  get_num_threads() const { return workers->num_threads(); }
+    void  set_num_threads(natural_32_bit const  num_threads_);
+
+    // In the event-driven mode only charges of units which received a spike (or were discharged) in the round are
+    // updated; decay of charges of other units is applied lazily. Results of rounds do NOT depend on the mode.
+    bool  is_event_driven() const { return event_driven; }
+    void  set_event_driven(bool const  state);
 
     void  next_round();
 
+    natural_32_bit  num_layers() const { return (natural_32_bit)layers.size(); }
     network_layer const&  get_layer(uid const  id) const { return layers.at(id.layer); }
-    network_layer&  layer_ref(uid const  id) { return layers.at(id.layer); }
-    computation_unit const&  get_unit(uid const  id) const { return get_layer(id).units.at(id.unit); }
-    computation_unit&  unit_ref(uid const  id) { return layer_ref(id).units.at(id.unit); }
-    input_socket const&  get_input_socket(uid const  id) const { return get_unit(id).inputs.at(id.socket); }
-    input_socket&  input_socket_ref(uid const  id) { return unit_ref(id).inputs.at(id.socket); }
-    output_socket const&  get_output_socket(uid const  id) const { return get_unit(id).outputs.at(id.socket); }
-    output_socket&  output_socket_ref(uid const  id) { return unit_ref(id).outputs.at(id.socket); }
+    float_32_bit  get_charge(uid const  unit_id) const { return current_charge(unit_index(unit_id)); }
+    // A socket 'id.socket' of a unit is valid, if it is less than 'get_layer(id).num_sockets_per_unit'.
+    bool  is_input_socket_connected(uid const  id) const;
+    bool  is_output_socket_connected(uid const  id) const;
+    input_socket  get_input_socket(uid const  id) const;    // The socket must be connected.
+    output_socket  get_output_socket(uid const  id) const;  // The socket must be connected.
+    synapses const&  get_sockets() const { return sockets; }
 
 private:
 
+    natural_32_bit  unit_index(uid const  unit_id) const { return layers.at(unit_id.layer).first_unit + unit_id.unit; }
+    uid  unit_uid(natural_32_bit const  unit_index) const;
+    float_32_bit  current_charge(natural_32_bit const  unit) const;
+
+    void  initialise_round_data();
+    void  refresh_charges_of_units_connected_to_spiking_units();
     void  update_input_sockets_of_spiking_units();
     void  update_output_sockets_of_spiking_units();
     void  propagate_charge_of_spikes();
     void  discharge_spiking_units();
     void  update_charge_of_units();
     void  connect_open_sockets();
-    bool  connect(
-            natural_32_bit const  input_idx,
-            natural_32_bit const  output_idx
-            );
-    void  disconnect(
-            std::vector<input_socket>&  inputs,
-            uid const  input_socket_id,
-            std::vector<output_socket>&  outputs,
-            uid const  output_socket_id
-            );
+    void  shuffle_open_inputs(natural_64_bit const  stream_key);
+    void  connect(natural_32_bit const  input_unit, natural_32_bit const  output_unit);
+    void  disconnect(natural_32_bit const  input_slot);
 
     friend struct  netlab::builder;
+    friend void  save_snapshot(network&  net, std::filesystem::path const&  pathname);
+    friend void  load_snapshot(network&  net, std::filesystem::path const&  pathname);
 
     // CONSTANTS:
 
@@ -71,17 +96,61 @@ private:
 
     std::vector<network_layer>  layers;
 
-    std::vector<uid>  open_inputs;
-    std::vector<uid>  open_outputs;
-    std::mutex  open_io_mutex;
+    // Per unit data; units are indexed by 'network_layer::first_unit' + unit.
+    std::vector<float_32_bit>  charges;
+    std::vector<natural_8_bit>  unit_layers;
+    synapses  sockets;
+
+    std::vector<natural_32_bit>  open_inputs;   // Indices of units, each one per an open input socket.
+    std::vector<natural_32_bit>  open_outputs;  // Indices of units, each one per an open output socket.
 
-    std::vector<uid>  spiking_units;
+    std::vector<natural_32_bit>  spiking_units; // Indices of units.
     std::vector<uid>  spiking_output_units;
-    std::mutex  spiking_mutex;
 
     random_generator_for_natural_32_bit  random_generator;
 
     statistics  stats;
+
+    natural_64_bit  num_spikes;
+    std::atomic<natural_64_bit>  num_synaptic_events;  // Updated once per task of 'propagate_charge_of_spikes'.
+    natural_64_bit  num_connections;
+    natural_64_bit  num_disconnections;
+
+    // DATA OF PARALLEL ROUNDS:
+
+    std::unique_ptr<thread_pool>  workers;                              // Runs tasks of phases of rounds. The partitioning of the work
+                                                                        // to tasks does not depend on the number of threads, so rounds
+                                                                        // are deterministic.
+    std::unique_ptr<std::atomic<integer_32_bit>[]>  received_spikes;    // For each unit the sum of signs of spikes received in the
+                                                                        // current round. Integer sums do not depend on the order
+                                                                        // of additions, so rounds are deterministic.
+    std::vector<uid>  charge_update_tasks;                              // For each task of 'update_charge_of_units' the layer and
+                                                                        // the first unit of the processed range of units.
+    std::vector<std::vector<natural_32_bit> >  task_outputs;            // Per task outputs (indices of units or spiking units).
+
+    // DATA OF THE EVENT-DRIVEN MODE:
+
+    bool  event_driven;
+    natural_32_bit  num_charge_updates;                                 // The number of calls to 'update_charge_of_units'.
+    std::vector<natural_32_bit>  charge_rounds;                         // For each unit the value of 'num_charge_updates' when its
+                                                                        // charge was updated last time (valid in the event-driven mode).
+    std::unique_ptr<std::atomic<natural_32_bit>[]>  receive_stamps;     // For each unit the value 'num_charge_updates + 1' of the last
+                                                                        // round in which the unit received a spike.
+    std::unique_ptr<std::atomic<natural_32_bit>[]>  refresh_stamps;     // For each unit the value 'num_charge_updates + 1' of the last
+                                                                        // round in which its charge was refreshed before updates of
+                                                                        // weights of sockets.
+    std::vector<natural_32_bit>  active_units;                          // Sorted indices of units whose charge is updated in the round.
+
+    // DATA OF REWIRING:
+
+    std::vector<natural_32_bit>  shuffled_inputs;                       // The buffer for the shuffle of 'open_inputs'.
+    std::vector<natural_32_bit>  shuffle_offsets;                       // For each pair (bucket, task) of the shuffle the index of
+                                                                        // the first item of the task in the bucket.
+
+    // DATA OF SNAPSHOTS:
+
+    natural_64_bit  snapshot_tag;                                       // The tag of the snapshot file the network was last saved to
+                                                                        // or loaded from (0 when there is none).
 };
 
 
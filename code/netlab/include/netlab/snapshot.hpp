@@ -0,0 +1,59 @@
+#ifndef NETLAB_SNAPSHOT_HPP_INCLUDED
+#   define NETLAB_SNAPSHOT_HPP_INCLUDED
+
+#   include <netlab/network.hpp>
+#   include <filesystem>
+
+namespace netlab {
+
+
+/**
+ * The binary snapshot of a network (between rounds). All values are in the native byte order and each
+ * section starts at an offset aligned to 8 bytes:
+ *      "E2NL"                                  magic (4 bytes)
+ *      natural_32_bit                          version (=1)
+ *      4 x natural_8_bit                       bits of layers, units and sockets in 'uid', and sizeof(uid::socket_index_type)
+ *      natural_32_bit                          sizeof(network_layer)
+ *      natural_64_bit                          tag of the snapshot (changes with each save; 0 while being saved)
+ *      natural_32_bit                          number of layers L
+ *      2 x natural_8_bit, natural_16_bit       NUM_INPUT_LAYERS, NUM_OUTPUT_LAYERS, unused
+ *      natural_32_bit                          number of units U
+ *      natural_32_bit                          number of slots of sockets S
+ *      2 x natural_32_bit                      numbers of input and output tombstones
+ *      natural_32_bit                          state of the random generator
+ *      natural_32_bit                          number of open sockets O
+ *      natural_32_bit                          number of spiking units P
+ *      natural_32_bit                          unused
+ *      L x network_layer                       layers
+ *      U x float_32_bit                        charges (with the decay applied in the event-driven mode)
+ *      U x natural_8_bit                       layers of units
+ *      (U + 1) x natural_32_bit                'synapses::slots_begin'
+ *      2 x U x socket_index_type               'synapses::num_used_inputs', 'synapses::num_used_outputs'
+ *      S x natural_32_bit                      'synapses::input_sources'
+ *      S x socket_index_type                   'synapses::input_source_sockets'
+ *      S x float_32_bit                        'synapses::input_weights'
+ *      S x natural_32_bit                      'synapses::output_targets'
+ *      S x socket_index_type                   'synapses::output_target_sockets'
+ *      2 x O x natural_32_bit                  open input sockets, open output sockets
+ *      P x natural_32_bit                      units spiking in the next round
+ * Only the last two sections change their sizes while the network runs.
+ */
+
+// When the file is the last snapshot saved or loaded by the network, then only the header, per unit data,
+// modified blocks of slots (see 'synapses::NUM_SLOTS_PER_BLOCK') and the trailing sections are written to
+// the file in place; if this save is interrupted, the file is rejected by the load. Otherwise the whole
+// snapshot is written to the file 'pathname' + ".tmp", which then replaces the file 'pathname', so that
+// a failed save keeps the previous snapshot. (The data are flushed from the process, but not synced to
+// the disk, i.e. the order of writes is not guaranteed on a crash of the system.)
+void  save_snapshot(network&  net, std::filesystem::path const&  pathname);
+
+// The file is memory-mapped and its sections are copied (memcpy) into arrays of the network, i.e. the arrays
+// do not refer to the mapped file, which is closed on return. The network keeps its number of threads, the
+// charge update mode and the configuration of statistics (which restart).
+// Throws std::runtime_error, when the file is not a valid snapshot for the 'uid' type of the build.
+void  load_snapshot(network&  net, std::filesystem::path const&  pathname);
+
+
+}
+
+#endif
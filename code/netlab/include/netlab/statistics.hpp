@@ -4,18 +4,23 @@
 #   include <netlab/uid.hpp>
 #   include <netlab/layer.hpp>
 #   include <utility/basic_numeric_types.hpp>
+#   include <utility/ring_buffer.hpp>
 #   include <vector>
-#   include <deque>
-#   include <unordered_map>
 
 namespace netlab {
 
 
+/**
+ * Statistics of a network collected in snapshots of NUM_ROUNDS_PER_SNAPSHOT rounds. Probed units are selected
+ * once (when the network is built) into a dense array. Events are counted into counters of the thread which
+ * reported them (so events can be reported from parallel tasks of a round without any synchronisation), and
+ * counters of all threads are merged into fixed-size histories at snapshot boundaries.
+ */
 struct  statistics
 {
     struct  probe
     {
-        natural_32_bit  num_spikes_received;
+        natural_32_bit  num_spikes_received;   // Deliveries of spikes produced by the unit (see 'on_spike_received').
         natural_32_bit  num_spikes_produced;
         natural_32_bit  num_connected_input_sockets;
         natural_32_bit  num_connected_output_sockets;
@@ -32,6 +37,14 @@ struct  statistics
         overall();
     };
 
+    // Counters of one thread in the current snapshot.
+    struct  counters
+    {
+        std::vector<probe>  probes;     // Indexed like 'probed_units'; the extra last probe counts events of units which are
+                                        // not probed (so that counting is branch-free) and it is ignored.
+        overall  totals;
+    };
+
     // CONSTANTS:
 
     natural_32_bit  NUM_ROUNDS_PER_SNAPSHOT;                        // When == 0, then statistics are NOT collected/updated!
@@ -42,12 +55,14 @@ struct  statistics
 
     natural_64_bit  num_passed_rounds;
     natural_32_bit  num_passed_rounds_in_current_snapshot;
-    std::unordered_map<uid, std::deque<probe> >  probes_history;    // For each uid, the size of the deque is > 0
-                                                                    // and <= SNAPSHOTS_HISTORY_SIZE + 1.
-                                                                    // The front element in each deque is the probe of the
-                                                                    // currently processed snapshot, for the related unit's uid.
-    std::deque<overall>  overall_history;   // The size is > 0 and <= SNAPSHOTS_HISTORY_SIZE + 1. The front element
-                                            // is the one of the currently processed snapshot.
+    std::vector<uid>  probed_units;                     // Sorted uids of probed units.
+    std::vector<natural_32_bit>  probe_indices;         // For each unit of the network (by its index in the network)
+                                                        // the index of its probe in 'probed_units', or the size of
+                                                        // 'probed_units' when the unit is not probed.
+    std::vector<counters>  thread_counters;             // One per thread of the network.
+    std::vector<ring_buffer<probe> >  probes_history;   // For each probe at most SNAPSHOTS_HISTORY_SIZE last completed
+                                                        // snapshots; the oldest one is at the front.
+    ring_buffer<overall>  overall_history;              // Like 'probes_history', but for the whole network.
 
     // FUNCTIONS:
 
@@ -59,19 +74,72 @@ struct  statistics
         );
 
     bool  enabled() const { return NUM_ROUNDS_PER_SNAPSHOT != 0U; }
+
+    // Called by the builder of the network. The probed units are evenly distributed in non-input layers.
+    void  select_probes(std::vector<network_layer> const&  layers, natural_32_bit const  num_input_layers);
+    void  set_num_threads(natural_32_bit const  num_threads);
+
     void  on_next_round();
-    void  on_spike_received(uid const  id);
-    void  on_spike_produced(uid const  id);
-    void  on_connect(uid const  iid, uid const  oid);
-    void  on_disconnect(
-            std::vector<input_socket> const&  inputs,
-            uid const  input_socket_id,
-            std::vector<output_socket> const&  outputs,
-            uid const  output_socket_id
-            );
+
+    // Units are passed by their indices in the network. Calls with different thread indices may run in parallel.
+    // The unit passed to 'on_spike_received' is the sending one; it is called once per target of the spike.
+    void  on_spike_received(natural_32_bit const  unit, natural_32_bit const  thread_index);
+    void  on_spike_produced(natural_32_bit const  unit, natural_32_bit const  thread_index);
+    void  on_connect(natural_32_bit const  input_unit, natural_32_bit const  output_unit, natural_32_bit const  thread_index);
+    void  on_disconnect(natural_32_bit const  input_unit, natural_32_bit const  output_unit, natural_32_bit const  thread_index);
+
+private:
+    void  merge_counters_to_history();
 };
 
 
+inline void  statistics::on_spike_received(natural_32_bit const  unit, natural_32_bit const  thread_index)
+{
+    if (enabled())
+        ++thread_counters[thread_index].probes[probe_indices[unit]].num_spikes_received;
+}
+
+
+inline void  statistics::on_spike_produced(natural_32_bit const  unit, natural_32_bit const  thread_index)
+{
+    if (!enabled())
+        return;
+    counters&  thread = thread_counters[thread_index];
+    ++thread.totals.num_spikes;
+    ++thread.probes[probe_indices[unit]].num_spikes_produced;
+}
+
+
+inline void  statistics::on_connect(
+        natural_32_bit const  input_unit,
+        natural_32_bit const  output_unit,
+        natural_32_bit const  thread_index
+        )
+{
+    if (!enabled())
+        return;
+    counters&  thread = thread_counters[thread_index];
+    ++thread.totals.num_connected_sockets;
+    ++thread.probes[probe_indices[input_unit]].num_connected_input_sockets;
+    ++thread.probes[probe_indices[output_unit]].num_connected_output_sockets;
+}
+
+
+inline void  statistics::on_disconnect(
+        natural_32_bit const  input_unit,
+        natural_32_bit const  output_unit,
+        natural_32_bit const  thread_index
+        )
+{
+    if (!enabled())
+        return;
+    counters&  thread = thread_counters[thread_index];
+    ++thread.totals.num_disconnected_sockets;
+    ++thread.probes[probe_indices[input_unit]].num_disconnected_input_sockets;
+    ++thread.probes[probe_indices[output_unit]].num_disconnected_output_sockets;
+}
+
+
 }
 
 #endif
@@ -0,0 +1,108 @@
+#ifndef NETLAB_SYNAPSES_HPP_INCLUDED
+#   define NETLAB_SYNAPSES_HPP_INCLUDED
+
+#   include <netlab/uid.hpp>
+#   include <utility/basic_numeric_types.hpp>
+#   include <vector>
+#   include <atomic>
+#   include <memory>
+
+namespace netlab {
+
+
+/**
+ * Sockets of all units of a network stored in flat (CSR-like) arrays. Units are identified by their
+ * index in the network (see 'network_layer::first_unit'). Each unit owns a contiguous range of slots
+ * [slots_begin[u], slots_begin[u+1]) for its input sockets and the same range (in other arrays) for its
+ * output sockets. Only leading 'num_used_inputs[u]' (resp. 'num_used_outputs[u]') slots are in use;
+ * each used slot is either connected or a tombstone (a disconnected socket). Disconnection only marks
+ * slots as tombstones, so positions of other sockets do not change; tombstones are removed by compaction
+ * of the unit's range, either when a new socket does not fit in, or by 'compact()' when there are too many
+ * tombstones.
+ * Slots are also grouped to blocks of NUM_SLOTS_PER_BLOCK slots and each block remembers whether any of its
+ * slots was modified (so that snapshots can be saved incrementally, see 'netlab/snapshot.hpp').
+ */
+struct  synapses
+{
+    using  socket_index_type = uid::socket_index_type;
+
+    static constexpr natural_32_bit  TOMBSTONE = 0xffffffffU;
+    static constexpr natural_32_bit  NUM_SLOTS_PER_BLOCK = 4096U;
+
+    synapses();
+    void  clear();
+    natural_32_bit  push_back_unit(socket_index_type const  num_sockets);   // Returns the index of the new unit.
+
+    natural_32_bit  num_units() const { return (natural_32_bit)num_used_inputs.size(); }
+    socket_index_type  num_sockets(natural_32_bit const  unit) const
+    { return (socket_index_type)(slots_begin[unit + 1U] - slots_begin[unit]); }
+
+    natural_32_bit  inputs_begin(natural_32_bit const  unit) const { return slots_begin[unit]; }
+    natural_32_bit  inputs_end(natural_32_bit const  unit) const { return slots_begin[unit] + num_used_inputs[unit]; }
+    natural_32_bit  outputs_begin(natural_32_bit const  unit) const { return slots_begin[unit]; }
+    natural_32_bit  outputs_end(natural_32_bit const  unit) const { return slots_begin[unit] + num_used_outputs[unit]; }
+
+    // Returns the slot of the input socket of the connection.
+    natural_32_bit  connect(natural_32_bit const  input_unit, natural_32_bit const  output_unit, float_32_bit const  weight);
+    // Disconnects the input socket in the passed slot and the output socket connected to it.
+    void  disconnect(natural_32_bit const  input_slot);
+
+    bool  should_compact() const { return 4U * (num_input_tombstones + num_output_tombstones) > num_slots(); }
+    void  compact();
+
+    natural_32_bit  num_slots() const { return slots_begin.empty() ? 0U : slots_begin.back(); }
+
+    natural_32_bit  num_blocks() const { return (num_slots() + NUM_SLOTS_PER_BLOCK - 1U) / NUM_SLOTS_PER_BLOCK; }
+    bool  is_block_modified(natural_32_bit const  block) const { return modified_blocks[block].load(std::memory_order_relaxed) != 0U; }
+    // Must be called whenever the number of slots changes (i.e. once all units are pushed back).
+    void  reset_modified_blocks(bool const  state);
+    // The functions below can be called from parallel tasks.
+    void  set_modified(natural_32_bit const  slot);
+    void  set_modified(natural_32_bit const  slots_begin, natural_32_bit const  slots_end);
+
+    // PER UNIT DATA:
+
+    std::vector<natural_32_bit>  slots_begin;               // Has num_units() + 1 elements.
+    std::vector<socket_index_type>  num_used_inputs;
+    std::vector<socket_index_type>  num_used_outputs;
+
+    // PER SLOT DATA:
+
+    std::vector<natural_32_bit>  input_sources;             // The unit of the connected output socket, or TOMBSTONE.
+    std::vector<socket_index_type>  input_source_sockets;      // The output socket of the source unit (relative to its slots_begin).
+    std::vector<float_32_bit>  input_weights;
+    std::vector<natural_32_bit>  output_targets;            // The unit of the connected input socket, or TOMBSTONE.
+    std::vector<socket_index_type>  output_target_sockets;     // The input socket of the target unit (relative to its slots_begin).
+
+    natural_32_bit  num_input_tombstones;
+    natural_32_bit  num_output_tombstones;
+
+    std::unique_ptr<std::atomic<natural_8_bit>[]>  modified_blocks;   // Has num_blocks() elements.
+
+private:
+    void  compact_inputs(natural_32_bit const  unit);
+    void  compact_outputs(natural_32_bit const  unit);
+};
+
+
+inline void  synapses::set_modified(natural_32_bit const  slot)
+{
+    // The load avoids writes to (i.e. invalidation of) the shared cache line, when the block is already modified.
+    std::atomic<natural_8_bit>&  flag = modified_blocks[slot / NUM_SLOTS_PER_BLOCK];
+    if (flag.load(std::memory_order_relaxed) == 0U)
+        flag.store(1U, std::memory_order_relaxed);
+}
+
+
+inline void  synapses::set_modified(natural_32_bit const  slots_begin, natural_32_bit const  slots_end)
+{
+    if (slots_begin != slots_end)
+        for (natural_32_bit  block = slots_begin / NUM_SLOTS_PER_BLOCK, last = (slots_end - 1U) / NUM_SLOTS_PER_BLOCK; block <= last; ++block)
+            set_modified(block * NUM_SLOTS_PER_BLOCK);
+}
+
+
+}
+
+
+#endif
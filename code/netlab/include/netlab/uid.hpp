@@ -2,47 +2,75 @@
 #   define NETLAB_UID_HPP_INCLUDED
 
 #   include <utility/basic_numeric_types.hpp>
+#   include <utility/typefn_if_then_else.hpp>
 #   include <functional>
 
 namespace netlab {
 
 
-struct uid
+/**
+ * An identifier of a layer, a unit or a socket of a network, packed to a single number. The split of bits
+ * between the layer, the unit and the socket is a template parameter. The network uses the type 'uid' below,
+ * which is the compact 32-bit variant by default, or the wide 64-bit one when NETLAB_WIDE_UID is defined
+ * (see the CMake option E2_NETLAB_WIDE_UID).
+ */
+template<natural_8_bit NUM_LAYER_BITS_, natural_8_bit NUM_UNIT_BITS_, natural_8_bit NUM_SOCKET_BITS_, typename number_type_>
+struct basic_uid
 {
-    static constexpr natural_8_bit  NUM_LAYER_BITS  = 6;
-    static constexpr natural_8_bit  NUM_UNIT_BITS   = 14;
-    static constexpr natural_8_bit  NUM_SOCKET_BITS = 12;
+    using  number_type = number_type_;
 
-    static constexpr natural_8_bit   MAX_NUM_LAYERS             = 1 << NUM_LAYER_BITS;
-    static constexpr natural_16_bit  MAX_NUM_UNITS_PER_LAYER    = 1 << NUM_UNIT_BITS;
-    static constexpr natural_16_bit  MAX_NUM_SOCKETS_PER_UNIT   = 1 << NUM_SOCKET_BITS;
+    static constexpr natural_8_bit  NUM_LAYER_BITS  = NUM_LAYER_BITS_;
+    static constexpr natural_8_bit  NUM_UNIT_BITS   = NUM_UNIT_BITS_;
+    static constexpr natural_8_bit  NUM_SOCKET_BITS = NUM_SOCKET_BITS_;
 
-    static_assert(uid::MAX_NUM_LAYERS           == 64, "");
-    static_assert(uid::MAX_NUM_UNITS_PER_LAYER  == 16384, "");
-    static_assert(uid::MAX_NUM_SOCKETS_PER_UNIT == 4096, "");
+    static_assert(NUM_LAYER_BITS + NUM_UNIT_BITS + NUM_SOCKET_BITS == 8U * sizeof(number_type), "");
+    static_assert(NUM_LAYER_BITS <= 8U && NUM_UNIT_BITS < 32U && NUM_SOCKET_BITS < 32U, "");
 
-    static inline uid  as_layer(uid const  id) { return { id.layer, 0U, 0U }; }
-    static inline uid  as_unit(uid const  id) { return { id.layer, id.unit, 0U }; }
-    static inline uid  as_socket(uid  unit_id, natural_16_bit const  socket_idx) { unit_id.socket = socket_idx; return unit_id; }
+    static constexpr natural_32_bit  MAX_NUM_LAYERS             = 1U << NUM_LAYER_BITS;
+    static constexpr natural_32_bit  MAX_NUM_UNITS_PER_LAYER    = 1U << NUM_UNIT_BITS;
+    static constexpr natural_32_bit  MAX_NUM_SOCKETS_PER_UNIT   = 1U << NUM_SOCKET_BITS;
 
-    static inline natural_32_bit  as_number(uid const  id) noexcept { return *reinterpret_cast<natural_32_bit const*>(&id); }
+    // The smallest type able to store any number of sockets of a unit (i.e. up to MAX_NUM_SOCKETS_PER_UNIT).
+    using  socket_index_type = typename typefn_if_then_else<(NUM_SOCKET_BITS < 16U), natural_16_bit, natural_32_bit>::result;
 
-    natural_32_bit  layer : NUM_LAYER_BITS,
-                    unit  : NUM_UNIT_BITS,
-                    socket: NUM_SOCKET_BITS;
+    static inline basic_uid  as_layer(basic_uid const  id) { return { id.layer, 0U, 0U }; }
+    static inline basic_uid  as_unit(basic_uid const  id) { return { id.layer, id.unit, 0U }; }
+    static inline basic_uid  as_socket(basic_uid  unit_id, socket_index_type const  socket_idx) { unit_id.socket = socket_idx; return unit_id; }
+
+    static inline number_type  as_number(basic_uid const  id) noexcept { return *reinterpret_cast<number_type const*>(&id); }
+
+    number_type  layer : NUM_LAYER_BITS,
+                 unit  : NUM_UNIT_BITS,
+                 socket: NUM_SOCKET_BITS;
 };
-static_assert(sizeof(uid) == sizeof(natural_32_bit), "");
 
 
-inline bool operator==(uid const  left, uid const  right) noexcept
+using  compact_uid = basic_uid<6U, 14U, 12U, natural_32_bit>;  // 64 layers, 16384 units per layer, 4096 sockets per unit.
+using  wide_uid = basic_uid<8U, 30U, 26U, natural_64_bit>;     // 256 layers, 2^30 units per layer, 2^26 sockets per unit.
+// NOTE: The limits above are only those of the packing. Flat indices of units and slots of sockets over the whole
+//       network (see 'netlab/synapses.hpp') are 32-bit, so the total counts must stay below 'synapses::TOMBSTONE'.
+
+static_assert(sizeof(compact_uid) == sizeof(natural_32_bit), "");
+static_assert(sizeof(wide_uid) == sizeof(natural_64_bit), "");
+
+#   if defined(NETLAB_WIDE_UID)
+using  uid = wide_uid;
+#   else
+using  uid = compact_uid;
+#   endif
+
+
+template<natural_8_bit L, natural_8_bit U, natural_8_bit S, typename N>
+inline bool operator==(basic_uid<L, U, S, N> const  left, basic_uid<L, U, S, N> const  right) noexcept
 {
-    return uid::as_number(left) == uid::as_number(right);
+    return basic_uid<L, U, S, N>::as_number(left) == basic_uid<L, U, S, N>::as_number(right);
 }
 
 
-inline bool operator<(uid const  left, uid const  right) noexcept
+template<natural_8_bit L, natural_8_bit U, natural_8_bit S, typename N>
+inline bool operator<(basic_uid<L, U, S, N> const  left, basic_uid<L, U, S, N> const  right) noexcept
 {
-    return uid::as_number(left) < uid::as_number(right);
+    return basic_uid<L, U, S, N>::as_number(left) < basic_uid<L, U, S, N>::as_number(right);
 }
 
 
@@ -51,12 +79,12 @@ inline bool operator<(uid const  left, uid const  right) noexcept
 namespace std {
 
 
-template<>
-struct hash<netlab::uid>
+template<natural_8_bit L, natural_8_bit U, natural_8_bit S, typename N>
+struct hash<netlab::basic_uid<L, U, S, N> >
 {
-    size_t  operator()(netlab::uid const  id) const
+    size_t  operator()(netlab::basic_uid<L, U, S, N> const  id) const
     {
-        return std::hash<natural_32_bit>()(netlab::uid::as_number(id));
+        return std::hash<N>()(netlab::basic_uid<L, U, S, N>::as_number(id));
     }
 };
 
@@ -18,7 +18,9 @@ builder::builder(network* const  net_)
 
 builder&  builder::insert_layer_info(layer_info const&  info)
 {
-    ASSUMPTION(info.num_units > 0U && info.layer.units.empty());
+    ASSUMPTION(layers.size() < uid::MAX_NUM_LAYERS);
+    ASSUMPTION(info.num_units > 0U && info.num_units <= uid::MAX_NUM_UNITS_PER_LAYER && info.layer.num_units == 0U);
+    ASSUMPTION(info.num_sockets_per_unit <= uid::MAX_NUM_SOCKETS_PER_UNIT);
     network_layer const&  layer = info.layer;
     ASSUMPTION(layer.SPIKE_SIGN == 1.0f || layer.SPIKE_SIGN == -1.0f);
     ASSUMPTION(layer.CHARGE_SPIKE > 0.0f);
@@ -30,6 +32,17 @@ builder&  builder::insert_layer_info(layer_info const&  info)
     ASSUMPTION(layer.WEIGHT_DISCONNECTION >= 0.0f && layer.WEIGHT_DISCONNECTION < layer.WEIGHT_CONNECTION);
     ASSUMPTION(layer.WEIGHT_MAXIMAL > layer.WEIGHT_CONNECTION);
     ASSUMPTION(layer.SPIKE_MAGNITUDE > 0.0f);
+    // Even with the wide uid, flat indices of units and slots in the network (see 'synapses') are 32-bit.
+    {
+        natural_64_bit  total_units = info.num_units;
+        natural_64_bit  total_slots = (natural_64_bit)info.num_units * info.num_sockets_per_unit;
+        for (layer_info const&  other : layers)
+        {
+            total_units += other.num_units;
+            total_slots += (natural_64_bit)other.num_units * other.num_sockets_per_unit;
+        }
+        ASSUMPTION(total_units < synapses::TOMBSTONE && total_slots < synapses::TOMBSTONE);
+    }
     layers.push_back(info);
     return *this;
 }
@@ -41,32 +54,39 @@ void  builder::run()
         setup_minimal_net();
 
     net->layers.resize(layers.size());
+    net->charges.clear();
+    net->unit_layers.clear();
+    net->sockets.clear();
     net->open_inputs.clear();
     net->open_outputs.clear();
     net->spiking_units.clear();
     net->spiking_output_units.clear();
-    for (natural_8_bit  i = 0U; i != (natural_8_bit)layers.size(); ++i)
+    net->snapshot_tag = 0ULL;
+    for (natural_32_bit  i = 0U; i != (natural_32_bit)layers.size(); ++i)
     {
         layer_info const&  info = layers.at(i);
         network_layer& nl = net->layers.at(i);
         nl = info.layer;
-        nl.units.resize(info.num_units);
-        for (natural_16_bit  j = 0U; j != info.num_units; ++j)
+        nl.first_unit = (natural_32_bit)net->charges.size();
+        nl.num_units = info.num_units;
+        nl.num_sockets_per_unit = info.num_sockets_per_unit;
+        for (natural_32_bit  j = 0U; j != info.num_units; ++j)
         {
-            computation_unit&  cu = nl.units.at(j);
-            cu.charge = nl.CHARGE_RECOVERY;
-            cu.inputs.clear();
-            cu.outputs.clear();
-            uid const  unit_id{ i, j, 0U };
-            for (natural_16_bit  k = 0U; k != info.num_sockets_per_unit; ++k)
+            natural_32_bit const  unit = net->sockets.push_back_unit(info.num_sockets_per_unit);
+            INVARIANT(unit == nl.first_unit + j);
+            net->charges.push_back(nl.CHARGE_RECOVERY);
+            net->unit_layers.push_back((natural_8_bit)i);
+            for (uid::socket_index_type  k = 0U; k != info.num_sockets_per_unit; ++k)
             {
                 if (i >= net->NUM_INPUT_LAYERS)
-                    net->open_inputs.push_back(unit_id);
-                if (i < (natural_8_bit)layers.size() - net->NUM_INPUT_LAYERS)
-                    net->open_outputs.push_back(unit_id);
+                    net->open_inputs.push_back(unit);
+                if (i < (natural_32_bit)layers.size() - net->NUM_OUTPUT_LAYERS)
+                    net->open_outputs.push_back(unit);
             }
         }
     }
+    net->stats.select_probes(net->layers, net->NUM_INPUT_LAYERS);
+    net->initialise_round_data();
     net->connect_open_sockets();
 }
 
@@ -84,13 +104,9 @@ void  builder::setup_minimal_net()
             0.0f, // WEIGHT_DISCONNECTION
             1.0f, // WEIGHT_MAXIMAL
             1.0f, // INPUT_SPIKE_MAGNITUDE
-            { // units
-                computation_unit {
-                    0.0f,   // charge
-                    {},     // inputs
-                    {}      // outputs
-                    }
-                }
+            0U, // first_unit
+            0U, // num_units
+            0U  // num_sockets_per_unit
             };
     layer_info const  info_template {
             1U, // num_units
@@ -111,7 +127,7 @@ void  builder::setup_minimal_net()
     if (net->NUM_OUTPUT_LAYERS > 0U)
         for (num_sockets = 0U, layer_idx = 0U; num_sockets < total_sockets; ++num_sockets)
         {
-            layer_info&  info = layers.at((natural_8_bit)layers.size() - net->NUM_OUTPUT_LAYERS + layer_idx);
+            layer_info&  info = layers.at(layers.size() - net->NUM_OUTPUT_LAYERS + layer_idx);
             ++info.num_sockets_per_unit;
             layer_idx = (layer_idx + 1U) % net->NUM_OUTPUT_LAYERS;
         }
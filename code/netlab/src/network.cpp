@@ -2,6 +2,98 @@
 #include <utility/assumptions.hpp>
 #include <utility/invariants.hpp>
 #include <utility/timeprof.hpp>
+#include <utility/config.hpp>
+#include <utility/bit_count.hpp>
+#include <algorithm>
+
+namespace netlab { namespace {
+
+
+natural_32_bit const  NUM_SPIKING_UNITS_PER_TASK = 256U;
+natural_32_bit const  NUM_UNITS_PER_TASK = 4096U;
+natural_32_bit const  NUM_UNITS_PER_BLOCK = 64U;     // The number of bits of a spike mask.
+natural_32_bit const  NUM_SOCKETS_PER_SHUFFLE_BUCKET = 4096U;
+
+
+natural_32_bit  get_num_tasks(natural_32_bit const  num_items, natural_32_bit const  num_items_per_task)
+{
+    return (num_items + num_items_per_task - 1U) / num_items_per_task;
+}
+
+
+float_32_bit  compute_weight_mult(float_32_bit const  charge, network_layer const&  layer, float_32_bit const  spike_sign)
+{
+    float_32_bit  weight_mult;
+    if (charge < layer.WEIGHT_NEUTRAL_CHARGE)
+        weight_mult = (charge - layer.WEIGHT_NEUTRAL_CHARGE) / (layer.WEIGHT_NEUTRAL_CHARGE - layer.CHARGE_RECOVERY);
+    else
+        weight_mult = (charge - layer.WEIGHT_NEUTRAL_CHARGE) / (layer.CHARGE_SPIKE - layer.WEIGHT_NEUTRAL_CHARGE);
+    return weight_mult * spike_sign;
+}
+
+
+// The update of the charge of a unit in one round, used by both the dense and the event-driven mode (so they
+// are bit-identical to each other). The input charge is the count of received spikes times SPIKE_MAGNITUDE, which
+// equals adding the spikes to the charge one by one only up to float rounding.
+inline float_32_bit  update_charge(
+        float_32_bit const  charge,
+        float_32_bit const  input_charge,
+        float_32_bit const  CHARGE_DECAY_COEF,
+        float_32_bit const  CHARGE_SPIKE
+        )
+{
+    return std::min((charge + input_charge) * CHARGE_DECAY_COEF, CHARGE_SPIKE);
+}
+
+
+// Updates charges of at most NUM_UNITS_PER_BLOCK consecutive units of a layer, where 'input_charges' are charges
+// received by the units in the round, and returns the mask of units which reached CHARGE_SPIKE. Both loops are
+// branch-free over contiguous arrays, so compilers vectorise them (to SSE/AVX/WASM SIMD, depending on the target).
+natural_64_bit  update_charges_block(
+        float_32_bit* const  charges,
+        float_32_bit const* const  input_charges,
+        natural_32_bit const  num_units,
+        network_layer const&  layer
+        )
+{
+    float_32_bit const  CHARGE_DECAY_COEF = layer.CHARGE_DECAY_COEF;
+    float_32_bit const  CHARGE_SPIKE = layer.CHARGE_SPIKE;
+    for (natural_32_bit  i = 0U; i < num_units; ++i)
+        charges[i] = update_charge(charges[i], input_charges[i], CHARGE_DECAY_COEF, CHARGE_SPIKE);
+    // Spikes are rare, so the mask is built only when the (vectorised) count of spiking units is not zero.
+    natural_32_bit  num_spiking_units = 0U;
+    for (natural_32_bit  i = 0U; i < num_units; ++i)
+        num_spiking_units += charges[i] == CHARGE_SPIKE ? 1U : 0U;
+    if (num_spiking_units == 0U)
+        return 0ULL;
+    natural_64_bit  spike_mask = 0ULL;
+    for (natural_32_bit  i = 0U; i < num_units; ++i)
+        spike_mask |= (natural_64_bit)(charges[i] == CHARGE_SPIKE) << i;
+    return spike_mask;
+}
+
+
+// Applies 'num_rounds' updates of the charge of a unit which received no spike in these rounds. The charge is
+// decayed round by round (rather than by the closed form 'charge * CHARGE_DECAY_COEF^num_rounds'), so that the
+// result is bit-identical to the one of the dense mode. The loop stops as soon as the charge reaches its fixed
+// point (a tiny subnormal number, where the rounded product equals the charge). From the charge 1 that is after
+// 964, 9876 and 96901 iterations for coefficients 0.9, 0.99 and 0.999 respectively. Since the decayed charge is
+// written back (see 'refresh_charges_of_units_connected_to_spiking_units'), the number of iterations of all the
+// decays of a unit is never larger than the number of rounds, i.e. than the work of the dense mode.
+float_32_bit  decay_charge(float_32_bit  charge, network_layer const&  layer, natural_32_bit  num_rounds)
+{
+    for ( ; num_rounds != 0U; --num_rounds)
+    {
+        float_32_bit const  decayed_charge = update_charge(charge, 0.0f, layer.CHARGE_DECAY_COEF, layer.CHARGE_SPIKE);
+        if (decayed_charge == charge)
+            break;
+        charge = decayed_charge;
+    }
+    return charge;
+}
+
+
+}}
 
 namespace netlab {
 
@@ -22,23 +114,155 @@ network::network(
 
     , layers()
 
+    , charges()
+    , unit_layers()
+    , sockets()
+
     , open_inputs()
     , open_outputs()
-    , open_io_mutex()
 
     , spiking_units()
     , spiking_output_units()
-    , spiking_mutex()
 
     , random_generator()
 
     , stats(stats_.NUM_ROUNDS_PER_SNAPSHOT, stats_.SNAPSHOTS_HISTORY_SIZE, stats_.RATIO_OF_PROBED_UNITS_PER_LAYER)
+
+    , num_spikes(0ULL)
+    , num_synaptic_events(0ULL)
+    , num_connections(0ULL)
+    , num_disconnections(0ULL)
+
+    , workers(std::make_unique<thread_pool>(1U))
+    , received_spikes()
+    , charge_update_tasks()
+    , task_outputs()
+
+    , event_driven(false)
+    , num_charge_updates(0U)
+    , charge_rounds()
+    , receive_stamps()
+    , refresh_stamps()
+    , active_units()
+
+    , shuffled_inputs()
+    , shuffle_offsets()
+
+    , snapshot_tag(0ULL)
 {
     reset(random_generator, random_generator_seed);
     builder(this).run();
 }
 
 
+network::counters  network::get_counters() const
+{
+    return { num_spikes, num_synaptic_events.load(std::memory_order_relaxed), num_connections, num_disconnections };
+}
+
+
+void  network::set_num_threads(natural_32_bit const  num_threads_)
+{
+    ASSUMPTION(num_threads_ > 0U);
+    if (num_threads_ == workers->num_threads())
+        return;
+    workers = nullptr;  // Joins the current workers first.
+    workers = std::make_unique<thread_pool>(num_threads_);
+    stats.set_num_threads(workers->num_threads());
+}
+
+
+void  network::set_event_driven(bool const  state)
+{
+    TMPROF_BLOCK();
+
+    if (event_driven)
+        for (natural_32_bit  unit = 0U, n = (natural_32_bit)charges.size(); unit != n; ++unit)
+            charges[unit] = current_charge(unit);
+    std::fill(charge_rounds.begin(), charge_rounds.end(), num_charge_updates);
+    event_driven = state;
+}
+
+
+bool  network::is_input_socket_connected(uid const  id) const
+{
+    natural_32_bit const  unit = unit_index(id);
+    ASSUMPTION(id.socket < sockets.num_sockets(unit));
+    return id.socket < sockets.num_used_inputs.at(unit) &&
+           sockets.input_sources.at(sockets.inputs_begin(unit) + id.socket) != synapses::TOMBSTONE;
+}
+
+
+bool  network::is_output_socket_connected(uid const  id) const
+{
+    natural_32_bit const  unit = unit_index(id);
+    ASSUMPTION(id.socket < sockets.num_sockets(unit));
+    return id.socket < sockets.num_used_outputs.at(unit) &&
+           sockets.output_targets.at(sockets.outputs_begin(unit) + id.socket) != synapses::TOMBSTONE;
+}
+
+
+input_socket  network::get_input_socket(uid const  id) const
+{
+    ASSUMPTION(is_input_socket_connected(id));
+    natural_32_bit const  slot = sockets.inputs_begin(unit_index(id)) + id.socket;
+    return {
+        uid::as_socket(unit_uid(sockets.input_sources.at(slot)), sockets.input_source_sockets.at(slot)),
+        sockets.input_weights.at(slot)
+        };
+}
+
+
+output_socket  network::get_output_socket(uid const  id) const
+{
+    ASSUMPTION(is_output_socket_connected(id));
+    natural_32_bit const  slot = sockets.outputs_begin(unit_index(id)) + id.socket;
+    return { uid::as_socket(unit_uid(sockets.output_targets.at(slot)), sockets.output_target_sockets.at(slot)) };
+}
+
+
+uid  network::unit_uid(natural_32_bit const  unit_index) const
+{
+    natural_8_bit const  layer_index = unit_layers.at(unit_index);
+    return { layer_index, unit_index - layers.at(layer_index).first_unit, 0U };
+}
+
+
+float_32_bit  network::current_charge(natural_32_bit const  unit) const
+{
+    natural_8_bit const  layer_index = unit_layers[unit];
+    if (!event_driven || layer_index < NUM_INPUT_LAYERS)
+        return charges[unit];
+    return decay_charge(charges[unit], layers[layer_index], num_charge_updates - charge_rounds[unit]);
+}
+
+
+void  network::initialise_round_data()
+{
+    natural_32_bit const  num_units = (natural_32_bit)charges.size();
+    sockets.reset_modified_blocks(true);
+    received_spikes.reset(new std::atomic<integer_32_bit>[num_units]);
+    for (natural_32_bit  i = 0U; i != num_units; ++i)
+        received_spikes[i].store(0, std::memory_order_relaxed);
+
+    num_charge_updates = 0U;
+    charge_rounds.assign(num_units, 0U);
+    receive_stamps.reset(new std::atomic<natural_32_bit>[num_units]);
+    refresh_stamps.reset(new std::atomic<natural_32_bit>[num_units]);
+    for (natural_32_bit  i = 0U; i != num_units; ++i)
+    {
+        receive_stamps[i].store(0U, std::memory_order_relaxed);
+        refresh_stamps[i].store(0U, std::memory_order_relaxed);
+    }
+    active_units.clear();
+
+    charge_update_tasks.clear();
+    for (natural_32_bit  i = NUM_INPUT_LAYERS; i < (natural_32_bit)layers.size(); ++i)
+        for (natural_32_bit  j = 0U; j < layers.at(i).num_units; j += NUM_UNITS_PER_TASK)
+            charge_update_tasks.push_back({ i, j, 0U });
+}
+
+
 void  network::set_spiking_input_unit(uid const  input_unit_id)
 {
     ASSUMPTION(input_unit_id.socket == 0U);
@@ -46,12 +270,12 @@ void  network::set_spiking_input_unit(uid const  input_unit_id)
     ASSUMPTION(input_unit_id.layer < NUM_INPUT_LAYERS);
     network_layer&  layer = layers.at(input_unit_id.layer);
 
-    ASSUMPTION(input_unit_id.unit < (natural_16_bit)layer.units.size());
-    computation_unit&  unit = layer.units.at(input_unit_id.unit);
+    ASSUMPTION(input_unit_id.unit < layer.num_units);
+    natural_32_bit const  unit = layer.first_unit + input_unit_id.unit;
 
-    unit.charge = layer.CHARGE_RECOVERY;
+    charges.at(unit) = layer.CHARGE_RECOVERY;
 
-    spiking_units.push_back(input_unit_id);
+    spiking_units.push_back(unit);
 }
 
 
@@ -61,64 +285,119 @@ void  network::next_round()
 
     stats.on_next_round();
 
+    // An input unit may have been set spiking several times. Each spiking unit must be processed only once,
+    // otherwise parallel tasks below could update the same sockets concurrently.
+    std::sort(spiking_units.begin(), spiking_units.end());
+    spiking_units.erase(std::unique(spiking_units.begin(), spiking_units.end()), spiking_units.end());
+    num_spikes += spiking_units.size();
+
     // NOTE: The order of called methods is highly important. Think twice before changing it!!
 
+    if (event_driven)
+        refresh_charges_of_units_connected_to_spiking_units();
     update_input_sockets_of_spiking_units();
     update_output_sockets_of_spiking_units();
     propagate_charge_of_spikes();
     discharge_spiking_units();
     update_charge_of_units();
+    if (sockets.should_compact())
+        sockets.compact();
     connect_open_sockets();
 }
 
 
-void  network::update_input_sockets_of_spiking_units()
+void  network::refresh_charges_of_units_connected_to_spiking_units()
 {
     TMPROF_BLOCK();
 
-    // NOTE: If we have K processors/cores, then we could split spiking_units to K intervals and
-    //       process each interval in a separate thread.
-    for (uid  id : spiking_units)
-    {
-        network_layer&  layer = layers.at(id.layer);
-        computation_unit&  unit = layer.units.at(id.unit);
+    // Charges of these units are read (possibly many times) when updating weights of sockets of spiking units.
+    // So, we apply their postponed decays now, once per unit. A unit connected to several spiking units is
+    // updated by the task which stamps it first.
+    natural_32_bit const  num_tasks = get_num_tasks((natural_32_bit)spiking_units.size(), NUM_SPIKING_UNITS_PER_TASK);
+    workers->run(num_tasks, [this](natural_32_bit const  task_index, natural_32_bit) {
+        natural_32_bit const  stamp = num_charge_updates + 1U;
+        auto const  refresh = [this, stamp](natural_32_bit const  unit) {
+            if (unit == synapses::TOMBSTONE || refresh_stamps[unit].exchange(stamp, std::memory_order_relaxed) == stamp)
+                return;
+            natural_8_bit const  layer_index = unit_layers[unit];
+            if (layer_index < NUM_INPUT_LAYERS || charge_rounds[unit] == num_charge_updates)
+                return;
+            charges[unit] = decay_charge(charges[unit], layers[layer_index], num_charge_updates - charge_rounds[unit]);
+            charge_rounds[unit] = num_charge_updates;
+        };
+        for (natural_32_bit  k = task_index * NUM_SPIKING_UNITS_PER_TASK,
+                            end = std::min(k + NUM_SPIKING_UNITS_PER_TASK, (natural_32_bit)spiking_units.size());
+             k < end; ++k)
+        {
+            natural_32_bit const  unit = spiking_units[k];
+            for (natural_32_bit  slot = sockets.inputs_begin(unit), slots_end = sockets.inputs_end(unit); slot != slots_end; ++slot)
+                refresh(sockets.input_sources[slot]);
+            for (natural_32_bit  slot = sockets.outputs_begin(unit), slots_end = sockets.outputs_end(unit); slot != slots_end; ++slot)
+                refresh(sockets.output_targets[slot]);
+        }
+    });
+}
+
 
-        std::vector<input_socket>&  inputs = unit.inputs;
-        for (natural_16_bit  i = 0U; i < (natural_16_bit)inputs.size(); )
+void  network::update_input_sockets_of_spiking_units()
+{
+    TMPROF_BLOCK();
+
+    // Each spiking unit updates weights of its own input sockets and only reads charges of other units.
+    // So, spiking units are processed in parallel. Disconnections modify sockets of other units, so they
+    // are performed afterwards in a single thread, in the order of spiking units.
+    natural_32_bit const  num_tasks = get_num_tasks((natural_32_bit)spiking_units.size(), NUM_SPIKING_UNITS_PER_TASK);
+    task_outputs.resize(std::max(num_tasks, (natural_32_bit)task_outputs.size()));
+    workers->run(num_tasks, [this](natural_32_bit const  task_index, natural_32_bit) {
+        std::vector<natural_32_bit>&  units_to_disconnect = task_outputs[task_index];
+        units_to_disconnect.clear();
+        for (natural_32_bit  k = task_index * NUM_SPIKING_UNITS_PER_TASK,
+                            end = std::min(k + NUM_SPIKING_UNITS_PER_TASK, (natural_32_bit)spiking_units.size());
+             k < end; ++k)
         {
-            input_socket&  input = inputs.at(i);
+            natural_32_bit const  unit = spiking_units[k];
+            network_layer const&  layer = layers[unit_layers[unit]];
 
-            uid const  other_id = input.other;
-            network_layer&  other_layer = layers.at(other_id.layer);
-            computation_unit&  other_unit = other_layer.units.at(other_id.unit);
+            sockets.set_modified(sockets.inputs_begin(unit), sockets.inputs_end(unit));
 
-            float_32_bit  weight_mult;
+            bool  has_socket_to_disconnect = false;
+            for (natural_32_bit  slot = sockets.inputs_begin(unit), slots_end = sockets.inputs_end(unit); slot != slots_end; ++slot)
             {
-                if (other_unit.charge < other_layer.WEIGHT_NEUTRAL_CHARGE)
-                    weight_mult = (other_unit.charge - other_layer.WEIGHT_NEUTRAL_CHARGE) /
-                                  (other_layer.WEIGHT_NEUTRAL_CHARGE - other_layer.CHARGE_RECOVERY);
-                else
-                    weight_mult = (other_unit.charge - other_layer.WEIGHT_NEUTRAL_CHARGE) /
-                                  (other_layer.CHARGE_SPIKE - other_layer.WEIGHT_NEUTRAL_CHARGE);
-                weight_mult *= other_layer.SPIKE_SIGN;
-            }
+                natural_32_bit const  other_unit = sockets.input_sources[slot];
+                if (other_unit == synapses::TOMBSTONE)
+                    continue;
+                network_layer const&  other_layer = layers[unit_layers[other_unit]];
 
-            float_32_bit const  WEIGHT_DELTA_PER_SPIKE = 0.5f * (layer.WEIGHT_DELTA_PER_SPIKE + other_layer.WEIGHT_DELTA_PER_SPIKE);
-            float_32_bit const  WEIGHT_MAXIMAL = 0.5f * (layer.WEIGHT_MAXIMAL + other_layer.WEIGHT_MAXIMAL);
+                float_32_bit const  weight_mult = compute_weight_mult(current_charge(other_unit), other_layer, other_layer.SPIKE_SIGN);
 
-            input.weight = std::min(input.weight + WEIGHT_DELTA_PER_SPIKE * weight_mult, WEIGHT_MAXIMAL);
+                float_32_bit const  WEIGHT_DELTA_PER_SPIKE = 0.5f * (layer.WEIGHT_DELTA_PER_SPIKE + other_layer.WEIGHT_DELTA_PER_SPIKE);
+                float_32_bit const  WEIGHT_MAXIMAL = 0.5f * (layer.WEIGHT_MAXIMAL + other_layer.WEIGHT_MAXIMAL);
 
-            float_32_bit const  WEIGHT_DISCONNECTION = 0.5f * (layer.WEIGHT_DISCONNECTION + other_layer.WEIGHT_DISCONNECTION);
+                float_32_bit&  weight = sockets.input_weights[slot];
+                weight = std::min(weight + WEIGHT_DELTA_PER_SPIKE * weight_mult, WEIGHT_MAXIMAL);
 
-            if (input.weight <= WEIGHT_DISCONNECTION)
+                if (weight <= 0.5f * (layer.WEIGHT_DISCONNECTION + other_layer.WEIGHT_DISCONNECTION))
+                    has_socket_to_disconnect = true;
+            }
+            if (has_socket_to_disconnect)
+                units_to_disconnect.push_back(unit);
+        }
+    });
+
+    for (natural_32_bit  task_index = 0U; task_index != num_tasks; ++task_index)
+        for (natural_32_bit  unit : task_outputs[task_index])
+        {
+            network_layer const&  layer = layers[unit_layers[unit]];
+            for (natural_32_bit  slot = sockets.inputs_begin(unit), slots_end = sockets.inputs_end(unit); slot != slots_end; ++slot)
             {
-                disconnect(inputs, uid::as_socket(id, i), other_unit.outputs, other_id);
-                continue;
+                natural_32_bit const  other_unit = sockets.input_sources[slot];
+                if (other_unit == synapses::TOMBSTONE)
+                    continue;
+                network_layer const&  other_layer = layers[unit_layers[other_unit]];
+                if (sockets.input_weights[slot] <= 0.5f * (layer.WEIGHT_DISCONNECTION + other_layer.WEIGHT_DISCONNECTION))
+                    disconnect(slot);
             }
-    
-            ++i;
         }
-    }
 }
 
 
@@ -126,55 +405,67 @@ void  network::update_output_sockets_of_spiking_units()
 {
     TMPROF_BLOCK();
 
-    // NOTE: If we have K processors/cores, then we could split spiking_units to K intervals and
-    //       process each interval in a separate thread.
-    for (uid  id : spiking_units)
-    {
-        network_layer&  layer = layers.at(id.layer);
-        computation_unit&  unit = layer.units.at(id.unit);
-
-        std::vector<output_socket>&  outputs = unit.outputs;
-        for (natural_16_bit  i = 0U; i < (natural_16_bit)outputs.size(); )
+    // Each input socket is connected to exactly one output socket. So, spiking units update weights of
+    // pairwise different input sockets of other units and they can be processed in parallel. Disconnections
+    // are then performed in a single thread, like in 'update_input_sockets_of_spiking_units'.
+    natural_32_bit const  num_tasks = get_num_tasks((natural_32_bit)spiking_units.size(), NUM_SPIKING_UNITS_PER_TASK);
+    task_outputs.resize(std::max(num_tasks, (natural_32_bit)task_outputs.size()));
+    workers->run(num_tasks, [this](natural_32_bit const  task_index, natural_32_bit) {
+        std::vector<natural_32_bit>&  units_to_disconnect = task_outputs[task_index];
+        units_to_disconnect.clear();
+        for (natural_32_bit  k = task_index * NUM_SPIKING_UNITS_PER_TASK,
+                            end = std::min(k + NUM_SPIKING_UNITS_PER_TASK, (natural_32_bit)spiking_units.size());
+             k < end; ++k)
         {
-            output_socket&  output = outputs.at(i);
+            natural_32_bit const  unit = spiking_units[k];
+            network_layer const&  layer = layers[unit_layers[unit]];
 
-            uid const  other_id = output.other;
-            network_layer&  other_layer = layers.at(other_id.layer);
-            computation_unit&  other_unit = other_layer.units.at(other_id.unit);
-
-            if (other_unit.charge == other_layer.CHARGE_SPIKE)
-                continue; // This socket pair was already updated in update_input_sockets_of_spiking_units().
+            bool  has_socket_to_disconnect = false;
+            for (natural_32_bit  slot = sockets.outputs_begin(unit), slots_end = sockets.outputs_end(unit); slot != slots_end; ++slot)
+            {
+                natural_32_bit const  other_unit = sockets.output_targets[slot];
+                if (other_unit == synapses::TOMBSTONE)
+                    continue;
+                network_layer const&  other_layer = layers[unit_layers[other_unit]];
 
-            std::vector<input_socket>&  other_inputs = other_unit.inputs;
-            input_socket&  other_input = other_inputs.at(other_id.socket);
+                float_32_bit const  other_charge = current_charge(other_unit);
+                if (other_charge == other_layer.CHARGE_SPIKE)
+                    continue; // This socket pair was already updated in update_input_sockets_of_spiking_units().
 
-            float_32_bit  weight_mult;
-            {
-                if (other_unit.charge < other_layer.WEIGHT_NEUTRAL_CHARGE)
-                    weight_mult = (other_unit.charge - other_layer.WEIGHT_NEUTRAL_CHARGE) /
-                                  (other_layer.WEIGHT_NEUTRAL_CHARGE - other_layer.CHARGE_RECOVERY);
-                else
-                    weight_mult = (other_unit.charge - other_layer.WEIGHT_NEUTRAL_CHARGE) /
-                                  (other_layer.CHARGE_SPIKE - other_layer.WEIGHT_NEUTRAL_CHARGE);
-                weight_mult *= layer.SPIKE_SIGN;
-            }
+                float_32_bit const  weight_mult = compute_weight_mult(other_charge, other_layer, layer.SPIKE_SIGN);
 
-            float_32_bit const  WEIGHT_DELTA_PER_SPIKE = 0.5f * (layer.WEIGHT_DELTA_PER_SPIKE + other_layer.WEIGHT_DELTA_PER_SPIKE);
-            float_32_bit const  WEIGHT_MAXIMAL = 0.5f * (layer.WEIGHT_MAXIMAL + other_layer.WEIGHT_MAXIMAL);
+                float_32_bit const  WEIGHT_DELTA_PER_SPIKE = 0.5f * (layer.WEIGHT_DELTA_PER_SPIKE + other_layer.WEIGHT_DELTA_PER_SPIKE);
+                float_32_bit const  WEIGHT_MAXIMAL = 0.5f * (layer.WEIGHT_MAXIMAL + other_layer.WEIGHT_MAXIMAL);
 
-            other_input.weight = std::min(other_input.weight + WEIGHT_DELTA_PER_SPIKE * weight_mult, WEIGHT_MAXIMAL);
+                natural_32_bit const  other_slot = sockets.inputs_begin(other_unit) + sockets.output_target_sockets[slot];
+                float_32_bit&  weight = sockets.input_weights[other_slot];
+                weight = std::min(weight + WEIGHT_DELTA_PER_SPIKE * weight_mult, WEIGHT_MAXIMAL);
+                sockets.set_modified(other_slot);
 
-            float_32_bit const  WEIGHT_DISCONNECTION = 0.5f * (layer.WEIGHT_DISCONNECTION + other_layer.WEIGHT_DISCONNECTION);
+                if (weight <= 0.5f * (layer.WEIGHT_DISCONNECTION + other_layer.WEIGHT_DISCONNECTION))
+                    has_socket_to_disconnect = true;
+            }
+            if (has_socket_to_disconnect)
+                units_to_disconnect.push_back(unit);
+        }
+    });
 
-            if (other_input.weight <= WEIGHT_DISCONNECTION)
+    for (natural_32_bit  task_index = 0U; task_index != num_tasks; ++task_index)
+        for (natural_32_bit  unit : task_outputs[task_index])
+        {
+            network_layer const&  layer = layers[unit_layers[unit]];
+            for (natural_32_bit  slot = sockets.outputs_begin(unit), slots_end = sockets.outputs_end(unit); slot != slots_end; ++slot)
             {
-                disconnect(other_inputs, other_id, outputs, uid::as_socket(id, i));
-                continue;
+                natural_32_bit const  other_unit = sockets.output_targets[slot];
+                if (other_unit == synapses::TOMBSTONE)
+                    continue;
+                network_layer const&  other_layer = layers[unit_layers[other_unit]];
+                natural_32_bit const  other_slot = sockets.inputs_begin(other_unit) + sockets.output_target_sockets[slot];
+                if (current_charge(other_unit) != other_layer.CHARGE_SPIKE &&
+                    sockets.input_weights[other_slot] <= 0.5f * (layer.WEIGHT_DISCONNECTION + other_layer.WEIGHT_DISCONNECTION))
+                    disconnect(other_slot);
             }
-    
-            ++i;
         }
-    }
 }
 
 
@@ -182,28 +473,43 @@ void  network::propagate_charge_of_spikes()
 {
     TMPROF_BLOCK();
 
-    // NOTE: If we have K processors/cores, then we could split spiking_units to K intervals and
-    //       process each interval in a separate thread.
-    //       WARNING/TODO: Concurrent access to 'other_unit.charge' - synchronisation required!
-    for (uid  id : spiking_units)
-    {
-        network_layer&  layer = layers.at(id.layer);
-        computation_unit&  unit = layer.units.at(id.unit);
-
-        std::vector<output_socket>&  outputs = unit.outputs;
-        for (natural_16_bit  i = 0U; i < (natural_16_bit)outputs.size(); ++i)
+    // Received spikes are only counted here (atomically, as units may receive spikes from several threads).
+    // The charge is updated from the counts in 'update_charge_of_units'. In the event-driven mode each task
+    // also records units which received their first spike in the round (the stamp is exchanged atomically).
+    natural_32_bit const  num_tasks = get_num_tasks((natural_32_bit)spiking_units.size(), NUM_SPIKING_UNITS_PER_TASK);
+    task_outputs.resize(std::max(num_tasks, (natural_32_bit)task_outputs.size()));
+    workers->run(num_tasks, [this](natural_32_bit const  task_index, natural_32_bit const  thread_index) {
+        std::vector<natural_32_bit>&  receiving_units = task_outputs[task_index];
+        receiving_units.clear();
+        natural_32_bit const  stamp = num_charge_updates + 1U;
+        natural_64_bit  num_events = 0ULL;
+        for (natural_32_bit  k = task_index * NUM_SPIKING_UNITS_PER_TASK,
+                            end = std::min(k + NUM_SPIKING_UNITS_PER_TASK, (natural_32_bit)spiking_units.size());
+             k < end; ++k)
         {
-            output_socket&  output = outputs.at(i);
-
-            uid const  other_id = output.other;
-            network_layer&  other_layer = layers.at(other_id.layer);
-            computation_unit&  other_unit = other_layer.units.at(other_id.unit);
-
-            stats.on_spike_received(id);
-
-            // WARNING: Concurrent access to 'other_unit.charge' - synchronisation required!
-            other_unit.charge += layer.SPIKE_SIGN * other_layer.SPIKE_MAGNITUDE;
+            natural_32_bit const  unit = spiking_units[k];
+            integer_32_bit const  spike_sign = layers[unit_layers[unit]].SPIKE_SIGN > 0.0f ? 1 : -1;
+            for (natural_32_bit  slot = sockets.outputs_begin(unit), slots_end = sockets.outputs_end(unit); slot != slots_end; ++slot)
+            {
+                natural_32_bit const  other_unit = sockets.output_targets[slot];
+                if (other_unit == synapses::TOMBSTONE)
+                    continue;
+                received_spikes[other_unit].fetch_add(spike_sign, std::memory_order_relaxed);
+                if (event_driven && receive_stamps[other_unit].exchange(stamp, std::memory_order_relaxed) != stamp)
+                    receiving_units.push_back(other_unit);
+                // Like in the original statistics, the delivery is counted to the probe of the sending unit.
+                stats.on_spike_received(unit, thread_index);
+                ++num_events;
+            }
         }
+        num_synaptic_events.fetch_add(num_events, std::memory_order_relaxed);
+    });
+
+    if (event_driven)
+    {
+        active_units.clear();
+        for (natural_32_bit  task_index = 0U; task_index != num_tasks; ++task_index)
+            active_units.insert(active_units.end(), task_outputs[task_index].begin(), task_outputs[task_index].end());
     }
 }
 
@@ -212,14 +518,21 @@ void  network::discharge_spiking_units()
 {
     TMPROF_BLOCK();
 
-    // NOTE: If we have K processors/cores, then we could split spiking_units to K intervals and
-    //       process each interval in a separate thread.
-    for (uid  id : spiking_units)
-    {
-        network_layer&  layer = layers.at(id.layer);
-        computation_unit&  unit = layer.units.at(id.unit);
-        unit.charge = id.layer < NUM_INPUT_LAYERS ? layer.CHARGE_RECOVERY : layer.CHARGE_RECOVERY / layer.CHARGE_DECAY_COEF;
-    }
+    natural_32_bit const  num_tasks = get_num_tasks((natural_32_bit)spiking_units.size(), NUM_SPIKING_UNITS_PER_TASK);
+    workers->run(num_tasks, [this](natural_32_bit const  task_index, natural_32_bit) {
+        for (natural_32_bit  k = task_index * NUM_SPIKING_UNITS_PER_TASK,
+                            end = std::min(k + NUM_SPIKING_UNITS_PER_TASK, (natural_32_bit)spiking_units.size());
+             k < end; ++k)
+        {
+            natural_32_bit const  unit = spiking_units[k];
+            natural_8_bit const  layer_index = unit_layers[unit];
+            network_layer const&  layer = layers[layer_index];
+            charges[unit] = layer_index < NUM_INPUT_LAYERS ? layer.CHARGE_RECOVERY : layer.CHARGE_RECOVERY / layer.CHARGE_DECAY_COEF;
+            charge_rounds[unit] = num_charge_updates;
+            // Spikes received by a discharged unit in this round are lost.
+            received_spikes[unit].store(0, std::memory_order_relaxed);
+        }
+    });
 }
 
 
@@ -227,30 +540,98 @@ void  network::update_charge_of_units()
 {
     TMPROF_BLOCK();
 
-    spiking_units.clear();
-    spiking_output_units.clear();
-    for (natural_8_bit  i = NUM_INPUT_LAYERS, n = (natural_8_bit)layers.size(); i != n; ++i)
+    // Ranges of units are processed in parallel, each into its own list of spiking units. The lists are
+    // then concatenated in the order of the ranges, so spiking units are always sorted by their indices.
+    natural_32_bit  num_tasks;
+    if (event_driven)
     {
-        // NOTE: Code in this block can run in a thread.
+        // Only units which received a spike or were discharged in this round can reach CHARGE_SPIKE; charges of
+        // all other units only decay, which is postponed until they are read or updated again.
+        for (natural_32_bit  unit : spiking_units)
+            if (unit_layers[unit] >= NUM_INPUT_LAYERS)
+                active_units.push_back(unit);
+        std::sort(active_units.begin(), active_units.end());
+        active_units.erase(std::unique(active_units.begin(), active_units.end()), active_units.end());
+
+        num_tasks = get_num_tasks((natural_32_bit)active_units.size(), NUM_SPIKING_UNITS_PER_TASK);
+        task_outputs.resize(std::max(num_tasks, (natural_32_bit)task_outputs.size()));
+        workers->run(num_tasks, [this](natural_32_bit const  task_index, natural_32_bit) {
+            std::vector<natural_32_bit>&  task_spiking_units = task_outputs[task_index];
+            task_spiking_units.clear();
+            for (natural_32_bit  k = task_index * NUM_SPIKING_UNITS_PER_TASK,
+                                end = std::min(k + NUM_SPIKING_UNITS_PER_TASK, (natural_32_bit)active_units.size());
+                 k < end; ++k)
+            {
+                natural_32_bit const  unit = active_units[k];
+                network_layer const&  layer = layers[unit_layers[unit]];
+                integer_32_bit const  num_spikes = received_spikes[unit].load(std::memory_order_relaxed);
+                received_spikes[unit].store(0, std::memory_order_relaxed);
+                float_32_bit const  input_charge = (float_32_bit)num_spikes * layer.SPIKE_MAGNITUDE;
+                float_32_bit  charge = decay_charge(charges[unit], layer, num_charge_updates - charge_rounds[unit]);
+                charge = update_charge(charge, input_charge, layer.CHARGE_DECAY_COEF, layer.CHARGE_SPIKE);
+                charges[unit] = charge;
+                charge_rounds[unit] = num_charge_updates + 1U;
+                if (charge == layer.CHARGE_SPIKE)
+                    task_spiking_units.push_back(unit);
+            }
+        });
+        active_units.clear();
+    }
+    else
+    {
+        num_tasks = (natural_32_bit)charge_update_tasks.size();
+        task_outputs.resize(std::max(num_tasks, (natural_32_bit)task_outputs.size()));
+        workers->run(num_tasks, [this](natural_32_bit const  task_index, natural_32_bit) {
+            std::vector<natural_32_bit>&  task_spiking_units = task_outputs[task_index];
+            task_spiking_units.clear();
+
+            uid const  task = charge_update_tasks[task_index];
+            network_layer const&  layer = layers[task.layer];
+            float_32_bit  input_charges[NUM_UNITS_PER_BLOCK];
+            for (natural_32_bit  block = layer.first_unit + task.unit,
+                                end = layer.first_unit + std::min(task.unit + NUM_UNITS_PER_TASK, layer.num_units);
+                 block < end; block += NUM_UNITS_PER_BLOCK)
+            {
+                natural_32_bit const  num_units = std::min(NUM_UNITS_PER_BLOCK, end - block);
+
+                // Atomic counters cannot be processed by vector instructions, so they are converted first. There are no
+                // concurrent writes to the counters in this phase, so relaxed loads and stores (plain moves) suffice.
+                for (natural_32_bit  i = 0U; i < num_units; ++i)
+                {
+                    integer_32_bit const  num_spikes = received_spikes[block + i].load(std::memory_order_relaxed);
+                    if (num_spikes != 0)
+                        received_spikes[block + i].store(0, std::memory_order_relaxed);
+                    input_charges[i] = (float_32_bit)num_spikes * layer.SPIKE_MAGNITUDE;
+                }
+
+                natural_64_bit  spike_mask = update_charges_block(&charges[block], input_charges, num_units, layer);
+                if (spike_mask == 0ULL)
+                    continue;
+
+                // Compression of the mask to indices of spiking units.
+                std::size_t  k = task_spiking_units.size();
+                task_spiking_units.resize(k + count_one_bits(spike_mask));
+                for ( ; spike_mask != 0ULL; spike_mask &= spike_mask - 1ULL)
+                    task_spiking_units[k++] = block + index_of_lowest_one_bit(spike_mask);
+            }
+        });
+    }
+    ++num_charge_updates;
 
-        network_layer&  layer = layers.at(i);
-        for (natural_16_bit j = 0U, m = (natural_16_bit)layer.units.size(); j != m; ++j)
+    spiking_units.clear();
+    spiking_output_units.clear();
+    natural_32_bit const  first_output_layer = (natural_32_bit)layers.size() - NUM_OUTPUT_LAYERS;
+    for (natural_32_bit  task_index = 0U; task_index != num_tasks; ++task_index)
+        for (natural_32_bit  unit : task_outputs[task_index])
         {
-            computation_unit&  unit = layer.units.at(j);
-            unit.charge = std::min(unit.charge * layer.CHARGE_DECAY_COEF, layer.CHARGE_SPIKE);
-            if (unit.charge == layer.CHARGE_SPIKE)
-            {
-                uid const  id{ i, j, 0U };
+            uid const  id = unit_uid(unit);
 
-                stats.on_spike_produced(id);
+            stats.on_spike_produced(unit, 0U);
 
-                std::lock_guard<std::mutex> lock(spiking_mutex);
-                spiking_units.push_back(id);
-                if (i >= n - NUM_OUTPUT_LAYERS)
-                    spiking_output_units.push_back(id);
-            }
+            spiking_units.push_back(unit);
+            if (id.layer >= first_output_layer)
+                spiking_output_units.push_back(id);
         }
-    }
 }
 
 
@@ -260,75 +641,129 @@ void  network::connect_open_sockets()
 
     INVARIANT(open_inputs.size() == open_outputs.size());
 
-    for (natural_32_bit  o_idx = 0U; o_idx < (natural_32_bit)open_outputs.size(); )
-    {
-        natural_32_bit const  i_idx =
-                get_random_natural_32_bit_in_range(0U, (natural_32_bit)open_inputs.size() - 1U, random_generator);
+    natural_32_bit const  num_open = (natural_32_bit)open_inputs.size();
+    if (num_open == 0U)
+        return;
 
-        if (!connect(i_idx, o_idx))
-            ++o_idx;
-    }
+    // All random numbers of the rewiring come from counter-based streams of this key, so the result depends only
+    // on the seed of the network (and not on the number of threads).
+    natural_64_bit const  stream_key = ((natural_64_bit)random_generator() << 32U) ^ (natural_64_bit)random_generator();
+
+    shuffle_open_inputs(stream_key);
+
+    // Self-pairs (an input and an output of the same unit) are fixed locally by an exchange of inputs with the next
+    // pair, if that does not create another self-pair. Pairs which cannot be fixed stay open for the next round.
+    for (natural_32_bit  k = 0U; k < num_open; ++k)
+        if (open_inputs[k] == open_outputs[k])
+        {
+            natural_32_bit const  j = k + 1U < num_open ? k + 1U : 0U;
+            if (open_inputs[j] != open_outputs[k] && open_inputs[k] != open_outputs[j])
+                std::swap(open_inputs[k], open_inputs[j]);
+        }
+
+    natural_32_bit  num_still_open = 0U;
+    for (natural_32_bit  k = 0U; k < num_open; ++k)
+        if (open_inputs[k] != open_outputs[k])
+            connect(open_inputs[k], open_outputs[k]);
+        else
+        {
+            open_inputs[num_still_open] = open_inputs[k];
+            open_outputs[num_still_open] = open_outputs[k];
+            ++num_still_open;
+        }
+    open_inputs.resize(num_still_open);
+    open_outputs.resize(num_still_open);
 }
 
 
-bool  network::connect(natural_32_bit const  input_idx, natural_32_bit const  output_idx)
+void  network::shuffle_open_inputs(natural_64_bit const  stream_key)
 {
     TMPROF_BLOCK();
 
-    uid&  iid = open_inputs.at(input_idx);
-    uid&  oid = open_outputs.at(output_idx);
-    if (iid.layer == oid.layer && iid.unit == oid.unit)
-        return false;
+    // A parallel Fisher-Yates shuffle (Rao-Sandelius): items are scattered to random buckets, which are then shuffled
+    // independently. Items are processed by tasks of NUM_SOCKETS_PER_SHUFFLE_BUCKET items and there is one bucket
+    // per task. The random numbers of an item are indexed by its position, so tasks can run in any order.
 
-    network_layer&  input_layer = layers.at(iid.layer);
-    std::vector<input_socket>&  inputs = input_layer.units.at(iid.unit).inputs;
-    network_layer&  output_layer = layers.at(oid.layer);
-    std::vector<output_socket>&  outputs = output_layer.units.at(oid.unit).outputs;
+    natural_32_bit const  num_items = (natural_32_bit)open_inputs.size();
+    natural_32_bit const  num_tasks = get_num_tasks(num_items, NUM_SOCKETS_PER_SHUFFLE_BUCKET);
+    natural_32_bit const  num_buckets = num_tasks;
 
-    iid.socket = inputs.size();
-    oid.socket = outputs.size();
+    auto const  shuffle = [stream_key](natural_32_bit* const  items, natural_32_bit const  size, natural_64_bit const  counter) {
+        for (natural_32_bit  i = size; i > 1U; --i)
+            std::swap(items[i - 1U], items[get_counter_based_random_natural_32_bit_below(stream_key, counter + i, i)]);
+    };
 
-    inputs.push_back({ oid, 0.5f * (input_layer.WEIGHT_CONNECTION + output_layer.WEIGHT_CONNECTION)});
-    outputs.push_back({ iid });
+    if (num_buckets == 1U)
+    {
+        shuffle(open_inputs.data(), num_items, num_items);
+        return;
+    }
 
-    iid = open_inputs.back();
-    open_inputs.pop_back();
+    auto const  bucket_of = [stream_key, num_buckets](natural_32_bit const  item_index) {
+        return get_counter_based_random_natural_32_bit_below(stream_key, item_index, num_buckets);
+    };
+
+    // Counts of items of each task in each bucket, stored bucket-major.
+    shuffle_offsets.assign(num_buckets * num_tasks, 0U);
+    workers->run(num_tasks, [this, num_items, num_tasks, &bucket_of](natural_32_bit const  task_index, natural_32_bit) {
+        natural_32_bit const  end = std::min(num_items, (task_index + 1U) * NUM_SOCKETS_PER_SHUFFLE_BUCKET);
+        for (natural_32_bit  i = task_index * NUM_SOCKETS_PER_SHUFFLE_BUCKET; i < end; ++i)
+            ++shuffle_offsets[bucket_of(i) * num_tasks + task_index];
+    });
+    // The exclusive prefix sum turns the counts into the first indices of the items of the tasks in 'shuffled_inputs'.
+    natural_32_bit  offset = 0U;
+    for (natural_32_bit&  count_or_offset : shuffle_offsets)
+    {
+        natural_32_bit const  count = count_or_offset;
+        count_or_offset = offset;
+        offset += count;
+    }
 
-    oid = open_outputs.back();
-    open_outputs.pop_back();
+    shuffled_inputs.resize(num_items);
+    workers->run(num_tasks, [this, num_items, num_tasks, &bucket_of](natural_32_bit const  task_index, natural_32_bit) {
+        natural_32_bit const  end = std::min(num_items, (task_index + 1U) * NUM_SOCKETS_PER_SHUFFLE_BUCKET);
+        for (natural_32_bit  i = task_index * NUM_SOCKETS_PER_SHUFFLE_BUCKET; i < end; ++i)
+            shuffled_inputs[shuffle_offsets[bucket_of(i) * num_tasks + task_index]++] = open_inputs[i];
+    });
+
+    // Now the offset of the last task of a bucket is the end of the bucket.
+    workers->run(num_buckets, [this, num_items, num_tasks, &shuffle](natural_32_bit const  bucket, natural_32_bit) {
+        natural_32_bit const  begin = bucket == 0U ? 0U : shuffle_offsets[bucket * num_tasks - 1U];
+        natural_32_bit const  end = shuffle_offsets[(bucket + 1U) * num_tasks - 1U];
+        shuffle(shuffled_inputs.data() + begin, end - begin, (natural_64_bit)num_items + begin);
+    });
+
+    open_inputs.swap(shuffled_inputs);
+}
 
-    stats.on_connect(iid, oid);
 
-    return true;
+void  network::connect(natural_32_bit const  input_unit, natural_32_bit const  output_unit)
+{
+    float_32_bit const  weight =
+            0.5f * (layers[unit_layers[input_unit]].WEIGHT_CONNECTION + layers[unit_layers[output_unit]].WEIGHT_CONNECTION);
+    sockets.connect(input_unit, output_unit, weight);
+    ++num_connections;
+
+    stats.on_connect(input_unit, output_unit, 0U);
 }
 
 
-void  network::disconnect(
-        std::vector<input_socket>&  inputs,
-        uid const  input_socket_id,
-        std::vector<output_socket>&  outputs,
-        uid const  output_socket_id
-        )
+void  network::disconnect(natural_32_bit const  input_slot)
 {
     TMPROF_BLOCK();
 
-    stats.on_disconnect(inputs, input_socket_id, outputs, output_socket_id);
-
-    uid const  oid = inputs.back().other;
-    layers.at(oid.layer).units.at(oid.unit).outputs.at(oid.socket).other.socket = input_socket_id.socket;
-
-    uid const  iid = outputs.back().other;
-    layers.at(iid.layer).units.at(iid.unit).inputs.at(iid.socket).other.socket = output_socket_id.socket;
+    natural_32_bit const  output_unit = sockets.input_sources.at(input_slot);
+    natural_32_bit const  input_unit = sockets.output_targets.at(
+            sockets.outputs_begin(output_unit) + sockets.input_source_sockets.at(input_slot)
+            );
 
-    inputs.at(input_socket_id.socket) = inputs.back();
-    inputs.pop_back();
+    stats.on_disconnect(input_unit, output_unit, 0U);
 
-    outputs.at(output_socket_id.socket) = outputs.back();
-    outputs.pop_back();
+    sockets.disconnect(input_slot);
+    ++num_disconnections;
 
-    std::lock_guard<std::mutex> lock(open_io_mutex);
-    open_inputs.push_back(uid::as_unit(input_socket_id));
-    open_outputs.push_back(uid::as_unit(output_socket_id));
+    open_inputs.push_back(input_unit);
+    open_outputs.push_back(output_unit);
 }
 
 
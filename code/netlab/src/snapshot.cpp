@@ -0,0 +1,401 @@
+#include <netlab/snapshot.hpp>
+#include <utility/mapped_file.hpp>
+#include <utility/random.hpp>
+#include <utility/assumptions.hpp>
+#include <utility/invariants.hpp>
+#include <utility/timeprof.hpp>
+#include <utility/msgstream.hpp>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace netlab { namespace {
+
+
+natural_32_bit const  SNAPSHOT_VERSION = 1U;
+natural_32_bit const  SNAPSHOT_HEADER_SIZE = 64U;
+
+
+struct  snapshot_header
+{
+    natural_64_bit  tag;
+    natural_32_bit  num_layers;
+    natural_8_bit  num_input_layers;
+    natural_8_bit  num_output_layers;
+    natural_32_bit  num_units;
+    natural_32_bit  num_slots;
+    natural_32_bit  num_input_tombstones;
+    natural_32_bit  num_output_tombstones;
+    natural_32_bit  random_generator_state;
+    natural_32_bit  num_open_sockets;
+    natural_32_bit  num_spiking_units;
+};
+
+
+// Offsets of sections of a snapshot file from its start.
+struct  snapshot_layout
+{
+    natural_64_bit  layers;
+    natural_64_bit  charges;
+    natural_64_bit  unit_layers;
+    natural_64_bit  slots_begin;
+    natural_64_bit  num_used_inputs;
+    natural_64_bit  num_used_outputs;
+    natural_64_bit  input_sources;
+    natural_64_bit  input_source_sockets;
+    natural_64_bit  input_weights;
+    natural_64_bit  output_targets;
+    natural_64_bit  output_target_sockets;
+    natural_64_bit  open_inputs;
+    natural_64_bit  open_outputs;
+    natural_64_bit  spiking_units;
+    natural_64_bit  end;                // The size of the file.
+};
+
+
+snapshot_layout  compute_layout(snapshot_header const&  header)
+{
+    natural_64_bit  offset = SNAPSHOT_HEADER_SIZE;
+    auto const  section = [&offset](natural_64_bit const  num_elements, natural_64_bit const  element_size) {
+        natural_64_bit const  begin = offset;
+        offset = (offset + num_elements * element_size + 7ULL) & ~7ULL;
+        return begin;
+    };
+
+    using  socket_index_type = synapses::socket_index_type;
+
+    snapshot_layout  layout;
+    layout.layers = section(header.num_layers, sizeof(network_layer));
+    layout.charges = section(header.num_units, sizeof(float_32_bit));
+    layout.unit_layers = section(header.num_units, sizeof(natural_8_bit));
+    layout.slots_begin = section(header.num_units + 1ULL, sizeof(natural_32_bit));
+    layout.num_used_inputs = section(header.num_units, sizeof(socket_index_type));
+    layout.num_used_outputs = section(header.num_units, sizeof(socket_index_type));
+    layout.input_sources = section(header.num_slots, sizeof(natural_32_bit));
+    layout.input_source_sockets = section(header.num_slots, sizeof(socket_index_type));
+    layout.input_weights = section(header.num_slots, sizeof(float_32_bit));
+    layout.output_targets = section(header.num_slots, sizeof(natural_32_bit));
+    layout.output_target_sockets = section(header.num_slots, sizeof(socket_index_type));
+    layout.open_inputs = section(header.num_open_sockets, sizeof(natural_32_bit));
+    layout.open_outputs = section(header.num_open_sockets, sizeof(natural_32_bit));
+    layout.spiking_units = section(header.num_spiking_units, sizeof(natural_32_bit));
+    layout.end = offset;
+    return layout;
+}
+
+
+template<typename T>
+T  read_binary_value(natural_8_bit const*  data, natural_64_bit const  offset)
+{
+    T  value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+
+template<typename T>
+void  write_binary_value(natural_8_bit* const  data, natural_64_bit const  offset, T const  value)
+{
+    std::memcpy(data + offset, &value, sizeof(T));
+}
+
+
+void  encode_header(snapshot_header const&  header, natural_8_bit* const  data)
+{
+    std::memset(data, 0, SNAPSHOT_HEADER_SIZE);
+    std::memcpy(data, "E2NL", 4U);
+    write_binary_value<natural_32_bit>(data, 4U, SNAPSHOT_VERSION);
+    write_binary_value<natural_8_bit>(data, 8U, uid::NUM_LAYER_BITS);
+    write_binary_value<natural_8_bit>(data, 9U, uid::NUM_UNIT_BITS);
+    write_binary_value<natural_8_bit>(data, 10U, uid::NUM_SOCKET_BITS);
+    write_binary_value<natural_8_bit>(data, 11U, (natural_8_bit)sizeof(uid::socket_index_type));
+    write_binary_value<natural_32_bit>(data, 12U, (natural_32_bit)sizeof(network_layer));
+    write_binary_value<natural_64_bit>(data, 16U, header.tag);
+    write_binary_value<natural_32_bit>(data, 24U, header.num_layers);
+    write_binary_value<natural_8_bit>(data, 28U, header.num_input_layers);
+    write_binary_value<natural_8_bit>(data, 29U, header.num_output_layers);
+    write_binary_value<natural_32_bit>(data, 32U, header.num_units);
+    write_binary_value<natural_32_bit>(data, 36U, header.num_slots);
+    write_binary_value<natural_32_bit>(data, 40U, header.num_input_tombstones);
+    write_binary_value<natural_32_bit>(data, 44U, header.num_output_tombstones);
+    write_binary_value<natural_32_bit>(data, 48U, header.random_generator_state);
+    write_binary_value<natural_32_bit>(data, 52U, header.num_open_sockets);
+    write_binary_value<natural_32_bit>(data, 56U, header.num_spiking_units);
+}
+
+
+// Returns nullptr on success, or the description of the error otherwise.
+char const*  decode_header(natural_8_bit const* const  data, natural_64_bit const  size, snapshot_header&  header)
+{
+    if (size < SNAPSHOT_HEADER_SIZE || std::memcmp(data, "E2NL", 4U) != 0)
+        return "it is not a netlab snapshot";
+    if (read_binary_value<natural_32_bit>(data, 4U) != SNAPSHOT_VERSION)
+        return "unsupported version of the snapshot";
+    if (read_binary_value<natural_8_bit>(data, 8U) != uid::NUM_LAYER_BITS ||
+        read_binary_value<natural_8_bit>(data, 9U) != uid::NUM_UNIT_BITS ||
+        read_binary_value<natural_8_bit>(data, 10U) != uid::NUM_SOCKET_BITS ||
+        read_binary_value<natural_8_bit>(data, 11U) != sizeof(uid::socket_index_type) ||
+        read_binary_value<natural_32_bit>(data, 12U) != sizeof(network_layer))
+        return "the snapshot was saved with a different type of network ids (see NETLAB_WIDE_UID)";
+    header.tag = read_binary_value<natural_64_bit>(data, 16U);
+    if (header.tag == 0ULL)
+        return "the save of the snapshot was interrupted";
+    header.num_layers = read_binary_value<natural_32_bit>(data, 24U);
+    header.num_input_layers = read_binary_value<natural_8_bit>(data, 28U);
+    header.num_output_layers = read_binary_value<natural_8_bit>(data, 29U);
+    header.num_units = read_binary_value<natural_32_bit>(data, 32U);
+    header.num_slots = read_binary_value<natural_32_bit>(data, 36U);
+    header.num_input_tombstones = read_binary_value<natural_32_bit>(data, 40U);
+    header.num_output_tombstones = read_binary_value<natural_32_bit>(data, 44U);
+    header.random_generator_state = read_binary_value<natural_32_bit>(data, 48U);
+    header.num_open_sockets = read_binary_value<natural_32_bit>(data, 52U);
+    header.num_spiking_units = read_binary_value<natural_32_bit>(data, 56U);
+    return nullptr;
+}
+
+
+template<typename T>
+void  write_section(std::ostream&  ostr, natural_64_bit const  offset, T const* const  data, natural_64_bit const  num_elements)
+{
+    ostr.seekp((std::streamoff)offset);
+    ostr.write((char const*)data, (std::streamsize)(num_elements * sizeof(T)));
+}
+
+
+template<typename T>
+void  read_section(natural_8_bit const* const  data, natural_64_bit const  offset, std::vector<T>&  elements, natural_64_bit const  num_elements)
+{
+    elements.resize(num_elements);
+    std::memcpy(elements.data(), data + offset, num_elements * sizeof(T));
+}
+
+
+}}
+
+namespace netlab {
+
+
+void  save_snapshot(network&  net, std::filesystem::path const&  pathname)
+{
+    TMPROF_BLOCK();
+
+    synapses&  sockets = net.sockets;
+
+    snapshot_header  header;
+    header.num_layers = (natural_32_bit)net.layers.size();
+    header.num_input_layers = net.NUM_INPUT_LAYERS;
+    header.num_output_layers = net.NUM_OUTPUT_LAYERS;
+    header.num_units = (natural_32_bit)net.charges.size();
+    header.num_slots = sockets.num_slots();
+    header.num_input_tombstones = sockets.num_input_tombstones;
+    header.num_output_tombstones = sockets.num_output_tombstones;
+    {
+        std::stringstream  sstr;
+        sstr << net.random_generator;
+        sstr >> header.random_generator_state;
+    }
+    header.num_open_sockets = (natural_32_bit)net.open_inputs.size();
+    header.num_spiking_units = (natural_32_bit)net.spiking_units.size();
+
+    snapshot_layout const  layout = compute_layout(header);
+
+    // Blocks of slots can be written incrementally only to the file written or read last time and only when
+    // sizes of the sections did not change.
+    bool  incremental = false;
+    if (net.snapshot_tag != 0ULL && std::filesystem::is_regular_file(pathname))
+    {
+        std::ifstream  istr(pathname, std::ios_base::binary);
+        natural_8_bit  data[SNAPSHOT_HEADER_SIZE];
+        snapshot_header  old_header;
+        incremental = istr.read((char*)data, SNAPSHOT_HEADER_SIZE).good() &&
+                      decode_header(data, SNAPSHOT_HEADER_SIZE, old_header) == nullptr &&
+                      old_header.tag == net.snapshot_tag &&
+                      old_header.num_layers == header.num_layers &&
+                      old_header.num_units == header.num_units &&
+                      old_header.num_slots == header.num_slots;
+    }
+
+    // The tag changes with each save, so that no other network (e.g. loaded from the same file before) can
+    // update the file incrementally.
+    header.tag = get_counter_based_random_natural_64_bit(
+                        (natural_64_bit)std::chrono::steady_clock::now().time_since_epoch().count(),
+                        net.snapshot_tag
+                        ) | 1ULL;
+
+    // A full save goes to a temporary file, which then replaces the old snapshot. So, the old snapshot is kept
+    // whole, when the save fails (e.g. the disk is full). An incremental save must update the file in place. So,
+    // it first writes the header with the tag 0 (rejected by the load) and the header with the new tag last.
+    // Then an interrupted save leaves a file, which is rejected, instead of a mix of the old and new content.
+    std::filesystem::path  written_pathname = pathname;
+    if (!incremental)
+        written_pathname += ".tmp";
+    {
+        std::fstream  ostr(written_pathname, incremental ? std::ios_base::in | std::ios_base::out | std::ios_base::binary :
+                                                           std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+        if (!ostr.good())
+            throw std::runtime_error(msgstream() << "Cannot open the snapshot file '" << written_pathname << "' for writing.");
+
+        natural_8_bit  header_data[SNAPSHOT_HEADER_SIZE];
+        encode_header(header, header_data);
+        write_binary_value<natural_64_bit>(header_data, 16U, 0ULL);
+        write_section(ostr, 0ULL, header_data, SNAPSHOT_HEADER_SIZE);
+        ostr.flush();
+
+        write_section(ostr, layout.layers, net.layers.data(), header.num_layers);
+        if (net.is_event_driven())
+        {
+            std::vector<float_32_bit>  charges(header.num_units);
+            for (natural_32_bit  unit = 0U; unit != header.num_units; ++unit)
+                charges[unit] = net.current_charge(unit);
+            write_section(ostr, layout.charges, charges.data(), header.num_units);
+        }
+        else
+            write_section(ostr, layout.charges, net.charges.data(), header.num_units);
+        write_section(ostr, layout.unit_layers, net.unit_layers.data(), header.num_units);
+        write_section(ostr, layout.slots_begin, sockets.slots_begin.data(), header.num_units + 1ULL);
+        write_section(ostr, layout.num_used_inputs, sockets.num_used_inputs.data(), header.num_units);
+        write_section(ostr, layout.num_used_outputs, sockets.num_used_outputs.data(), header.num_units);
+
+        // Runs of consecutive modified blocks are written at once.
+        for (natural_32_bit  block = 0U, num_blocks = sockets.num_blocks(); block < num_blocks; )
+        {
+            if (incremental && !sockets.is_block_modified(block))
+            {
+                ++block;
+                continue;
+            }
+            natural_32_bit  end_block = block + 1U;
+            while (end_block < num_blocks && (!incremental || sockets.is_block_modified(end_block)))
+                ++end_block;
+
+            natural_32_bit const  begin = block * synapses::NUM_SLOTS_PER_BLOCK;
+            natural_32_bit const  end = std::min(end_block * synapses::NUM_SLOTS_PER_BLOCK, header.num_slots);
+            natural_32_bit const  count = end - begin;
+            write_section(ostr, layout.input_sources + begin * sizeof(natural_32_bit), sockets.input_sources.data() + begin, count);
+            write_section(ostr, layout.input_source_sockets + begin * sizeof(synapses::socket_index_type),
+                          sockets.input_source_sockets.data() + begin, count);
+            write_section(ostr, layout.input_weights + begin * sizeof(float_32_bit), sockets.input_weights.data() + begin, count);
+            write_section(ostr, layout.output_targets + begin * sizeof(natural_32_bit), sockets.output_targets.data() + begin, count);
+            write_section(ostr, layout.output_target_sockets + begin * sizeof(synapses::socket_index_type),
+                          sockets.output_target_sockets.data() + begin, count);
+
+            block = end_block;
+        }
+
+        write_section(ostr, layout.open_inputs, net.open_inputs.data(), header.num_open_sockets);
+        write_section(ostr, layout.open_outputs, net.open_outputs.data(), header.num_open_sockets);
+        write_section(ostr, layout.spiking_units, net.spiking_units.data(), header.num_spiking_units);
+
+        // Padding of the last section.
+        ostr.seekp((std::streamoff)(layout.end - 1ULL));
+        ostr.put(0);
+        ostr.flush();
+
+        if (ostr.good())
+        {
+            encode_header(header, header_data);
+            write_section(ostr, 0ULL, header_data, SNAPSHOT_HEADER_SIZE);
+            ostr.flush();
+        }
+        if (!ostr.good())
+        {
+            ostr.close();
+            if (!incremental)
+            {
+                std::error_code  ignored;
+                std::filesystem::remove(written_pathname, ignored);
+            }
+            throw std::runtime_error(msgstream() << "Cannot write the snapshot file '" << written_pathname << "'.");
+        }
+    }
+    // Bytes after the end of the layout are ignored by the load, so the file is shrunk after the header is written.
+    if (incremental)
+        std::filesystem::resize_file(pathname, layout.end);
+    else
+        std::filesystem::rename(written_pathname, pathname);
+
+    sockets.reset_modified_blocks(false);
+    net.snapshot_tag = header.tag;
+}
+
+
+void  load_snapshot(network&  net, std::filesystem::path const&  pathname)
+{
+    TMPROF_BLOCK();
+
+    mapped_file const  file(pathname);
+    natural_8_bit const* const  data = file.data();
+
+    snapshot_header  header;
+    if (char const* const  error = decode_header(data, file.size(), header))
+        throw std::runtime_error(msgstream() << "Cannot load the snapshot file '" << pathname << "': " << error << ".");
+    snapshot_layout const  layout = compute_layout(header);
+    if (layout.end > file.size())
+        throw std::runtime_error(msgstream() << "The snapshot file '" << pathname << "' is truncated.");
+    if (header.num_layers == 0U || header.num_layers > uid::MAX_NUM_LAYERS ||
+        (natural_32_bit)header.num_input_layers + header.num_output_layers > header.num_layers)
+        throw std::runtime_error(msgstream() << "Wrong counts of layers in the snapshot file '" << pathname << "'.");
+
+    // The layout is validated from the mapped data before the network is touched, so a rejected file leaves
+    // the network intact. Only consistency of the layout is checked; the content of slots is trusted.
+    std::vector<network_layer>  layers;
+    read_section(data, layout.layers, layers, header.num_layers);
+    natural_32_bit  num_units = 0U;
+    for (network_layer const&  layer : layers)
+    {
+        if (layer.first_unit != num_units || layer.num_units == 0U || layer.num_units > uid::MAX_NUM_UNITS_PER_LAYER)
+            throw std::runtime_error(msgstream() << "Wrong ranges of units of layers in the snapshot file '" << pathname << "'.");
+        num_units += layer.num_units;
+    }
+    if (num_units != header.num_units ||
+        read_binary_value<natural_32_bit>(data, layout.slots_begin) != 0U ||
+        read_binary_value<natural_32_bit>(data, layout.slots_begin + header.num_units * sizeof(natural_32_bit)) != header.num_slots)
+        throw std::runtime_error(msgstream() << "Wrong counts of units or slots in the snapshot file '" << pathname << "'.");
+    for (natural_32_bit  i = 0U; i != header.num_spiking_units; ++i)
+        if (read_binary_value<natural_32_bit>(data, layout.spiking_units + i * sizeof(natural_32_bit)) >= header.num_units)
+            throw std::runtime_error(msgstream() << "Wrong spiking units in the snapshot file '" << pathname << "'.");
+
+    synapses&  sockets = net.sockets;
+
+    net.NUM_INPUT_LAYERS = header.num_input_layers;
+    net.NUM_OUTPUT_LAYERS = header.num_output_layers;
+    net.layers.swap(layers);
+    read_section(data, layout.charges, net.charges, header.num_units);
+    read_section(data, layout.unit_layers, net.unit_layers, header.num_units);
+
+    sockets.clear();
+    read_section(data, layout.slots_begin, sockets.slots_begin, header.num_units + 1ULL);
+    read_section(data, layout.num_used_inputs, sockets.num_used_inputs, header.num_units);
+    read_section(data, layout.num_used_outputs, sockets.num_used_outputs, header.num_units);
+    read_section(data, layout.input_sources, sockets.input_sources, header.num_slots);
+    read_section(data, layout.input_source_sockets, sockets.input_source_sockets, header.num_slots);
+    read_section(data, layout.input_weights, sockets.input_weights, header.num_slots);
+    read_section(data, layout.output_targets, sockets.output_targets, header.num_slots);
+    read_section(data, layout.output_target_sockets, sockets.output_target_sockets, header.num_slots);
+    sockets.num_input_tombstones = header.num_input_tombstones;
+    sockets.num_output_tombstones = header.num_output_tombstones;
+
+    read_section(data, layout.open_inputs, net.open_inputs, header.num_open_sockets);
+    read_section(data, layout.open_outputs, net.open_outputs, header.num_open_sockets);
+    read_section(data, layout.spiking_units, net.spiking_units, header.num_spiking_units);
+
+    natural_32_bit const  first_output_layer = header.num_layers - net.NUM_OUTPUT_LAYERS;
+    net.spiking_output_units.clear();
+    for (natural_32_bit  unit : net.spiking_units)
+        if (net.unit_layers[unit] >= first_output_layer)
+            net.spiking_output_units.push_back(net.unit_uid(unit));
+
+    reset(net.random_generator, header.random_generator_state);
+
+    net.stats.select_probes(net.layers, net.NUM_INPUT_LAYERS);
+    net.initialise_round_data();
+
+    sockets.reset_modified_blocks(false);
+    net.snapshot_tag = header.tag;
+}
+
+
+}
@@ -3,6 +3,30 @@
 #include <utility/invariants.hpp>
 #include <utility/timeprof.hpp>
 
+namespace netlab { namespace {
+
+
+void  add_probe(statistics::probe&  target, statistics::probe const&  source)
+{
+    target.num_spikes_received += source.num_spikes_received;
+    target.num_spikes_produced += source.num_spikes_produced;
+    target.num_connected_input_sockets += source.num_connected_input_sockets;
+    target.num_connected_output_sockets += source.num_connected_output_sockets;
+    target.num_disconnected_input_sockets += source.num_disconnected_input_sockets;
+    target.num_disconnected_output_sockets += source.num_disconnected_output_sockets;
+}
+
+
+void  add_overall(statistics::overall&  target, statistics::overall const&  source)
+{
+    target.num_spikes += source.num_spikes;
+    target.num_connected_sockets += source.num_connected_sockets;
+    target.num_disconnected_sockets += source.num_disconnected_sockets;
+}
+
+
+}}
+
 namespace netlab {
 
 
@@ -39,122 +63,132 @@ statistics::statistics(
 
     , num_passed_rounds(0U)
     , num_passed_rounds_in_current_snapshot(0U)
+    , probed_units()
+    , probe_indices()
+    , thread_counters(1U)
     , probes_history()
-    , overall_history({})
+    , overall_history()
 {
-    ASSUMPTION(RATIO_OF_PROBED_UNITS_PER_LAYER >= 0.0f);
-
-//    for (natural_8_bit  layer_idx = 0U; layer_idx < layers_configs.size(); ++layer_idx)
-//    {
-//        network_layer::config const&  layer_config = layers_configs.at(layer_idx);
-//
-//        natural_16_bit const  num_probes =
-//                (natural_16_bit)(layer_config.sign_and_geometry_info.num_units * cfg.RATIO_OF_PROBED_UNITS_PER_LAYER + 0.5f);
-//        if (num_probes == 0U)
-//            continue;
-//
-//        natural_16_bit const  stride = layer_config.sign_and_geometry_info.num_units / num_probes;
-//        for (natural_16_bit  unit_idx = 0U; unit_idx < layer_config.sign_and_geometry_info.num_units; unit_idx += stride)
-//            probes_history.insert({ {(natural_8_bit)(num_input_layers + layer_idx), unit_idx, 0U}, { {} } });
-//    }
+    ASSUMPTION(RATIO_OF_PROBED_UNITS_PER_LAYER >= 0.0f && RATIO_OF_PROBED_UNITS_PER_LAYER <= 1.0f);
+    overall_history.reserve(SNAPSHOTS_HISTORY_SIZE);
 }
 
 
-void  statistics::on_next_round()
+void  statistics::select_probes(std::vector<network_layer> const&  layers, natural_32_bit const  num_input_layers)
 {
     TMPROF_BLOCK();
 
-    if (!enabled())
-        return;
-
-    ++num_passed_rounds;
-
-    ++num_passed_rounds_in_current_snapshot;
-    if (num_passed_rounds_in_current_snapshot != NUM_ROUNDS_PER_SNAPSHOT)
-        return;
-    num_passed_rounds_in_current_snapshot = 1U;
-
-    for (auto&  uid_and_probes : probes_history)
+    // Probes are first marked in 'probe_indices' and then indexed, so that 'probed_units' are sorted.
+    natural_32_bit const  NOT_PROBED = 0xffffffffU;
+    probed_units.clear();
+    probe_indices.clear();
+    if (enabled())
     {
-        uid_and_probes.second.push_front({});
-        while (uid_and_probes.second.size() > SNAPSHOTS_HISTORY_SIZE + 1U)
-            uid_and_probes.second.pop_back();
+        for (natural_32_bit  layer_idx = 0U; layer_idx != (natural_32_bit)layers.size(); ++layer_idx)
+        {
+            network_layer const&  layer = layers.at(layer_idx);
+            probe_indices.resize(layer.first_unit + layer.num_units, NOT_PROBED);
+            if (layer_idx < num_input_layers)
+                continue;
+
+            natural_32_bit const  num_probes = (natural_32_bit)(layer.num_units * RATIO_OF_PROBED_UNITS_PER_LAYER + 0.5f);
+            if (num_probes == 0U)
+                continue;
+
+            // Exactly 'num_probes' units evenly spread over the layer (a fixed stride would select up to
+            // 2 * num_probes - 1 units, when 'num_units' is not a multiple of 'num_probes').
+            for (natural_32_bit  k = 0U; k != num_probes; ++k)
+            {
+                natural_32_bit const  unit_idx =
+                        (natural_32_bit)(((natural_64_bit)k * (natural_64_bit)layer.num_units) / num_probes);
+                probe_indices.at(layer.first_unit + unit_idx) = (natural_32_bit)probed_units.size();
+                probed_units.push_back({ layer_idx, unit_idx, 0U });
+            }
+        }
     }
-    overall_history.push_front({});
-    while (overall_history.size() > SNAPSHOTS_HISTORY_SIZE + 1U)
-        overall_history.pop_back();
+    for (natural_32_bit&  probe_index : probe_indices)
+        if (probe_index == NOT_PROBED)
+            probe_index = (natural_32_bit)probed_units.size();
+
+    for (counters&  thread : thread_counters)
+        thread = { std::vector<probe>(probed_units.size() + 1U), {} };
+    probes_history.assign(probed_units.size(), {});
+    for (ring_buffer<probe>&  history : probes_history)
+        history.reserve(SNAPSHOTS_HISTORY_SIZE);
+    overall_history.clear();
+    num_passed_rounds = 0U;
+    num_passed_rounds_in_current_snapshot = 0U;
 }
 
 
-void  statistics::on_spike_received(uid const  id)
+void  statistics::set_num_threads(natural_32_bit const  num_threads)
 {
-    TMPROF_BLOCK();
-
-    if (!enabled())
-        return;
-
-    auto const  it = probes_history.find(uid::as_unit(id));
-    if (it != probes_history.end())
-        ++it->second.front().num_spikes_received;
+    ASSUMPTION(num_threads > 0U);
+    // Counters of removed threads are merged to the first thread, so events of the current snapshot are not lost.
+    for (natural_32_bit  i = num_threads; i < (natural_32_bit)thread_counters.size(); ++i)
+    {
+        counters&  target = thread_counters.front();
+        counters const&  source = thread_counters.at(i);
+        for (natural_32_bit  j = 0U; j != (natural_32_bit)target.probes.size(); ++j)
+            add_probe(target.probes.at(j), source.probes.at(j));
+        add_overall(target.totals, source.totals);
+    }
+    thread_counters.resize(num_threads, { std::vector<probe>(probed_units.size() + 1U), {} });
 }
 
 
-void  statistics::on_spike_produced(uid const  id)
+void  statistics::on_next_round()
 {
     TMPROF_BLOCK();
 
     if (!enabled())
         return;
 
-    ++overall_history.front().num_spikes;
-
-    auto const  it = probes_history.find(uid::as_unit(id));
-    if (it != probes_history.end())
-        ++it->second.front().num_spikes_produced;
-}
-
-void  statistics::on_connect(uid const  iid, uid const  oid)
-{
-    TMPROF_BLOCK();
+    ++num_passed_rounds;
 
-    if (!enabled())
+    ++num_passed_rounds_in_current_snapshot;
+    if (num_passed_rounds_in_current_snapshot <= NUM_ROUNDS_PER_SNAPSHOT)
         return;
+    num_passed_rounds_in_current_snapshot = 1U;
 
-    ++overall_history.front().num_connected_sockets;
-
-    auto const  iit = probes_history.find(uid::as_unit(iid));
-    if (iit != probes_history.end())
-        ++iit->second.front().num_connected_input_sockets;
-
-    auto const  oit = probes_history.find(uid::as_unit(oid));
-    if (oit != probes_history.end())
-        ++oit->second.front().num_connected_output_sockets;
+    merge_counters_to_history();
 }
 
 
-void  statistics::on_disconnect(
-        std::vector<input_socket> const&  inputs,
-        uid const  input_socket_id,
-        std::vector<output_socket> const&  outputs,
-        uid const  output_socket_id
-        )
+void  statistics::merge_counters_to_history()
 {
     TMPROF_BLOCK();
 
-    if (!enabled())
-        return;
-
-    ++overall_history.front().num_disconnected_sockets;
-
-    uid const  iid = uid::as_unit(outputs.at(output_socket_id.socket).other);
-    auto const  iit = probes_history.find(iid);
-    if (iit != probes_history.end())
-        ++iit->second.front().num_disconnected_input_sockets;
+    overall  snapshot_overall;
+    for (counters&  thread : thread_counters)
+    {
+        add_overall(snapshot_overall, thread.totals);
+        thread.totals = {};
+        thread.probes.back() = {};
+    }
+    if (SNAPSHOTS_HISTORY_SIZE != 0U)
+    {
+        if (overall_history.size() == SNAPSHOTS_HISTORY_SIZE)
+            overall_history.pop_front();
+        overall_history.push_back(snapshot_overall);
+    }
 
-    uid const  oid = uid::as_unit(inputs.at(input_socket_id.socket).other);
-    auto const  oit = probes_history.find(oid);
-    if (oit != probes_history.end())
-        ++oit->second.front().num_disconnected_output_sockets;
+    for (natural_32_bit  i = 0U; i != (natural_32_bit)probed_units.size(); ++i)
+    {
+        probe  snapshot_probe;
+        for (counters&  thread : thread_counters)
+        {
+            add_probe(snapshot_probe, thread.probes[i]);
+            thread.probes[i] = {};
+        }
+        if (SNAPSHOTS_HISTORY_SIZE != 0U)
+        {
+            ring_buffer<probe>&  history = probes_history[i];
+            if (history.size() == SNAPSHOTS_HISTORY_SIZE)
+                history.pop_front();
+            history.push_back(snapshot_probe);
+        }
+    }
 }
 
 
@@ -0,0 +1,180 @@
+#include <netlab/synapses.hpp>
+#include <utility/assumptions.hpp>
+#include <utility/invariants.hpp>
+#include <utility/timeprof.hpp>
+
+namespace netlab {
+
+
+synapses::synapses()
+    : slots_begin(1U, 0U)
+    , num_used_inputs()
+    , num_used_outputs()
+    , input_sources()
+    , input_source_sockets()
+    , input_weights()
+    , output_targets()
+    , output_target_sockets()
+    , num_input_tombstones(0U)
+    , num_output_tombstones(0U)
+    , modified_blocks()
+{}
+
+
+void  synapses::clear()
+{
+    slots_begin.assign(1U, 0U);
+    num_used_inputs.clear();
+    num_used_outputs.clear();
+    input_sources.clear();
+    input_source_sockets.clear();
+    input_weights.clear();
+    output_targets.clear();
+    output_target_sockets.clear();
+    num_input_tombstones = 0U;
+    num_output_tombstones = 0U;
+    modified_blocks.reset();
+}
+
+
+void  synapses::reset_modified_blocks(bool const  state)
+{
+    natural_32_bit const  n = num_blocks();
+    modified_blocks.reset(new std::atomic<natural_8_bit>[n]);
+    for (natural_32_bit  i = 0U; i != n; ++i)
+        modified_blocks[i].store(state ? 1U : 0U, std::memory_order_relaxed);
+}
+
+
+natural_32_bit  synapses::push_back_unit(socket_index_type const  num_sockets)
+{
+    natural_32_bit const  unit = num_units();
+    // Unit and slot indices are 32-bit (whatever the uid is) and must never reach the TOMBSTONE.
+    ASSUMPTION(unit + 1U < TOMBSTONE && (natural_64_bit)slots_begin.back() + num_sockets < TOMBSTONE);
+    slots_begin.push_back(slots_begin.back() + num_sockets);
+    num_used_inputs.push_back(0U);
+    num_used_outputs.push_back(0U);
+    input_sources.resize(slots_begin.back(), TOMBSTONE);
+    input_source_sockets.resize(slots_begin.back(), 0U);
+    input_weights.resize(slots_begin.back(), 0.0f);
+    output_targets.resize(slots_begin.back(), TOMBSTONE);
+    output_target_sockets.resize(slots_begin.back(), 0U);
+    return unit;
+}
+
+
+natural_32_bit  synapses::connect(natural_32_bit const  input_unit, natural_32_bit const  output_unit, float_32_bit const  weight)
+{
+    if (num_used_inputs[input_unit] == num_sockets(input_unit))
+        compact_inputs(input_unit);
+    if (num_used_outputs[output_unit] == num_sockets(output_unit))
+        compact_outputs(output_unit);
+    ASSUMPTION(num_used_inputs[input_unit] < num_sockets(input_unit) && num_used_outputs[output_unit] < num_sockets(output_unit));
+
+    socket_index_type const  input_socket = num_used_inputs[input_unit]++;
+    socket_index_type const  output_socket = num_used_outputs[output_unit]++;
+    natural_32_bit const  input_slot = slots_begin[input_unit] + input_socket;
+    natural_32_bit const  output_slot = slots_begin[output_unit] + output_socket;
+
+    input_sources[input_slot] = output_unit;
+    input_source_sockets[input_slot] = output_socket;
+    input_weights[input_slot] = weight;
+    output_targets[output_slot] = input_unit;
+    output_target_sockets[output_slot] = input_socket;
+
+    set_modified(input_slot);
+    set_modified(output_slot);
+
+    return input_slot;
+}
+
+
+void  synapses::disconnect(natural_32_bit const  input_slot)
+{
+    ASSUMPTION(input_sources[input_slot] != TOMBSTONE);
+    natural_32_bit const  output_slot = slots_begin[input_sources[input_slot]] + input_source_sockets[input_slot];
+    INVARIANT(output_targets[output_slot] != TOMBSTONE);
+    input_sources[input_slot] = TOMBSTONE;
+    output_targets[output_slot] = TOMBSTONE;
+    set_modified(input_slot);
+    set_modified(output_slot);
+    ++num_input_tombstones;
+    ++num_output_tombstones;
+}
+
+
+void  synapses::compact()
+{
+    TMPROF_BLOCK();
+
+    for (natural_32_bit  unit = 0U, n = num_units(); unit != n; ++unit)
+    {
+        compact_inputs(unit);
+        compact_outputs(unit);
+    }
+    INVARIANT(num_input_tombstones == 0U && num_output_tombstones == 0U);
+}
+
+
+void  synapses::compact_inputs(natural_32_bit const  unit)
+{
+    natural_32_bit const  begin = inputs_begin(unit);
+    natural_32_bit  dst = begin;
+    for (natural_32_bit  src = begin, end = inputs_end(unit); src != end; ++src)
+    {
+        natural_32_bit const  source_unit = input_sources[src];
+        if (source_unit == TOMBSTONE)
+        {
+            --num_input_tombstones;
+            continue;
+        }
+        if (src != dst)
+        {
+            input_sources[dst] = source_unit;
+            input_source_sockets[dst] = input_source_sockets[src];
+            input_weights[dst] = input_weights[src];
+            natural_32_bit const  source_slot = slots_begin[source_unit] + input_source_sockets[src];
+            output_target_sockets[source_slot] = (socket_index_type)(dst - begin);
+            set_modified(source_slot);
+        }
+        ++dst;
+    }
+    if (dst != inputs_end(unit))
+        set_modified(begin, inputs_end(unit));
+    for (natural_32_bit  slot = dst, end = inputs_end(unit); slot != end; ++slot)
+        input_sources[slot] = TOMBSTONE;
+    num_used_inputs[unit] = (socket_index_type)(dst - begin);
+}
+
+
+void  synapses::compact_outputs(natural_32_bit const  unit)
+{
+    natural_32_bit const  begin = outputs_begin(unit);
+    natural_32_bit  dst = begin;
+    for (natural_32_bit  src = begin, end = outputs_end(unit); src != end; ++src)
+    {
+        natural_32_bit const  target_unit = output_targets[src];
+        if (target_unit == TOMBSTONE)
+        {
+            --num_output_tombstones;
+            continue;
+        }
+        if (src != dst)
+        {
+            output_targets[dst] = target_unit;
+            output_target_sockets[dst] = output_target_sockets[src];
+            natural_32_bit const  target_slot = slots_begin[target_unit] + output_target_sockets[src];
+            input_source_sockets[target_slot] = (socket_index_type)(dst - begin);
+            set_modified(target_slot);
+        }
+        ++dst;
+    }
+    if (dst != outputs_end(unit))
+        set_modified(begin, outputs_end(unit));
+    for (natural_32_bit  slot = dst, end = outputs_end(unit); slot != end; ++slot)
+        output_targets[slot] = TOMBSTONE;
+    num_used_outputs[unit] = (socket_index_type)(dst - begin);
+}
+
+
+}
@@ -0,0 +1,20 @@
+#include <aibench/program_info.hpp>
+
+std::string  get_program_name()
+{
+    return "aibench";
+}
+
+std::string  get_program_version()
+{
+    return "0.1";
+}
+
+std::string  get_program_description()
+{
+    return "Builds synthetic data for the selected part of the simulation of agents\n"
+           "(without a scene, a window, or a GL context) and measures the duration of\n"
+           "its updates. Each run starts from the given seed, so results (checksums)\n"
+           "are reproducible.\n"
+           ;
+}
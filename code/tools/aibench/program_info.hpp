@@ -0,0 +1,10 @@
+#ifndef E2_TOOL_AIBENCH_PROGRAM_INFO_HPP_INCLUDED
+#   define E2_TOOL_AIBENCH_PROGRAM_INFO_HPP_INCLUDED
+
+#   include <string>
+
+std::string  get_program_name();
+std::string  get_program_version();
+std::string  get_program_description();
+
+#endif
@@ -0,0 +1,142 @@
+#include <aibench/program_options.hpp>
+#include <aibench/program_info.hpp>
+#include <utility/assumptions.hpp>
+#include <stdexcept>
+#include <iostream>
+
+program_options::program_options(int argc, char* argv[])
+    : program_options_default(argc, argv)
+{
+    add_option(
+        "benchmark",
+
+        "What to measure: 'frames' (relocations of 'moved_ratio' of 'frames' frames of "
+        "reference in a random hierarchy followed by the update of their cached data, "
+        "i.e. the work done when the simulation context is frozen for parallel agents) "
+        "or 'navpath' (searches of 'queries' paths between random points on a grid of "
+        "'platforms' platforms, first by one finder and then by 'threads' finders in "
+        "parallel; with default values the navsystem has about 100k waypoints) or "
+        "'navlinks' (the build of navigation data of a grid of 'platforms' moveable "
+        "platforms followed by 'steps' rounds, in which all platforms move together, "
+        "and 'steps' rounds, in which each platform moves by its own random shift) or "
+        "'lookat' (look-at and aim-at inverse kinematics of 'agents' agents with a synthetic "
+        "skeleton in 'steps' steps) or 'animation' (interpolation of keyframes of 'bones' "
+        "bones of 'agents' agents in 'steps' steps) or 'agents' ('steps' rounds of the AI "
+        "simulator with 1, 10, 100 and 500 copies of the 'agent_scene' scene, first updated "
+        "serially and then by 'threads' threads).",
+
+        "1"
+        );
+    add_value("benchmark", "frames");
+    add_option(
+        "steps",
+
+        "A number of measured steps.",
+
+        "1"
+        );
+    add_value("steps", "100");
+    add_option(
+        "seed",
+
+        "A seed of random generators of synthetic data.",
+
+        "1"
+        );
+    add_value("seed", "1");
+    add_option(
+        "frames",
+
+        "A number of frames of reference.",
+
+        "1"
+        );
+    add_value("frames", "100000");
+    add_option(
+        "moved_ratio",
+
+        "A ratio of frames relocated in each step.",
+
+        "1"
+        );
+    add_value("moved_ratio", "0.01");
+    add_option(
+        "platforms",
+
+        "A number of square platforms (static boxes) arranged in a square grid. Adjacent "
+        "platforms are separated by 1m gaps, so they are connected by navlinks.",
+
+        "1"
+        );
+    add_value("platforms", "256");
+    add_option(
+        "platform_size",
+
+        "A length of a side of a platform in meters. A top side of a platform has about "
+        "(size/2.6)^2 waypoints.",
+
+        "1"
+        );
+    add_value("platform_size", "54");
+    add_option(
+        "queries",
+
+        "A number of path queries.",
+
+        "1"
+        );
+    add_value("queries", "10000");
+    add_option(
+        "threads",
+
+        "A number of threads (each with its own path finder) searching paths in parallel.",
+
+        "1"
+        );
+    add_value("threads", "4");
+    add_option(
+        "agents",
+
+        "A number of agents.",
+
+        "1"
+        );
+    add_value("agents", "100");
+    add_option(
+        "bones",
+
+        "A number of bones of a skeleton.",
+
+        "1"
+        );
+    add_value("bones", "60");
+    add_option(
+        "agent_scene",
+
+        "A directory of a scene with one agent; the 'agents' benchmark imports it "
+        "repeatedly. The path is relative to the scene root directory (see --data option).",
+
+        "1"
+        );
+}
+
+static program_options_ptr  global_program_options;
+
+void initialise_program_options(int argc, char* argv[])
+{
+    ASSUMPTION(!global_program_options.operator bool());
+    global_program_options = program_options_ptr(new program_options(argc,argv));
+}
+
+program_options_ptr get_program_options()
+{
+    ASSUMPTION(global_program_options.operator bool());
+    return global_program_options;
+}
+
+std::ostream& operator<<(std::ostream& ostr, program_options_ptr options)
+{
+    ASSUMPTION(options.operator bool());
+    options->operator<<(ostr);
+    return ostr;
+}
@@ -0,0 +1,34 @@
+#ifndef E2_TOOL_AIBENCH_PROGRAM_OPTIONS_HPP_INCLUDED
+#   define E2_TOOL_AIBENCH_PROGRAM_OPTIONS_HPP_INCLUDED
+
+#   include <utility/program_options_base.hpp>
+#   include <memory>
+
+class program_options : public program_options_default
+{
+public:
+    program_options(int argc, char* argv[]);
+
+    std::string  benchmark() const { return value("benchmark"); }
+    int  num_steps() const { return value_as_int("steps"); }
+    int  seed() const { return value_as_int("seed"); }
+    int  num_frames() const { return value_as_int("frames"); }
+    float  ratio_of_moved_frames() const { return value_as_float("moved_ratio"); }
+    int  num_platforms() const { return value_as_int("platforms"); }
+    float  platform_size() const { return value_as_float("platform_size"); }
+    int  num_queries() const { return value_as_int("queries"); }
+    int  num_threads() const { return value_as_int("threads"); }
+    int  num_agents() const { return value_as_int("agents"); }
+    int  num_bones() const { return value_as_int("bones"); }
+    bool  has_agent_scene_dir() const { return has("agent_scene"); }
+    std::string  agent_scene_dir() const { return value("agent_scene"); }
+};
+
+typedef std::shared_ptr<program_options const> program_options_ptr;
+
+void initialise_program_options(int argc, char* argv[]);
+program_options_ptr get_program_options();
+
+std::ostream& operator<<(std::ostream& ostr, program_options_ptr options);
+
+#endif
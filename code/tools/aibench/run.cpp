@@ -0,0 +1,648 @@
+#include <aibench/program_info.hpp>
+#include <aibench/program_options.hpp>
+#include <ai/simulator.hpp>
+#include <ai/navigation.hpp>
+#include <ai/navigation_path.hpp>
+#include <ai/skeleton_utils.hpp>
+#include <com/simulation_context.hpp>
+#include <com/frame_of_reference.hpp>
+#include <com/detail/import_scene.hpp>
+#include <angeo/collision_scene.hpp>
+#include <angeo/rigid_body_simulator.hpp>
+#include <angeo/skeleton_kinematics.hpp>
+#include <angeo/tensor_math.hpp>
+#include <utility/random.hpp>
+#include <utility/timeprof.hpp>
+#include <utility/log.hpp>
+#include <utility/assumptions.hpp>
+#include <utility/invariants.hpp>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <thread>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+
+static float_64_bit  seconds_since(std::chrono::high_resolution_clock::time_point const  start_time)
+{
+    return std::chrono::duration<float_64_bit>(std::chrono::high_resolution_clock::now() - start_time).count();
+}
+
+
+// A simulation context without a simulator; benchmarks insert objects into it directly.
+struct  synthetic_scene
+{
+    synthetic_scene()
+        : ai_simulator(std::make_shared<ai::simulator>())
+        , context(com::simulation_context::create(
+                [](){
+                    auto  vec_ptr = std::make_shared<std::vector<std::shared_ptr<angeo::collision_scene> > >();
+                    vec_ptr->push_back(std::make_shared<angeo::collision_scene>());
+                    return vec_ptr;
+                    }(),
+                std::make_shared<angeo::rigid_body_simulator>(),
+                std::make_shared<com::device_simulator>(),
+                ai_simulator,
+                get_program_options()->data_root()
+                ))
+    {
+        ai_simulator->initialise_navsystem(context);
+    }
+
+    ~synthetic_scene()
+    {
+        ai_simulator->clear();
+        context->clear(true);
+    }
+
+    // Inserts a box collider whose top side is at the height 'origin(2)'.
+    com::object_guid  insert_platform(std::string const&  name, vector3 const&  origin, vector3 const&  half_sizes,
+                                      angeo::COLLISION_CLASS const  collision_class = angeo::COLLISION_CLASS::STATIC_OBJECT)
+    {
+        com::object_guid const  folder_guid = context->insert_folder(context->root_folder(), name);
+        context->insert_frame(folder_guid, com::invalid_object_guid(), origin - half_sizes(2) * vector3_unit_z(),
+                              quaternion_identity());
+        return context->insert_collider_box(folder_guid, "box", half_sizes, angeo::COLLISION_MATERIAL_TYPE::CONCRETE,
+                                            collision_class, 1.0f, 0U);
+    }
+
+    // Inserts a square grid of 'num_platforms' square platforms of the given size, separated by 1m gaps (so that
+    // adjacent platforms are connected by navlinks). Returns centres of top sides of inserted platforms.
+    std::vector<vector3>  insert_platforms_grid(
+            natural_32_bit const  num_platforms,
+            float_32_bit const  platform_size,
+            angeo::COLLISION_CLASS const  collision_class = angeo::COLLISION_CLASS::STATIC_OBJECT
+            )
+    {
+        natural_32_bit const  num_columns = (natural_32_bit)std::ceil(std::sqrt((float_32_bit)num_platforms));
+        float_32_bit const  spacing = platform_size + 1.0f;
+        std::vector<vector3>  centres;
+        for (natural_32_bit  i = 0U; i != num_platforms; ++i)
+        {
+            centres.push_back({ (i % num_columns) * spacing, (i / num_columns) * spacing, 0.0f });
+            insert_platform("platform_" + std::to_string(i), centres.back(), { 0.5f * platform_size, 0.5f * platform_size, 0.5f },
+                            collision_class);
+        }
+        return centres;
+    }
+
+    natural_32_bit  num_waypoints() const
+    {
+        natural_32_bit  result = 0U;
+        for (ai::navcomponent_ptr const&  component : ai_simulator->get_navsystem()->get_components())
+            result += (natural_32_bit)component->get_waypoints().valid_indices().size();
+        return result;
+    }
+
+    std::shared_ptr<ai::simulator>  ai_simulator;
+    com::simulation_context_ptr  context;
+};
+
+
+static void  run_frames_benchmark()
+{
+    TMPROF_BLOCK();
+
+    random_generator_for_natural_32_bit  generator;
+    reset(generator, (natural_32_bit)get_program_options()->seed());
+
+    // Each 16th frame is a root; other frames have a random parent among preceding frames.
+    natural_32_bit const  num_frames = (natural_32_bit)get_program_options()->num_frames();
+    com::frames_provider  frames;
+    std::vector<com::frame_id>  ids;
+    for (natural_32_bit  i = 0U; i != num_frames; ++i)
+    {
+        ids.push_back(frames.insert());
+        frames.set_origin(ids.back(), {
+                get_random_float_32_bit_in_range(-1.0f, 1.0f, generator),
+                get_random_float_32_bit_in_range(-1.0f, 1.0f, generator),
+                get_random_float_32_bit_in_range(-1.0f, 1.0f, generator)
+                });
+        if (i % 16U != 0U)
+            frames.set_parent(ids.back(), ids.at(get_random_natural_32_bit_in_range(0U, i - 1U, generator)));
+    }
+    frames.update_cached_data();
+
+    natural_32_bit const  num_moved = (natural_32_bit)(get_program_options()->ratio_of_moved_frames() * num_frames);
+    float_64_bit  relocation_duration = 0.0;
+    float_64_bit  update_duration = 0.0;
+    float_64_bit  idle_update_duration = 0.0;
+    float_32_bit  checksum = 0.0f;
+    for (int  step = 0; step < get_program_options()->num_steps(); ++step)
+    {
+        auto  start_time = std::chrono::high_resolution_clock::now();
+        for (natural_32_bit  i = 0U; i != num_moved; ++i)
+            frames.translate(ids.at(get_random_natural_32_bit_in_range(0U, num_frames - 1U, generator)), { 0.001f, 0.0f, 0.0f });
+        relocation_duration += seconds_since(start_time);
+
+        start_time = std::chrono::high_resolution_clock::now();
+        frames.update_cached_data();
+        update_duration += seconds_since(start_time);
+
+        // Nothing was modified since the last update, so this one should cost nothing.
+        start_time = std::chrono::high_resolution_clock::now();
+        frames.update_cached_data();
+        idle_update_duration += seconds_since(start_time);
+
+        checksum += frames.frame_explicit_in_world_space(ids.at(step % num_frames)).origin()(0);
+    }
+
+    float_64_bit const  num_steps = std::max(get_program_options()->num_steps(), 1);
+    std::cout << "frames: " << num_frames
+              << "  moved/step: " << num_moved
+              << "  relocation seconds/step: " << relocation_duration / num_steps
+              << "  update seconds/step: " << update_duration / num_steps
+              << "  idle update seconds/step: " << idle_update_duration / num_steps
+              << "  checksum: " << checksum
+              << std::endl;
+}
+
+
+static void  run_navpath_benchmark()
+{
+    TMPROF_BLOCK();
+
+    random_generator_for_natural_32_bit  generator;
+    reset(generator, (natural_32_bit)get_program_options()->seed());
+
+    synthetic_scene  scene;
+    float_32_bit const  platform_size = get_program_options()->platform_size();
+    std::vector<vector3> const  centres =
+            scene.insert_platforms_grid((natural_32_bit)get_program_options()->num_platforms(), platform_size);
+    for (auto  it = scene.context->colliders_begin(), end = scene.context->colliders_end(); it != end; ++it)
+        scene.ai_simulator->get_naveditor()->add_navcomponents_2d(*it);
+
+    // Starts and goals are random points above top sides of random platforms.
+    std::vector<ai::navpath_query>  queries;
+    auto const  random_point = [&generator, &centres, platform_size]() -> vector3 {
+        return centres.at(get_random_natural_32_bit_in_range(0U, (natural_32_bit)centres.size() - 1U, generator)) + vector3{
+                get_random_float_32_bit_in_range(-0.5f * platform_size, 0.5f * platform_size, generator),
+                get_random_float_32_bit_in_range(-0.5f * platform_size, 0.5f * platform_size, generator),
+                0.25f
+                };
+    };
+    for (int  i = 0; i < get_program_options()->num_queries(); ++i)
+        queries.push_back({ random_point(), random_point(), 5.0f });
+
+    std::vector<ai::navpath_finder_ptr>  finders;
+    for (int  i = 0; i < get_program_options()->num_threads(); ++i)
+        finders.push_back(std::make_shared<ai::navpath_finder>(scene.ai_simulator->get_navsystem()));
+
+    thread_pool  workers((natural_32_bit)finders.size());
+
+    // The first (unmeasured) run only grows search buffers of the finders.
+    std::vector<ai::navpath>  paths;
+    ai::find_navpaths_in_parallel(workers, finders, queries, paths);
+
+    auto  start_time = std::chrono::high_resolution_clock::now();
+    finders.front()->find_paths(queries, paths);
+    float_64_bit const  sequential_duration = seconds_since(start_time);
+
+    start_time = std::chrono::high_resolution_clock::now();
+    ai::find_navpaths_in_parallel(workers, finders, queries, paths);
+    float_64_bit const  parallel_duration = seconds_since(start_time);
+
+    natural_32_bit  num_found = 0U;
+    float_64_bit  checksum = 0.0;
+    for (ai::navpath const&  path : paths)
+        if (!path.empty())
+        {
+            ++num_found;
+            checksum += path.length;
+        }
+
+    float_64_bit const  num_queries = std::max((float_64_bit)queries.size(), 1.0);
+    std::cout << "platforms: " << centres.size()
+              << "  components: " << scene.ai_simulator->get_navsystem()->get_components().valid_indices().size()
+              << "  waypoints: " << scene.num_waypoints()
+              << "  navlinks: " << scene.ai_simulator->get_navsystem()->get_navlinks().valid_indices().size()
+              << "  queries: " << queries.size()
+              << "  found: " << num_found
+              << std::endl
+              << "threads: 1"
+              << "  seconds: " << sequential_duration
+              << "  microseconds/query: " << 1e6 * sequential_duration / num_queries
+              << std::endl
+              << "threads: " << finders.size()
+              << "  seconds: " << parallel_duration
+              << "  microseconds/query: " << 1e6 * parallel_duration / num_queries
+              << std::endl
+              << "checksum: " << checksum
+              << std::endl;
+}
+
+
+static void  run_navlinks_benchmark()
+{
+    TMPROF_BLOCK();
+
+    random_generator_for_natural_32_bit  generator;
+    reset(generator, (natural_32_bit)get_program_options()->seed());
+
+    synthetic_scene  scene;
+    scene.insert_platforms_grid((natural_32_bit)get_program_options()->num_platforms(), get_program_options()->platform_size(),
+                                angeo::COLLISION_CLASS::COMMON_MOVEABLE_OBJECT);
+    std::vector<com::object_guid>  frames;
+    for (auto  it = scene.context->colliders_begin(), end = scene.context->colliders_end(); it != end; ++it)
+        frames.push_back(scene.context->frame_of_collider(*it));
+    scene.context->clear_relocated_frame_guids();
+
+    auto  start_time = std::chrono::high_resolution_clock::now();
+    for (auto  it = scene.context->colliders_begin(), end = scene.context->colliders_end(); it != end; ++it)
+        scene.ai_simulator->get_naveditor()->add_navcomponents_2d(*it);
+    // The first round only rebalances the proximity map of components.
+    scene.ai_simulator->get_naveditor()->next_round(1.0f / 60.0f);
+    float_64_bit const  build_duration = seconds_since(start_time);
+
+    natural_32_bit const  num_navlinks = (natural_32_bit)scene.ai_simulator->get_navsystem()->get_navlinks().valid_indices().size();
+
+    // All platforms move with the same velocity, so all navlinks remain valid.
+    float_64_bit  together_duration = 0.0;
+    for (int  step = 0; step < get_program_options()->num_steps(); ++step)
+    {
+        for (com::object_guid  frame_guid : frames)
+            scene.context->frame_translate(frame_guid, { 0.01f, 0.0f, 0.0f });
+        start_time = std::chrono::high_resolution_clock::now();
+        scene.ai_simulator->get_naveditor()->next_round(1.0f / 60.0f);
+        together_duration += seconds_since(start_time);
+        scene.context->clear_relocated_frame_guids();
+    }
+
+    // Each platform moves by its own random shift (mostly above the rebuild tolerance), so navlinks are rebuilt.
+    float_64_bit  separately_duration = 0.0;
+    for (int  step = 0; step < get_program_options()->num_steps(); ++step)
+    {
+        for (com::object_guid  frame_guid : frames)
+            scene.context->frame_translate(frame_guid, {
+                    get_random_float_32_bit_in_range(-0.2f, 0.2f, generator),
+                    get_random_float_32_bit_in_range(-0.2f, 0.2f, generator),
+                    0.0f
+                    });
+        start_time = std::chrono::high_resolution_clock::now();
+        scene.ai_simulator->get_naveditor()->next_round(1.0f / 60.0f);
+        separately_duration += seconds_since(start_time);
+        scene.context->clear_relocated_frame_guids();
+    }
+
+    float_64_bit const  num_steps = std::max(get_program_options()->num_steps(), 1);
+    std::cout << "platforms: " << frames.size()
+              << "  components: " << scene.ai_simulator->get_navsystem()->get_components().valid_indices().size()
+              << "  waypoints: " << scene.num_waypoints()
+              << "  navlinks: " << num_navlinks << " -> "
+              << scene.ai_simulator->get_navsystem()->get_navlinks().valid_indices().size()
+              << std::endl
+              << "build seconds: " << build_duration
+              << "  moving together seconds/step: " << together_duration / num_steps
+              << "  moving separately seconds/step: " << separately_duration / num_steps
+              << std::endl;
+}
+
+
+// A skeleton of a torso with two eyes (look-at chains sharing the spine, the neck and the head) and an arm (an aim-at chain).
+// All bones point along the y axis of their frames and each joint has two dofs (along x and z axes of the parent bone).
+struct  synthetic_skeleton
+{
+    synthetic_skeleton()
+        : parents{ -1, 0, 1, 2, 3, 4, 5, 5, 2, 8, 9, 10 }
+        , lengths{ 0.1f, 0.15f, 0.15f, 0.15f, 0.1f, 0.1f, 0.02f, 0.02f, 0.15f, 0.3f, 0.25f, 0.1f }
+        , pose_frames()
+        , joints()
+        , look_at_chains{ { 6U, { 3U, 4U, 5U, 6U } }, { 7U, { 3U, 4U, 5U, 7U } } }
+        , aim_at_chain{ 11U, { 8U, 9U, 10U, 11U } }
+    {
+        for (natural_32_bit  bone = 0U; bone != (natural_32_bit)parents.size(); ++bone)
+        {
+            vector3 const  origin = parents.at(bone) < 0 ? vector3_zero() : vector3(0.0f, lengths.at(parents.at(bone)), 0.0f);
+            pose_frames.push_back(angeo::coordinate_system(origin, quaternion_identity()));
+            if (parents.at(bone) >= 0)
+                joints[bone] = {
+                    { vector3_unit_x(), vector3_unit_y(), vector3_unit_y(), PI() / 2.0f, 1.0f },
+                    { vector3_unit_z(), vector3_unit_y(), vector3_unit_y(), PI() / 2.0f, 1.0f }
+                    };
+        }
+    }
+
+    std::vector<integer_32_bit>  parents;
+    std::vector<float_32_bit>  lengths;
+    std::vector<angeo::coordinate_system>  pose_frames;
+    angeo::joint_rotation_props_of_bones  joints;
+    std::vector<std::pair<natural_32_bit, std::unordered_set<natural_32_bit> > >  look_at_chains;
+    std::pair<natural_32_bit, std::unordered_set<natural_32_bit> >  aim_at_chain;
+};
+
+
+static void  run_lookat_benchmark()
+{
+    TMPROF_BLOCK();
+
+    random_generator_for_natural_32_bit  generator;
+    reset(generator, (natural_32_bit)get_program_options()->seed());
+
+    synthetic_skeleton const  skeleton;
+
+    angeo::skeleton_kinematics_flat::chain_specs  look_at_specs;
+    for (auto const&  chain : skeleton.look_at_chains)
+        look_at_specs.push_back({ chain.first, &chain.second });
+    angeo::skeleton_kinematics_flat::chain_specs const  aim_at_specs{ { skeleton.aim_at_chain.first, &skeleton.aim_at_chain.second } };
+
+    // Targets of agents of all steps are generated in advance, so that all variants process the same data.
+    natural_32_bit const  num_agents = (natural_32_bit)get_program_options()->num_agents();
+    natural_32_bit const  num_steps = (natural_32_bit)std::max(get_program_options()->num_steps(), 1);
+    std::vector<vector3>  targets;
+    for (natural_32_bit  i = 0U; i != num_agents * num_steps; ++i)
+        targets.push_back({
+                get_random_float_32_bit_in_range(-1.0f, 1.0f, generator),
+                get_random_float_32_bit_in_range(0.5f, 2.0f, generator),
+                get_random_float_32_bit_in_range(-1.0f, 1.0f, generator)
+                });
+
+    std::vector<std::vector<angeo::coordinate_system> >  frames(num_agents, skeleton.pose_frames);
+    auto const  frames_checksum = [&frames]() {
+        float_64_bit  checksum = 0.0;
+        for (auto const&  agent_frames : frames)
+            for (angeo::coordinate_system const&  frame : agent_frames)
+                checksum += frame.origin()(0) + frame.orientation().x() + frame.orientation().z();
+        return checksum;
+    };
+
+    // The map-based kinematics built in each call (the implementation before the flat kinematics).
+    auto  start_time = std::chrono::high_resolution_clock::now();
+    for (natural_32_bit  step = 0U; step != num_steps; ++step)
+        for (natural_32_bit  agent = 0U; agent != num_agents; ++agent)
+        {
+            vector3 const&  target = targets.at(step * num_agents + agent);
+
+            std::unordered_map<natural_32_bit, angeo::coordinate_system const*>  pose_frame_pointers;
+            std::unordered_map<natural_32_bit, angeo::coordinate_system*>  output_frame_pointers;
+            for (natural_32_bit  bone = 0U; bone != (natural_32_bit)skeleton.parents.size(); ++bone)
+            {
+                pose_frame_pointers.insert({ bone, &skeleton.pose_frames.at(bone) });
+                output_frame_pointers.insert({ bone, &frames.at(agent).at(bone) });
+            }
+
+            std::vector<angeo::skeleton_kinematics_of_chain_of_bones>  kinematics;
+            std::vector<angeo::look_at_target>  look_at_targets;
+            for (auto const&  chain : skeleton.look_at_chains)
+            {
+                kinematics.push_back({ pose_frame_pointers, chain.second, chain.first, skeleton.joints, skeleton.parents, skeleton.lengths });
+                look_at_targets.push_back({ target, vector3_unit_y() });
+            }
+            angeo::skeleton_look_at(kinematics, look_at_targets);
+            for (angeo::skeleton_kinematics_of_chain_of_bones const&  kin : kinematics)
+                kin.commit_target_frames(output_frame_pointers);
+
+            angeo::skeleton_kinematics_of_chain_of_bones  aim_at_kinematics(
+                    pose_frame_pointers, skeleton.aim_at_chain.second, skeleton.aim_at_chain.first,
+                    skeleton.joints, skeleton.parents, skeleton.lengths
+                    );
+            angeo::skeleton_aim_at(aim_at_kinematics, { { target, vector3(0.0f, skeleton.lengths.back(), 0.0f) } });
+            aim_at_kinematics.commit_target_frames(output_frame_pointers);
+        }
+    float_64_bit const  maps_duration = seconds_since(start_time);
+    float_64_bit const  maps_checksum = frames_checksum();
+
+    // The flat kinematics, either built in each call or only once per agent (i.e. cached for the motion templates).
+    auto const  run_flat = [&](bool const  build_in_each_call) {
+        frames.assign(num_agents, skeleton.pose_frames);
+        std::vector<angeo::skeleton_kinematics_flat>  look_at_kinematics(num_agents);
+        std::vector<angeo::skeleton_kinematics_flat>  aim_at_kinematics(num_agents);
+        std::vector<angeo::look_at_target>  look_at_targets;
+        auto  start_time = std::chrono::high_resolution_clock::now();
+        for (natural_32_bit  step = 0U; step != num_steps; ++step)
+            for (natural_32_bit  agent = 0U; agent != num_agents; ++agent)
+            {
+                vector3 const&  target = targets.at(step * num_agents + agent);
+
+                if (build_in_each_call || look_at_kinematics.at(agent).num_chains() == 0U)
+                {
+                    look_at_kinematics.at(agent) = angeo::skeleton_kinematics_flat(look_at_specs, skeleton.joints, skeleton.parents, skeleton.lengths);
+                    aim_at_kinematics.at(agent) = angeo::skeleton_kinematics_flat(aim_at_specs, skeleton.joints, skeleton.parents, skeleton.lengths);
+                }
+
+                look_at_kinematics.at(agent).setup_joint_states_from_pose_frames(skeleton.pose_frames);
+                look_at_targets.assign(skeleton.look_at_chains.size(), { target, vector3_unit_y() });
+                angeo::skeleton_look_at(look_at_kinematics.at(agent), look_at_targets);
+                look_at_kinematics.at(agent).commit_target_frames(frames.at(agent));
+
+                aim_at_kinematics.at(agent).setup_joint_states_from_pose_frames(skeleton.pose_frames);
+                angeo::skeleton_aim_at(aim_at_kinematics.at(agent), 0U, { { target, vector3(0.0f, skeleton.lengths.back(), 0.0f) } });
+                aim_at_kinematics.at(agent).commit_target_frames_of_chain(0U, frames.at(agent));
+            }
+        return seconds_since(start_time);
+    };
+    float_64_bit const  flat_built_duration = run_flat(true);
+    float_64_bit const  flat_cached_duration = run_flat(false);
+
+    float_64_bit const  num_calls = (float_64_bit)num_agents * num_steps;
+    std::cout << "agents: " << num_agents
+              << "  steps: " << num_steps
+              << "  bones: " << skeleton.parents.size()
+              << "  look-at chains: " << skeleton.look_at_chains.size()
+              << "  aim-at chains: 1"
+              << std::endl
+              << "maps, built per call:  microseconds/agent: " << 1e6 * maps_duration / num_calls
+              << "  checksum: " << maps_checksum
+              << std::endl
+              << "flat, built per call:  microseconds/agent: " << 1e6 * flat_built_duration / num_calls
+              << std::endl
+              << "flat, cached:          microseconds/agent: " << 1e6 * flat_cached_duration / num_calls
+              << "  checksum: " << frames_checksum()
+              << std::endl;
+}
+
+
+static void  run_animation_benchmark()
+{
+    TMPROF_BLOCK();
+
+    random_generator_for_natural_32_bit  generator;
+    reset(generator, (natural_32_bit)get_program_options()->seed());
+
+    natural_32_bit const  num_agents = (natural_32_bit)get_program_options()->num_agents();
+    natural_32_bit const  num_bones = (natural_32_bit)get_program_options()->num_bones();
+    natural_32_bit const  num_steps = (natural_32_bit)std::max(get_program_options()->num_steps(), 1);
+
+    auto const  random_frame = [&generator]() {
+        return angeo::coordinate_system(
+                vector3(
+                    get_random_float_32_bit_in_range(-1.0f, 1.0f, generator),
+                    get_random_float_32_bit_in_range(-1.0f, 1.0f, generator),
+                    get_random_float_32_bit_in_range(-1.0f, 1.0f, generator)
+                    ),
+                normalised(make_quaternion_xyzw(
+                    get_random_float_32_bit_in_range(-1.0f, 1.0f, generator),
+                    get_random_float_32_bit_in_range(-1.0f, 1.0f, generator),
+                    get_random_float_32_bit_in_range(-1.0f, 1.0f, generator),
+                    get_random_float_32_bit_in_range(-1.0f, 1.0f, generator)
+                    ))
+                );
+    };
+    std::vector<std::vector<angeo::coordinate_system> >  src_frames(num_agents), dst_frames(num_agents);
+    for (natural_32_bit  agent = 0U; agent != num_agents; ++agent)
+    {
+        for (natural_32_bit  bone = 0U; bone != num_bones; ++bone)
+        {
+            src_frames.at(agent).push_back(random_frame());
+            dst_frames.at(agent).push_back(random_frame());
+        }
+    }
+
+    std::vector<std::vector<angeo::coordinate_system> >  frames(num_agents);
+    auto const  frames_checksum = [&frames]() {
+        float_64_bit  checksum = 0.0;
+        for (auto const&  agent_frames : frames)
+            for (angeo::coordinate_system const&  frame : agent_frames)
+                checksum += frame.origin()(0) + frame.orientation().x() + frame.orientation().z();
+        return checksum;
+    };
+    auto const  interpolation_param = [num_steps](natural_32_bit const  step) {
+        return (float_32_bit)(step + 1U) / (float_32_bit)num_steps;
+    };
+
+    auto const  start_time = std::chrono::high_resolution_clock::now();
+    for (natural_32_bit  step = 0U; step != num_steps; ++step)
+        for (natural_32_bit  agent = 0U; agent != num_agents; ++agent)
+            ai::interpolate_keyframes_spherical(src_frames.at(agent), dst_frames.at(agent), interpolation_param(step), frames.at(agent));
+    float_64_bit const  duration = seconds_since(start_time);
+
+    std::cout << "agents: " << num_agents
+              << "  steps: " << num_steps
+              << "  bones: " << num_bones
+              << std::endl
+              << "microseconds/agent: " << 1e6 * duration / ((float_64_bit)num_agents * num_steps)
+              << "  checksum: " << frames_checksum()
+              << std::endl;
+}
+
+
+static void  run_agents_benchmark()
+{
+    TMPROF_BLOCK();
+
+    synthetic_scene  scene;
+    com::simulation_context&  ctx = *scene.context;
+
+    std::string const  scene_dir = ctx.get_scene_root_dir() + get_program_options()->agent_scene_dir();
+    if (!std::filesystem::is_directory(scene_dir))
+    {
+        std::cout << "The scene directory '" << scene_dir << "' does not exist." << std::endl;
+        return;
+    }
+    com::detail::imported_scene const  agent_scene(scene_dir);
+    if (!agent_scene.wait_till_load_is_finished())
+    {
+        std::cout << "Failed to load the scene '" << scene_dir << "'. Details: " << agent_scene.error_message() << std::endl;
+        return;
+    }
+
+    // Copies of the scene are imported in a square grid with 2m spacing, so that agents do not overlap.
+    natural_32_bit  num_imported = 0U;
+    auto const  import_agents = [&](natural_32_bit const  num_agents) {
+        for ( ; num_imported < num_agents; ++num_imported)
+        {
+            com::import_scene_props  props(
+                    scene_dir,
+                    ctx.insert_folder(ctx.root_folder(), "agent_" + std::to_string(num_imported))
+                    );
+            props.relocation_frame_ptr = std::make_shared<angeo::coordinate_system const>(
+                    vector3{ 2.0f * (float_32_bit)(num_imported % 32U), 2.0f * (float_32_bit)(num_imported / 32U), 0.0f },
+                    quaternion_identity()
+                    );
+            com::detail::import_scene(ctx, agent_scene, props);
+        }
+        while (ctx.has_pending_late_requests())
+        {
+            ctx.process_pending_late_requests();
+            if (ctx.has_pending_late_requests())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (ctx.has_pending_requests())
+            ctx.process_pending_requests();
+    };
+
+    // Runs 'steps' rounds of agents with the given number of threads. Requests of agents are processed
+    // after each round (not measured), as the simulator does.
+    float_32_bit const  time_step = 1.0f / 60.0f;
+    auto const  run_rounds = [&](natural_32_bit const  num_threads) {
+        scene.ai_simulator->set_num_worker_threads(num_threads);
+        float_64_bit  duration = 0.0;
+        for (int  step = 0; step < get_program_options()->num_steps(); ++step)
+        {
+            auto const  start_time = std::chrono::high_resolution_clock::now();
+            {
+                com::simulation_context_freeze_guard const  freeze_guard(ctx, num_threads > 1U);
+                scene.ai_simulator->next_round(time_step, nullptr);
+            }
+            duration += seconds_since(start_time);
+            ctx.process_pending_early_requests();
+            ctx.process_pending_requests();
+        }
+        return duration;
+    };
+
+    natural_32_bit const  num_threads = (natural_32_bit)get_program_options()->num_threads();
+    float_64_bit const  num_steps = std::max(get_program_options()->num_steps(), 1);
+    for (natural_32_bit const  num_agents : { 1U, 10U, 100U, 500U })
+    {
+        import_agents(num_agents);
+        natural_32_bit  num_inserted = 0U;
+        for (auto  it = ctx.agents_begin(), end = ctx.agents_end(); it != end; ++it)
+            ++num_inserted;
+
+        // The first (unmeasured) rounds let agents settle in their initial actions.
+        run_rounds(1U);
+
+        float_64_bit const  serial_duration = run_rounds(1U);
+        float_64_bit const  parallel_duration = run_rounds(num_threads);
+        std::cout << "agents: " << num_inserted
+                  << "  threads: 1  milliseconds/step: " << 1e3 * serial_duration / num_steps
+                  << "  threads: " << num_threads << "  milliseconds/step: " << 1e3 * parallel_duration / num_steps
+                  << "  speedup: " << (parallel_duration > 0.0 ? serial_duration / parallel_duration : 0.0)
+                  << std::endl;
+    }
+}
+
+
+void run(int argc, char* argv[])
+{
+    TMPROF_BLOCK();
+
+    if (get_program_options()->num_steps() < 0 ||
+        get_program_options()->num_frames() < 1 ||
+        get_program_options()->ratio_of_moved_frames() < 0.0f || get_program_options()->ratio_of_moved_frames() > 1.0f ||
+        get_program_options()->num_platforms() < 1 ||
+        get_program_options()->platform_size() <= 0.0f ||
+        get_program_options()->num_queries() < 0 ||
+        get_program_options()->num_threads() < 1 ||
+        get_program_options()->num_agents() < 1 ||
+        get_program_options()->num_bones() < 1 ||
+        (get_program_options()->benchmark() != "frames" &&
+            get_program_options()->benchmark() != "navpath" &&
+            get_program_options()->benchmark() != "navlinks" &&
+            get_program_options()->benchmark() != "lookat" &&
+            get_program_options()->benchmark() != "animation" &&
+            get_program_options()->benchmark() != "agents") ||
+        (get_program_options()->benchmark() == "agents" && !get_program_options()->has_agent_scene_dir()))
+    {
+        std::cout << "Wrong usage of the tool. Use the command --help." << std::endl;
+        return;
+    }
+
+    if (get_program_options()->benchmark() == "navpath")
+        run_navpath_benchmark();
+    else if (get_program_options()->benchmark() == "navlinks")
+        run_navlinks_benchmark();
+    else if (get_program_options()->benchmark() == "lookat")
+        run_lookat_benchmark();
+    else if (get_program_options()->benchmark() == "animation")
+        run_animation_benchmark();
+    else if (get_program_options()->benchmark() == "agents")
+        run_agents_benchmark();
+    else
+        run_frames_benchmark();
+}
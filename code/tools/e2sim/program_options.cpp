@@ -16,6 +16,32 @@ program_options::program_options(int argc, char* argv[])
         
         "1"
         );
+    add_option(
+        "bake_dir",
+
+        "A cache directory into which navigation data generated for the scene "
+        "are baked, so that next loads of the scene read them from there instead "
+        "of generating them again. The directory is created when needed. It should "
+        "not be a directory with the scene data. Without the option nothing is baked.",
+
+        "1"
+        );
+    add_option(
+        "simulation_thread",
+
+        "Simulates the scene in a separate thread. The main thread then only renders "
+        "snapshots of the scene and processes the user input.",
+
+        "0"
+        );
+    add_option(
+        "fixed_time_step",
+
+        "Each simulation step takes exactly the maximal time delta of the simulation "
+        "(the rest of the time of a round is kept for next rounds).",
+
+        "0"
+        );
 }
 
 static program_options_ptr  global_program_options;
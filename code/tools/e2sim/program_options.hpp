@@ -11,6 +11,10 @@ public:
 
     bool  has_scene_dir() const { return has("scene"); }
     std::string  scene_dir() const { return value("scene"); }
+    bool  has_bake_dir() const { return has("bake_dir"); }
+    std::string  bake_dir() const { return value("bake_dir"); }
+    bool  simulation_thread() const { return has("simulation_thread"); }
+    bool  fixed_time_step() const { return has("fixed_time_step"); }
 };
 
 typedef std::shared_ptr<program_options const> program_options_ptr;
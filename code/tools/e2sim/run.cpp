@@ -26,6 +26,12 @@ struct  simulator : public com::simulator
         set_window_size(1024U, 768U);
         maximise_window();
 
+        simulation_config().SIMULATE_IN_SEPARATE_THREAD = get_program_options()->simulation_thread();
+        simulation_config().FIXED_TIME_STEP = get_program_options()->fixed_time_step();
+
+        if (get_program_options()->has_bake_dir())
+            context()->set_navigation_bake_dir(get_program_options()->bake_dir());
+
         if (get_program_options()->has_scene_dir())
             context()->request_late_import_scene_from_directory({
                 context()->get_scene_root_dir() + get_program_options()->scene_dir(),
@@ -131,12 +137,14 @@ struct  simulator : public com::simulator
         {
             if (get_keyboard_props().keys_just_pressed().count(osi::KEY_R()) != 0UL)
             {
-                clear(shift);
-                if (get_program_options()->has_scene_dir())
-                    context()->request_late_import_scene_from_directory({
-                            context()->get_scene_root_dir() + get_program_options()->scene_dir(),
-                            context()->root_folder()
-                            });
+                call_with_context([this, shift]() {
+                    clear(shift);
+                    if (get_program_options()->has_scene_dir())
+                        context()->request_late_import_scene_from_directory({
+                                context()->get_scene_root_dir() + get_program_options()->scene_dir(),
+                                context()->root_folder()
+                                });
+                });
                 simulation_config().paused = true;
             }
             if (get_keyboard_props().keys_just_pressed().count(osi::KEY_NUMERIC_PLUS()) != 0UL)
@@ -146,19 +154,19 @@ struct  simulator : public com::simulator
         }
 
         if (get_mouse_props().buttons_just_pressed().count(osi::LEFT_MOUSE_BUTTON()) != 0UL)
-        {
-            com::object_guid const  guid = find_collider_under_mouse();
-            if (guid != com::invalid_object_guid())
-            {
-                if (ctrl)
+            call_with_context([this, shift, ctrl]() {
+                com::object_guid const  guid = find_collider_under_mouse();
+                if (guid != com::invalid_object_guid())
                 {
-                    std::string const  txt = paste_object_path_to_command_line_of_console(guid, shift, true, false);
-                    CLOG("Clicked: " << (txt.empty() ? "NONE" : txt));
+                    if (ctrl)
+                    {
+                        std::string const  txt = paste_object_path_to_command_line_of_console(guid, shift, true, false);
+                        CLOG("Clicked: " << (txt.empty() ? "NONE" : txt));
+                    }
                 }
-            }
-            else
-                CLOG("Clicked: NONE");
-        }
+                else
+                    CLOG("Clicked: NONE");
+            });
     }
 
     void  custom_module_round() override
@@ -0,0 +1,20 @@
+#include <e2simbatch/program_info.hpp>
+
+std::string  get_program_name()
+{
+    return "e2simbatch";
+}
+
+std::string  get_program_version()
+{
+    return "0.1";
+}
+
+std::string  get_program_description()
+{
+    return "Runs a simulation of a scene without a window, GL context, or render.\n"
+           "The scene is simulated by the given number of fixed time steps as fast\n"
+           "as possible. Then the time profile and the final state of the scene\n"
+           "(frames, rigid bodies, and agents) are written to files.\n"
+           ;
+}
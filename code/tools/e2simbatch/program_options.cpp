@@ -0,0 +1,83 @@
+#include <e2simbatch/program_options.hpp>
+#include <e2simbatch/program_info.hpp>
+#include <utility/assumptions.hpp>
+#include <stdexcept>
+#include <iostream>
+
+program_options::program_options(int argc, char* argv[])
+    : program_options_default(argc, argv)
+{
+    add_option(
+        "scene",
+        
+        "A directory of a scene to be loaded. A scene directory always "
+        "contains a file 'hierarchy.json'. The scene is  a relative "
+        "path to the data root directory (see --data option).",
+        
+        "1"
+        );
+    add_option(
+        "bake_dir",
+
+        "A cache directory into which navigation data generated for the scene "
+        "are baked, so that next loads of the scene read them from there instead "
+        "of generating them again. The directory is created when needed. It should "
+        "not be a directory with the scene data. Without the option nothing is baked.",
+
+        "1"
+        );
+    add_option(
+        "steps",
+
+        "A number of simulation steps to perform.",
+
+        "1"
+        );
+    add_value("steps", "1000");
+    add_option(
+        "time_step",
+
+        "A duration of each simulation step in seconds.",
+
+        "1"
+        );
+    add_value("time_step", "0.0333333");
+    add_option(
+        "ai_threads",
+
+        "A number of threads updating agents in each simulation step.",
+
+        "1"
+        );
+    add_value("ai_threads", "1");
+    add_option(
+        "output",
+
+        "A file into which the final state of the scene is written. When "
+        "the option is not specified, the state is written into the file "
+        "'e2simbatch_STATE.txt' in the current directory.",
+
+        "1"
+        );
+}
+
+static program_options_ptr  global_program_options;
+
+void initialise_program_options(int argc, char* argv[])
+{
+    ASSUMPTION(!global_program_options.operator bool());
+    global_program_options = program_options_ptr(new program_options(argc,argv));
+}
+
+program_options_ptr get_program_options()
+{
+    ASSUMPTION(global_program_options.operator bool());
+    return global_program_options;
+}
+
+std::ostream& operator<<(std::ostream& ostr, program_options_ptr options)
+{
+    ASSUMPTION(options.operator bool());
+    options->operator<<(ostr);
+    return ostr;
+}
@@ -0,0 +1,32 @@
+#ifndef E2_TOOL_E2SIMBATCH_PROGRAM_OPTIONS_HPP_INCLUDED
+#   define E2_TOOL_E2SIMBATCH_PROGRAM_OPTIONS_HPP_INCLUDED
+
+#   include <utility/program_options_base.hpp>
+#   include <memory>
+
+class program_options : public program_options_default
+{
+public:
+    program_options(int argc, char* argv[]);
+
+    bool  has_scene_dir() const { return has("scene"); }
+    std::string  scene_dir() const { return value("scene"); }
+    bool  has_bake_dir() const { return has("bake_dir"); }
+    std::string  bake_dir() const { return value("bake_dir"); }
+
+    int  num_steps() const { return value_as_int("steps"); }
+    float  time_step() const { return value_as_float("time_step"); }
+    int  num_ai_threads() const { return value_as_int("ai_threads"); }
+
+    bool  has_output_file() const { return has("output"); }
+    std::string  output_file() const { return value("output"); }
+};
+
+typedef std::shared_ptr<program_options const> program_options_ptr;
+
+void initialise_program_options(int argc, char* argv[]);
+program_options_ptr get_program_options();
+
+std::ostream& operator<<(std::ostream& ostr, program_options_ptr options);
+
+#endif
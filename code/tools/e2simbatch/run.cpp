@@ -0,0 +1,110 @@
+#include <e2simbatch/program_info.hpp>
+#include <e2simbatch/program_options.hpp>
+#include <com/simulator.hpp>
+#include <com/detail/import_scene.hpp>
+#include <angeo/tensor_math.hpp>
+#include <utility/timeprof.hpp>
+#include <utility/log.hpp>
+#include <utility/assumptions.hpp>
+#include <utility/invariants.hpp>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+
+static void  write_vector3(std::ostream&  ostr, vector3 const&  u)
+{
+    ostr << u(0) << ' ' << u(1) << ' ' << u(2);
+}
+
+
+static void  write_quaternion(std::ostream&  ostr, quaternion const&  q)
+{
+    ostr << q.w() << ' ' << q.x() << ' ' << q.y() << ' ' << q.z();
+}
+
+
+static void  write_scene_state(com::simulator const&  sim, std::ostream&  ostr)
+{
+    TMPROF_BLOCK();
+
+    com::simulation_context const&  ctx = *sim.context();
+
+    ostr << "SIMULATION_TIME_STEP " << sim.simulation_config().MAX_SIMULATION_TIME_DELTA << '\n';
+    ostr << "NUM_STEPS " << get_program_options()->num_steps() << '\n';
+
+    ostr << "\nFRAMES\n";
+    for (auto  it = ctx.frames_begin(), end = ctx.frames_end(); it != end; ++it)
+    {
+        angeo::coordinate_system const&  coord_system = ctx.frame_coord_system_in_world_space(*it);
+        ostr << ctx.to_absolute_path(*it) << "  ";
+        write_vector3(ostr, coord_system.origin());
+        ostr << "  ";
+        write_quaternion(ostr, coord_system.orientation());
+        ostr << '\n';
+    }
+
+    ostr << "\nRIGID_BODIES\n";
+    for (auto  it = ctx.rigid_bodies_begin(), end = ctx.rigid_bodies_end(); it != end; ++it)
+    {
+        ostr << ctx.to_absolute_path(*it) << "  ";
+        write_vector3(ostr, ctx.mass_centre_of_rigid_body(*it));
+        ostr << "  ";
+        write_quaternion(ostr, ctx.orientation_of_rigid_body(*it));
+        ostr << "  ";
+        write_vector3(ostr, ctx.linear_velocity_of_rigid_body(*it));
+        ostr << "  ";
+        write_vector3(ostr, ctx.angular_velocity_of_rigid_body(*it));
+        ostr << '\n';
+    }
+
+    ostr << "\nAGENTS\n";
+    for (auto  it = ctx.agents_begin(), end = ctx.agents_end(); it != end; ++it)
+        ostr << ctx.to_absolute_path(*it) << '\n';
+}
+
+
+void run(int argc, char* argv[])
+{
+    TMPROF_BLOCK();
+
+    if (!get_program_options()->has_scene_dir())
+        throw std::invalid_argument("The option --scene is required.");
+    if (get_program_options()->num_steps() < 0)
+        throw std::invalid_argument("The value of the option --steps must not be negative.");
+    if (get_program_options()->time_step() <= 0.0f)
+        throw std::invalid_argument("The value of the option --time_step must be positive.");
+    if (get_program_options()->num_ai_threads() <= 0)
+        throw std::invalid_argument("The value of the option --ai_threads must be positive.");
+
+    com::simulator  sim(get_program_options()->data_root());
+    sim.simulation_config().MAX_SIMULATION_TIME_DELTA = get_program_options()->time_step();
+    sim.simulation_config().FIXED_TIME_STEP = true;
+    sim.simulation_config().paused = false;
+    sim.ai_simulator()->set_num_worker_threads((natural_32_bit)get_program_options()->num_ai_threads());
+    if (get_program_options()->has_bake_dir())
+        sim.context()->set_navigation_bake_dir(get_program_options()->bake_dir());
+
+    // The scene is imported here (instead of by a late request processed in the first step), because
+    // a late request only logs a failure and the batch would then silently simulate an empty scene.
+    std::string const  scene_dir = sim.context()->get_scene_root_dir() + get_program_options()->scene_dir();
+    if (!std::filesystem::is_directory(scene_dir))
+        throw std::invalid_argument("The scene directory '" + scene_dir + "' does not exist.");
+    com::detail::imported_scene const  scene(scene_dir);
+    if (!scene.wait_till_load_is_finished())
+        throw std::runtime_error("Failed to load the scene '" + scene_dir + "'. Details: " + scene.error_message());
+    com::detail::import_scene(*sim.context(), scene, { scene_dir, sim.context()->root_folder() });
+
+    sim.run_headless((natural_32_bit)get_program_options()->num_steps());
+
+    std::ofstream  ostr(
+            get_program_options()->has_output_file() ?
+                    get_program_options()->output_file() :
+                    get_program_name() + "_STATE.txt"
+            );
+    if (!ostr.is_open())
+        throw std::runtime_error("Cannot open the output file for the final state of the scene.");
+    write_scene_state(sim, ostr);
+
+    sim.context()->clear(true);
+}
@@ -0,0 +1,20 @@
+#include <netlabbench/program_info.hpp>
+
+std::string  get_program_name()
+{
+    return "netlabbench";
+}
+
+std::string  get_program_version()
+{
+    return "0.1";
+}
+
+std::string  get_program_description()
+{
+    return "Builds a synthetic netlab network and measures the duration of its rounds\n"
+           "for 1, 2, 4, ... threads (up to the given maximum). Each run starts from\n"
+           "the same seed, so checksums of spiking output units must be equal for all\n"
+           "thread counts.\n"
+           ;
+}
@@ -0,0 +1,150 @@
+#include <netlabbench/program_options.hpp>
+#include <netlabbench/program_info.hpp>
+#include <utility/assumptions.hpp>
+#include <stdexcept>
+#include <iostream>
+
+program_options::program_options(int argc, char* argv[])
+    : program_options_default(argc, argv)
+{
+    add_option(
+        "layers",
+
+        "A number of layers of the network (at most 64, or 256 with wide ids). The first "
+        "layer is the input layer and the last one is the output layer.",
+
+        "1"
+        );
+    add_value("layers", "16");
+    add_option(
+        "units",
+
+        "A number of units in each layer (at most 16384, or 2^30 with wide ids).",
+
+        "1"
+        );
+    add_value("units", "4096");
+    add_option(
+        "sockets",
+
+        "A number of input and output sockets of each unit.",
+
+        "1"
+        );
+    add_value("sockets", "8");
+    add_option(
+        "inhibitory_ratio",
+
+        "A ratio of inhibitory layers; they are evenly distributed among all layers "
+        "(e.g. for 0.25 each fourth layer is inhibitory). Other layers are excitatory.",
+
+        "1"
+        );
+    add_value("inhibitory_ratio", "0.25");
+    add_option(
+        "input_spikes",
+
+        "A number of randomly chosen units of the input layer spiking in each round "
+        "(i.e. the input spike rate).",
+
+        "1"
+        );
+    add_value("input_spikes", "256");
+    add_option(
+        "rounds",
+
+        "A number of measured rounds of the network.",
+
+        "1"
+        );
+    add_value("rounds", "100");
+    add_option(
+        "threads",
+
+        "The maximal number of threads used by rounds of the network.",
+
+        "1"
+        );
+    add_value("threads", "8");
+    add_option(
+        "seed",
+
+        "A seed of random generators of the network and of input spikes.",
+
+        "1"
+        );
+    add_value("seed", "1");
+    add_option(
+        "charge_update",
+
+        "A mode of the update of charges of units: 'dense', 'event' (i.e. event-driven) "
+        "or 'both'. In the last case the network is measured in both modes; spike trains "
+        "(and so checksums) must be the same.",
+
+        "1"
+        );
+    add_value("charge_update", "both");
+    add_option(
+        "benchmark",
+
+        "What to measure: 'network' (rounds of the whole network), 'layer' (updates of "
+        "charges of a single layer of 1k, 2k, ..., 16k units; options 'layers', 'units', "
+        "'sockets' and 'threads' are ignored), 'uid' (operations with compact 32-bit and "
+        "wide 64-bit ids of units of 'layers' x 'units' units, repeated 'rounds' times) or "
+        "'snapshot' (a full save, an incremental save after one more round and a load of "
+        "a snapshot of the network after 'rounds' rounds; the loaded network must then "
+        "produce the same spikes as the original one).",
+
+        "1"
+        );
+    add_value("benchmark", "network");
+    add_option(
+        "snapshot_rounds",
+
+        "A number of rounds per snapshot of statistics of the network. When 0, statistics "
+        "are not collected.",
+
+        "1"
+        );
+    add_value("snapshot_rounds", "0");
+    add_option(
+        "probed_ratio",
+
+        "A ratio of probed units in each non-input layer, when statistics are collected.",
+
+        "1"
+        );
+    add_value("probed_ratio", "0.1");
+    add_option(
+        "report",
+
+        "A format of results of all benchmarks: 'text', or 'json' (a single machine-readable "
+        "object with the benchmark name, parameters and results; for 'network' the memory of "
+        "synapses and for each run spikes/s, synaptic events/s, connections/s, disconnections/s "
+        "and rewirings/s, i.e. connections and disconnections per second).",
+
+        "1"
+        );
+    add_value("report", "text");
+}
+
+static program_options_ptr  global_program_options;
+
+void initialise_program_options(int argc, char* argv[])
+{
+    ASSUMPTION(!global_program_options.operator bool());
+    global_program_options = program_options_ptr(new program_options(argc,argv));
+}
+
+program_options_ptr get_program_options()
+{
+    ASSUMPTION(global_program_options.operator bool());
+    return global_program_options;
+}
+
+std::ostream& operator<<(std::ostream& ostr, program_options_ptr options)
+{
+    ASSUMPTION(options.operator bool());
+    options->operator<<(ostr);
+    return ostr;
+}
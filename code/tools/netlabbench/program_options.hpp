@@ -0,0 +1,34 @@
+#ifndef E2_TOOL_NETLABBENCH_PROGRAM_OPTIONS_HPP_INCLUDED
+#   define E2_TOOL_NETLABBENCH_PROGRAM_OPTIONS_HPP_INCLUDED
+
+#   include <utility/program_options_base.hpp>
+#   include <memory>
+
+class program_options : public program_options_default
+{
+public:
+    program_options(int argc, char* argv[]);
+
+    int  num_layers() const { return value_as_int("layers"); }
+    int  num_units_per_layer() const { return value_as_int("units"); }
+    int  num_sockets_per_unit() const { return value_as_int("sockets"); }
+    float  ratio_of_inhibitory_layers() const { return value_as_float("inhibitory_ratio"); }
+    int  num_input_spikes_per_round() const { return value_as_int("input_spikes"); }
+    int  num_rounds() const { return value_as_int("rounds"); }
+    int  max_num_threads() const { return value_as_int("threads"); }
+    int  seed() const { return value_as_int("seed"); }
+    std::string  charge_update() const { return value("charge_update"); }
+    std::string  benchmark() const { return value("benchmark"); }
+    int  num_rounds_per_snapshot() const { return value_as_int("snapshot_rounds"); }
+    float  ratio_of_probed_units() const { return value_as_float("probed_ratio"); }
+    std::string  report() const { return value("report"); }
+};
+
+typedef std::shared_ptr<program_options const> program_options_ptr;
+
+void initialise_program_options(int argc, char* argv[]);
+program_options_ptr get_program_options();
+
+std::ostream& operator<<(std::ostream& ostr, program_options_ptr options);
+
+#endif
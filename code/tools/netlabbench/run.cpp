@@ -0,0 +1,524 @@
+#include <netlabbench/program_info.hpp>
+#include <netlabbench/program_options.hpp>
+#include <netlab/network.hpp>
+#include <netlab/snapshot.hpp>
+#include <utility/random.hpp>
+#include <utility/hash_combine.hpp>
+#include <utility/timeprof.hpp>
+#include <utility/log.hpp>
+#include <utility/assumptions.hpp>
+#include <utility/invariants.hpp>
+#include <unordered_set>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+
+
+static netlab::network_layer  make_layer(float_32_bit const  spike_sign)
+{
+    return {
+            spike_sign, // SPIKE_SIGN
+            1.0f,   // CHARGE_SPIKE
+            0.0f,   // CHARGE_RECOVERY
+            0.9f,   // CHARGE_DECAY_COEF
+            0.5f,   // WEIGHT_NEUTRAL_CHARGE
+            0.01f,  // WEIGHT_DELTA_PER_SPIKE
+            0.5f,   // WEIGHT_CONNECTION
+            0.1f,   // WEIGHT_DISCONNECTION
+            1.0f,   // WEIGHT_MAXIMAL
+            0.4f,   // SPIKE_MAGNITUDE
+            0U,     // first_unit
+            0U,     // num_units
+            0U      // num_sockets_per_unit
+            };
+}
+
+
+static void  build_network(netlab::network&  net)
+{
+    TMPROF_BLOCK();
+
+    // The layer i is inhibitory, when the count of inhibitory layers (i.e. 'ratio * number of layers', rounded down)
+    // increases at i.
+    float_32_bit const  ratio = get_program_options()->ratio_of_inhibitory_layers();
+    netlab::builder  net_builder(&net);
+    for (int  i = 0; i < get_program_options()->num_layers(); ++i)
+        net_builder.insert_layer_info({
+                (natural_32_bit)get_program_options()->num_units_per_layer(),
+                (netlab::uid::socket_index_type)get_program_options()->num_sockets_per_unit(),
+                make_layer(std::floor((i + 1) * ratio) > std::floor(i * ratio) ? -1.0f : 1.0f)
+                });
+    net_builder.run();
+}
+
+
+// The number of bytes allocated by arrays of sockets.
+static natural_64_bit  compute_memory_of_synapses(netlab::synapses const&  sockets)
+{
+    auto const  bytes = [](auto const&  elements) {
+        return (natural_64_bit)elements.capacity() * sizeof(elements.front());
+    };
+    return bytes(sockets.slots_begin) + bytes(sockets.num_used_inputs) + bytes(sockets.num_used_outputs) +
+           bytes(sockets.input_sources) + bytes(sockets.input_source_sockets) + bytes(sockets.input_weights) +
+           bytes(sockets.output_targets) + bytes(sockets.output_target_sockets) +
+           (natural_64_bit)sockets.num_blocks() * sizeof(sockets.modified_blocks[0]);
+}
+
+
+// Runs rounds of the network with random spikes of input units. Returns the number of spikes of output units.
+static natural_64_bit  run_rounds(
+        netlab::network&  net,
+        natural_32_bit const  num_rounds,
+        random_generator_for_natural_32_bit&  input_generator,
+        std::size_t&  checksum
+        )
+{
+    natural_64_bit  num_output_spikes = 0ULL;
+    for (natural_32_bit  round = 0U; round < num_rounds; ++round)
+    {
+        for (int  i = 0; i < get_program_options()->num_input_spikes_per_round(); ++i)
+            net.set_spiking_input_unit({
+                    0U,
+                    get_random_natural_32_bit_in_range(0U, get_program_options()->num_units_per_layer() - 1U, input_generator),
+                    0U
+                    });
+        net.next_round();
+        for (netlab::uid  id : net.get_spiking_output_units())
+            ::hash_combine(checksum, netlab::uid::as_number(id));
+        num_output_spikes += net.get_spiking_output_units().size();
+    }
+    return num_output_spikes;
+}
+
+
+// Prints the start of the JSON object reported by each benchmark (its name and the values of all options);
+// the caller adds its own members and closes the object.
+static void  print_json_header(std::string const&  benchmark)
+{
+    std::cout << "{\n"
+              << "  \"benchmark\": \"" << benchmark << "\",\n"
+              << "  \"parameters\": {"
+              << " \"layers\": " << get_program_options()->num_layers()
+              << ", \"units\": " << get_program_options()->num_units_per_layer()
+              << ", \"sockets\": " << get_program_options()->num_sockets_per_unit()
+              << ", \"inhibitory_ratio\": " << get_program_options()->ratio_of_inhibitory_layers()
+              << ", \"input_spikes\": " << get_program_options()->num_input_spikes_per_round()
+              << ", \"rounds\": " << get_program_options()->num_rounds()
+              << ", \"threads\": " << get_program_options()->max_num_threads()
+              << ", \"seed\": " << get_program_options()->seed()
+              << ", \"charge_update\": \"" << get_program_options()->charge_update() << "\""
+              << ", \"snapshot_rounds\": " << get_program_options()->num_rounds_per_snapshot()
+              << " },\n";
+}
+
+
+static void  run_layer_benchmark()
+{
+    TMPROF_BLOCK();
+
+    struct  run_result
+    {
+        natural_32_bit  num_units;
+        float_64_bit  seconds;
+        natural_64_bit  num_output_spikes;
+    };
+
+    natural_32_bit const  seed = (natural_32_bit)get_program_options()->seed();
+
+    std::vector<run_result>  results;
+    for (natural_32_bit  num_units = 1024U; num_units <= 16384U; num_units *= 2U)
+    {
+        // The measured layer is the output layer of the network; each its unit is connected to one input unit.
+        netlab::network  net(1U, 1U, seed, {});
+        netlab::builder  net_builder(&net);
+        net_builder.insert_layer_info({ num_units, 1U, make_layer(1.0f) });
+        net_builder.insert_layer_info({ num_units, 1U, make_layer(1.0f) });
+        net_builder.run();
+        net.set_event_driven(get_program_options()->charge_update() == "event");
+
+        random_generator_for_natural_32_bit  input_generator;
+        reset(input_generator, seed);
+
+        natural_32_bit const  num_input_spikes =
+                std::min((natural_32_bit)get_program_options()->num_input_spikes_per_round(), num_units);
+        natural_64_bit  num_output_spikes = 0ULL;
+        auto const  start_time = std::chrono::high_resolution_clock::now();
+        for (int  round = 0; round < get_program_options()->num_rounds(); ++round)
+        {
+            for (natural_32_bit  i = 0U; i < num_input_spikes; ++i)
+                net.set_spiking_input_unit({ 0U, get_random_natural_32_bit_in_range(0U, num_units - 1U, input_generator), 0U });
+            net.next_round();
+            num_output_spikes += net.get_spiking_output_units().size();
+        }
+        float_64_bit const  duration =
+                std::chrono::duration<float_64_bit>(std::chrono::high_resolution_clock::now() - start_time).count();
+
+        results.push_back({ num_units, duration, num_output_spikes });
+    }
+
+    auto const  nanoseconds_per_unit = [](run_result const&  result) {
+        return 1e9 * result.seconds / ((float_64_bit)result.num_units * get_program_options()->num_rounds());
+    };
+
+    if (get_program_options()->report() == "json")
+    {
+        print_json_header("layer");
+        std::cout << "  \"runs\": [";
+        for (std::size_t  i = 0UL; i != results.size(); ++i)
+        {
+            run_result const&  result = results.at(i);
+            std::cout << (i == 0UL ? "\n" : ",\n")
+                      << "    {"
+                      << " \"units\": " << result.num_units
+                      << ", \"seconds\": " << result.seconds
+                      << ", \"nanoseconds_per_unit\": " << nanoseconds_per_unit(result)
+                      << ", \"output_spikes\": " << result.num_output_spikes
+                      << " }";
+        }
+        std::cout << "\n  ]\n}" << std::endl;
+        return;
+    }
+
+    for (run_result const&  result : results)
+        std::cout << "units: " << result.num_units
+                  << "  seconds: " << result.seconds
+                  << "  nanoseconds/unit: " << nanoseconds_per_unit(result)
+                  << "  output spikes: " << result.num_output_spikes
+                  << std::endl;
+}
+
+
+struct  uid_benchmark_result
+{
+    std::string  name;
+    natural_32_bit  num_bytes;
+    float_64_bit  seconds;
+    float_64_bit  nanoseconds_per_id;
+    std::size_t  checksum;
+};
+
+
+// Measures operations the network performs with ids of units (sorting, hashing in statistics) for 'uid_type'.
+template<typename uid_type>
+static uid_benchmark_result  run_uid_benchmark(std::string const&  name)
+{
+    TMPROF_BLOCK();
+
+    natural_32_bit const  num_layers = std::min((natural_32_bit)get_program_options()->num_layers(), uid_type::MAX_NUM_LAYERS);
+    natural_32_bit const  num_units =
+            std::min((natural_32_bit)get_program_options()->num_units_per_layer(), uid_type::MAX_NUM_UNITS_PER_LAYER);
+
+    random_generator_for_natural_32_bit  generator;
+    reset(generator, (natural_32_bit)get_program_options()->seed());
+    std::vector<uid_type>  ids;
+    for (natural_32_bit  i = 0U, n = num_layers * num_units; i != n; ++i)
+        ids.push_back({
+                get_random_natural_32_bit_in_range(0U, num_layers - 1U, generator),
+                get_random_natural_32_bit_in_range(0U, num_units - 1U, generator),
+                0U
+                });
+
+    std::size_t  checksum = 0UL;
+    auto const  start_time = std::chrono::high_resolution_clock::now();
+    for (int  round = 0; round < get_program_options()->num_rounds(); ++round)
+    {
+        std::vector<uid_type>  sorted_ids = ids;
+        std::sort(sorted_ids.begin(), sorted_ids.end());
+        std::unordered_set<uid_type>  probes(sorted_ids.begin(), sorted_ids.begin() + sorted_ids.size() / 16U);
+        for (uid_type const  id : ids)
+            if (probes.count(uid_type::as_unit(id)) != 0UL)
+                ::hash_combine(checksum, uid_type::as_number(id));
+    }
+    float_64_bit const  duration =
+            std::chrono::duration<float_64_bit>(std::chrono::high_resolution_clock::now() - start_time).count();
+
+    return {
+            name,
+            (natural_32_bit)sizeof(uid_type),
+            duration,
+            1e9 * duration / ((float_64_bit)ids.size() * get_program_options()->num_rounds()),
+            checksum
+            };
+}
+
+
+static void  run_uid_benchmarks()
+{
+    TMPROF_BLOCK();
+
+    std::vector<uid_benchmark_result> const  results{
+            run_uid_benchmark<netlab::compact_uid>("compact"),
+            run_uid_benchmark<netlab::wide_uid>("wide")
+            };
+
+    if (get_program_options()->report() == "json")
+    {
+        print_json_header("uid");
+        std::cout << "  \"runs\": [";
+        for (std::size_t  i = 0UL; i != results.size(); ++i)
+        {
+            uid_benchmark_result const&  result = results.at(i);
+            std::cout << (i == 0UL ? "\n" : ",\n")
+                      << "    {"
+                      << " \"ids\": \"" << result.name << "\""
+                      << ", \"bytes\": " << result.num_bytes
+                      << ", \"seconds\": " << result.seconds
+                      << ", \"nanoseconds_per_id\": " << result.nanoseconds_per_id
+                      << ", \"checksum\": \"" << result.checksum << "\""
+                      << " }";
+        }
+        std::cout << "\n  ]\n}" << std::endl;
+        return;
+    }
+
+    for (uid_benchmark_result const&  result : results)
+        std::cout << "ids: " << result.name
+                  << "  bytes: " << result.num_bytes
+                  << "  seconds: " << result.seconds
+                  << "  nanoseconds/id: " << result.nanoseconds_per_id
+                  << "  checksum: " << result.checksum
+                  << std::endl;
+}
+
+
+static void  run_network_benchmark()
+{
+    TMPROF_BLOCK();
+
+    struct  run_result
+    {
+        bool  event_driven;
+        natural_32_bit  num_threads;
+        float_64_bit  seconds;
+        natural_64_bit  num_output_spikes;
+        std::size_t  checksum;
+        netlab::network::counters  counters;    // Differences of counters of the network during the run.
+    };
+
+    natural_32_bit const  seed = (natural_32_bit)get_program_options()->seed();
+
+    std::vector<run_result>  results;
+    natural_64_bit  num_slots = 0ULL;
+    natural_64_bit  num_synapses = 0ULL;
+    natural_64_bit  num_bytes = 0ULL;
+    for (bool const  event_driven : { false, true })
+    {
+        if (get_program_options()->charge_update() == (event_driven ? "dense" : "event"))
+            continue;
+
+        for (natural_32_bit  num_threads = 1U; ; num_threads *= 2U)
+        {
+            num_threads = std::min(num_threads, (natural_32_bit)get_program_options()->max_num_threads());
+
+            netlab::network  net(1U, 1U, seed, {
+                    (natural_32_bit)get_program_options()->num_rounds_per_snapshot(),
+                    16U,
+                    get_program_options()->ratio_of_probed_units()
+                    });
+            build_network(net);
+            net.set_num_threads(num_threads);
+            net.set_event_driven(event_driven);
+
+            random_generator_for_natural_32_bit  input_generator;
+            reset(input_generator, seed);
+
+            run_result  result;
+            result.event_driven = event_driven;
+            result.num_threads = num_threads;
+            result.checksum = 0UL;
+            netlab::network::counters const  counters = net.get_counters();
+            auto const  start_time = std::chrono::high_resolution_clock::now();
+            result.num_output_spikes =
+                    run_rounds(net, (natural_32_bit)get_program_options()->num_rounds(), input_generator, result.checksum);
+            result.seconds =
+                    std::chrono::duration<float_64_bit>(std::chrono::high_resolution_clock::now() - start_time).count();
+            result.counters = net.get_counters();
+            result.counters.num_spikes -= counters.num_spikes;
+            result.counters.num_synaptic_events -= counters.num_synaptic_events;
+            result.counters.num_connections -= counters.num_connections;
+            result.counters.num_disconnections -= counters.num_disconnections;
+            results.push_back(result);
+
+            if (results.size() == 1UL)
+            {
+                netlab::synapses const&  sockets = net.get_sockets();
+                num_slots = sockets.num_slots();
+                num_synapses = std::count_if(sockets.input_sources.begin(), sockets.input_sources.end(),
+                                             [](natural_32_bit const  unit) { return unit != netlab::synapses::TOMBSTONE; });
+                num_bytes = compute_memory_of_synapses(sockets);
+            }
+
+            if (num_threads == (natural_32_bit)get_program_options()->max_num_threads())
+                break;
+        }
+    }
+
+    auto const  per_second = [](natural_64_bit const  count, float_64_bit const  seconds) {
+        return (float_64_bit)count / std::max(seconds, 1e-9);
+    };
+    // A rewiring is either a new connection or a disconnection of a synapse.
+    auto const  num_rewirings = [](run_result const&  result) {
+        return result.counters.num_connections + result.counters.num_disconnections;
+    };
+    char const* const  ids_name = sizeof(netlab::uid) == sizeof(netlab::compact_uid) ? "compact" : "wide";
+
+    if (get_program_options()->report() == "json")
+    {
+        print_json_header("network");
+        std::cout << "  \"ids\": \"" << ids_name << "\",\n"
+                  << "  \"memory\": {"
+                  << " \"slots\": " << num_slots
+                  << ", \"synapses\": " << num_synapses
+                  << ", \"bytes\": " << num_bytes
+                  << ", \"bytes_per_slot\": " << (float_64_bit)num_bytes / std::max(num_slots, (natural_64_bit)1U)
+                  << ", \"bytes_per_synapse\": " << (float_64_bit)num_bytes / std::max(num_synapses, (natural_64_bit)1U)
+                  << " },\n"
+                  << "  \"runs\": [";
+        for (std::size_t  i = 0UL; i != results.size(); ++i)
+        {
+            run_result const&  result = results.at(i);
+            std::cout << (i == 0UL ? "\n" : ",\n")
+                      << "    {"
+                      << " \"mode\": \"" << (result.event_driven ? "event" : "dense") << "\""
+                      << ", \"threads\": " << result.num_threads
+                      << ", \"seconds\": " << result.seconds
+                      << ", \"rounds_per_second\": " << per_second(get_program_options()->num_rounds(), result.seconds)
+                      << ", \"spikes_per_second\": " << per_second(result.counters.num_spikes, result.seconds)
+                      << ", \"synaptic_events_per_second\": " << per_second(result.counters.num_synaptic_events, result.seconds)
+                      << ", \"connections_per_second\": " << per_second(result.counters.num_connections, result.seconds)
+                      << ", \"disconnections_per_second\": " << per_second(result.counters.num_disconnections, result.seconds)
+                      << ", \"rewirings_per_second\": " << per_second(num_rewirings(result), result.seconds)
+                      << ", \"output_spikes\": " << result.num_output_spikes
+                      << ", \"checksum\": \"" << result.checksum << "\""    // A string, as JSON numbers are not exact above 2^53.
+                      << " }";
+        }
+        std::cout << "\n  ]\n}" << std::endl;
+        return;
+    }
+
+    std::cout << "ids: " << ids_name
+              << "  bytes: " << sizeof(netlab::uid)
+              << "  synapses: " << num_synapses << "/" << num_slots
+              << "  bytes/synapse: " << (float_64_bit)num_bytes / std::max(num_synapses, (natural_64_bit)1U)
+              << std::endl;
+    for (run_result const&  result : results)
+        std::cout << "mode: " << (result.event_driven ? "event" : "dense")
+                  << "  threads: " << result.num_threads
+                  << "  seconds: " << result.seconds
+                  << "  rounds/second: " << per_second(get_program_options()->num_rounds(), result.seconds)
+                  << "  spikes/second: " << per_second(result.counters.num_spikes, result.seconds)
+                  << "  synaptic events/second: " << per_second(result.counters.num_synaptic_events, result.seconds)
+                  << "  rewirings/second: " << per_second(num_rewirings(result), result.seconds)
+                  << "  output spikes: " << result.num_output_spikes
+                  << "  checksum: " << result.checksum
+                  << std::endl;
+}
+
+
+static void  run_snapshot_benchmark()
+{
+    TMPROF_BLOCK();
+
+    natural_32_bit const  seed = (natural_32_bit)get_program_options()->seed();
+    natural_32_bit const  num_rounds = (natural_32_bit)get_program_options()->num_rounds();
+    std::filesystem::path const  pathname = std::filesystem::temp_directory_path() / "netlabbench.snapshot";
+
+    auto const  seconds_since = [](std::chrono::high_resolution_clock::time_point const  start_time) {
+        return std::chrono::duration<float_64_bit>(std::chrono::high_resolution_clock::now() - start_time).count();
+    };
+
+    netlab::network  net(1U, 1U, seed, {});
+    build_network(net);
+    net.set_num_threads((natural_32_bit)get_program_options()->max_num_threads());
+
+    random_generator_for_natural_32_bit  input_generator;
+    reset(input_generator, seed);
+    std::size_t  checksum = 0UL;
+    run_rounds(net, num_rounds, input_generator, checksum);
+
+    auto  start_time = std::chrono::high_resolution_clock::now();
+    netlab::save_snapshot(net, pathname);
+    float_64_bit const  full_save_duration = seconds_since(start_time);
+
+    run_rounds(net, 1U, input_generator, checksum);
+    natural_32_bit  num_modified_blocks = 0U;
+    for (natural_32_bit  block = 0U; block != net.get_sockets().num_blocks(); ++block)
+        if (net.get_sockets().is_block_modified(block))
+            ++num_modified_blocks;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    netlab::save_snapshot(net, pathname);
+    float_64_bit const  incremental_save_duration = seconds_since(start_time);
+
+    netlab::network  restored_net;
+    restored_net.set_num_threads(net.get_num_threads());
+    start_time = std::chrono::high_resolution_clock::now();
+    netlab::load_snapshot(restored_net, pathname);
+    float_64_bit const  load_duration = seconds_since(start_time);
+
+    natural_64_bit const  num_bytes = std::filesystem::file_size(pathname);
+    std::filesystem::remove(pathname);
+
+    random_generator_for_natural_32_bit  restored_input_generator = input_generator;
+    std::size_t  restored_checksum = checksum;
+    run_rounds(net, num_rounds, input_generator, checksum);
+    run_rounds(restored_net, num_rounds, restored_input_generator, restored_checksum);
+
+    if (get_program_options()->report() == "json")
+    {
+        print_json_header("snapshot");
+        std::cout << "  \"bytes\": " << num_bytes << ",\n"
+                  << "  \"full_save_seconds\": " << full_save_duration << ",\n"
+                  << "  \"modified_blocks\": " << num_modified_blocks << ",\n"
+                  << "  \"blocks\": " << net.get_sockets().num_blocks() << ",\n"
+                  << "  \"incremental_save_seconds\": " << incremental_save_duration << ",\n"
+                  << "  \"load_seconds\": " << load_duration << ",\n"
+                  << "  \"restored_identical\": " << (checksum == restored_checksum ? "true" : "false") << "\n"
+                  << "}" << std::endl;
+        return;
+    }
+
+    std::cout << "bytes: " << num_bytes
+              << "  full save seconds: " << full_save_duration
+              << "  modified blocks: " << num_modified_blocks << "/" << net.get_sockets().num_blocks()
+              << "  incremental save seconds: " << incremental_save_duration
+              << "  load seconds: " << load_duration
+              << "  restored: " << (checksum == restored_checksum ? "identical" : "DIFFERENT")
+              << std::endl;
+}
+
+
+void run(int argc, char* argv[])
+{
+    TMPROF_BLOCK();
+
+    if (get_program_options()->num_layers() < 2 || get_program_options()->num_layers() > (int)netlab::uid::MAX_NUM_LAYERS ||
+        get_program_options()->num_units_per_layer() < 1 ||
+        get_program_options()->num_units_per_layer() > (int)netlab::uid::MAX_NUM_UNITS_PER_LAYER ||
+        get_program_options()->num_sockets_per_unit() < 1 ||
+        get_program_options()->num_sockets_per_unit() > (int)netlab::uid::MAX_NUM_SOCKETS_PER_UNIT ||
+        get_program_options()->max_num_threads() < 1 ||
+        get_program_options()->num_rounds_per_snapshot() < 0 ||
+        get_program_options()->ratio_of_probed_units() < 0.0f || get_program_options()->ratio_of_probed_units() > 1.0f ||
+        get_program_options()->ratio_of_inhibitory_layers() < 0.0f || get_program_options()->ratio_of_inhibitory_layers() > 1.0f ||
+        (get_program_options()->report() != "text" && get_program_options()->report() != "json") ||
+        (get_program_options()->charge_update() != "dense" && get_program_options()->charge_update() != "event" &&
+         get_program_options()->charge_update() != "both") ||
+        (get_program_options()->benchmark() != "network" && get_program_options()->benchmark() != "layer" &&
+         get_program_options()->benchmark() != "uid" && get_program_options()->benchmark() != "snapshot"))
+    {
+        std::cout << "Wrong usage of the tool. Use the command --help." << std::endl;
+        return;
+    }
+
+    if (get_program_options()->benchmark() == "layer")
+        run_layer_benchmark();
+    else if (get_program_options()->benchmark() == "uid")
+        run_uid_benchmarks();
+    else if (get_program_options()->benchmark() == "snapshot")
+        run_snapshot_benchmark();
+    else
+        run_network_benchmark();
+}
@@ -0,0 +1,22 @@
+#include <packkeyframes/program_info.hpp>
+
+std::string  get_program_name()
+{
+    return "packkeyframes";
+}
+
+std::string  get_program_version()
+{
+    return "0.1";
+}
+
+std::string  get_program_description()
+{
+    return "Converts keyframes of motion templates from text files 'keyframe*.txt'\n"
+           "(and 'bones.txt') into a single binary file 'keyframes.bin' per directory.\n"
+           "Binary keyframes are memory-mapped on load and each keyframe is decoded\n"
+           "only when it is accessed for the first time. NOTE: When 'keyframes.bin'\n"
+           "is present, the text files in the directory are ignored by the loader.\n"
+           "So, re-run the tool whenever the text files are modified.\n"
+           ;
+}
@@ -0,0 +1,41 @@
+#include <packkeyframes/program_options.hpp>
+#include <packkeyframes/program_info.hpp>
+#include <utility/assumptions.hpp>
+#include <stdexcept>
+#include <iostream>
+
+program_options::program_options(int argc, char* argv[])
+    : program_options_default(argc, argv)
+{
+    add_option(
+        "input",
+
+        "A directory which is searched recursively for directories of keyframes "
+        "(i.e. those containing the file 'keyframe0.txt'). Typically, it is a "
+        "directory of skeletal motion templates, like 'anim/skeletal/mannequin'. "
+        "The path is relative to the data root directory (see --data option).",
+
+        "1"
+        );
+}
+
+static program_options_ptr  global_program_options;
+
+void initialise_program_options(int argc, char* argv[])
+{
+    ASSUMPTION(!global_program_options.operator bool());
+    global_program_options = program_options_ptr(new program_options(argc,argv));
+}
+
+program_options_ptr get_program_options()
+{
+    ASSUMPTION(global_program_options.operator bool());
+    return global_program_options;
+}
+
+std::ostream& operator<<(std::ostream& ostr, program_options_ptr options)
+{
+    ASSUMPTION(options.operator bool());
+    options->operator<<(ostr);
+    return ostr;
+}
@@ -0,0 +1,50 @@
+#include <packkeyframes/program_info.hpp>
+#include <packkeyframes/program_options.hpp>
+#include <gfx/keyframe.hpp>
+#include <utility/timeprof.hpp>
+#include <utility/log.hpp>
+#include <utility/msgstream.hpp>
+#include <utility/assumptions.hpp>
+#include <utility/invariants.hpp>
+#include <filesystem>
+#include <iostream>
+
+
+void run(int argc, char* argv[])
+{
+    TMPROF_BLOCK();
+
+    if (!get_program_options()->has_input_dir())
+    {
+        std::cout << "Wrong usage of the tool. Use the command --help." << std::endl;
+        return;
+    }
+    std::filesystem::path const  input_dir =
+            std::filesystem::absolute(std::filesystem::path(get_program_options()->data_root()) / get_program_options()->input_dir());
+    if (!std::filesystem::is_directory(input_dir))
+    {
+        std::cout << "Cannot access the input directory '" << input_dir.string() << "'" << std::endl;
+        return;
+    }
+
+    natural_32_bit  num_converted = 0U;
+    natural_32_bit  num_failed = 0U;
+    for (std::filesystem::directory_entry const&  entry : std::filesystem::recursive_directory_iterator(input_dir))
+    {
+        if (!std::filesystem::is_directory(entry.path()) || !std::filesystem::is_regular_file(entry.path() / "keyframe0.txt"))
+            continue;
+        try
+        {
+            gfx::convert_keyframes_to_binary(entry.path());
+            ++num_converted;
+        }
+        catch (std::exception const& e)
+        {
+            std::cout << "Failed to convert keyframes in the directory '" << entry.path().string() << "'. Details:\n"
+                      << e.what() << std::endl;
+            LOG(LSL_ERROR, e.what());
+            ++num_failed;
+        }
+    }
+    std::cout << "Converted directories: " << num_converted << ", failed: " << num_failed << std::endl;
+}
@@ -4,6 +4,10 @@
 #   include <utility/basic_numeric_types.hpp>
 #   include <utility/typefn_if_then_else.hpp>
 #   include <utility/assumptions.hpp>
+#   include <utility/config.hpp>
+#   if COMPILER() == COMPILER_VC()
+#       include <intrin.h>
+#   endif
 
 
 natural_8_bit  compute_num_of_bits_to_store_number(natural_32_bit  number);
@@ -11,6 +15,28 @@ natural_8_bit  compute_byte_aligned_num_of_bits_to_store_number(natural_32_bit
 
 natural_64_bit  num_bytes_to_store_bits(natural_64_bit const  num_bits_to_store);
 
+// Both functions map to single instructions on targets supporting them (popcnt, tzcnt/bsf).
+inline natural_8_bit  count_one_bits(natural_64_bit const  bits)
+{
+#   if COMPILER() == COMPILER_VC()
+    return (natural_8_bit)__popcnt64(bits);
+#   else
+    return (natural_8_bit)__builtin_popcountll(bits);
+#   endif
+}
+
+inline natural_8_bit  index_of_lowest_one_bit(natural_64_bit const  bits)
+{
+    ASSUMPTION(bits != 0ULL);
+#   if COMPILER() == COMPILER_VC()
+    unsigned long  index;
+    _BitScanForward64(&index, bits);
+    return (natural_8_bit)index;
+#   else
+    return (natural_8_bit)__builtin_ctzll(bits);
+#   endif
+}
+
 template<typename T>
 struct smallest_natural_type_storing_bit_count_of
 {
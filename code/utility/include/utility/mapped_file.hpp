@@ -0,0 +1,45 @@
+#ifndef UTILITY_MAPPED_FILE_HPP_INCLUDED
+#   define UTILITY_MAPPED_FILE_HPP_INCLUDED
+
+#   include <utility/basic_numeric_types.hpp>
+#   include <utility/config.hpp>
+#   include <filesystem>
+#   include <vector>
+#   include <memory>
+
+
+/**
+ * A read-only view of the whole content of a file. The file is memory-mapped, so its pages
+ * are loaded by the OS only when they are accessed for the first time. On platforms without
+ * memory mapping (WebAssembly) the content is read into a buffer instead.
+ * The constructor throws std::runtime_error, when the file cannot be opened or mapped.
+ */
+struct  mapped_file
+{
+    explicit mapped_file(std::filesystem::path const&  pathname);
+    ~mapped_file();
+
+    mapped_file(mapped_file const&) = delete;
+    mapped_file&  operator=(mapped_file const&) = delete;
+
+    natural_8_bit const*  data() const { return m_data; }
+    natural_64_bit  size() const { return m_size; }
+    std::filesystem::path const&  pathname() const { return m_pathname; }
+
+private:
+    std::filesystem::path  m_pathname;
+    natural_8_bit const*  m_data;
+    natural_64_bit  m_size;
+#   if PLATFORM() == PLATFORM_WINDOWS()
+    void*  m_file_handle;
+    void*  m_mapping_handle;
+#   elif PLATFORM() == PLATFORM_WEBASSEMBLY()
+    std::vector<natural_8_bit>  m_buffer;
+#   endif
+};
+
+
+using  mapped_file_ptr = std::shared_ptr<mapped_file const>;
+
+
+#endif
@@ -50,6 +50,28 @@ void  reset(random_generator_for_natural_64_bit&  generator,
             natural_64_bit const  seed = random_generator_for_natural_64_bit::default_seed);
 
 
+// Counter-based generation: returns the 'counter'-th number of the random stream identified by 'key' (mixed by
+// the finaliser of SplitMix64). There is no state, so numbers of a stream can be generated in any order and by
+// any number of threads, and the results are still reproducible.
+inline natural_64_bit  get_counter_based_random_natural_64_bit(natural_64_bit const  key, natural_64_bit const  counter)
+{
+    natural_64_bit  z = key + (counter + 1ULL) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31U);
+}
+
+// Returns a number in 0,...,bound-1 (by the multiply-shift reduction, whose bias is negligible for bounds << 2^32).
+inline natural_32_bit  get_counter_based_random_natural_32_bit_below(
+        natural_64_bit const  key,
+        natural_64_bit const  counter,
+        natural_32_bit const  bound
+        )
+{
+    return (natural_32_bit)(((get_counter_based_random_natural_64_bit(key, counter) >> 32U) * (natural_64_bit)bound) >> 32U);
+}
+
+
 using  bar_random_distribution = std::vector<float_32_bit>;
 
 inline natural_32_bit  get_num_bars(bar_random_distribution const&  bar_distribution)
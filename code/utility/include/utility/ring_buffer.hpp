@@ -0,0 +1,105 @@
+#ifndef UTILITY_RING_BUFFER_HPP_INCLUDED
+#   define UTILITY_RING_BUFFER_HPP_INCLUDED
+
+#   include <utility/basic_numeric_types.hpp>
+#   include <utility/assumptions.hpp>
+#   include <vector>
+
+
+/**
+ * A FIFO queue stored in a single contiguous vector. Elements are pushed at the back and popped
+ * from the front. The capacity is always a power of 2 and it doubles when the buffer is full, so
+ * that there are no allocations in a steady state (unlike node based containers like std::multimap).
+ */
+template<typename T>
+struct  ring_buffer
+{
+    using  element_type = T;
+    using  data_vector = std::vector<element_type>;
+
+    struct  const_iterator
+    {
+        using value_type      = element_type;
+        using difference_type = natural_32_bit;
+        using pointer         = value_type const*;
+        using reference       = value_type const&;
+
+        const_iterator() noexcept : buffer(nullptr), idx(0U) {}
+        const_iterator(ring_buffer const* const  buffer_, natural_32_bit const  idx_) noexcept : buffer(buffer_), idx(idx_) {}
+
+        reference  operator*() const { return buffer->at(idx); }
+        pointer  operator->() const { return &buffer->at(idx); }
+
+        const_iterator&  operator++() { ++idx; return *this; }
+        const_iterator  operator++(int) { const_iterator  tmp = *this; ++idx; return tmp; }
+
+        bool  operator==(const_iterator const&  other) const { return idx == other.idx && buffer == other.buffer; }
+        bool  operator!=(const_iterator const&  other) const { return !(*this == other); }
+
+        natural_32_bit  index() const { return idx; }
+
+    private:
+
+        ring_buffer const*  buffer;
+        natural_32_bit  idx;
+    };
+
+    ring_buffer() : m_data(), m_first(0U), m_size(0U) {}
+
+    void  push_back(element_type const&  value);
+    void  pop_front() { ASSUMPTION(!empty()); m_first = (m_first + 1U) & mask(); --m_size; }
+    void  clear() { m_first = 0U; m_size = 0U; }
+
+    bool  empty() const { return m_size == 0U; }
+    natural_32_bit  size() const { return m_size; }
+    natural_32_bit  capacity() const { return (natural_32_bit)m_data.size(); }
+    void  reserve(natural_32_bit const  min_capacity);
+
+    // The index 0 refers to the front (the oldest) element.
+    element_type const&  at(natural_32_bit const  idx) const { ASSUMPTION(idx < m_size); return m_data[(m_first + idx) & mask()]; }
+    element_type&  at(natural_32_bit const  idx) { ASSUMPTION(idx < m_size); return m_data[(m_first + idx) & mask()]; }
+
+    element_type const&  front() const { return at(0U); }
+    element_type&  front() { return at(0U); }
+    element_type const&  back() const { return at(m_size - 1U); }
+    element_type&  back() { return at(m_size - 1U); }
+
+    const_iterator  begin() const { return const_iterator(this, 0U); }
+    const_iterator  end() const { return const_iterator(this, m_size); }
+
+private:
+    natural_32_bit  mask() const { return (natural_32_bit)m_data.size() - 1U; }
+
+    data_vector  m_data;
+    natural_32_bit  m_first;
+    natural_32_bit  m_size;
+};
+
+
+template<typename T>
+void  ring_buffer<T>::push_back(element_type const&  value)
+{
+    if (m_size == capacity())
+        reserve(m_size == 0U ? 16U : 2U * m_size);
+    m_data[(m_first + m_size) & mask()] = value;
+    ++m_size;
+}
+
+
+template<typename T>
+void  ring_buffer<T>::reserve(natural_32_bit const  min_capacity)
+{
+    if (min_capacity <= capacity())
+        return;
+    natural_32_bit  new_capacity = 16U;
+    while (new_capacity < min_capacity)
+        new_capacity *= 2U;
+    data_vector  new_data(new_capacity);
+    for (natural_32_bit  i = 0U; i < m_size; ++i)
+        new_data[i] = at(i);
+    m_data.swap(new_data);
+    m_first = 0U;
+}
+
+
+#endif
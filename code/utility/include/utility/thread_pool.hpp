@@ -0,0 +1,52 @@
+#ifndef UTILITY_THREAD_POOL_HPP_INCLUDED
+#   define UTILITY_THREAD_POOL_HPP_INCLUDED
+
+#   include <utility/basic_numeric_types.hpp>
+#   include <boost/noncopyable.hpp>
+#   include <functional>
+#   include <exception>
+#   include <atomic>
+#   include <mutex>
+#   include <condition_variable>
+#   include <thread>
+#   include <vector>
+
+
+/**
+ * A fixed set of worker threads executing batches of tasks together with the calling thread. The workers are
+ * created in the constructor and they sleep between batches, so a batch costs only their wake-up, not a creation
+ * of threads. On platforms without threads (WebAssembly) there are no workers and all tasks run in the calling thread.
+ */
+struct  thread_pool : private boost::noncopyable
+{
+    using  task_function = std::function<void(natural_32_bit, natural_32_bit)>;
+
+    explicit thread_pool(natural_32_bit const  num_threads); // Including the calling thread, so it must be > 0.
+    ~thread_pool();
+
+    natural_32_bit  num_threads() const { return (natural_32_bit)m_workers.size() + 1U; }
+
+    // Calls 'task(i, t)' for each i in 0,...,num_tasks-1, where 't' is the index of the executing thread
+    // (in 0,...,num_threads()-1; the calling thread has 0). Returns when all tasks are done. When a task
+    // throws, remaining tasks are skipped and the first exception is rethrown. Batches cannot be nested.
+    void  run(natural_32_bit const  num_tasks, task_function const&  task);
+
+private:
+    void  execute_tasks(natural_32_bit const  thread_index);
+    void  worker_loop(natural_32_bit const  thread_index);
+
+    std::vector<std::thread>  m_workers;
+    std::mutex  m_mutex;
+    std::condition_variable  m_batch_started;
+    std::condition_variable  m_batch_finished;
+    task_function const*  m_task;                   // Valid only while a batch runs.
+    natural_32_bit  m_num_tasks;
+    std::atomic<natural_32_bit>  m_next_task_index;
+    natural_64_bit  m_batch_index;                  // Incremented with each batch; workers wait for its change.
+    natural_32_bit  m_num_busy_workers;
+    std::exception_ptr  m_first_exception;
+    bool  m_stop;
+};
+
+
+#endif
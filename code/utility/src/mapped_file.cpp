@@ -0,0 +1,87 @@
+#include <utility/mapped_file.hpp>
+#include <utility/msgstream.hpp>
+#include <utility/timeprof.hpp>
+#include <utility/assumptions.hpp>
+#include <stdexcept>
+#if PLATFORM() == PLATFORM_WINDOWS()
+#   include <windows.h>
+#elif PLATFORM() == PLATFORM_WEBASSEMBLY()
+#   include <fstream>
+#else
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+
+mapped_file::mapped_file(std::filesystem::path const&  pathname)
+    : m_pathname(pathname)
+    , m_data(nullptr)
+    , m_size(0ULL)
+#if PLATFORM() == PLATFORM_WINDOWS()
+    , m_file_handle(INVALID_HANDLE_VALUE)
+    , m_mapping_handle(nullptr)
+#elif PLATFORM() == PLATFORM_WEBASSEMBLY()
+    , m_buffer()
+#endif
+{
+    TMPROF_BLOCK();
+
+    if (!std::filesystem::is_regular_file(m_pathname))
+        throw std::runtime_error(msgstream() << "Cannot access the file '" << m_pathname << "'.");
+    m_size = std::filesystem::file_size(m_pathname);
+    if (m_size == 0ULL)
+        throw std::runtime_error(msgstream() << "Cannot map the empty file '" << m_pathname << "'.");
+
+#if PLATFORM() == PLATFORM_WINDOWS()
+    m_file_handle = CreateFileW(m_pathname.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file_handle == INVALID_HANDLE_VALUE)
+        throw std::runtime_error(msgstream() << "Cannot open the file '" << m_pathname << "'.");
+    m_mapping_handle = CreateFileMappingW(m_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping_handle == nullptr)
+    {
+        CloseHandle(m_file_handle);
+        throw std::runtime_error(msgstream() << "Cannot map the file '" << m_pathname << "'.");
+    }
+    m_data = (natural_8_bit const*)MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (m_data == nullptr)
+    {
+        CloseHandle(m_mapping_handle);
+        CloseHandle(m_file_handle);
+        throw std::runtime_error(msgstream() << "Cannot map the file '" << m_pathname << "'.");
+    }
+#elif PLATFORM() == PLATFORM_WEBASSEMBLY()
+    std::ifstream  istr(m_pathname.string(), std::ios_base::binary);
+    if (!istr.good())
+        throw std::runtime_error(msgstream() << "Cannot open the file '" << m_pathname << "'.");
+    m_buffer.resize(m_size);
+    if (!istr.read((char*)m_buffer.data(), (std::streamsize)m_size))
+        throw std::runtime_error(msgstream() << "Cannot read the file '" << m_pathname << "'.");
+    m_data = m_buffer.data();
+#else
+    int const  file_descriptor = ::open(m_pathname.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+        throw std::runtime_error(msgstream() << "Cannot open the file '" << m_pathname << "'.");
+    void* const  address = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    ::close(file_descriptor); // The mapping stays valid after the file is closed.
+    if (address == MAP_FAILED)
+        throw std::runtime_error(msgstream() << "Cannot map the file '" << m_pathname << "'.");
+    m_data = (natural_8_bit const*)address;
+#endif
+}
+
+
+mapped_file::~mapped_file()
+{
+#if PLATFORM() == PLATFORM_WINDOWS()
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping_handle);
+    CloseHandle(m_file_handle);
+#elif PLATFORM() == PLATFORM_WEBASSEMBLY()
+    // Nothing to release; the buffer is destroyed automatically.
+#else
+    ::munmap((void*)m_data, m_size);
+#endif
+}
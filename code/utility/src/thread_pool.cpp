@@ -0,0 +1,116 @@
+#include <utility/thread_pool.hpp>
+#include <utility/assumptions.hpp>
+#include <utility/invariants.hpp>
+#include <utility/config.hpp>
+
+
+thread_pool::thread_pool(natural_32_bit const  num_threads)
+    : m_workers()
+    , m_mutex()
+    , m_batch_started()
+    , m_batch_finished()
+    , m_task(nullptr)
+    , m_num_tasks(0U)
+    , m_next_task_index(0U)
+    , m_batch_index(0ULL)
+    , m_num_busy_workers(0U)
+    , m_first_exception(nullptr)
+    , m_stop(false)
+{
+    ASSUMPTION(num_threads > 0U);
+#if PLATFORM() != PLATFORM_WEBASSEMBLY()
+    for (natural_32_bit  i = 1U; i < num_threads; ++i)
+        m_workers.push_back(std::thread(&thread_pool::worker_loop, this, i));
+#endif
+}
+
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> const  lock(m_mutex);
+        m_stop = true;
+    }
+    m_batch_started.notify_all();
+    for (std::thread&  worker : m_workers)
+        worker.join();
+}
+
+
+void  thread_pool::run(natural_32_bit const  num_tasks, task_function const&  task)
+{
+    if (m_workers.empty() || num_tasks < 2U)
+    {
+        for (natural_32_bit  i = 0U; i < num_tasks; ++i)
+            task(i, 0U);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> const  lock(m_mutex);
+        ASSUMPTION(m_task == nullptr);
+        m_task = &task;
+        m_num_tasks = num_tasks;
+        m_next_task_index = 0U;
+        m_num_busy_workers = (natural_32_bit)m_workers.size();
+        m_first_exception = nullptr;
+        ++m_batch_index;
+    }
+    m_batch_started.notify_all();
+
+    execute_tasks(0U);
+
+    std::exception_ptr  first_exception;
+    {
+        std::unique_lock<std::mutex>  lock(m_mutex);
+        m_batch_finished.wait(lock, [this] { return m_num_busy_workers == 0U; });
+        m_task = nullptr;
+        std::swap(first_exception, m_first_exception);
+    }
+    if (first_exception != nullptr)
+        std::rethrow_exception(first_exception);
+}
+
+
+void  thread_pool::execute_tasks(natural_32_bit const  thread_index)
+{
+    try
+    {
+        for (natural_32_bit  i = m_next_task_index++; i < m_num_tasks; i = m_next_task_index++)
+            (*m_task)(i, thread_index);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> const  lock(m_mutex);
+        if (m_first_exception == nullptr)
+            m_first_exception = std::current_exception();
+        m_next_task_index = m_num_tasks;
+    }
+}
+
+
+void  thread_pool::worker_loop(natural_32_bit const  thread_index)
+{
+    natural_64_bit  last_batch_index = 0ULL;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex>  lock(m_mutex);
+            m_batch_started.wait(lock, [this, last_batch_index] { return m_stop || m_batch_index != last_batch_index; });
+            if (m_stop)
+                return;
+            last_batch_index = m_batch_index;
+        }
+
+        execute_tasks(thread_index);
+
+        bool  is_last;
+        {
+            std::lock_guard<std::mutex> const  lock(m_mutex);
+            INVARIANT(m_num_busy_workers > 0U);
+            is_last = --m_num_busy_workers == 0U;
+        }
+        if (is_last)
+            m_batch_finished.notify_one();
+    }
+}